@@ -0,0 +1,14 @@
+// Clip-space position of the depth pre-pass and of every pass testing GL_EQUAL
+// against its depth, see DepthPrepass. Depth only matches bit for bit if each
+// shader computes gl_Position with this same expression, declared invariant.
+uniform mat4 model;
+layout (std140, binding = 0) uniform FrameUniforms {
+    mat4 view;
+    mat4 projection;
+};
+
+invariant gl_Position;
+
+vec4 getClipPosition(vec4 position) {
+    return projection * view * model * position;
+}
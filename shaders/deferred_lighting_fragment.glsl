@@ -0,0 +1,232 @@
+#version 460 core
+
+// Must match GBuffer::MAX_SHININESS.
+#define MAX_SHININESS 256.0
+
+out vec4 FragColor;
+
+in vec2 screenPosition;
+
+// Bound to the units of GBuffer::Target.
+layout (binding = 0) uniform sampler2D gAlbedoSpecular;
+layout (binding = 1) uniform sampler2D gNormalShininess;
+layout (binding = 2) uniform sampler2D gDepth;
+
+uniform mat4 inverseViewProjection;
+uniform vec3 cameraPosition;
+
+struct Surface {
+    vec3 position;
+    vec3 normal;
+    vec3 albedo;
+    float specular;
+    float shininess;
+};
+
+struct DirectionalLight {
+    vec3 direction;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+uniform DirectionalLight directionalLight;
+
+// Same cluster lists as the forward path, see LightClusters.
+struct PointLight {
+    vec4 positionRadius;
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
+    vec4 attenuation;
+};
+
+layout (std140, binding = 0) uniform FrameUniforms {
+    mat4 view;
+    mat4 projection;
+};
+
+layout (std140, binding = 1) uniform ClusterUniforms {
+    uvec4 gridSize;
+    // near, far, slice scale, slice bias
+    vec4 depthParams;
+};
+
+layout (std430, binding = 1) readonly buffer PointLights {
+    PointLight pointLights[];
+};
+
+// (offset, count) into lightIndices for every cluster.
+layout (std430, binding = 2) readonly buffer LightClusters {
+    uvec2 lightClusters[];
+};
+
+layout (std430, binding = 3) readonly buffer LightIndices {
+    uint lightIndices[];
+};
+
+// Shadow maps of every light live in one atlas, see ShadowRenderer.
+struct ShadowView {
+    mat4 matrix;
+    vec4 rect;
+};
+
+layout (std140, binding = 2) uniform ShadowUniforms {
+    vec4 cascadeSplits;
+    // count, first view
+    ivec4 cascades;
+    // texel size, depth bias
+    vec4 shadowParams;
+};
+
+layout (std430, binding = 4) readonly buffer ShadowViews {
+    ShadowView shadowViews[];
+};
+
+layout (binding = 8) uniform sampler2DShadow shadowAtlas;
+
+vec3 decodeNormal(vec2 e);
+vec3 calculateDirectionalLight(DirectionalLight light, Surface surface, vec3 viewDir);
+vec3 calculatePointLight(PointLight light, Surface surface, vec3 viewDir);
+uint getClusterIndex(vec3 position);
+float sampleShadow(int viewIndex, vec3 position);
+float samplePointShadow(int firstView, vec3 lightPosition, vec3 position);
+float sampleDirectionalShadow(vec3 position);
+
+void main() {
+    float depth = texture(gDepth, screenPosition).r;
+    // Nothing was drawn here.
+    if (depth == 1.0) discard;
+
+    vec4 albedoSpecular = texture(gAlbedoSpecular, screenPosition);
+    vec4 normalShininess = texture(gNormalShininess, screenPosition);
+
+    vec4 worldPosition = inverseViewProjection * vec4(vec3(screenPosition, depth) * 2.0 - 1.0, 1.0);
+
+    Surface surface;
+    surface.position = worldPosition.xyz / worldPosition.w;
+    surface.normal = decodeNormal(normalShininess.xy * 2.0 - 1.0);
+    surface.albedo = albedoSpecular.rgb;
+    surface.specular = albedoSpecular.a;
+    surface.shininess = normalShininess.z * MAX_SHININESS;
+
+    // Light types and shadows are compiled in per variant, see ShaderPermutations.
+    vec3 viewDirection = normalize(cameraPosition - surface.position);
+    vec3 result = vec3(0.0);
+#ifdef DIRECTIONAL_LIGHT
+    result += calculateDirectionalLight(directionalLight, surface, viewDirection);
+#endif
+
+#ifdef POINT_LIGHTS
+    uvec2 cluster = lightClusters[getClusterIndex(surface.position)];
+    for (uint i = cluster.x; i < cluster.x + cluster.y; i++)
+        result += calculatePointLight(pointLights[lightIndices[i]], surface, viewDirection);
+#endif
+
+    FragColor = vec4(result, 1.0);
+}
+
+vec3 decodeNormal(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0)
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(n);
+}
+
+uint getClusterIndex(vec3 position) {
+    vec2 tile = screenPosition * vec2(gridSize.xy);
+    float viewDepth = -(view * vec4(position, 1.0)).z;
+    float slice = log(viewDepth) * depthParams.z + depthParams.w;
+
+    uvec3 cell = uvec3(clamp(vec3(tile, slice), vec3(0.0), vec3(gridSize.xyz) - 1.0));
+    return (cell.z * gridSize.y + cell.y) * gridSize.x + cell.x;
+}
+
+vec3 calculateDirectionalLight(DirectionalLight light, Surface surface, vec3 viewDir) {
+    vec3 lightDir = normalize(-light.direction);
+
+    float diff = max(dot(surface.normal, lightDir), 0.0);
+
+    vec3 reflectDir = reflect(-lightDir, surface.normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), surface.shininess);
+
+    vec3 ambient = light.ambient * surface.albedo;
+    vec3 diffuse = light.diffuse * diff * surface.albedo;
+    vec3 specular = light.specular * spec * surface.specular;
+
+#ifdef SHADOWS
+    return ambient + (diffuse + specular) * sampleDirectionalShadow(surface.position);
+#else
+    return ambient + diffuse + specular;
+#endif
+}
+
+vec3 calculatePointLight(PointLight light, Surface surface, vec3 viewDir) {
+    vec3 position = light.positionRadius.xyz;
+    vec3 lightDir = normalize(position - surface.position);
+    float diff = max(dot(surface.normal, lightDir), 0.0);
+
+    vec3 reflectDir = reflect(-lightDir, surface.normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), surface.shininess);
+
+    float distance = length(position - surface.position);
+    float attenuation = 1.0 / (light.attenuation.x + light.attenuation.y * distance +
+                            light.attenuation.z * (distance * distance));
+    // Fade out to zero at the culling radius so cluster edges do not show.
+    float falloff = clamp(1.0 - pow(distance / light.positionRadius.w, 4.0), 0.0, 1.0);
+    attenuation *= falloff * falloff;
+
+    vec3 ambient = light.ambient.rgb * surface.albedo;
+    vec3 diffuse  = light.diffuse.rgb  * diff * surface.albedo;
+    vec3 specular = light.specular.rgb * spec * surface.specular;
+#ifdef SHADOWS
+    float shadow = samplePointShadow(int(light.attenuation.w), position, surface.position);
+#else
+    float shadow = 1.0;
+#endif
+    return (ambient + (diffuse + specular) * shadow) * attenuation;
+}
+
+float sampleShadow(int viewIndex, vec3 position) {
+    if (viewIndex < 0) return 1.0;
+
+    ShadowView shadowView = shadowViews[viewIndex];
+    vec4 coords = shadowView.matrix * vec4(position, 1.0);
+    coords.xyz /= coords.w;
+    if (coords.z >= 1.0) return 1.0;
+
+    // Four bilinear comparisons, each already a 2x2 PCF, kept inside the tile.
+    float depth = coords.z - shadowParams.y;
+    float shadow = 0.0;
+    for (int i = 0; i < 4; i++) {
+        vec2 offset = vec2((i & 1) != 0 ? 0.5 : -0.5, (i & 2) != 0 ? 0.5 : -0.5) * shadowParams.x;
+        vec2 uv = clamp(coords.xy + offset, shadowView.rect.xy, shadowView.rect.zw);
+        shadow += texture(shadowAtlas, vec3(uv, depth));
+    }
+    return shadow * 0.25;
+}
+
+// Cube face views are stored +X, -X, +Y, -Y, +Z, -Z.
+float samplePointShadow(int firstView, vec3 lightPosition, vec3 position) {
+    if (firstView < 0) return 1.0;
+
+    vec3 direction = position - lightPosition;
+    vec3 size = abs(direction);
+    int face;
+    if (size.x >= size.y && size.x >= size.z)
+        face = direction.x >= 0.0 ? 0 : 1;
+    else if (size.y >= size.z)
+        face = direction.y >= 0.0 ? 2 : 3;
+    else
+        face = direction.z >= 0.0 ? 4 : 5;
+    return sampleShadow(firstView + face, position);
+}
+
+float sampleDirectionalShadow(vec3 position) {
+    float viewDepth = -(view * vec4(position, 1.0)).z;
+    for (int i = 0; i < cascades.x; i++) {
+        if (viewDepth < cascadeSplits[i])
+            return sampleShadow(cascades.y + i, position);
+    }
+    return 1.0;
+}
@@ -0,0 +1,10 @@
+#version 460 core
+
+out vec2 screenPosition;
+
+// One triangle covering the screen, generated from gl_VertexID.
+void main() {
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    screenPosition = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,5 @@
+#version 460 core
+
+// Depth only, color writes are masked off.
+void main() {
+}
@@ -0,0 +1,16 @@
+#version 460 core
+
+layout (location = 0) in vec3 aPos;
+
+#include "skinning.glsl"
+
+#include "clip_position.glsl"
+
+void main() {
+#ifdef SKINNING
+    vec4 position = getSkinMatrix() * vec4(aPos, 1.0);
+#else
+    vec4 position = vec4(aPos, 1.0);
+#endif
+    gl_Position = getClipPosition(position);
+}
@@ -0,0 +1,54 @@
+#version 460 core
+
+// Must match GBuffer::MAX_SHININESS.
+#define MAX_SHININESS 256.0
+
+layout (location = 0) out vec4 gAlbedoSpecular;
+layout (location = 1) out vec4 gNormalShininess;
+
+in vec3 normal;
+in vec2 TexCoords;
+
+struct Material {
+    sampler2D texture_diffuse1;
+    sampler2D texture_specular1;
+};
+uniform Material material;
+
+// Colors of every registered material, see MaterialTable.
+struct MaterialData {
+    vec4 ambient;   // rgb, dissolve
+    vec4 diffuse;   // rgb, shininess
+    vec4 specular;  // rgb, optical density
+    vec4 emissive;  // rgb, illumination model
+};
+layout (std430, binding = 6) readonly buffer Materials {
+    MaterialData materials[];
+};
+uniform int materialIndex;
+
+// Octahedral mapping of a unit vector to [-1, 1]^2.
+vec2 encodeNormal(vec3 n) {
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    vec2 e = n.xy;
+    if (n.z < 0.0)
+        e = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return e;
+}
+
+void main() {
+    MaterialData surface = materials[materialIndex];
+    // Maps are compiled in per variant, see ShaderPermutations.
+    vec3 albedo = surface.diffuse.rgb;
+#ifdef DIFFUSE_MAP
+    albedo *= texture(material.texture_diffuse1, TexCoords).rgb;
+#endif
+    vec3 specular = surface.specular.rgb;
+#ifdef SPECULAR_MAP
+    specular *= texture(material.texture_specular1, TexCoords).rgb;
+#endif
+
+    gAlbedoSpecular = vec4(albedo, dot(specular, vec3(0.2126, 0.7152, 0.0722)));
+    gNormalShininess = vec4(encodeNormal(normalize(normal)) * 0.5 + 0.5,
+                            clamp(surface.diffuse.w / MAX_SHININESS, 0.0, 1.0), 0.0);
+}
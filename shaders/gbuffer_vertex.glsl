@@ -0,0 +1,26 @@
+#version 460 core
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+
+#include "skinning.glsl"
+
+out vec3 normal;
+out vec2 TexCoords;
+
+#include "clip_position.glsl"
+
+void main() {
+#ifdef SKINNING
+    mat4 skin = getSkinMatrix();
+    vec4 position = skin * vec4(aPos, 1.0);
+    vec3 objectNormal = mat3(skin) * aNormal;
+#else
+    vec4 position = vec4(aPos, 1.0);
+    vec3 objectNormal = aNormal;
+#endif
+    gl_Position = getClipPosition(position);
+    normal = mat3(transpose(inverse(model))) * objectNormal;
+    TexCoords = aTexCoords;
+}
@@ -6,8 +6,10 @@ layout (location = 2) in vec2 aTexCoord;
 out vec2 TexCoord;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140, binding = 0) uniform FrameUniforms {
+    mat4 view;
+    mat4 projection;
+};
 
 void main()
 {
@@ -8,14 +8,30 @@ in vec3 fragPosition;
 
 uniform vec3 cameraPosition;
 
-// was object color
+// Maps replace the colors when compiled in, see ShaderPermutations.
 struct Material {
     sampler2D texture_diffuse1;
     sampler2D texture_specular1;
-    float shininess;
 };
 uniform Material material;
 
+// Colors of every registered material, see MaterialTable.
+struct MaterialData {
+    vec4 ambient;   // rgb, dissolve
+    vec4 diffuse;   // rgb, shininess
+    vec4 specular;  // rgb, optical density
+    vec4 emissive;  // rgb, illumination model
+};
+layout (std430, binding = 6) readonly buffer Materials {
+    MaterialData materials[];
+};
+uniform int materialIndex;
+
+// Surface colors, read once per fragment.
+vec3 surfaceDiffuse;
+vec3 surfaceSpecular;
+float surfaceShininess;
+
 struct DirectionalLight {
     vec3 direction;
   
@@ -25,20 +41,59 @@ struct DirectionalLight {
 };  
 uniform DirectionalLight directionalLight;
 
+// Point lights are binned into view-space clusters on the CPU (see
+// LightClusters); each fragment only walks the lights of its own cluster.
 struct PointLight {
-    vec3 position;
+    vec4 positionRadius;
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
+    vec4 attenuation;
+};
 
-    float constant;
-    float linear;
-    float quadratic;
+layout (std140, binding = 0) uniform FrameUniforms {
+    mat4 view;
+    mat4 projection;
+};
 
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
+layout (std140, binding = 1) uniform ClusterUniforms {
+    uvec4 gridSize;
+    // near, far, slice scale, slice bias
+    vec4 depthParams;
+};
+
+layout (std430, binding = 1) readonly buffer PointLights {
+    PointLight pointLights[];
+};
+
+// (offset, count) into lightIndices for every cluster.
+layout (std430, binding = 2) readonly buffer LightClusters {
+    uvec2 lightClusters[];
+};
+
+layout (std430, binding = 3) readonly buffer LightIndices {
+    uint lightIndices[];
+};
+
+// Shadow maps of every light live in one atlas, see ShadowRenderer.
+struct ShadowView {
+    mat4 matrix;
+    vec4 rect;
 };
 
-#define NR_POINT_LIGHTS 4
-uniform PointLight pointLights[NR_POINT_LIGHTS];
+layout (std140, binding = 2) uniform ShadowUniforms {
+    vec4 cascadeSplits;
+    // count, first view
+    ivec4 cascades;
+    // texel size, depth bias
+    vec4 shadowParams;
+};
+
+layout (std430, binding = 4) readonly buffer ShadowViews {
+    ShadowView shadowViews[];
+};
+
+layout (binding = 8) uniform sampler2DShadow shadowAtlas;
 
 struct Spotlight {
     vec3 position;
@@ -54,23 +109,50 @@ struct Spotlight {
 
     float radius;
     float outerRadius;
+
+    // -1 without shadow.
+    int shadowView;
 };
 uniform Spotlight spotlight;
 
 vec3 calculateDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir);
 vec3 calculatePointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
 vec3 calculateSpotlight(Spotlight light, vec3 normal, vec3 fragPos, vec3 viewDir);
+uint getClusterIndex(vec3 fragPos);
+float sampleShadow(int viewIndex, vec3 position);
+float samplePointShadow(int firstView, vec3 lightPosition, vec3 position);
+float sampleDirectionalShadow(vec3 position);
 
 void main() {
+    MaterialData surface = materials[materialIndex];
+    surfaceShininess = surface.diffuse.w;
+#ifdef DIFFUSE_MAP
+    surfaceDiffuse = texture(material.texture_diffuse1, TexCoords).rgb;
+#else
+    surfaceDiffuse = surface.diffuse.rgb;
+#endif
+#ifdef SPECULAR_MAP
+    surfaceSpecular = texture(material.texture_specular1, TexCoords).rgb;
+#else
+    surfaceSpecular = surface.specular.rgb;
+#endif
+
     vec3 norm = normalize(normal);
     vec3 viewDirection = normalize(cameraPosition - fragPosition);
-    vec3 result;
-    result = calculateDirectionalLight(directionalLight, norm, viewDirection);
-
-    for (int i = 0; i < NR_POINT_LIGHTS; i++)
-        result += calculatePointLight(pointLights[i], norm, fragPosition, viewDirection);
-
+    vec3 result = surface.emissive.rgb;
+#ifdef DIRECTIONAL_LIGHT
+    result += calculateDirectionalLight(directionalLight, norm, viewDirection);
+#endif
+
+#ifdef POINT_LIGHTS
+    uvec2 cluster = lightClusters[getClusterIndex(fragPosition)];
+    for (uint i = cluster.x; i < cluster.x + cluster.y; i++)
+        result += calculatePointLight(pointLights[lightIndices[i]], norm, fragPosition, viewDirection);
+#endif
+
+#ifdef SPOTLIGHT
     result += calculateSpotlight(spotlight, norm, fragPosition, viewDirection);
+#endif
 
     FragColor = vec4(result, 1.0);
 };
@@ -81,32 +163,56 @@ vec3 calculateDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir
     float diff = max(dot(normal, lightDir), 0.0);
 
     vec3 reflectDir = reflect(-lightDir, normal);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), surfaceShininess);
+
+    vec3 ambient = light.ambient * surfaceDiffuse;
+    vec3 diffuse = light.diffuse * diff * surfaceDiffuse;
+    vec3 specular = light.specular * spec * surfaceSpecular;
+
+#ifdef SHADOWS
+    return ambient + (diffuse + specular) * sampleDirectionalShadow(fragPosition);
+#else
+    return ambient + diffuse + specular;
+#endif
+};
 
-    vec3 ambient = light.ambient * vec3(texture(material.texture_diffuse1, TexCoords));
-    vec3 diffuse = light.diffuse * diff * vec3(texture(material.texture_diffuse1, TexCoords));
-    vec3 specular = light.specular * spec * vec3(texture(material.texture_specular1, TexCoords));
+uint getClusterIndex(vec3 fragPos) {
+    vec4 viewPosition = view * vec4(fragPos, 1.0);
+    vec4 clipPosition = projection * viewPosition;
+    vec2 tile = (clipPosition.xy / clipPosition.w * 0.5 + 0.5) * vec2(gridSize.xy);
+    float slice = log(-viewPosition.z) * depthParams.z + depthParams.w;
 
-    return (ambient + diffuse + specular);
+    uvec3 cell = uvec3(clamp(vec3(tile, slice), vec3(0.0), vec3(gridSize.xyz) - 1.0));
+    return (cell.z * gridSize.y + cell.y) * gridSize.x + cell.x;
 };
 
 vec3 calculatePointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir) {
-    vec3 lightDir = normalize(light.position - fragPos);
+    vec3 position = light.positionRadius.xyz;
+    vec3 lightDir = normalize(position - fragPos);
     float diff = max(dot(normal, lightDir), 0.0);
 
     vec3 reflectDir = reflect(-lightDir, normal);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-
-    float distance = length(light.position - fragPos);
-    float attenuation = 1.0 / (light.constant + light.linear * distance +
-                            light.quadratic * (distance * distance));
-    vec3 ambient = light.ambient * vec3(texture(material.texture_diffuse1, TexCoords));
-    vec3 diffuse  = light.diffuse  * diff * vec3(texture(material.texture_diffuse1, TexCoords));
-    vec3 specular = light.specular * spec * vec3(texture(material.texture_specular1, TexCoords));
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), surfaceShininess);
+
+    float distance = length(position - fragPos);
+    float attenuation = 1.0 / (light.attenuation.x + light.attenuation.y * distance +
+                            light.attenuation.z * (distance * distance));
+    // Fade out to zero at the culling radius so cluster edges do not show.
+    float falloff = clamp(1.0 - pow(distance / light.positionRadius.w, 4.0), 0.0, 1.0);
+    attenuation *= falloff * falloff;
+
+    vec3 ambient = light.ambient.rgb * surfaceDiffuse;
+    vec3 diffuse  = light.diffuse.rgb  * diff * surfaceDiffuse;
+    vec3 specular = light.specular.rgb * spec * surfaceSpecular;
     ambient  *= attenuation;
     diffuse  *= attenuation;
     specular *= attenuation;
-    return (ambient + diffuse + specular);
+#ifdef SHADOWS
+    float shadow = samplePointShadow(int(light.attenuation.w), position, fragPos);
+#else
+    float shadow = 1.0;
+#endif
+    return ambient + (diffuse + specular) * shadow;
 };
 
 vec3 calculateSpotlight(Spotlight light, vec3 normal, vec3 fragPos, vec3 viewDir) {
@@ -115,11 +221,11 @@ vec3 calculateSpotlight(Spotlight light, vec3 normal, vec3 fragPos, vec3 viewDir
     float diff = max(dot(normal, lightDirToFrag), 0.0);
 
     vec3 reflectDir = reflect(-lightDirToFrag, normal);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), surfaceShininess);
 
-    vec3 ambient = light.ambient * vec3(texture(material.texture_diffuse1, TexCoords));
-    vec3 diffuse  = light.diffuse  * diff * vec3(texture(material.texture_diffuse1, TexCoords));
-    vec3 specular = light.specular * spec * vec3(texture(material.texture_specular1, TexCoords));
+    vec3 ambient = light.ambient * surfaceDiffuse;
+    vec3 diffuse  = light.diffuse  * diff * surfaceDiffuse;
+    vec3 specular = light.specular * spec * surfaceSpecular;
 
     float theta = dot(lightDirToFrag, normalize(-light.direction));
     float epsilon = light.radius - light.outerRadius;
@@ -133,5 +239,53 @@ vec3 calculateSpotlight(Spotlight light, vec3 normal, vec3 fragPos, vec3 viewDir
     diffuse  *= attenuation;
     specular *= attenuation;
 
-    return (ambient + diffuse + specular);
+#ifdef SHADOWS
+    return ambient + (diffuse + specular) * sampleShadow(light.shadowView, fragPos);
+#else
+    return ambient + diffuse + specular;
+#endif
+}
+
+float sampleShadow(int viewIndex, vec3 position) {
+    if (viewIndex < 0) return 1.0;
+
+    ShadowView shadowView = shadowViews[viewIndex];
+    vec4 coords = shadowView.matrix * vec4(position, 1.0);
+    coords.xyz /= coords.w;
+    if (coords.z >= 1.0) return 1.0;
+
+    // Four bilinear comparisons, each already a 2x2 PCF, kept inside the tile.
+    float depth = coords.z - shadowParams.y;
+    float shadow = 0.0;
+    for (int i = 0; i < 4; i++) {
+        vec2 offset = vec2((i & 1) != 0 ? 0.5 : -0.5, (i & 2) != 0 ? 0.5 : -0.5) * shadowParams.x;
+        vec2 uv = clamp(coords.xy + offset, shadowView.rect.xy, shadowView.rect.zw);
+        shadow += texture(shadowAtlas, vec3(uv, depth));
+    }
+    return shadow * 0.25;
+}
+
+// Cube face views are stored +X, -X, +Y, -Y, +Z, -Z.
+float samplePointShadow(int firstView, vec3 lightPosition, vec3 position) {
+    if (firstView < 0) return 1.0;
+
+    vec3 direction = position - lightPosition;
+    vec3 size = abs(direction);
+    int face;
+    if (size.x >= size.y && size.x >= size.z)
+        face = direction.x >= 0.0 ? 0 : 1;
+    else if (size.y >= size.z)
+        face = direction.y >= 0.0 ? 2 : 3;
+    else
+        face = direction.z >= 0.0 ? 4 : 5;
+    return sampleShadow(firstView + face, position);
+}
+
+float sampleDirectionalShadow(vec3 position) {
+    float viewDepth = -(view * vec4(position, 1.0)).z;
+    for (int i = 0; i < cascades.x; i++) {
+        if (viewDepth < cascadeSplits[i])
+            return sampleShadow(cascades.y + i, position);
+    }
+    return 1.0;
 }
@@ -4,18 +4,26 @@ layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
 
+#include "skinning.glsl"
+
 out vec3 normal;
 out vec3 fragPosition;
 out vec2 TexCoords;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "clip_position.glsl"
 
 void main() {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
-    normal = mat3(transpose(inverse(model))) * aNormal;;
+#ifdef SKINNING
+    mat4 skin = getSkinMatrix();
+    vec4 position = skin * vec4(aPos, 1.0);
+    vec3 objectNormal = mat3(skin) * aNormal;
+#else
+    vec4 position = vec4(aPos, 1.0);
+    vec3 objectNormal = aNormal;
+#endif
+    gl_Position = getClipPosition(position);
+    normal = mat3(transpose(inverse(model))) * objectNormal;
     // normal = aNormal;
     TexCoords = aTexCoords;
-    fragPosition = vec3(model * vec4(aPos, 1.0));
+    fragPosition = vec3(model * position);
 }
@@ -0,0 +1,17 @@
+#version 460 core
+
+layout (location = 0) in vec3 aPos;
+
+#include "skinning.glsl"
+
+uniform mat4 model;
+uniform mat4 lightViewProjection;
+
+void main() {
+#ifdef SKINNING
+    vec4 position = getSkinMatrix() * vec4(aPos, 1.0);
+#else
+    vec4 position = vec4(aPos, 1.0);
+#endif
+    gl_Position = lightViewProjection * model * position;
+}
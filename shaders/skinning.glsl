@@ -0,0 +1,19 @@
+// Bone attributes and palettes of skinned meshes, compiled in the SKINNING
+// variant of a vertex shader. The palettes of every animated character share
+// one buffer, see Animator; paletteOffset selects the drawn character's.
+#ifdef SKINNING
+layout (location = 5) in ivec4 aBoneIds;
+layout (location = 6) in vec4 aBoneWeights;
+
+layout (std430, binding = 5) readonly buffer SkinPalettes {
+    mat4 skinPalettes[];
+};
+uniform int paletteOffset;
+
+mat4 getSkinMatrix() {
+    return aBoneWeights.x * skinPalettes[paletteOffset + aBoneIds.x]
+         + aBoneWeights.y * skinPalettes[paletteOffset + aBoneIds.y]
+         + aBoneWeights.z * skinPalettes[paletteOffset + aBoneIds.z]
+         + aBoneWeights.w * skinPalettes[paletteOffset + aBoneIds.w];
+}
+#endif
@@ -7,9 +7,8 @@ out vec3 Normal;
 out vec3 LightDir;
 
 uniform vec3 lightPosition;
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+#include "clip_position.glsl"
 
 void main()
 {
@@ -17,7 +16,6 @@ void main()
     LightDir = normalize(lightPosition - worldPosition.xyz);
     Normal = mat3(transpose(inverse(model))) * aNormal;
 
-    gl_Position = projection * view * worldPosition;
     // TexCoords = aTexCoords;    
-    // gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = getClipPosition(vec4(aPos, 1.0));
 } 
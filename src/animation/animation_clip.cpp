@@ -0,0 +1,134 @@
+#include <animation_clip.hpp>
+#include <simd.hpp>
+#include <algorithm>
+#include <cmath>
+
+
+static constexpr float COMPONENT_LIMIT = 0.70710678f;
+static constexpr uint16_t COMPONENT_MAX = 0x7FFF;
+
+CompressedRotation compressRotation(const glm::quat& rotation) {
+    const float values[4] = {rotation.x, rotation.y, rotation.z, rotation.w};
+    int largest = 0;
+    for (int i = 1; i < 4; i++) {
+        if (std::abs(values[i]) > std::abs(values[largest])) largest = i;
+    }
+    // q and -q are the same rotation: keep the dropped component positive so
+    // it can be rebuilt from the other three.
+    float sign = values[largest] < 0.0f ? -1.0f : 1.0f;
+
+    CompressedRotation compressed;
+    int slot = 0;
+    for (int i = 0; i < 4; i++) {
+        if (i == largest) continue;
+        // Components other than the largest lie within +-1/sqrt(2).
+        float normalized = std::clamp(values[i] * sign / COMPONENT_LIMIT, -1.0f, 1.0f) * 0.5f + 0.5f;
+        compressed.components[slot++] = static_cast<uint16_t>(std::lround(normalized * COMPONENT_MAX));
+    }
+    compressed.components[0] |= static_cast<uint16_t>((largest & 1) << 15);
+    compressed.components[1] |= static_cast<uint16_t>((largest >> 1) << 15);
+    return compressed;
+}
+
+glm::quat decompressRotation(const CompressedRotation& rotation) {
+    int largest = (rotation.components[0] >> 15) | ((rotation.components[1] >> 15) << 1);
+    float values[4];
+    float sumOfSquares = 0.0f;
+    int slot = 0;
+    for (int i = 0; i < 4; i++) {
+        if (i == largest) continue;
+        float normalized = static_cast<float>(rotation.components[slot++] & COMPONENT_MAX) / COMPONENT_MAX;
+        values[i] = (normalized * 2.0f - 1.0f) * COMPONENT_LIMIT;
+        sumOfSquares += values[i] * values[i];
+    }
+    values[largest] = std::sqrt(std::max(0.0f, 1.0f - sumOfSquares));
+    return glm::quat(values[3], values[0], values[1], values[2]);
+}
+
+uint16_t quantize(float value, float min, float extent) {
+    if (extent <= 0.0f) return 0;
+    float normalized = std::clamp((value - min) / extent, 0.0f, 1.0f);
+    return static_cast<uint16_t>(std::lround(normalized * 65535.0f));
+}
+
+float dequantize(uint16_t value, float min, float extent) {
+    return min + extent * (static_cast<float>(value) / 65535.0f);
+}
+
+AnimationClip::AnimationClip(std::string name, float sampleRate, uint32_t frameCount,
+                             std::vector<uint32_t> joints, std::span<const JointPose> frames)
+    : m_name(std::move(name)), m_sampleRate(sampleRate), m_frameCount(frameCount), m_joints(std::move(joints)) {
+    m_duration = frameCount > 1 ? (frameCount - 1) / sampleRate : 0.0f;
+    const size_t trackCount = m_joints.size();
+
+    m_ranges.resize(trackCount);
+    for (size_t track = 0; track < trackCount && frameCount > 0; track++) {
+        glm::vec3 translationMin(INFINITY), translationMax(-INFINITY);
+        glm::vec3 scaleMin(INFINITY), scaleMax(-INFINITY);
+        for (uint32_t frame = 0; frame < frameCount; frame++) {
+            const JointPose& pose = frames[frame * trackCount + track];
+            translationMin = glm::min(translationMin, pose.translation);
+            translationMax = glm::max(translationMax, pose.translation);
+            scaleMin = glm::min(scaleMin, pose.scale);
+            scaleMax = glm::max(scaleMax, pose.scale);
+        }
+        TrackRange& range = m_ranges[track];
+        range.translationMin = translationMin;
+        range.translationExtent = translationMax - translationMin;
+        range.scaleMin = scaleMin;
+        range.scaleExtent = scaleMax - scaleMin;
+    }
+
+    m_keys.resize(size_t(frameCount) * trackCount);
+    for (size_t i = 0; i < m_keys.size(); i++) {
+        const JointPose& pose = frames[i];
+        const TrackRange& range = m_ranges[i % trackCount];
+        CompressedJointKey& key = m_keys[i];
+        key.rotation = compressRotation(pose.rotation);
+        for (int axis = 0; axis < 3; axis++) {
+            key.translation[axis] = quantize(pose.translation[axis], range.translationMin[axis], range.translationExtent[axis]);
+            key.scale[axis] = quantize(pose.scale[axis], range.scaleMin[axis], range.scaleExtent[axis]);
+        }
+    }
+}
+
+JointPose AnimationClip::decompress(const CompressedJointKey& key, const TrackRange& range) const {
+    JointPose pose;
+    pose.rotation = decompressRotation(key.rotation);
+    for (int axis = 0; axis < 3; axis++) {
+        pose.translation[axis] = dequantize(key.translation[axis], range.translationMin[axis], range.translationExtent[axis]);
+        pose.scale[axis] = dequantize(key.scale[axis], range.scaleMin[axis], range.scaleExtent[axis]);
+    }
+    return pose;
+}
+
+void AnimationClip::sample(float time, std::span<JointPose> pose) const {
+    if (m_frameCount == 0) return;
+
+    float frame = 0.0f;
+    if (m_duration > 0.0f) {
+        float looped = std::fmod(time, m_duration);
+        if (looped < 0.0f) looped += m_duration;
+        frame = looped * m_sampleRate;
+    }
+    uint32_t first = std::min(static_cast<uint32_t>(frame), m_frameCount - 1);
+    uint32_t second = std::min(first + 1, m_frameCount - 1);
+    float weight = frame - static_cast<float>(first);
+
+    const size_t trackCount = m_joints.size();
+    const CompressedJointKey* firstKeys = m_keys.data() + first * trackCount;
+    const CompressedJointKey* secondKeys = m_keys.data() + second * trackCount;
+    for (size_t track = 0; track < trackCount; track++) {
+        JointPose a = decompress(firstKeys[track], m_ranges[track]);
+        JointPose b = decompress(secondKeys[track], m_ranges[track]);
+        JointPose& out = pose[m_joints[track]];
+        out.translation = glm::mix(a.translation, b.translation, weight);
+        out.rotation = Simd::quatNlerp(a.rotation, b.rotation, weight);
+        out.scale = glm::mix(a.scale, b.scale, weight);
+    }
+}
+
+size_t AnimationClip::getBytes() const {
+    return m_keys.size() * sizeof(CompressedJointKey) + m_ranges.size() * sizeof(TrackRange)
+         + m_joints.size() * sizeof(uint32_t);
+}
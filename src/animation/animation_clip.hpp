@@ -0,0 +1,91 @@
+#ifndef ANIMATION_CLIP_H_
+#define ANIMATION_CLIP_H_
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <joint_pose.hpp>
+
+/**
+ * @brief Unit quaternion in 48 bits: the three smallest components at 15
+ * bits each, and the index of the dropped largest one in the top bits of the
+ * first two.
+ */
+struct CompressedRotation {
+    uint16_t components[3];
+};
+
+CompressedRotation compressRotation(const glm::quat& rotation);
+glm::quat decompressRotation(const CompressedRotation& rotation);
+
+/**
+ * @brief 16-bit fixed point of `value` within [min, min + extent].
+ */
+uint16_t quantize(float value, float min, float extent);
+float dequantize(uint16_t value, float min, float extent);
+
+/**
+ * @brief Pose of one joint at one frame, 18 bytes instead of 40. Translation
+ * and scale are quantized within the range of their track.
+ */
+struct CompressedJointKey {
+    CompressedRotation rotation;
+    uint16_t translation[3];
+    uint16_t scale[3];
+};
+
+/**
+ * @class AnimationClip
+ * @brief Animation resampled at a fixed rate and quantized.
+ *
+ * A fixed rate means key times are implicit and sampling never searches.
+ * Keys are stored frame by frame, the animated joints of a frame adjacent, so
+ * sampling any time reads two contiguous runs.
+ */
+class AnimationClip {
+public:
+    AnimationClip() = default;
+    /**
+     * @param joints Skeleton joint animated by each track.
+     * @param frames frameCount * joints.size() poses, frame by frame.
+     */
+    AnimationClip(std::string name, float sampleRate, uint32_t frameCount, std::vector<uint32_t> joints,
+                  std::span<const JointPose> frames);
+
+    /**
+     * @brief Write the pose at `time`, looping, of every animated joint into
+     * `pose`, indexed by joint. Other joints are left untouched.
+     */
+    void sample(float time, std::span<JointPose> pose) const;
+
+    const std::string& getName() const { return m_name; }
+    float getDuration() const { return m_duration; }
+    float getSampleRate() const { return m_sampleRate; }
+    uint32_t getFrameCount() const { return m_frameCount; }
+    std::span<const uint32_t> getJoints() const { return m_joints; }
+    size_t getBytes() const;
+    size_t getUncompressedBytes() const { return m_keys.size() * sizeof(JointPose); }
+
+private:
+    // Quantization range of a track.
+    struct TrackRange {
+        glm::vec3 translationMin{0.0f};
+        glm::vec3 translationExtent{0.0f};
+        glm::vec3 scaleMin{0.0f};
+        glm::vec3 scaleExtent{0.0f};
+    };
+
+    std::string m_name;
+    float m_sampleRate{30.0f};
+    float m_duration{0.0f};
+    uint32_t m_frameCount{0};
+    std::vector<uint32_t> m_joints;
+    std::vector<TrackRange> m_ranges;
+    std::vector<CompressedJointKey> m_keys;
+
+    JointPose decompress(const CompressedJointKey& key, const TrackRange& range) const;
+};
+
+#endif
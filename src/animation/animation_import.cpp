@@ -0,0 +1,75 @@
+#include <animation_import.hpp>
+#include <algorithm>
+#include <cmath>
+
+
+/**
+ * @brief Index of the last key at or before `ticks`, so that the key after it
+ * is the one to interpolate toward.
+ */
+template <typename Key>
+static unsigned int findKey(const Key* keys, unsigned int count, double ticks) {
+    const Key* next = std::upper_bound(keys, keys + count, ticks,
+        [](double time, const Key& key) { return time < key.mTime; });
+    return next == keys ? 0 : static_cast<unsigned int>(next - keys - 1);
+}
+
+template <typename Key>
+static float getKeyFactor(const Key* keys, unsigned int count, unsigned int index, double ticks) {
+    if (index + 1 >= count) return 0.0f;
+    double span = keys[index + 1].mTime - keys[index].mTime;
+    return span > 0.0 ? static_cast<float>(std::clamp((ticks - keys[index].mTime) / span, 0.0, 1.0)) : 0.0f;
+}
+
+static glm::vec3 sampleVectorKeys(const aiVectorKey* keys, unsigned int count, double ticks) {
+    unsigned int index = findKey(keys, count, ticks);
+    float factor = getKeyFactor(keys, count, index, ticks);
+    const aiVector3D& a = keys[index].mValue;
+    const aiVector3D& b = keys[std::min(index + 1, count - 1)].mValue;
+    return glm::mix(glm::vec3(a.x, a.y, a.z), glm::vec3(b.x, b.y, b.z), factor);
+}
+
+static glm::quat sampleRotationKeys(const aiQuatKey* keys, unsigned int count, double ticks) {
+    unsigned int index = findKey(keys, count, ticks);
+    float factor = getKeyFactor(keys, count, index, ticks);
+    aiQuaternion rotation;
+    aiQuaternion::Interpolate(rotation, keys[index].mValue, keys[std::min(index + 1, count - 1)].mValue, factor);
+    return glm::normalize(glm::quat(rotation.w, rotation.x, rotation.y, rotation.z));
+}
+
+AnimationClip importAnimationClip(const aiAnimation& animation, const Skeleton& skeleton, float sampleRate) {
+    // Assimp leaves the rate at 0 when the file does not specify it.
+    double ticksPerSecond = animation.mTicksPerSecond > 0.0 ? animation.mTicksPerSecond : 25.0;
+    double duration = animation.mDuration / ticksPerSecond;
+    uint32_t frameCount = static_cast<uint32_t>(std::ceil(duration * sampleRate)) + 1;
+
+    std::vector<uint32_t> joints;
+    std::vector<const aiNodeAnim*> channels;
+    for (unsigned int i = 0; i < animation.mNumChannels; i++) {
+        const aiNodeAnim* channel = animation.mChannels[i];
+        int32_t joint = skeleton.findJoint(channel->mNodeName.C_Str());
+        if (joint < 0) continue;
+        joints.push_back(static_cast<uint32_t>(joint));
+        channels.push_back(channel);
+    }
+
+    const size_t trackCount = joints.size();
+    std::vector<JointPose> frames(frameCount * trackCount);
+    for (size_t track = 0; track < trackCount; track++) {
+        const aiNodeAnim& channel = *channels[track];
+        for (uint32_t frame = 0; frame < frameCount; frame++) {
+            double ticks = std::min(frame / sampleRate * ticksPerSecond, animation.mDuration);
+            // Components without keys keep the rest pose.
+            JointPose pose = skeleton.bindPose[joints[track]];
+            if (channel.mNumPositionKeys > 0)
+                pose.translation = sampleVectorKeys(channel.mPositionKeys, channel.mNumPositionKeys, ticks);
+            if (channel.mNumRotationKeys > 0)
+                pose.rotation = sampleRotationKeys(channel.mRotationKeys, channel.mNumRotationKeys, ticks);
+            if (channel.mNumScalingKeys > 0)
+                pose.scale = sampleVectorKeys(channel.mScalingKeys, channel.mNumScalingKeys, ticks);
+            frames[frame * trackCount + track] = pose;
+        }
+    }
+
+    return AnimationClip(animation.mName.C_Str(), sampleRate, frameCount, std::move(joints), frames);
+}
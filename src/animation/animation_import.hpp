@@ -0,0 +1,15 @@
+#ifndef ANIMATION_IMPORT_H_
+#define ANIMATION_IMPORT_H_
+
+#include <assimp/scene.h>
+#include <animation_clip.hpp>
+#include <skeleton.hpp>
+
+/**
+ * @brief Resample every channel of `animation` that drives a joint of
+ * `skeleton` at `sampleRate` frames per second, then compress the result.
+ * Channels of nodes outside the skeleton are dropped.
+ */
+AnimationClip importAnimationClip(const aiAnimation& animation, const Skeleton& skeleton, float sampleRate);
+
+#endif
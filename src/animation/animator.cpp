@@ -0,0 +1,80 @@
+#include <animator.hpp>
+#include <thread_pool.hpp>
+#include <algorithm>
+
+
+// Characters per task: enough to amortize scheduling, few enough to balance.
+static constexpr size_t CHARACTERS_PER_TASK = 16;
+
+uint32_t Animator::add(const Skeleton& skeleton, const AnimationClip* clip, float time) {
+    Character character;
+    character.skeleton = &skeleton;
+    character.clip = clip;
+    character.time = time;
+    character.paletteOffset = m_paletteSize;
+    m_paletteSize += static_cast<uint32_t>(skeleton.getBoneCount());
+
+    m_characters.push_back(character);
+    return static_cast<uint32_t>(m_characters.size() - 1);
+}
+
+void Animator::play(uint32_t character, const AnimationClip* clip, float fadeSeconds) {
+    Character& target = m_characters[character];
+    if (target.clip == clip) return;
+
+    if (fadeSeconds > 0.0f && target.clip) {
+        target.previousClip = target.clip;
+        target.previousTime = target.time;
+        target.fadeTime = 0.0f;
+        target.fadeDuration = fadeSeconds;
+    } else {
+        target.previousClip = nullptr;
+    }
+    target.clip = clip;
+    target.time = 0.0f;
+}
+
+void Animator::advance(Character& character, float deltaTime) {
+    float step = deltaTime * character.speed;
+    character.time += step;
+    if (!character.previousClip) return;
+
+    character.previousTime += step;
+    character.fadeTime += deltaTime;
+    if (character.fadeTime >= character.fadeDuration)
+        character.previousClip = nullptr;
+}
+
+void Animator::evaluate(const Character& character, Scratch& scratch, glm::mat4* palette) {
+    const Skeleton& skeleton = *character.skeleton;
+    scratch.pose.assign(skeleton.bindPose.begin(), skeleton.bindPose.end());
+    if (character.clip) character.clip->sample(character.time, scratch.pose);
+
+    if (character.previousClip) {
+        scratch.previousPose.assign(skeleton.bindPose.begin(), skeleton.bindPose.end());
+        character.previousClip->sample(character.previousTime, scratch.previousPose);
+        float weight = std::clamp(character.fadeTime / character.fadeDuration, 0.0f, 1.0f);
+        blendPoses(scratch.previousPose, scratch.pose, weight, scratch.pose);
+    }
+
+    scratch.globals.resize(skeleton.getJointCount());
+    skeleton.computePalette(scratch.pose, scratch.globals,
+                            std::span<glm::mat4>(palette, skeleton.getBoneCount()));
+}
+
+void Animator::update(float deltaTime, std::vector<glm::mat4>& palettes) {
+    palettes.resize(m_paletteSize);
+    ThreadPool& pool = ThreadPool::getInstance();
+    m_scratch.resize(pool.getThreadCount());
+
+    // Characters only write their own state and palette run, so ranges are
+    // independent.
+    pool.parallelFor(m_characters.size(), CHARACTERS_PER_TASK, [&](size_t begin, size_t end, size_t slot) {
+        Scratch& scratch = m_scratch[slot];
+        for (size_t i = begin; i < end; i++) {
+            Character& character = m_characters[i];
+            advance(character, deltaTime);
+            evaluate(character, scratch, palettes.data() + character.paletteOffset);
+        }
+    });
+}
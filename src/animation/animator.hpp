@@ -0,0 +1,77 @@
+#ifndef ANIMATOR_H_
+#define ANIMATOR_H_
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <skeleton.hpp>
+#include <animation_clip.hpp>
+
+/**
+ * @class Animator
+ * @brief Plays clips on animated characters and builds their skinning
+ * palettes, sampling and blending the characters in parallel on the
+ * ThreadPool.
+ *
+ * Each character owns a fixed run of the palette array, one matrix per bone
+ * of its skeleton, so palettes of every character can be uploaded as one
+ * buffer and found by offset from the vertex shader. Skeletons and clips are
+ * referenced, not copied, and must outlive the animator.
+ */
+class Animator {
+public:
+    /**
+     * @brief Add a character posed with `skeleton`, playing `clip` from
+     * `time` if not null, or holding the bind pose.
+     * @return Index of the character.
+     */
+    uint32_t add(const Skeleton& skeleton, const AnimationClip* clip = nullptr, float time = 0.0f);
+
+    /**
+     * @brief Switch `character` to `clip`, cross-fading from its current clip
+     * over `fadeSeconds`.
+     */
+    void play(uint32_t character, const AnimationClip* clip, float fadeSeconds = 0.0f);
+    void setSpeed(uint32_t character, float speed) { m_characters[character].speed = speed; }
+
+    /**
+     * @brief Advance every character by `deltaTime` and write its palette into
+     * `palettes`, which is resized to getPaletteSize().
+     */
+    void update(float deltaTime, std::vector<glm::mat4>& palettes);
+
+    // First palette entry of `character`.
+    uint32_t getPaletteOffset(uint32_t character) const { return m_characters[character].paletteOffset; }
+    uint32_t getPaletteSize() const { return m_paletteSize; }
+    size_t size() const { return m_characters.size(); }
+
+private:
+    struct Character {
+        const Skeleton* skeleton;
+        const AnimationClip* clip;
+        // Clip faded out, null once the fade is over.
+        const AnimationClip* previousClip = nullptr;
+        float time = 0.0f;
+        float previousTime = 0.0f;
+        float fadeTime = 0.0f;
+        float fadeDuration = 0.0f;
+        float speed = 1.0f;
+        uint32_t paletteOffset;
+    };
+
+    // Working memory of one thread, reused across characters and frames.
+    struct Scratch {
+        std::vector<JointPose> pose;
+        std::vector<JointPose> previousPose;
+        std::vector<glm::mat4> globals;
+    };
+
+    std::vector<Character> m_characters;
+    std::vector<Scratch> m_scratch;
+    uint32_t m_paletteSize{0};
+
+    static void advance(Character& character, float deltaTime);
+    static void evaluate(const Character& character, Scratch& scratch, glm::mat4* palette);
+};
+
+#endif
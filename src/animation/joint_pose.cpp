@@ -0,0 +1,34 @@
+#include <joint_pose.hpp>
+#include <simd.hpp>
+
+
+glm::mat4 toMatrix(const JointPose& pose) {
+    glm::mat4 matrix = glm::mat4_cast(pose.rotation);
+    matrix[0] *= pose.scale.x;
+    matrix[1] *= pose.scale.y;
+    matrix[2] *= pose.scale.z;
+    matrix[3] = glm::vec4(pose.translation, 1.0f);
+    return matrix;
+}
+
+JointPose fromMatrix(const glm::mat4& matrix) {
+    JointPose pose;
+    pose.translation = glm::vec3(matrix[3]);
+    pose.scale = glm::vec3(glm::length(glm::vec3(matrix[0])), glm::length(glm::vec3(matrix[1])),
+                           glm::length(glm::vec3(matrix[2])));
+
+    glm::mat3 rotation;
+    for (int i = 0; i < 3; i++)
+        rotation[i] = pose.scale[i] > 0.0f ? glm::vec3(matrix[i]) / pose.scale[i] : glm::vec3(0.0f);
+    pose.rotation = glm::normalize(glm::quat_cast(rotation));
+    return pose;
+}
+
+void blendPoses(std::span<const JointPose> a, std::span<const JointPose> b, float weight,
+                std::span<JointPose> out) {
+    for (size_t i = 0; i < out.size(); i++) {
+        out[i].translation = glm::mix(a[i].translation, b[i].translation, weight);
+        out[i].rotation = Simd::quatNlerp(a[i].rotation, b[i].rotation, weight);
+        out[i].scale = glm::mix(a[i].scale, b[i].scale, weight);
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef JOINT_POSE_H_
+#define JOINT_POSE_H_
+
+#include <span>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+/**
+ * @brief Transform of a joint relative to its parent.
+ */
+struct JointPose {
+    glm::vec3 translation{0.0f};
+    glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
+    glm::vec3 scale{1.0f};
+};
+
+/**
+ * @brief translate * rotate * scale.
+ */
+glm::mat4 toMatrix(const JointPose& pose);
+
+/**
+ * @brief Inverse of toMatrix() for matrices without shear or mirroring.
+ */
+JointPose fromMatrix(const glm::mat4& matrix);
+
+/**
+ * @brief Per joint, `a` moved toward `b` by `weight`. `out` may alias either.
+ */
+void blendPoses(std::span<const JointPose> a, std::span<const JointPose> b, float weight,
+                std::span<JointPose> out);
+
+#endif
@@ -0,0 +1,24 @@
+#include <skeleton.hpp>
+#include <simd.hpp>
+
+
+int32_t Skeleton::findJoint(std::string_view name) const {
+    for (size_t i = 0; i < jointNames.size(); i++) {
+        if (jointNames[i] == name) return static_cast<int32_t>(i);
+    }
+    return -1;
+}
+
+void Skeleton::computePalette(std::span<const JointPose> pose, std::span<glm::mat4> globals,
+                              std::span<glm::mat4> palette) const {
+    // Parents come first, so one forward pass resolves the hierarchy.
+    for (size_t i = 0; i < jointParents.size(); i++) {
+        glm::mat4 local = toMatrix(pose[i]);
+        if (jointParents[i] < 0)
+            globals[i] = local;
+        else
+            Simd::mat4Mul(globals[jointParents[i]], local, globals[i]);
+    }
+    for (size_t i = 0; i < boneJoints.size(); i++)
+        Simd::mat4Mul(globals[boneJoints[i]], inverseBindMatrices[i], palette[i]);
+}
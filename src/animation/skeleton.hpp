@@ -0,0 +1,44 @@
+#ifndef SKELETON_H_
+#define SKELETON_H_
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <glm/glm.hpp>
+#include <joint_pose.hpp>
+
+/**
+ * @struct Skeleton
+ * @brief Joint hierarchy of a model, stored parent first, and the bones that
+ * skinned vertices reference by index.
+ *
+ * Every node of the model is a joint, so bones can hang anywhere in the
+ * hierarchy; only bones get an entry in the skinning palette.
+ */
+struct Skeleton {
+    std::vector<std::string> jointNames;
+    // -1 for roots.
+    std::vector<int32_t> jointParents;
+    // Rest pose, kept by joints a clip does not animate.
+    std::vector<JointPose> bindPose;
+    // Joint moving each bone.
+    std::vector<uint32_t> boneJoints;
+    // Mesh space to bone space at bind time.
+    std::vector<glm::mat4> inverseBindMatrices;
+
+    size_t getJointCount() const { return jointParents.size(); }
+    size_t getBoneCount() const { return boneJoints.size(); }
+    // -1 if no joint has that name.
+    int32_t findJoint(std::string_view name) const;
+
+    /**
+     * @brief Model-space matrix of every joint of `pose` into `globals`, then
+     * `global * inverseBind` of every bone into `palette`.
+     */
+    void computePalette(std::span<const JointPose> pose, std::span<glm::mat4> globals,
+                        std::span<glm::mat4> palette) const;
+};
+
+#endif
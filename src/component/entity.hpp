@@ -1,8 +1,15 @@
 #ifndef ENTITY_HPP_
 #define ENTITY_HPP_
 
-#include <transform.hpp>
-#include <model.hpp>
+#include <cstdint>
+#include <transform_hierarchy.hpp>
+#include <material.hpp>
+
+/**
+ * @brief Index of an asset path interned by the EntityManager.
+ */
+using AssetId = uint32_t;
+constexpr AssetId INVALID_ASSET = UINT32_MAX;
 
 class Entity {
 public:
@@ -11,8 +18,12 @@ public:
 
     int getId() const { return id; }
 
-    Transform transform;
-    // Model model;
+    // Node in the scene's TransformHierarchy, which holds the entity's local
+    // transform and parent. INVALID_TRANSFORM for an entity without one.
+    TransformHandle transform{INVALID_TRANSFORM};
+    MaterialId material{INVALID_MATERIAL};
+    // Model drawn for the entity, INVALID_ASSET for none.
+    AssetId model{INVALID_ASSET};
 private:
     int id;
     static int entityCount;
@@ -0,0 +1,106 @@
+#include <entity_manager.hpp>
+#include <asset_path.hpp>
+#include <material_registry.hpp>
+#include <scene_snapshot.hpp>
+#include <transform_hierarchy.hpp>
+
+AssetId EntityManager::addAsset(std::string_view path) {
+    std::string normalized = AssetPath::normalize(path);
+    auto [it, inserted] = m_assetIds.try_emplace(normalized, static_cast<AssetId>(m_assets.size()));
+    if (inserted) m_assets.push_back(std::move(normalized));
+    return it->second;
+}
+
+void EntityManager::save(const std::string& path, const MaterialRegistry& materials,
+                         const TransformHierarchy& transforms) const {
+    IO::SceneData scene;
+    // Index of the entity of each node.
+    std::unordered_map<TransformHandle, int32_t> indices;
+    for (size_t i = 0; i < m_entities.size(); i++) {
+        if (transforms.isValid(m_entities[i]->transform))
+            indices[m_entities[i]->transform] = static_cast<int32_t>(i);
+    }
+
+    // Tables of the materials and assets used, in order of first use.
+    std::unordered_map<MaterialId, uint32_t> materialIndices;
+    std::unordered_map<AssetId, uint32_t> assetIndices;
+    size_t materialCount = materials.size();
+    for (const Entity* entity : m_entities) {
+        Transform local;
+        int32_t parentIndex = -1;
+        if (transforms.isValid(entity->transform)) {
+            local = transforms.getLocal(entity->transform);
+            auto parent = indices.find(transforms.getParent(entity->transform));
+            if (parent != indices.end()) parentIndex = parent->second;
+        }
+        scene.parents.push_back(parentIndex);
+        scene.transforms.push_back({local.position, local.rotation, local.scale});
+
+        uint32_t material = IO::NO_SCENE_REFERENCE;
+        if (entity->material < materialCount) {
+            auto [it, inserted] = materialIndices.try_emplace(entity->material,
+                                                              static_cast<uint32_t>(scene.materialNames.size()));
+            if (inserted) scene.materialNames.push_back(materials.get(entity->material).name);
+            material = it->second;
+        }
+        scene.materials.push_back(material);
+
+        uint32_t model = IO::NO_SCENE_REFERENCE;
+        if (entity->model < m_assets.size()) {
+            auto [it, inserted] = assetIndices.try_emplace(entity->model, static_cast<uint32_t>(scene.assets.size()));
+            if (inserted) scene.assets.push_back(m_assets[entity->model]);
+            model = it->second;
+        }
+        scene.models.push_back(model);
+    }
+    IO::writeScene(path, scene);
+}
+
+std::span<Entity> EntityManager::load(const std::string& path, const MaterialRegistry& materials,
+                                      TransformHierarchy& transforms) {
+    IO::SceneSnapshot snapshot(path);
+
+    // Names and paths are resolved once per table entry, not per entity.
+    std::vector<MaterialId> materialIds(snapshot.getMaterialNameCount());
+    for (size_t i = 0; i < materialIds.size(); i++) materialIds[i] = materials.find(snapshot.getMaterialName(i));
+    std::vector<AssetId> assetIds(snapshot.getAssetCount());
+    for (size_t i = 0; i < assetIds.size(); i++) assetIds[i] = addAsset(snapshot.getAsset(i));
+
+    size_t count = snapshot.getEntityCount();
+    if (count == 0) return {};
+    // Constructed in order, so the ids of the block are consecutive.
+    std::unique_ptr<Entity[]> block = std::make_unique<Entity[]>(count);
+    std::span<const int32_t> parents = snapshot.getParents();
+    std::span<const uint32_t> entityMaterials = snapshot.getMaterials();
+    std::span<const uint32_t> models = snapshot.getModels();
+    std::span<const IO::SceneTransform> locals = snapshot.getTransforms();
+    // Parents may be saved after their children: create each chain of
+    // ancestors first. The snapshot has no cycle, so every chain ends.
+    std::vector<int32_t> chain;
+    for (size_t i = 0; i < count; i++) {
+        for (int32_t entity = static_cast<int32_t>(i); entity >= 0 && block[entity].transform == INVALID_TRANSFORM;
+             entity = parents[entity])
+            chain.push_back(entity);
+        for (; !chain.empty(); chain.pop_back()) {
+            int32_t entity = chain.back();
+            Transform local;
+            local.position = locals[entity].position;
+            local.rotation = locals[entity].rotation;
+            local.scale = locals[entity].scale;
+            TransformHandle parent = parents[entity] < 0 ? INVALID_TRANSFORM : block[parents[entity]].transform;
+            block[entity].transform = transforms.create(parent, local);
+        }
+    }
+
+    m_entities.reserve(m_entities.size() + count);
+    for (size_t i = 0; i < count; i++) {
+        Entity& entity = block[i];
+        entity.material = entityMaterials[i] == IO::NO_SCENE_REFERENCE ? INVALID_MATERIAL : materialIds[entityMaterials[i]];
+        entity.model = models[i] == IO::NO_SCENE_REFERENCE ? INVALID_ASSET : assetIds[models[i]];
+        m_entities.push_back(&entity);
+    }
+
+    std::span<Entity> entities(block.get(), count);
+    m_blocks.push_back(std::move(block));
+    return entities;
+}
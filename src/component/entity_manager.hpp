@@ -3,8 +3,16 @@
 
 #include <vector>
 #include <algorithm>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 #include "entity.hpp"
 
+class MaterialRegistry;
+class TransformHierarchy;
+
 class EntityManager {
 public:
     static EntityManager& getInstance() {
@@ -12,10 +20,22 @@ public:
         return instance;
     }
 
+    EntityManager() {}
+    ~EntityManager() {}
+
     void addEntity(Entity* entity) {
         m_entities.push_back(entity);
     }
 
+    /**
+     * @brief New entity owned by the manager, valid as long as it is.
+     */
+    Entity& createEntity() {
+        m_blocks.push_back(std::make_unique<Entity[]>(1));
+        addEntity(m_blocks.back().get());
+        return m_blocks.back()[0];
+    }
+
     void removeEntity(Entity* entity) {
         m_entities.erase(std::remove(m_entities.begin(), m_entities.end(), entity), m_entities.end());
     }
@@ -36,20 +56,44 @@ public:
         return m_entities;
     }
 
+    /**
+     * @brief Id of the asset at `path`, the same for every spelling of it.
+     */
+    AssetId addAsset(std::string_view path);
+    const std::string& getAssetPath(AssetId id) const { return m_assets[id]; }
+
+    /**
+     * @brief Write every entity to a ".lscene" snapshot at `path`, with its
+     * local transform and parent entity in `transforms`. Materials are saved
+     * by their name in `materials`. An entity whose parent node is not an
+     * entity's is saved as a root; one without a node as an identity root.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void save(const std::string& path, const MaterialRegistry& materials, const TransformHierarchy& transforms) const;
+    /**
+     * @brief Add the entities of the snapshot at `path`, with new ids, each
+     * with a new node in `transforms` under its parent's.
+     * Materials missing from `materials` are INVALID_MATERIAL.
+     * @return The entities loaded, in the order they were saved.
+     * @throws std::runtime_error if the file cannot be read or is malformed.
+     */
+    std::span<Entity> load(const std::string& path, const MaterialRegistry& materials, TransformHierarchy& transforms);
+
 private:
     std::vector<Entity*> m_entities;
-    EntityManager() {}
-    ~EntityManager() {}
+    // Entities created by the manager. A loaded scene is a single block.
+    std::vector<std::unique_ptr<Entity[]>> m_blocks;
+    std::vector<std::string> m_assets;
+    std::unordered_map<std::string, AssetId> m_assetIds;
+
     EntityManager& operator=(EntityManager&) = delete;
     EntityManager(const EntityManager&) = delete;
 };
 
 class EntityFactory {
 public:
-    static Entity createEntity() {
-        Entity entity;
-        EntityManager::getInstance().addEntity(&entity);
-        return entity;
+    static Entity& createEntity() {
+        return EntityManager::getInstance().createEntity();
     }
 };
 
@@ -0,0 +1,27 @@
+#include <transform.hpp>
+#include <cmath>
+
+
+glm::mat4 Transform::getMatrix() const {
+    // Closed form of translate * rotateX * rotateY * rotateZ * scale, which
+    // avoids three generic axis-angle rotations per node.
+    float ca = cosf(glm::radians(rotation.x)), sa = sinf(glm::radians(rotation.x));
+    float cb = cosf(glm::radians(rotation.y)), sb = sinf(glm::radians(rotation.y));
+    float cc = cosf(glm::radians(rotation.z)), sc = sinf(glm::radians(rotation.z));
+
+    glm::mat4 matrix(1.0f);
+    matrix[0][0] = cb * cc * scale.x;
+    matrix[0][1] = (ca * sc + sa * sb * cc) * scale.x;
+    matrix[0][2] = (sa * sc - ca * sb * cc) * scale.x;
+
+    matrix[1][0] = -cb * sc * scale.y;
+    matrix[1][1] = (ca * cc - sa * sb * sc) * scale.y;
+    matrix[1][2] = (sa * cc + ca * sb * sc) * scale.y;
+
+    matrix[2][0] = sb * scale.z;
+    matrix[2][1] = -sa * cb * scale.z;
+    matrix[2][2] = ca * cb * scale.z;
+
+    matrix[3] = glm::vec4(position, 1.0f);
+    return matrix;
+}
@@ -6,9 +6,12 @@
 
 class Transform : Component {
 public:
-    glm::vec3 position;
-    glm::vec3 rotation;
-    glm::vec3 scale;
+    glm::vec3 position{0.0f};
+    // Euler angles in degrees, applied X then Y then Z.
+    glm::vec3 rotation{0.0f};
+    glm::vec3 scale{1.0f};
+
+    glm::mat4 getMatrix() const;
 };
 
 #endif
@@ -0,0 +1,237 @@
+#include <transform_hierarchy.hpp>
+#include <simd.hpp>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+
+static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+/**
+ * @brief World matrices for one depth level. Parents all live in earlier
+ * levels, so every entry of the batch is independent.
+ */
+static void computeWorldBatch(const uint32_t* indices, size_t count,
+    const int32_t* parents, const glm::mat4* locals, glm::mat4* worlds) {
+    for (size_t k = 0; k < count; k++) {
+        uint32_t i = indices[k];
+        Simd::mat4Mul(worlds[parents[i]], locals[i], worlds[i]);
+    }
+}
+
+TransformHandle TransformHierarchy::create(TransformHandle parent, const Transform& local) {
+    int32_t parentIndex = -1;
+    uint32_t depth = 0;
+    if (parent != INVALID_TRANSFORM) {
+        if (!isValid(parent))
+            throw std::invalid_argument("Invalid parent transform handle.");
+        parentIndex = static_cast<int32_t>(indexOf(parent));
+        depth = m_depths[parentIndex] + 1;
+    }
+
+    TransformHandle handle;
+    if (!m_freeHandles.empty()) {
+        handle = m_freeHandles.back();
+        m_freeHandles.pop_back();
+    } else {
+        handle = static_cast<TransformHandle>(m_handleToIndex.size());
+        m_handleToIndex.push_back(INVALID_INDEX);
+    }
+
+    uint32_t index = static_cast<uint32_t>(m_parents.size());
+    m_handleToIndex[handle] = index;
+
+    // Appending keeps the arrays depth-sorted as long as the new node is not
+    // shallower than the current last one; otherwise re-sort on next update.
+    if (m_structureDirty || (!m_depths.empty() && depth < m_depths.back())) {
+        m_structureDirty = true;
+    } else {
+        if (m_levelOffsets.empty()) m_levelOffsets.push_back(0);
+        if (depth + 1 == m_levelOffsets.size())
+            m_levelOffsets.push_back(index + 1);
+        else
+            m_levelOffsets.back() = index + 1;
+    }
+
+    m_parents.push_back(parentIndex);
+    m_depths.push_back(depth);
+    m_locals.push_back(local);
+    m_localMatrices.push_back(glm::mat4(1.0f));
+    m_worldMatrices.push_back(glm::mat4(1.0f));
+    m_dirty.push_back(LOCAL_DIRTY | WORLD_DIRTY);
+    m_alive.push_back(1);
+    m_indexToHandle.push_back(handle);
+
+    return handle;
+}
+
+void TransformHierarchy::destroy(TransformHandle handle) {
+    m_alive[indexOf(handle)] = 0;
+    m_structureDirty = true;
+}
+
+void TransformHierarchy::setParent(TransformHandle handle, TransformHandle parent) {
+    uint32_t index = indexOf(handle);
+    int32_t parentIndex = -1;
+    if (parent != INVALID_TRANSFORM) {
+        parentIndex = static_cast<int32_t>(indexOf(parent));
+        for (int32_t i = parentIndex; i >= 0; i = m_parents[i]) {
+            if (static_cast<uint32_t>(i) == index)
+                throw std::invalid_argument("Transform cannot be parented to its own subtree.");
+        }
+    }
+
+    if (m_parents[index] == parentIndex) return;
+    m_parents[index] = parentIndex;
+    m_dirty[index] |= WORLD_DIRTY;
+    m_structureDirty = true;
+}
+
+TransformHandle TransformHierarchy::getParent(TransformHandle handle) const {
+    int32_t parentIndex = m_parents[indexOf(handle)];
+    return parentIndex < 0 ? INVALID_TRANSFORM : m_indexToHandle[parentIndex];
+}
+
+void TransformHierarchy::setLocal(TransformHandle handle, const Transform& local) {
+    uint32_t index = indexOf(handle);
+    m_locals[index] = local;
+    m_dirty[index] |= LOCAL_DIRTY | WORLD_DIRTY;
+}
+
+const Transform& TransformHierarchy::getLocal(TransformHandle handle) const {
+    return m_locals[indexOf(handle)];
+}
+
+const glm::mat4& TransformHierarchy::getWorldMatrix(TransformHandle handle) const {
+    return m_worldMatrices[indexOf(handle)];
+}
+
+bool TransformHierarchy::isValid(TransformHandle handle) const {
+    return handle < m_handleToIndex.size() && m_handleToIndex[handle] != INVALID_INDEX
+        && m_alive[m_handleToIndex[handle]];
+}
+
+uint32_t TransformHierarchy::indexOf(TransformHandle handle) const {
+    if (handle >= m_handleToIndex.size() || m_handleToIndex[handle] == INVALID_INDEX)
+        throw std::invalid_argument("Invalid transform handle.");
+    return m_handleToIndex[handle];
+}
+
+void TransformHierarchy::update() {
+    if (m_structureDirty) rebuild();
+
+    m_lastUpdateCount = 0;
+    for (size_t level = 0; level + 1 < m_levelOffsets.size(); level++) {
+        m_batch.clear();
+        for (uint32_t i = m_levelOffsets[level]; i < m_levelOffsets[level + 1]; i++) {
+            int32_t parent = m_parents[i];
+            // Parents were visited in an earlier level, so their flags are final.
+            if (parent >= 0 && m_dirty[parent] != CLEAN)
+                m_dirty[i] |= WORLD_DIRTY;
+            if (m_dirty[i] == CLEAN) continue;
+
+            if (m_dirty[i] & LOCAL_DIRTY)
+                m_localMatrices[i] = m_locals[i].getMatrix();
+
+            if (parent < 0)
+                m_worldMatrices[i] = m_localMatrices[i];
+            else
+                m_batch.push_back(i);
+            m_lastUpdateCount++;
+        }
+
+        computeWorldBatch(m_batch.data(), m_batch.size(), m_parents.data(),
+            m_localMatrices.data(), m_worldMatrices.data());
+
+        // A level's flags are only read by the next level, so clear the
+        // previous one now that it is no longer needed.
+        if (level > 0) {
+            std::fill(m_dirty.begin() + m_levelOffsets[level - 1],
+                      m_dirty.begin() + m_levelOffsets[level], uint8_t(CLEAN));
+        }
+    }
+
+    if (m_levelOffsets.size() >= 2) {
+        std::fill(m_dirty.begin() + m_levelOffsets[m_levelOffsets.size() - 2],
+                  m_dirty.end(), uint8_t(CLEAN));
+    }
+}
+
+void TransformHierarchy::rebuild() {
+    const size_t count = m_parents.size();
+
+    // Depth of every node, or -1 if the node or one of its ancestors is dead.
+    constexpr int64_t UNKNOWN = -2, DEAD = -1;
+    std::vector<int64_t> depths(count, UNKNOWN);
+    std::vector<uint32_t> chain;
+    for (uint32_t i = 0; i < count; i++) {
+        chain.clear();
+        int64_t node = i;
+        while (node >= 0 && depths[node] == UNKNOWN) {
+            chain.push_back(static_cast<uint32_t>(node));
+            node = m_parents[node];
+        }
+        bool dead = node >= 0 && depths[node] == DEAD;
+        int64_t depth = node < 0 ? -1 : depths[node];
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+            if (dead || !m_alive[*it]) {
+                dead = true;
+                depths[*it] = DEAD;
+            } else {
+                depths[*it] = ++depth;
+            }
+        }
+    }
+
+    std::vector<uint32_t> order;
+    order.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        if (depths[i] == DEAD) {
+            TransformHandle handle = m_indexToHandle[i];
+            m_handleToIndex[handle] = INVALID_INDEX;
+            m_freeHandles.push_back(handle);
+        } else {
+            order.push_back(i);
+        }
+    }
+    std::stable_sort(order.begin(), order.end(),
+        [&depths](uint32_t a, uint32_t b) { return depths[a] < depths[b]; });
+
+    std::vector<uint32_t> newIndex(count, INVALID_INDEX);
+    for (uint32_t k = 0; k < order.size(); k++) newIndex[order[k]] = k;
+
+    auto permute = [&order](auto& values) {
+        std::remove_reference_t<decltype(values)> sorted;
+        sorted.reserve(order.size());
+        for (uint32_t old : order) sorted.push_back(values[old]);
+        values.swap(sorted);
+    };
+
+    permute(m_locals);
+    permute(m_localMatrices);
+    permute(m_worldMatrices);
+    permute(m_dirty);
+    permute(m_indexToHandle);
+
+    std::vector<int32_t> parents(order.size());
+    std::vector<uint32_t> sortedDepths(order.size());
+    for (uint32_t k = 0; k < order.size(); k++) {
+        int32_t oldParent = m_parents[order[k]];
+        parents[k] = oldParent < 0 ? -1 : static_cast<int32_t>(newIndex[oldParent]);
+        sortedDepths[k] = static_cast<uint32_t>(depths[order[k]]);
+        m_handleToIndex[m_indexToHandle[k]] = k;
+    }
+    m_parents.swap(parents);
+    m_depths.swap(sortedDepths);
+    m_alive.assign(order.size(), 1);
+
+    m_levelOffsets.assign(1, 0);
+    for (uint32_t k = 0; k < m_depths.size(); k++) {
+        if (m_depths[k] + 1 == m_levelOffsets.size())
+            m_levelOffsets.push_back(k + 1);
+        else
+            m_levelOffsets.back() = k + 1;
+    }
+
+    m_structureDirty = false;
+}
@@ -0,0 +1,97 @@
+#ifndef TRANSFORM_HIERARCHY_H_
+#define TRANSFORM_HIERARCHY_H_
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+#include <transform.hpp>
+
+using TransformHandle = uint32_t;
+constexpr TransformHandle INVALID_TRANSFORM = UINT32_MAX;
+
+/**
+ * @class TransformHierarchy
+ * @brief Parent/child transforms stored in flat, depth-sorted arrays.
+ *
+ * Every node lives at an index where its parent is guaranteed to come first,
+ * and nodes of the same depth are contiguous. update() only recomputes the
+ * subtrees whose local transform changed, one depth level at a time, so that
+ * each level can be multiplied as a single batch.
+ *
+ * Handles stay valid across re-sorting; indices do not and are never exposed.
+ */
+class TransformHierarchy {
+public:
+    /**
+     * @brief Create a node under `parent` (or a root if INVALID_TRANSFORM).
+     *
+     * @throws std::invalid_argument if `parent` is not a live handle.
+     */
+    TransformHandle create(TransformHandle parent = INVALID_TRANSFORM,
+                           const Transform& local = Transform());
+
+    /**
+     * @brief Destroy a node and its whole subtree. Descendant handles become
+     * invalid on the next update().
+     */
+    void destroy(TransformHandle handle);
+
+    /**
+     * @brief Move a node (and its subtree) under a new parent.
+     *
+     * @throws std::invalid_argument if this would create a cycle.
+     */
+    void setParent(TransformHandle handle, TransformHandle parent);
+    TransformHandle getParent(TransformHandle handle) const;
+
+    void setLocal(TransformHandle handle, const Transform& local);
+    const Transform& getLocal(TransformHandle handle) const;
+
+    /**
+     * @brief Local-to-world matrix as of the last update().
+     */
+    const glm::mat4& getWorldMatrix(TransformHandle handle) const;
+
+    /**
+     * @brief Re-sort if the structure changed, then recompute dirty subtrees.
+     */
+    void update();
+
+    bool isValid(TransformHandle handle) const;
+    size_t size() const { return m_parents.size(); }
+
+    // Number of world matrices recomputed by the last update().
+    size_t getLastUpdateCount() const { return m_lastUpdateCount; }
+
+private:
+    enum DirtyFlags : uint8_t {
+        CLEAN = 0,
+        LOCAL_DIRTY = 1 << 0,
+        WORLD_DIRTY = 1 << 1,
+    };
+
+    // Structure of arrays, indexed by position in depth order.
+    std::vector<int32_t> m_parents;
+    std::vector<uint32_t> m_depths;
+    std::vector<Transform> m_locals;
+    std::vector<glm::mat4> m_localMatrices;
+    std::vector<glm::mat4> m_worldMatrices;
+    std::vector<uint8_t> m_dirty;
+    std::vector<uint8_t> m_alive;
+    std::vector<TransformHandle> m_indexToHandle;
+
+    // [m_levelOffsets[d], m_levelOffsets[d + 1]) holds all nodes of depth d.
+    std::vector<uint32_t> m_levelOffsets;
+
+    std::vector<uint32_t> m_handleToIndex;
+    std::vector<TransformHandle> m_freeHandles;
+
+    std::vector<uint32_t> m_batch;
+    bool m_structureDirty{false};
+    size_t m_lastUpdateCount{0};
+
+    uint32_t indexOf(TransformHandle handle) const;
+    void rebuild();
+};
+
+#endif
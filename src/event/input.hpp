@@ -2,6 +2,7 @@
 #define INPUT_HPP_
 
 #include <SDL2/SDL.h>
+#include <array>
 #include <vector>
 #include <functional>
 #include <stdexcept>
@@ -18,8 +19,33 @@ enum class Action {
     Backward
 };
 
-inline std::vector<Action> getActions(const Uint8* keystate) {
-    std::vector<Action> actions;
+/**
+ * @class ActionList
+ * @brief Fixed-capacity list of the actions triggered during a frame, so
+ * polling the keyboard never allocates.
+ */
+class ActionList {
+public:
+    static constexpr size_t CAPACITY = 6;
+
+    void push_back(Action action) {
+        if (m_size < CAPACITY) m_actions[m_size++] = action;
+    }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    const Action* data() const { return m_actions.data(); }
+    const Action& operator[](size_t index) const { return m_actions[index]; }
+    const Action* begin() const { return m_actions.data(); }
+    const Action* end() const { return m_actions.data() + m_size; }
+
+private:
+    std::array<Action, CAPACITY> m_actions{};
+    size_t m_size{0};
+};
+
+inline ActionList getActions(const Uint8* keystate) {
+    ActionList actions;
     if (keystate[SDL_SCANCODE_W]) actions.push_back(Action::Forward);
     if (keystate[SDL_SCANCODE_S]) actions.push_back(Action::Backward);
     if (keystate[SDL_SCANCODE_A]) actions.push_back(Action::Left);
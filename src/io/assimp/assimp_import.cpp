@@ -0,0 +1,85 @@
+#include <assimp/config.h>
+#include <assimp/postprocess.h>
+
+#include "assimp_import.hpp"
+#include "asset_path.hpp"
+#include "virtual_file_system.hpp"
+
+namespace AssimpImport {
+
+glm::mat4 toGlm(const aiMatrix4x4& matrix) {
+    // Assimp matrices are row-major, glm is column-major.
+    return glm::mat4(
+        glm::vec4(matrix.a1, matrix.b1, matrix.c1, matrix.d1),
+        glm::vec4(matrix.a2, matrix.b2, matrix.c2, matrix.d2),
+        glm::vec4(matrix.a3, matrix.b3, matrix.c3, matrix.d3),
+        glm::vec4(matrix.a4, matrix.b4, matrix.c4, matrix.d4));
+}
+
+const aiScene* readFile(Assimp::Importer& importer, const std::string& path, const ImportProfile& profile) {
+    if (profile.removeDegenerates) {
+        importer.SetPropertyBool(AI_CONFIG_PP_FD_REMOVE, true);
+        importer.SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_POINT | aiPrimitiveType_LINE);
+    }
+
+    // Read with the minimal steps first so the effect of the profile can be measured.
+    unsigned int readFlags = aiProcess_Triangulate;
+    if (profile.flipUVs) readFlags |= aiProcess_FlipUVs;
+    VirtualFileSystem& files = VirtualFileSystem::getInstance();
+    std::string nativePath = files.getNativePath(path);
+    if (!nativePath.empty()) return importer.ReadFile(nativePath, readFlags);
+
+    // Packed in an archive: Assimp reads it from memory, guessing the format
+    // from the extension. Files the model refers to are not found this way.
+    FileData file;
+    try {
+        file = files.open(path);
+    } catch (const std::exception&) {
+        return importer.ReadFile(path, readFlags);
+    }
+    std::string hint = AssetPath::getExtension(path);
+    return importer.ReadFileFromMemory(file.data(), file.size(), readFlags, hint.empty() ? "" : hint.c_str() + 1);
+}
+
+unsigned int getPostProcessFlags(const ImportProfile& profile) {
+    unsigned int flags = 0;
+    if (profile.weldVertices) flags |= aiProcess_JoinIdenticalVertices;
+    if (profile.generateTangents) flags |= aiProcess_CalcTangentSpace;
+    if (profile.mergeMeshes) flags |= aiProcess_OptimizeMeshes;
+    if (profile.findInstances) flags |= aiProcess_FindInstances;
+    if (profile.removeDegenerates) flags |= aiProcess_FindDegenerates | aiProcess_SortByPType;
+    if (profile.removeRedundantMaterials) flags |= aiProcess_RemoveRedundantMaterials;
+    if (profile.optimizeCache) flags |= aiProcess_ImproveCacheLocality;
+    return flags;
+}
+
+std::vector<Vertex> readVertices(const aiMesh& mesh) {
+    std::vector<Vertex> vertices;
+    vertices.reserve(mesh.mNumVertices);
+    for (unsigned int i = 0; i < mesh.mNumVertices; i++) {
+        Vertex vertex{};
+        vertex.position = glm::vec3(mesh.mVertices[i].x, mesh.mVertices[i].y, mesh.mVertices[i].z);
+        if (mesh.HasNormals())
+            vertex.normal = glm::vec3(mesh.mNormals[i].x, mesh.mNormals[i].y, mesh.mNormals[i].z);
+        if (mesh.HasTangentsAndBitangents()) {
+            vertex.tangent = glm::vec3(mesh.mTangents[i].x, mesh.mTangents[i].y, mesh.mTangents[i].z);
+            vertex.biTangent = glm::vec3(mesh.mBitangents[i].x, mesh.mBitangents[i].y, mesh.mBitangents[i].z);
+        }
+        if (mesh.mTextureCoords[0])
+            vertex.textureCoordinates = glm::vec2(mesh.mTextureCoords[0][i].x, mesh.mTextureCoords[0][i].y);
+        vertices.push_back(vertex);
+    }
+    return vertices;
+}
+
+std::vector<unsigned int> readIndices(const aiMesh& mesh) {
+    std::vector<unsigned int> indices;
+    indices.reserve(mesh.mNumFaces * 3);
+    for (unsigned int i = 0; i < mesh.mNumFaces; i++) {
+        const aiFace& face = mesh.mFaces[i];
+        indices.insert(indices.end(), face.mIndices, face.mIndices + face.mNumIndices);
+    }
+    return indices;
+}
+
+}
@@ -0,0 +1,34 @@
+#ifndef ASSIMP_IMPORT_H_
+#define ASSIMP_IMPORT_H_
+
+#include <glm/glm.hpp>
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <vector>
+#include <vertex.hpp>
+#include <import_profile.hpp>
+
+/**
+ * Conversions shared by the Assimp import of Model and the asset cook, so
+ * that a cooked model holds exactly what importing the source would.
+ */
+namespace AssimpImport {
+
+    glm::mat4 toGlm(const aiMatrix4x4& matrix);
+
+    /**
+     * @brief Read `path` with the steps of `profile`, the post-processing of
+     * `profile` not applied yet.
+     * @return The scene, owned by `importer`, or nullptr on failure.
+     */
+    const aiScene* readFile(Assimp::Importer& importer, const std::string& path, const ImportProfile& profile);
+    unsigned int getPostProcessFlags(const ImportProfile& profile);
+
+    /**
+     * @brief Vertices of `mesh` without bone influences.
+     */
+    std::vector<Vertex> readVertices(const aiMesh& mesh);
+    std::vector<unsigned int> readIndices(const aiMesh& mesh);
+}
+
+#endif
@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <iostream>
+
+#include "asset_loader.hpp"
+#include "allocation_tracker.hpp"
+#include "thread_pool.hpp"
+
+AssetLoader& AssetLoader::getInstance() {
+    static AssetLoader instance(ThreadPool::getInstance());
+    return instance;
+}
+
+void AssetLoader::spawn(Task<void> task) {
+    beginLoad();
+    drive(std::move(task));
+}
+
+AssetLoader::Detached AssetLoader::drive(Task<void> task) {
+    try {
+        co_await task;
+    } catch (const std::exception& e) {
+        reportError(e.what());
+    } catch (...) {
+        reportError("Unknown error");
+    }
+    finishLoad();
+}
+
+void AssetLoader::scheduleWorker(std::coroutine_handle<> handle) {
+    m_pool.submit([handle] {
+        ScopedAllocationTag assetsTag(AllocationTag::ASSETS);
+        handle.resume();
+    });
+}
+
+void AssetLoader::scheduleGl(std::coroutine_handle<> handle, std::chrono::steady_clock::time_point due) {
+    std::lock_guard lock(m_mutex);
+    m_glTasks.push_back({handle, due});
+    m_condition.notify_all();
+}
+
+size_t AssetLoader::runGlTasks(std::chrono::microseconds budget) {
+    std::deque<GlTask> tasks;
+    {
+        std::lock_guard lock(m_mutex);
+        tasks.swap(m_glTasks);
+    }
+
+    ScopedAllocationTag assetsTag(AllocationTag::ASSETS);
+    auto start = std::chrono::steady_clock::now();
+    std::deque<GlTask> waiting;
+    size_t count = 0;
+    // Compared in microseconds: the default budget overflows nanoseconds.
+    auto spent = [start] {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    };
+    while (!tasks.empty() && (count == 0 || spent() < budget)) {
+        GlTask task = tasks.front();
+        tasks.pop_front();
+        if (task.due > start) {
+            waiting.push_back(task);
+            continue;
+        }
+        task.handle.resume();
+        count++;
+    }
+
+    // Delayed or over budget: they go first next time.
+    waiting.insert(waiting.end(), tasks.begin(), tasks.end());
+    if (!waiting.empty()) {
+        std::lock_guard lock(m_mutex);
+        m_glTasks.insert(m_glTasks.begin(), waiting.begin(), waiting.end());
+    }
+    return count;
+}
+
+void AssetLoader::waitAll() {
+    while (true) {
+        runGlTasks();
+        std::unique_lock lock(m_mutex);
+        if (m_pending == 0 && m_glTasks.empty()) return;
+        // Sleep until a step is queued, the earliest delayed step is due, or
+        // the last load finishes.
+        size_t queued = m_glTasks.size();
+        auto changed = [&] { return m_pending == 0 || m_glTasks.size() != queued; };
+        if (m_glTasks.empty()) {
+            m_condition.wait(lock, changed);
+        } else {
+            auto wakeUp = std::min_element(m_glTasks.begin(), m_glTasks.end(), [](const GlTask& a, const GlTask& b) {
+                return a.due < b.due;
+            })->due;
+            m_condition.wait_until(lock, wakeUp, changed);
+        }
+    }
+}
+
+size_t AssetLoader::getPendingCount() const {
+    std::lock_guard lock(m_mutex);
+    return m_pending;
+}
+
+void AssetLoader::beginLoad() {
+    std::lock_guard lock(m_mutex);
+    m_pending++;
+}
+
+void AssetLoader::finishLoad() {
+    // Notified under the lock: once waitAll() sees the last load finish, the
+    // loader may be destroyed, so this must be its final access.
+    std::lock_guard lock(m_mutex);
+    m_pending--;
+    m_condition.notify_all();
+}
+
+void AssetLoader::reportError(const std::string& error) {
+    std::cerr << "ERROR::ASSET_LOADER::" << error << std::endl;
+}
@@ -0,0 +1,215 @@
+#ifndef ASSET_LOADER_H_
+#define ASSET_LOADER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <task.hpp>
+
+class ThreadPool;
+
+/**
+ * @class AssetHandle
+ * @brief Result of a load started by the AssetLoader, which becomes ready
+ * later. Copies share the same result.
+ *
+ * `co_await handle` waits for it without blocking a thread and gives the
+ * result, or nullptr if the load failed. The awaiting coroutine resumes on the
+ * thread that finished the load, the GL thread for loads ending with an
+ * upload.
+ */
+template <typename T>
+class AssetHandle {
+public:
+    AssetHandle() = default;
+
+    bool isValid() const { return m_state != nullptr; }
+    bool isReady() const {
+        std::lock_guard lock(m_state->mutex);
+        return m_state->ready;
+    }
+    // nullptr until ready, or if the load failed.
+    std::shared_ptr<T> get() const {
+        std::lock_guard lock(m_state->mutex);
+        return m_state->value;
+    }
+    // Why the load failed, empty otherwise.
+    std::string getError() const {
+        std::lock_guard lock(m_state->mutex);
+        return m_state->error;
+    }
+
+    bool await_ready() const { return isReady(); }
+    bool await_suspend(std::coroutine_handle<> awaiting) const {
+        std::lock_guard lock(m_state->mutex);
+        if (m_state->ready) return false;
+        m_state->waiters.push_back(awaiting);
+        return true;
+    }
+    std::shared_ptr<T> await_resume() const { return get(); }
+
+private:
+    friend class AssetLoader;
+
+    struct State {
+        mutable std::mutex mutex;
+        bool ready = false;
+        std::shared_ptr<T> value;
+        std::string error;
+        std::vector<std::coroutine_handle<>> waiters;
+
+        void complete(std::shared_ptr<T> result, std::string message) {
+            std::vector<std::coroutine_handle<>> waiting;
+            {
+                std::lock_guard lock(mutex);
+                value = std::move(result);
+                error = std::move(message);
+                ready = true;
+                waiting.swap(waiters);
+            }
+            for (std::coroutine_handle<> waiter : waiting) waiter.resume();
+        }
+    };
+
+    std::shared_ptr<State> m_state;
+};
+
+/**
+ * @class AssetLoader
+ * @brief Runs asset loads written as coroutines, many at a time, moving each
+ * one between the worker threads of a ThreadPool, for reading and decoding,
+ * and the GL thread, for uploads.
+ * This class is a Singleton.
+ *
+ * A load awaits toWorker() before its CPU work and toGlThread() before its GL
+ * calls. The GL thread runs the steps queued for it when it calls
+ * runGlTasks(), once per frame with a time budget, or waitAll() to finish
+ * every load, e.g. at startup. Loads must finish before the loader is
+ * destroyed.
+ *
+ * Once rendering starts, the GL thread is the render thread: GL steps must
+ * only build new objects, handed back through the AssetHandle, and never
+ * modify objects the simulation thread reads.
+ */
+class AssetLoader {
+public:
+    /**
+     * @brief Loader running its CPU steps on the shared ThreadPool.
+     */
+    static AssetLoader& getInstance();
+
+    explicit AssetLoader(ThreadPool& pool) : m_pool(pool) {}
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    /**
+     * @brief Start `task` on the calling thread, up to its first suspension.
+     * A task that throws gives a failed handle; the error is also printed.
+     */
+    template <typename T>
+    AssetHandle<T> load(Task<std::shared_ptr<T>> task) {
+        AssetHandle<T> handle;
+        handle.m_state = std::make_shared<typename AssetHandle<T>::State>();
+        beginLoad();
+        drive(std::move(task), handle.m_state);
+        return handle;
+    }
+    /**
+     * @brief Start `task`, which gives no result, like load().
+     */
+    void spawn(Task<void> task);
+
+    struct WorkerAwaiter {
+        AssetLoader* loader;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) const { loader->scheduleWorker(handle); }
+        void await_resume() const noexcept {}
+    };
+    struct GlThreadAwaiter {
+        AssetLoader* loader;
+        std::chrono::steady_clock::time_point due;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) const { loader->scheduleGl(handle, due); }
+        void await_resume() const noexcept {}
+    };
+    // Continue on a worker thread.
+    WorkerAwaiter toWorker() { return {this}; }
+    /**
+     * @brief Continue on the GL thread, at its next runGlTasks() once `delay`
+     * has passed. A step polling the driver waits with a delay, so that
+     * waitAll() sleeps meanwhile instead of spinning.
+     */
+    GlThreadAwaiter toGlThread(std::chrono::microseconds delay = std::chrono::microseconds(0)) {
+        return {this, std::chrono::steady_clock::now() + delay};
+    }
+
+    /**
+     * @brief Resume the steps queued for the GL thread whose delay has passed,
+     * at least one and then until `budget` is spent. Steps queued meanwhile
+     * wait for the next call.
+     * GL thread only.
+     * @return Number of steps run.
+     */
+    size_t runGlTasks(std::chrono::microseconds budget = std::chrono::microseconds::max());
+    /**
+     * @brief Run GL steps until every load has finished. GL thread only.
+     */
+    void waitAll();
+    // Loads started and not finished yet.
+    size_t getPendingCount() const;
+
+private:
+    struct Detached {
+        struct promise_type {
+            Detached get_return_object() noexcept { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+    };
+
+    struct GlTask {
+        std::coroutine_handle<> handle;
+        std::chrono::steady_clock::time_point due;
+    };
+
+    ThreadPool& m_pool;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<GlTask> m_glTasks;
+    size_t m_pending{0};
+
+    void scheduleWorker(std::coroutine_handle<> handle);
+    void scheduleGl(std::coroutine_handle<> handle, std::chrono::steady_clock::time_point due);
+    void beginLoad();
+    void finishLoad();
+    static void reportError(const std::string& error);
+
+    template <typename T>
+    Detached drive(Task<std::shared_ptr<T>> task, std::shared_ptr<typename AssetHandle<T>::State> state) {
+        std::shared_ptr<T> value;
+        std::string error;
+        try {
+            value = co_await task;
+        } catch (const std::exception& e) {
+            error = e.what();
+        } catch (...) {
+            error = "Unknown error";
+        }
+        if (!error.empty()) reportError(error);
+        // Ready before it stops counting as pending, for waitAll().
+        state->complete(std::move(value), std::move(error));
+        finishLoad();
+    }
+    Detached drive(Task<void> task);
+};
+
+#endif
@@ -5,6 +5,12 @@
 #include <string>
 #include <fstream>
 #include <iostream>
+#include <asset_cook.hpp>
+#include <asset_path.hpp>
+#include <import_profile.hpp>
+#include <render_path.hpp>
+#include <shadow_settings.hpp>
+#include <virtual_file_system.hpp>
 
 using json = nlohmann::json;
 
@@ -19,11 +25,106 @@ public:
         return m_materials_path;
     }
 
+    size_t getGpuBudgetBytes() const {
+        size_t megabytes = m_config.is_object() ? m_config.value("gpu_budget_mb", size_t(2048)) : 2048;
+        return megabytes * 1024 * 1024;
+    }
+
+    /**
+     * @brief Frames the CPU may record ahead of the GPU, at least 1.
+     */
+    uint32_t getFramesInFlight() const {
+        uint32_t frames = m_config.is_object() ? m_config.value("frames_in_flight", 3u) : 3u;
+        return frames > 0 ? frames : 1;
+    }
+
+    /**
+     * @brief Size of each frame's region of the streaming ring buffer.
+     */
+    size_t getStreamBufferBytes() const {
+        size_t kilobytes = m_config.is_object() ? m_config.value("stream_buffer_kb", size_t(1024)) : 1024;
+        return kilobytes * 1024;
+    }
+
+    bool getDepthPrepass() const {
+        return m_config.is_object() ? m_config.value("depth_prepass", false) : false;
+    }
+
+    RenderPath getRenderPath() const {
+        return renderPathFromString(m_config.is_object() ? m_config.value("render_path", std::string("forward")) : "forward");
+    }
+
+    ShadowSettings getShadowSettings() const {
+        ShadowSettings settings;
+        if (m_config.contains("shadows"))
+            settings.apply(m_config["shadows"]);
+        return settings;
+    }
+
+    /**
+     * @brief Animated model instanced as a crowd, empty for none.
+     */
+    std::string getCrowdModel() const {
+        if (!m_config.contains("crowd")) return "";
+        return m_config["crowd"].value("model", std::string());
+    }
+
+    uint32_t getCrowdCount() const {
+        if (!m_config.contains("crowd")) return 0;
+        return m_config["crowd"].value("count", 0u);
+    }
+
+    /**
+     * @brief Import profile for `assetPath`: the "default" profile with the
+     * asset's own overrides applied on top.
+     */
+    ImportProfile getImportProfile(const std::string& assetPath) const {
+        ImportProfile profile;
+        if (!m_config.contains("import")) return profile;
+
+        const json& import = m_config["import"];
+        if (import.contains("default"))
+            profile.apply(import["default"]);
+        if (import.contains("assets")) {
+            // Keys may be written with either separator.
+            std::string key = AssetPath::normalize(assetPath);
+            for (const auto& [asset, overrides] : import["assets"].items()) {
+                if (AssetPath::normalize(asset) == key) profile.apply(overrides);
+            }
+        }
+        return profile;
+    }
+
+    /**
+     * @brief Artifact cooked by lamb_cook from the source asset `path`, or an
+     * empty string if there is none or cooked assets are disabled.
+     */
+    std::string getCookedPath(const std::string& path) const {
+        std::string directory = m_config.is_object() ? m_config.value("cooked_directory", std::string()) : "";
+        std::string artifact = Cook::getArtifactPath(path);
+        if (directory.empty() || artifact.empty()) return "";
+        artifact = directory + '/' + artifact;
+        return VirtualFileSystem::getInstance().exists(artifact) ? artifact : "";
+    }
+
+    /**
+     * @brief Pak archives mounted at startup, as {mount point, archive file}
+     * pairs in mount order: files in later archives override earlier ones and
+     * the loose files under their mount point.
+     */
+    std::vector<std::pair<std::string, std::string>> getArchives() const {
+        std::vector<std::pair<std::string, std::string>> archives;
+        if (!m_config.is_object() || !m_config.contains("archives")) return archives;
+        for (const json& archive : m_config["archives"])
+            archives.emplace_back(archive.value("mount", std::string()), archive.value("file", std::string()));
+        return archives;
+    }
+
 private:
     static ConfigurationManager* instance;
     json m_config;
     std::string m_materials_path;
-    const char* m_config_path = ".\\config\\links.json";
+    const char* m_config_path = "config/links.json";
 
     ConfigurationManager(const ConfigurationManager&) = delete;
     ConfigurationManager& operator=(const ConfigurationManager) = delete;
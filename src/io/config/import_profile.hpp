@@ -0,0 +1,56 @@
+#ifndef IMPORT_PROFILE_H_
+#define IMPORT_PROFILE_H_
+
+#include <nlohmann/json.hpp>
+#include <residency.hpp>
+
+/**
+ * @brief Post-processing applied to a model when it is imported.
+ *
+ * Loaded from the "import" section of the configuration file: a "default"
+ * profile, optionally overridden per asset path under "assets".
+ */
+struct ImportProfile {
+    bool flipUVs = true;
+    // Join identical vertices so faces share them through the index buffer.
+    bool weldVertices = true;
+    bool generateTangents = true;
+    // Merge meshes sharing a material. Node hierarchy is preserved.
+    bool mergeMeshes = false;
+    // Replace duplicate meshes by instances of a single one.
+    bool findInstances = true;
+    bool removeDegenerates = true;
+    bool removeRedundantMaterials = true;
+    // Reorder triangles for the post-transform vertex cache.
+    bool optimizeCache = true;
+    // CPU copy of the geometry kept after upload: "keep", "discard" or "collision".
+    GeometryResidency residency = GeometryResidency::KEEP;
+    // Frames per second animation clips are resampled at before compression.
+    float animationSampleRate = 30.0f;
+    // Read .glb and .gltf files with the native loader instead of Assimp. The
+    // post-processing flags above only apply to Assimp imports.
+    bool nativeGltf = true;
+    // Read .obj files with the parallel native parser instead of Assimp.
+    bool nativeObj = true;
+
+    /**
+     * @brief Override the fields present in `config`, keep the others.
+     */
+    void apply(const nlohmann::json& config) {
+        flipUVs = config.value("flip_uvs", flipUVs);
+        weldVertices = config.value("weld_vertices", weldVertices);
+        generateTangents = config.value("generate_tangents", generateTangents);
+        mergeMeshes = config.value("merge_meshes", mergeMeshes);
+        findInstances = config.value("find_instances", findInstances);
+        removeDegenerates = config.value("remove_degenerates", removeDegenerates);
+        removeRedundantMaterials = config.value("remove_redundant_materials", removeRedundantMaterials);
+        optimizeCache = config.value("optimize_cache", optimizeCache);
+        animationSampleRate = config.value("animation_sample_rate", animationSampleRate);
+        nativeGltf = config.value("native_gltf", nativeGltf);
+        nativeObj = config.value("native_obj", nativeObj);
+        if (config.contains("residency"))
+            residency = residencyFromString(config["residency"].get<std::string>());
+    }
+};
+
+#endif
@@ -0,0 +1,285 @@
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "asset_cook.hpp"
+#include "asset_path.hpp"
+#include "hash.hpp"
+#include "mapped_file.hpp"
+#include "thread_pool.hpp"
+
+using json = nlohmann::json;
+
+namespace {
+
+constexpr int MANIFEST_VERSION = 1;
+
+// Cooked extension by source extension.
+const std::pair<const char*, const char*> ARTIFACT_EXTENSIONS[] = {
+    {".fbx", ".lmodel"},
+    {".png", ".ltex"},
+    {".bmp", ".ltex"},
+    {".mtl", ".mtl"},
+    {".glsl", ".glsl"},
+};
+
+std::string toHex(uint64_t value) {
+    std::ostringstream stream;
+    stream << std::hex << std::setw(16) << std::setfill('0') << value;
+    return stream.str();
+}
+
+uint64_t fromHex(const std::string& hex) {
+    return std::stoull(hex, nullptr, 16);
+}
+
+/**
+ * @brief Content hashes shared by the cook tasks, each file is read once.
+ */
+class FileHashes {
+public:
+    // Zero with `found` false if the file cannot be read.
+    uint64_t get(const std::string& path, bool& found) {
+        {
+            std::lock_guard lock(m_mutex);
+            auto entry = m_hashes.find(path);
+            if (entry != m_hashes.end()) {
+                found = entry->second.second;
+                return entry->second.first;
+            }
+        }
+        uint64_t hash = 0;
+        found = true;
+        try {
+            hash = Cook::hashFile(path);
+        } catch (const std::exception&) {
+            found = false;
+        }
+        std::lock_guard lock(m_mutex);
+        m_hashes[path] = {hash, found};
+        return hash;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::unordered_map<std::string, std::pair<uint64_t, bool>> m_hashes;
+};
+
+}
+
+namespace Cook {
+
+std::string getArtifactPath(std::string_view source) {
+    std::string extension = AssetPath::getExtension(source);
+    for (const auto& [from, to] : ARTIFACT_EXTENSIONS) {
+        if (extension == from)
+            return AssetPath::normalize(source.substr(0, source.size() - extension.size())) + to;
+    }
+    return "";
+}
+
+uint64_t hashFile(const std::string& path) {
+    MappedFile file(path);
+    return Hash::fnv1a(static_cast<const void*>(file.data()), file.size());
+}
+
+void CookManifest::load(const std::string& path) {
+    m_entries.clear();
+    std::ifstream file(path);
+    if (!file.is_open()) return;
+    try {
+        json manifest = json::parse(file);
+        if (manifest.value("version", 0) != MANIFEST_VERSION) return;
+        for (const auto& [source, asset] : manifest["assets"].items()) {
+            ManifestEntry entry;
+            entry.artifact = asset.at("artifact").get<std::string>();
+            entry.version = asset.at("cooker").get<uint32_t>();
+            entry.settingsHash = fromHex(asset.at("settings").get<std::string>());
+            for (const json& input : asset.at("inputs"))
+                entry.inputs.push_back({input.at(0).get<std::string>(), fromHex(input.at(1).get<std::string>())});
+            m_entries[source] = std::move(entry);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "COOK::WARNING::" << path << " is unreadable, cooking everything: " << e.what() << std::endl;
+        m_entries.clear();
+    }
+}
+
+void CookManifest::save(const std::string& path) const {
+    json assets = json::object();
+    for (const auto& [source, entry] : m_entries) {
+        json inputs = json::array();
+        for (const auto& [input, hash] : entry.inputs)
+            inputs.push_back({input, toHex(hash)});
+        assets[source] = {{"artifact", entry.artifact}, {"cooker", entry.version},
+                          {"settings", toHex(entry.settingsHash)}, {"inputs", std::move(inputs)}};
+    }
+
+    // Written aside and renamed, so an interrupted cook keeps the old manifest.
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file) throw std::runtime_error("Cannot open file for writing: " + temporary);
+        file << json{{"version", MANIFEST_VERSION}, {"assets", std::move(assets)}}.dump(2) << std::endl;
+        if (!file) throw std::runtime_error("Cannot write file: " + temporary);
+    }
+    std::filesystem::rename(temporary, path);
+}
+
+const ManifestEntry* CookManifest::find(const std::string& source) const {
+    auto entry = m_entries.find(source);
+    return entry == m_entries.end() ? nullptr : &entry->second;
+}
+
+AssetCooker::AssetCooker(std::string sourceRoot, std::string outputRoot, std::vector<CookRule> rules)
+    : m_sourceRoot(AssetPath::normalize(sourceRoot)), m_outputRoot(AssetPath::normalize(outputRoot)),
+      m_rules(std::move(rules)) {
+    if (m_sourceRoot.empty()) m_sourceRoot = ".";
+    if (m_outputRoot.empty()) m_outputRoot = ".";
+}
+
+const CookRule* AssetCooker::findRule(const std::string& source) const {
+    std::string extension = AssetPath::getExtension(source);
+    for (const CookRule& rule : m_rules) {
+        for (const std::string& ruleExtension : rule.extensions) {
+            if (ruleExtension == extension) return &rule;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<std::string> AssetCooker::findSources(const std::vector<std::string>& directories) const {
+    namespace fs = std::filesystem;
+    std::vector<std::string> sources;
+    for (const std::string& directory : directories) {
+        std::error_code error;
+        fs::recursive_directory_iterator iterator(fs::path(m_sourceRoot) / directory, error);
+        if (error) continue;
+        for (const fs::directory_entry& file : iterator) {
+            if (!file.is_regular_file()) continue;
+            std::string source = AssetPath::normalize(
+                fs::relative(file.path(), m_sourceRoot).generic_string());
+            if (findRule(source) && !getArtifactPath(source).empty()) sources.push_back(std::move(source));
+        }
+    }
+    std::sort(sources.begin(), sources.end());
+    sources.erase(std::unique(sources.begin(), sources.end()), sources.end());
+    return sources;
+}
+
+CookReport AssetCooker::cook(const std::vector<std::string>& sources, bool force, ThreadPool* pool) {
+    namespace fs = std::filesystem;
+    CookManifest manifest;
+    manifest.load(getManifestPath());
+
+    struct Result {
+        bool cooked = false;
+        std::string skipped;
+        std::string error;
+        ManifestEntry entry;
+    };
+    std::vector<Result> results(sources.size());
+    FileHashes hashes;
+
+    // Each task checks its asset and cooks it if stale. Tasks must not throw.
+    ThreadPool& threads = pool ? *pool : ThreadPool::getInstance();
+    threads.parallelFor(sources.size(), 1, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; i++) {
+            Result& result = results[i];
+            const std::string& source = sources[i];
+            try {
+                const CookRule* rule = findRule(source);
+                std::string artifact = getArtifactPath(source);
+                if (!rule || artifact.empty()) throw std::runtime_error("no rule cooks this asset");
+
+                CookJob job{m_sourceRoot, source, m_sourceRoot + '/' + source, m_outputRoot + '/' + artifact};
+                uint64_t settingsHash = rule->getSettingsHash ? rule->getSettingsHash(source) : 0;
+
+                const ManifestEntry* previous = manifest.find(source);
+                bool skipped = previous && previous->artifact.empty();
+                bool stale = force || !previous || previous->version != rule->version ||
+                             previous->settingsHash != settingsHash ||
+                             (!skipped && (previous->artifact != artifact || !fs::exists(job.artifactPath)));
+                for (size_t input = 0; !stale && previous && input < previous->inputs.size(); input++) {
+                    bool found;
+                    uint64_t hash = hashes.get(m_sourceRoot + '/' + previous->inputs[input].first, found);
+                    stale = !found || hash != previous->inputs[input].second;
+                }
+                if (!stale) {
+                    result.entry = *previous;
+                    continue;
+                }
+
+                // Hashed before cooking, so an edit made meanwhile is seen by the next cook.
+                bool found;
+                uint64_t sourceHash = hashes.get(job.sourcePath, found);
+                if (!found) throw std::runtime_error("cannot read source");
+                std::error_code error;
+                fs::create_directories(fs::path(job.artifactPath).parent_path(), error);
+
+                std::vector<std::string> dependencies;
+                try {
+                    dependencies = rule->cook(job);
+                    result.entry.artifact = artifact;
+                } catch (const AssetSkipped& e) {
+                    // Recorded with its inputs so it is not tried again until they change.
+                    fs::remove(job.artifactPath, error);
+                    result.skipped = source + ": " + e.what();
+                }
+
+                result.entry.version = rule->version;
+                result.entry.settingsHash = settingsHash;
+                result.entry.inputs.push_back({source, sourceHash});
+                for (const std::string& dependency : dependencies) {
+                    std::string normalized = AssetPath::normalize(dependency);
+                    uint64_t hash = hashes.get(m_sourceRoot + '/' + normalized, found);
+                    // Recorded even if missing, which keeps the asset stale until it exists.
+                    result.entry.inputs.push_back({normalized, found ? hash : 0});
+                }
+                result.cooked = true;
+            } catch (const std::exception& e) {
+                result.error = source + ": " + e.what();
+            }
+        }
+    });
+
+    CookReport report;
+    std::unordered_set<std::string> current(sources.begin(), sources.end());
+    std::vector<std::string> removed;
+    for (const auto& [source, entry] : manifest.getEntries()) {
+        if (current.count(source)) continue;
+        std::error_code error;
+        fs::remove(m_outputRoot + '/' + entry.artifact, error);
+        removed.push_back(source);
+    }
+    for (const std::string& source : removed) manifest.erase(source);
+    report.removed = removed.size();
+
+    for (size_t i = 0; i < sources.size(); i++) {
+        if (!results[i].error.empty()) {
+            // Forgotten, so the next cook tries again.
+            manifest.erase(sources[i]);
+            report.errors.push_back(std::move(results[i].error));
+            continue;
+        }
+        if (!results[i].skipped.empty()) report.skipped.push_back(std::move(results[i].skipped));
+        else if (results[i].cooked) report.cooked++;
+        else report.upToDate++;
+        manifest.set(sources[i], std::move(results[i].entry));
+    }
+
+    std::error_code error;
+    fs::create_directories(m_outputRoot, error);
+    manifest.save(getManifestPath());
+    return report;
+}
+
+}
@@ -0,0 +1,151 @@
+#ifndef ASSET_COOK_H_
+#define ASSET_COOK_H_
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * Offline conversion of source assets into the formats the engine loads
+ * fastest: ".lmodel" models, ".ltex" textures with their mip chain, shaders
+ * with their includes expanded.
+ *
+ * Artifacts mirror the source tree under an output directory. A manifest
+ * records, for each source, the content hash of every file its artifact was
+ * made from, so only assets whose inputs, settings or cooker changed are
+ * cooked again.
+ */
+namespace Cook {
+
+    /**
+     * @brief Artifact of the source asset `source`, with the same relative
+     * path and the extension of its cooked form. Empty if such assets are not
+     * cooked.
+     */
+    std::string getArtifactPath(std::string_view source);
+
+    /**
+     * @brief Content hash of the file at `path`.
+     * @throws std::runtime_error if it cannot be read.
+     */
+    uint64_t hashFile(const std::string& path);
+
+    /**
+     * @brief Thrown by a cook function for an asset that is better left in
+     * its source form. Not an error.
+     */
+    class AssetSkipped : public std::runtime_error {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    struct CookJob {
+        std::string sourceRoot;
+        // Normalized and relative to sourceRoot, e.g. "res/teapot.fbx".
+        std::string source;
+        std::string sourcePath;
+        std::string artifactPath;
+    };
+
+    struct CookRule {
+        // Lowercase source extensions, with their dot.
+        std::vector<std::string> extensions;
+        // Raise when the artifacts change, so that every asset is cooked again.
+        uint32_t version = 1;
+        // Hash of the settings the artifact depends on besides its files, for
+        // instance the import profile. Null if there are none.
+        std::function<uint64_t(const std::string& source)> getSettingsHash;
+        /**
+         * @brief Write the artifact of `job`.
+         * @return Files read besides the source, relative to the source root.
+         * @throws AssetSkipped to leave the asset uncooked, any other
+         * std::exception on failure.
+         */
+        std::function<std::vector<std::string>(const CookJob& job)> cook;
+    };
+
+    /**
+     * @brief What an artifact was made from.
+     */
+    struct ManifestEntry {
+        // Empty if the asset was skipped.
+        std::string artifact;
+        uint32_t version = 0;
+        uint64_t settingsHash = 0;
+        // Source first, then its dependencies, with their content hash.
+        std::vector<std::pair<std::string, uint64_t>> inputs;
+    };
+
+    class CookManifest {
+    public:
+        /**
+         * @brief Read the manifest at `path`. A missing or unreadable manifest
+         * is empty, which cooks everything again.
+         */
+        void load(const std::string& path);
+        /**
+         * @throws std::runtime_error if the file cannot be written.
+         */
+        void save(const std::string& path) const;
+
+        const ManifestEntry* find(const std::string& source) const;
+        void set(const std::string& source, ManifestEntry entry) { m_entries[source] = std::move(entry); }
+        void erase(const std::string& source) { m_entries.erase(source); }
+        const std::map<std::string, ManifestEntry>& getEntries() const { return m_entries; }
+
+    private:
+        // Ordered so the saved manifest diffs cleanly.
+        std::map<std::string, ManifestEntry> m_entries;
+    };
+
+    struct CookReport {
+        size_t cooked = 0;
+        size_t upToDate = 0;
+        // Assets left in their source form, with the reason.
+        std::vector<std::string> skipped;
+        size_t removed = 0;
+        // One message per asset that failed to cook.
+        std::vector<std::string> errors;
+    };
+
+    /**
+     * @class AssetCooker
+     * @brief Cooks the assets of a source tree into an output tree, in
+     * parallel, skipping those whose artifact is up to date.
+     */
+    class AssetCooker {
+    public:
+        AssetCooker(std::string sourceRoot, std::string outputRoot, std::vector<CookRule> rules);
+
+        /**
+         * @brief Every file under `directories`, relative to the source root,
+         * that one of the rules cooks. Sorted.
+         */
+        std::vector<std::string> findSources(const std::vector<std::string>& directories) const;
+
+        /**
+         * @brief Cook the stale assets among `sources` on `pool` or the shared
+         * ThreadPool, and update the manifest. Artifacts of assets that are no
+         * longer in `sources` are deleted.
+         * @param force Cook every asset, even those that are up to date.
+         */
+        CookReport cook(const std::vector<std::string>& sources, bool force = false, ThreadPool* pool = nullptr);
+
+        std::string getManifestPath() const { return m_outputRoot + "/cook_manifest.json"; }
+
+    private:
+        std::string m_sourceRoot;
+        std::string m_outputRoot;
+        std::vector<CookRule> m_rules;
+
+        const CookRule* findRule(const std::string& source) const;
+    };
+}
+
+#endif
@@ -0,0 +1,94 @@
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <algorithm>
+#include <stdexcept>
+
+#include "cook_rules.hpp"
+#include "asset_path.hpp"
+#include "assimp_import.hpp"
+#include "config_manager.hpp"
+#include "cooked_model.hpp"
+#include "hash.hpp"
+#include "mesh_codec.hpp"
+
+namespace {
+
+void addTextures(const aiMaterial& material, aiTextureType assimpType, TextureType type,
+                 std::vector<IO::CookedTexture>& textures) {
+    for (unsigned int i = 0; i < material.GetTextureCount(assimpType); i++) {
+        aiString path;
+        material.GetTexture(assimpType, i, &path);
+        // Images are cooked next to the model, under the same relative path.
+        std::string cooked = Cook::getArtifactPath(path.C_Str());
+        textures.push_back({type, cooked.empty() ? std::string(path.C_Str()) : cooked});
+    }
+}
+
+void addNode(const aiNode& node, const aiScene& scene, int32_t parent, std::vector<int32_t>& sceneMeshToMesh,
+             IO::CookedModel& model) {
+    uint32_t nodeIndex = static_cast<uint32_t>(model.nodes.size());
+    model.nodes.push_back({node.mName.C_Str(), parent, AssimpImport::toGlm(node.mTransformation)});
+
+    for (unsigned int i = 0; i < node.mNumMeshes; i++) {
+        unsigned int sceneMesh = node.mMeshes[i];
+        // Each aiMesh is stored once, further references only add an instance.
+        if (sceneMeshToMesh[sceneMesh] < 0) {
+            const aiMesh& source = *scene.mMeshes[sceneMesh];
+            IO::CookedMesh mesh;
+            mesh.vertices = AssimpImport::readVertices(source);
+            mesh.indices = AssimpImport::readIndices(source);
+            MeshCodec::optimizeVertexOrder(mesh.vertices, mesh.indices);
+            if (source.mMaterialIndex < scene.mNumMaterials) {
+                const aiMaterial& material = *scene.mMaterials[source.mMaterialIndex];
+                addTextures(material, aiTextureType_DIFFUSE, TextureType::DIFFUSE, mesh.textures);
+                addTextures(material, aiTextureType_SPECULAR, TextureType::SPECULAR, mesh.textures);
+            }
+            sceneMeshToMesh[sceneMesh] = static_cast<int32_t>(model.meshes.size());
+            model.meshes.push_back(std::move(mesh));
+        }
+        model.instances.push_back({static_cast<uint32_t>(sceneMeshToMesh[sceneMesh]), nodeIndex});
+    }
+
+    for (unsigned int i = 0; i < node.mNumChildren; i++)
+        addNode(*node.mChildren[i], scene, static_cast<int32_t>(nodeIndex), sceneMeshToMesh, model);
+}
+
+}
+
+namespace Cook {
+
+uint64_t getModelSettingsHash(const std::string& source) {
+    ImportProfile profile = ConfigurationManager::getInstance()->getImportProfile(source);
+    // Only the steps that change the imported geometry.
+    const bool steps[] = {profile.flipUVs, profile.weldVertices, profile.generateTangents, profile.mergeMeshes,
+                          profile.findInstances, profile.removeDegenerates, profile.removeRedundantMaterials,
+                          profile.optimizeCache};
+    return Hash::fnv1a(static_cast<const void*>(steps), sizeof(steps));
+}
+
+std::vector<std::string> cookModel(const CookJob& job) {
+    ImportProfile profile = ConfigurationManager::getInstance()->getImportProfile(job.source);
+    Assimp::Importer importer;
+    const aiScene* scene = AssimpImport::readFile(importer, job.sourcePath, profile);
+    if (scene && scene->mRootNode) {
+        unsigned int postProcessFlags = AssimpImport::getPostProcessFlags(profile);
+        if (postProcessFlags != 0) scene = importer.ApplyPostProcessing(postProcessFlags);
+    }
+    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+        throw std::runtime_error(std::string("Assimp import failed: ") + importer.GetErrorString());
+
+    bool skinned = scene->HasAnimations();
+    for (unsigned int i = 0; i < scene->mNumMeshes; i++) skinned = skinned || scene->mMeshes[i]->HasBones();
+    if (skinned) throw AssetSkipped("skinned and animated models are imported from source");
+
+    IO::CookedModel model;
+    std::vector<int32_t> sceneMeshToMesh(scene->mNumMeshes, -1);
+    addNode(*scene->mRootNode, *scene, -1, sceneMeshToMesh, model);
+    // Keep instances of the same mesh adjacent, as Model does.
+    std::stable_sort(model.instances.begin(), model.instances.end(),
+        [](const IO::CookedInstance& a, const IO::CookedInstance& b) { return a.mesh < b.mesh; });
+    IO::writeCookedModel(job.artifactPath, model);
+    return {};
+}
+
+}
@@ -0,0 +1,86 @@
+#include <stb_image.h>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "cook_rules.hpp"
+#include "asset_path.hpp"
+#include "cooked_image.hpp"
+#include "mtl_parser.hpp"
+#include "shader_preprocessor.hpp"
+
+namespace {
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) throw std::runtime_error("Cannot open file: " + path);
+    std::stringstream stream;
+    stream << file.rdbuf();
+    return stream.str();
+}
+
+void writeFile(const std::string& path, const std::string& content) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) throw std::runtime_error("Cannot open file for writing: " + path);
+    file << content;
+    if (!file) throw std::runtime_error("Cannot write file: " + path);
+}
+
+// Path of `file` relative to the source root, `file` being as opened while
+// cooking, i.e. prefixed by the source root.
+std::string toSourceRelative(const std::string& file, const std::string& sourceRoot) {
+    std::string normalized = AssetPath::normalize(file);
+    if (sourceRoot == ".") return normalized;
+    std::string prefix = AssetPath::normalize(sourceRoot) + '/';
+    return normalized.compare(0, prefix.size(), prefix) == 0 ? normalized.substr(prefix.size()) : normalized;
+}
+
+}
+
+namespace Cook {
+
+std::vector<std::string> cookShader(const CookJob& job) {
+    std::vector<std::string> includes;
+    std::string source = ShaderPreprocessor::stripComments(ShaderPreprocessor::expandIncludes(job.sourcePath, &includes));
+    writeFile(job.artifactPath, source);
+
+    std::vector<std::string> dependencies;
+    for (const std::string& include : includes) dependencies.push_back(toSourceRelative(include, job.sourceRoot));
+    return dependencies;
+}
+
+std::vector<std::string> cookMaterialLibrary(const CookJob& job) {
+    std::string source = readFile(job.sourcePath);
+    // Reports what the engine would skip, at cook time rather than on every launch.
+    IO::parseMTLSource(source, job.source);
+
+    std::string out;
+    std::istringstream lines(source);
+    std::string line;
+    while (std::getline(lines, line)) {
+        line = line.substr(0, line.find('#'));
+        size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) continue;
+        size_t end = line.find_last_not_of(" \t\r");
+        out += line.substr(begin, end - begin + 1);
+        out += '\n';
+    }
+    writeFile(job.artifactPath, out);
+    return {};
+}
+
+std::vector<std::string> cookTexture(const CookJob& job) {
+    int width, height, components;
+    unsigned char* pixels = stbi_load(job.sourcePath.c_str(), &width, &height, &components, 0);
+    if (!pixels) throw std::runtime_error(std::string("Cannot decode image: ") + stbi_failure_reason());
+    try {
+        IO::writeCookedImage(job.artifactPath, pixels, width, height, components);
+    } catch (...) {
+        stbi_image_free(pixels);
+        throw;
+    }
+    stbi_image_free(pixels);
+    return {};
+}
+
+}
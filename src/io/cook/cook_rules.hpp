@@ -0,0 +1,41 @@
+#ifndef COOK_RULES_H_
+#define COOK_RULES_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <asset_cook.hpp>
+
+/**
+ * Cook functions of each kind of source asset, see Cook::CookRule.
+ */
+namespace Cook {
+
+    /**
+     * @brief Shader with its includes expanded and its comments removed.
+     * Depends on the files it includes.
+     */
+    std::vector<std::string> cookShader(const CookJob& job);
+
+    /**
+     * @brief MTL library checked by the engine's parser and written back
+     * without comments or blank lines.
+     */
+    std::vector<std::string> cookMaterialLibrary(const CookJob& job);
+
+    /**
+     * @brief Image decoded into a ".ltex" file with its mip chain.
+     */
+    std::vector<std::string> cookTexture(const CookJob& job);
+
+    /**
+     * @brief Model imported through Assimp with its import profile, stored as
+     * a ".lmodel" file. Texture references point at the cooked textures.
+     * @throws AssetSkipped for skinned or animated models, which keep being
+     * imported from source.
+     */
+    std::vector<std::string> cookModel(const CookJob& job);
+    uint64_t getModelSettingsHash(const std::string& source);
+}
+
+#endif
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "cooked_image.hpp"
+
+namespace {
+
+constexpr uint32_t IMAGE_MAGIC = 0x5845544C; // "LTEX"
+constexpr uint32_t IMAGE_VERSION = 1;
+
+struct ImageHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t components;
+    uint32_t levelCount;
+};
+
+size_t getLevelBytes(int width, int height, int components) {
+    return static_cast<size_t>(width) * height * components;
+}
+
+int countLevels(int width, int height) {
+    int levels = 1;
+    while (std::max(width, height) > 1) {
+        width = std::max(width / 2, 1);
+        height = std::max(height / 2, 1);
+        levels++;
+    }
+    return levels;
+}
+
+// Average of the 2x2 texels under each destination texel; an odd last row or
+// column folds into its neighbour.
+void downsample(const unsigned char* source, int width, int height, int components, unsigned char* destination) {
+    int halfWidth = std::max(width / 2, 1);
+    int halfHeight = std::max(height / 2, 1);
+    for (int y = 0; y < halfHeight; y++) {
+        int y0 = std::min(y * 2, height - 1);
+        int y1 = std::min(y * 2 + 1, height - 1);
+        for (int x = 0; x < halfWidth; x++) {
+            int x0 = std::min(x * 2, width - 1);
+            int x1 = std::min(x * 2 + 1, width - 1);
+            for (int c = 0; c < components; c++) {
+                unsigned int sum = source[(static_cast<size_t>(y0) * width + x0) * components + c] +
+                                   source[(static_cast<size_t>(y0) * width + x1) * components + c] +
+                                   source[(static_cast<size_t>(y1) * width + x0) * components + c] +
+                                   source[(static_cast<size_t>(y1) * width + x1) * components + c];
+                destination[(static_cast<size_t>(y) * halfWidth + x) * components + c] =
+                    static_cast<unsigned char>((sum + 2) / 4);
+            }
+        }
+    }
+}
+
+}
+
+namespace IO {
+
+std::vector<unsigned char> encodeCookedImage(const unsigned char* pixels, int width, int height, int components) {
+    if (width <= 0 || height <= 0 || components < 1 || components > 4)
+        throw std::invalid_argument("Invalid image size");
+
+    ImageHeader header{IMAGE_MAGIC, IMAGE_VERSION, static_cast<uint32_t>(width), static_cast<uint32_t>(height),
+                       static_cast<uint32_t>(components), static_cast<uint32_t>(countLevels(width, height))};
+    size_t total = sizeof(ImageHeader);
+    for (int level = 0, w = width, h = height; level < static_cast<int>(header.levelCount); level++) {
+        total += getLevelBytes(w, h, components);
+        w = std::max(w / 2, 1);
+        h = std::max(h / 2, 1);
+    }
+
+    std::vector<unsigned char> bytes(total);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    unsigned char* level = bytes.data() + sizeof(header);
+    std::memcpy(level, pixels, getLevelBytes(width, height, components));
+    for (uint32_t i = 1; i < header.levelCount; i++) {
+        unsigned char* next = level + getLevelBytes(width, height, components);
+        downsample(level, width, height, components, next);
+        level = next;
+        width = std::max(width / 2, 1);
+        height = std::max(height / 2, 1);
+    }
+    return bytes;
+}
+
+void writeCookedImage(const std::string& path, const unsigned char* pixels, int width, int height, int components) {
+    std::vector<unsigned char> bytes = encodeCookedImage(pixels, width, height, components);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) throw std::runtime_error("Cannot open file for writing: " + path);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file) throw std::runtime_error("Cannot write file: " + path);
+}
+
+CookedImage::CookedImage(const std::string& path) : m_file(VirtualFileSystem::getInstance().open(path)) {
+    ImageHeader header;
+    if (m_file.size() < sizeof(header)) throw std::runtime_error("Not a cooked image: " + path);
+    std::memcpy(&header, m_file.data(), sizeof(header));
+    if (header.magic != IMAGE_MAGIC) throw std::runtime_error("Not a cooked image: " + path);
+    if (header.version != IMAGE_VERSION)
+        throw std::runtime_error("Unsupported cooked image version " + std::to_string(header.version));
+    if (header.width == 0 || header.height == 0 || header.components < 1 || header.components > 4 ||
+        header.width > 65536 || header.height > 65536 ||
+        header.levelCount != static_cast<uint32_t>(countLevels(header.width, header.height)))
+        throw std::runtime_error("Invalid cooked image: " + path);
+
+    m_width = static_cast<int>(header.width);
+    m_height = static_cast<int>(header.height);
+    m_components = static_cast<int>(header.components);
+    size_t offset = sizeof(header);
+    for (int level = 0, w = m_width, h = m_height; level < static_cast<int>(header.levelCount); level++) {
+        size_t bytes = getLevelBytes(w, h, m_components);
+        if (bytes > m_file.size() - offset) throw std::runtime_error("Truncated cooked image: " + path);
+        m_levels.push_back(m_file.getBytes().subspan(offset, bytes));
+        offset += bytes;
+        w = std::max(w / 2, 1);
+        h = std::max(h / 2, 1);
+    }
+}
+
+}
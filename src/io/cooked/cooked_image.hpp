@@ -0,0 +1,48 @@
+#ifndef COOKED_IMAGE_H_
+#define COOKED_IMAGE_H_
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+#include <virtual_file_system.hpp>
+
+namespace IO {
+
+    /**
+     * @brief Encode 8-bit `pixels` as a ".ltex" file: the image and its full
+     * mip chain, box filtered, stored uncompressed so that loading is a single
+     * upload per level without decoding or mipmap generation.
+     */
+    std::vector<unsigned char> encodeCookedImage(const unsigned char* pixels, int width, int height, int components);
+    /**
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void writeCookedImage(const std::string& path, const unsigned char* pixels, int width, int height,
+                          int components);
+
+    /**
+     * @class CookedImage
+     * @brief Memory-mapped ".ltex" file, loose or in an archive. Levels are views into the mapping.
+     */
+    class CookedImage {
+    public:
+        /**
+         * @throws std::runtime_error if the file cannot be read or is malformed.
+         */
+        explicit CookedImage(const std::string& path);
+
+        int getWidth() const { return m_width; }
+        int getHeight() const { return m_height; }
+        int getComponents() const { return m_components; }
+        int getLevelCount() const { return static_cast<int>(m_levels.size()); }
+        std::span<const unsigned char> getLevel(int level) const { return m_levels[level]; }
+
+    private:
+        FileData m_file;
+        int m_width{0}, m_height{0}, m_components{0};
+        std::vector<std::span<const unsigned char>> m_levels;
+    };
+}
+
+#endif
@@ -0,0 +1,210 @@
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "cooked_model.hpp"
+#include "mesh_codec.hpp"
+#include "virtual_file_system.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+
+constexpr uint32_t MODEL_MAGIC = 0x4C444D4C; // "LMDL"
+constexpr uint32_t MODEL_VERSION = 1;
+
+constexpr uint32_t MESH_SKINNED = 1u << 0;
+
+class Writer {
+public:
+    std::vector<unsigned char> bytes;
+
+    template <typename T>
+    void put(const T& value) {
+        const unsigned char* begin = reinterpret_cast<const unsigned char*>(&value);
+        bytes.insert(bytes.end(), begin, begin + sizeof(T));
+    }
+
+    void putString(const std::string& value) {
+        put(static_cast<uint32_t>(value.size()));
+        bytes.insert(bytes.end(), value.begin(), value.end());
+    }
+
+    void putBlob(const std::vector<unsigned char>& blob) {
+        put(static_cast<uint64_t>(blob.size()));
+        bytes.insert(bytes.end(), blob.begin(), blob.end());
+    }
+};
+
+class Reader {
+public:
+    explicit Reader(std::span<const unsigned char> bytes) : m_bytes(bytes) {}
+
+    template <typename T>
+    T get() {
+        T value;
+        std::memcpy(&value, take(sizeof(T)).data(), sizeof(T));
+        return value;
+    }
+
+    std::string getString() {
+        std::span<const unsigned char> characters = take(get<uint32_t>());
+        return std::string(characters.begin(), characters.end());
+    }
+
+    std::span<const unsigned char> getBlob() {
+        uint64_t size = get<uint64_t>();
+        if (size > m_bytes.size() - m_offset) throw std::runtime_error("Truncated cooked model");
+        return take(static_cast<size_t>(size));
+    }
+
+    // Element count about to be read, checked against the bytes left so a
+    // corrupt count cannot make us allocate gigabytes.
+    uint32_t getCount(size_t minimumElementSize) {
+        uint32_t count = get<uint32_t>();
+        if (count > (m_bytes.size() - m_offset) / minimumElementSize)
+            throw std::runtime_error("Truncated cooked model");
+        return count;
+    }
+
+private:
+    std::span<const unsigned char> m_bytes;
+    size_t m_offset{0};
+
+    std::span<const unsigned char> take(size_t size) {
+        if (size > m_bytes.size() - m_offset) throw std::runtime_error("Truncated cooked model");
+        std::span<const unsigned char> result = m_bytes.subspan(m_offset, size);
+        m_offset += size;
+        return result;
+    }
+};
+
+}
+
+namespace IO {
+
+std::vector<unsigned char> serializeCookedModel(const CookedModel& model) {
+    Writer writer;
+    writer.put(MODEL_MAGIC);
+    writer.put(MODEL_VERSION);
+
+    writer.put(static_cast<uint32_t>(model.materialLibraries.size()));
+    for (const std::string& library : model.materialLibraries) writer.putString(library);
+
+    writer.put(static_cast<uint32_t>(model.meshes.size()));
+    for (const CookedMesh& mesh : model.meshes) {
+        writer.put(mesh.skinned ? MESH_SKINNED : 0u);
+        writer.putString(mesh.material);
+        writer.put(static_cast<uint32_t>(mesh.textures.size()));
+        for (const CookedTexture& texture : mesh.textures) {
+            writer.put(static_cast<uint32_t>(texture.type));
+            writer.putString(texture.path);
+        }
+        writer.putBlob(MeshCodec::encodeVertices(mesh.vertices));
+        writer.putBlob(MeshCodec::encodeIndices(mesh.indices));
+    }
+
+    writer.put(static_cast<uint32_t>(model.nodes.size()));
+    for (const CookedNode& node : model.nodes) {
+        writer.putString(node.name);
+        writer.put(node.parent);
+        for (int column = 0; column < 4; column++)
+            for (int row = 0; row < 4; row++) writer.put(node.localTransform[column][row]);
+    }
+
+    writer.put(static_cast<uint32_t>(model.instances.size()));
+    for (const CookedInstance& instance : model.instances) {
+        writer.put(instance.mesh);
+        writer.put(instance.node);
+    }
+    return std::move(writer.bytes);
+}
+
+void writeCookedModel(const std::string& path, const CookedModel& model) {
+    std::vector<unsigned char> bytes = serializeCookedModel(model);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) throw std::runtime_error("Cannot open file for writing: " + path);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file) throw std::runtime_error("Cannot write file: " + path);
+}
+
+CookedModel parseCookedModel(std::span<const unsigned char> bytes, ThreadPool* pool) {
+    Reader reader(bytes);
+    if (reader.get<uint32_t>() != MODEL_MAGIC) throw std::runtime_error("Not a cooked model");
+    uint32_t version = reader.get<uint32_t>();
+    if (version != MODEL_VERSION)
+        throw std::runtime_error("Unsupported cooked model version " + std::to_string(version));
+
+    CookedModel model;
+    model.materialLibraries.resize(reader.getCount(sizeof(uint32_t)));
+    for (std::string& library : model.materialLibraries) library = reader.getString();
+
+    // Read the mesh headers first, the compressed streams are decoded below.
+    std::vector<std::span<const unsigned char>> encodedVertices;
+    std::vector<std::span<const unsigned char>> encodedIndices;
+    model.meshes.resize(reader.getCount(3 * sizeof(uint32_t) + 2 * sizeof(uint64_t)));
+    for (CookedMesh& mesh : model.meshes) {
+        mesh.skinned = (reader.get<uint32_t>() & MESH_SKINNED) != 0;
+        mesh.material = reader.getString();
+        mesh.textures.resize(reader.getCount(2 * sizeof(uint32_t)));
+        for (CookedTexture& texture : mesh.textures) {
+            uint32_t type = reader.get<uint32_t>();
+            if (type > static_cast<uint32_t>(TextureType::SPECULAR))
+                throw std::runtime_error("Invalid texture type in cooked model");
+            texture.type = static_cast<TextureType>(type);
+            texture.path = reader.getString();
+        }
+        encodedVertices.push_back(reader.getBlob());
+        encodedIndices.push_back(reader.getBlob());
+        mesh.vertices.resize(MeshCodec::getVertexCount(encodedVertices.back()));
+        mesh.indices.resize(MeshCodec::getIndexCount(encodedIndices.back()));
+    }
+
+    model.nodes.resize(reader.getCount(sizeof(uint32_t) + sizeof(int32_t) + 16 * sizeof(float)));
+    for (size_t i = 0; i < model.nodes.size(); i++) {
+        CookedNode& node = model.nodes[i];
+        node.name = reader.getString();
+        node.parent = reader.get<int32_t>();
+        if (node.parent >= static_cast<int32_t>(i)) throw std::runtime_error("Cooked model node before its parent");
+        for (int column = 0; column < 4; column++)
+            for (int row = 0; row < 4; row++) node.localTransform[column][row] = reader.get<float>();
+    }
+
+    model.instances.resize(reader.getCount(2 * sizeof(uint32_t)));
+    for (CookedInstance& instance : model.instances) {
+        instance.mesh = reader.get<uint32_t>();
+        instance.node = reader.get<uint32_t>();
+        if (instance.mesh >= model.meshes.size() || instance.node >= model.nodes.size())
+            throw std::runtime_error("Invalid instance in cooked model");
+    }
+
+    // One task per mesh, each decoding its blocks in parallel as well. Tasks
+    // must not throw, so the first error is kept and rethrown afterwards.
+    ThreadPool& threads = pool ? *pool : ThreadPool::getInstance();
+    std::vector<std::string> errors(model.meshes.size());
+    threads.parallelFor(model.meshes.size(), 1, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; i++) {
+            try {
+                MeshCodec::decodeVertices(encodedVertices[i], model.meshes[i].vertices, &threads);
+                MeshCodec::decodeIndices(encodedIndices[i], model.meshes[i].indices, &threads);
+                for (unsigned int index : model.meshes[i].indices) {
+                    if (index >= model.meshes[i].vertices.size())
+                        throw std::runtime_error("Index out of range");
+                }
+            } catch (const std::exception& e) {
+                errors[i] = e.what();
+            }
+        }
+    });
+    for (size_t i = 0; i < errors.size(); i++) {
+        if (!errors[i].empty())
+            throw std::runtime_error("Mesh " + std::to_string(i) + " of cooked model: " + errors[i]);
+    }
+    return model;
+}
+
+CookedModel readCookedModel(const std::string& path, ThreadPool* pool) {
+    FileData file = VirtualFileSystem::getInstance().open(path);
+    return parseCookedModel(file.getBytes(), pool);
+}
+
+}
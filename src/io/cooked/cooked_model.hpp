@@ -0,0 +1,76 @@
+#ifndef COOKED_MODEL_H_
+#define COOKED_MODEL_H_
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include <vertex.hpp>
+#include <texture.hpp>
+
+class ThreadPool;
+
+namespace IO {
+
+    struct CookedNode {
+        std::string name;
+        int32_t parent;
+        glm::mat4 localTransform;
+    };
+
+    struct CookedTexture {
+        TextureType type;
+        // Relative to the directory of the cooked file.
+        std::string path;
+    };
+
+    struct CookedMesh {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+        // Name in the MaterialRegistry, empty for the default material.
+        std::string material;
+        std::vector<CookedTexture> textures;
+        bool skinned = false;
+    };
+
+    struct CookedInstance {
+        uint32_t mesh;
+        uint32_t node;
+    };
+
+    /**
+     * @brief Scene ready to upload, as stored in a ".lmodel" file: meshes
+     * compressed with MeshCodec, nodes parent first as in Model.
+     */
+    struct CookedModel {
+        std::vector<CookedMesh> meshes;
+        std::vector<CookedNode> nodes;
+        std::vector<CookedInstance> instances;
+        // Material libraries to load before resolving mesh materials.
+        std::vector<std::string> materialLibraries;
+    };
+
+    /**
+     * @brief Encode `model`. Meshes are expected to be in the vertex order of
+     * MeshCodec::optimizeVertexOrder(), which compresses best.
+     */
+    std::vector<unsigned char> serializeCookedModel(const CookedModel& model);
+    /**
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void writeCookedModel(const std::string& path, const CookedModel& model);
+
+    /**
+     * @brief Decode a cooked model, meshes in parallel on `pool` or the shared
+     * ThreadPool.
+     * @throws std::runtime_error if `bytes` is malformed or of another version.
+     */
+    CookedModel parseCookedModel(std::span<const unsigned char> bytes, ThreadPool* pool = nullptr);
+    /**
+     * @throws std::runtime_error if the file cannot be read or is malformed.
+     */
+    CookedModel readCookedModel(const std::string& path, ThreadPool* pool = nullptr);
+}
+
+#endif
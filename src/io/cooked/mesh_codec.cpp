@@ -0,0 +1,695 @@
+#include <mesh_codec.hpp>
+#include <thread_pool.hpp>
+#include <simd.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <tuple>
+
+static constexpr uint32_t VERTEX_MAGIC = 0x5854564C; // "LVTX"
+static constexpr uint32_t INDEX_MAGIC = 0x5844494C;  // "LIDX"
+// Vertices and triangles per block. Blocks are the unit of parallel decoding.
+static constexpr uint32_t VERTEX_BLOCK_SIZE = 8192;
+static constexpr uint32_t INDEX_BLOCK_TRIANGLES = 8192;
+// Bytes of a byte plane packed at the same bit width.
+static constexpr size_t GROUP_SIZE = 16;
+// FIFO entries addressable from a 4-bit code.
+static constexpr int EDGE_FIFO_SIZE = 15;
+static constexpr int VERTEX_FIFO_SIZE = 14;
+static constexpr uint8_t CODE_NEXT = 0;
+static constexpr uint8_t CODE_EXPLICIT = 15;
+static constexpr uint8_t NO_EDGE = 15;
+static constexpr uint32_t NO_VERTEX = UINT32_MAX;
+
+// Streams stored besides positions and texture coordinates.
+enum VertexStreams : uint32_t {
+    HAS_NORMALS = 1 << 0,
+    HAS_TANGENTS = 1 << 1,
+    HAS_BONES = 1 << 2
+};
+
+namespace {
+
+struct VertexHeader {
+    uint32_t magic;
+    uint32_t vertexCount;
+    uint32_t streams;
+    uint32_t blockCount;
+    float positionMin[3];
+    float positionScale[3];
+    float uvMin[2];
+    float uvScale[2];
+};
+
+struct IndexHeader {
+    uint32_t magic;
+    uint32_t indexCount;
+    uint32_t blockCount;
+};
+
+// Decoder state at the start of an index block.
+struct IndexBlock {
+    uint32_t offset;
+    uint32_t next;
+    uint32_t last;
+};
+
+/**
+ * @brief Recent edges and vertices shared by the index encoder and decoder,
+ * most recent first.
+ */
+class IndexFifos {
+public:
+    IndexFifos() {
+        std::fill(std::begin(m_edges), std::end(m_edges), std::pair<uint32_t, uint32_t>(NO_VERTEX, NO_VERTEX));
+        std::fill(std::begin(m_vertices), std::end(m_vertices), NO_VERTEX);
+    }
+
+    void pushEdge(uint32_t a, uint32_t b) { m_edges[m_edgeHead++ & 15] = {a, b}; }
+    const std::pair<uint32_t, uint32_t>& getEdge(int i) const { return m_edges[(m_edgeHead - 1 - i) & 15]; }
+    int findEdge(uint32_t a, uint32_t b) const {
+        for (int i = 0; i < EDGE_FIFO_SIZE; i++) {
+            if (getEdge(i).first == a && getEdge(i).second == b) return i;
+        }
+        return -1;
+    }
+
+    void pushVertex(uint32_t v) { m_vertices[m_vertexHead++ & 15] = v; }
+    uint32_t getVertex(int i) const { return m_vertices[(m_vertexHead - 1 - i) & 15]; }
+    int findVertex(uint32_t v) const {
+        for (int i = 0; i < VERTEX_FIFO_SIZE; i++) {
+            if (getVertex(i) == v) return i;
+        }
+        return -1;
+    }
+
+private:
+    std::pair<uint32_t, uint32_t> m_edges[16];
+    uint32_t m_vertices[16];
+    uint32_t m_edgeHead{0};
+    uint32_t m_vertexHead{0};
+};
+
+/**
+ * @brief Bounds-checked reader over an encoded buffer.
+ */
+class Reader {
+public:
+    Reader(const unsigned char* at, const unsigned char* end) : m_at(at), m_end(end) {}
+
+    bool has(size_t bytes) const { return static_cast<size_t>(m_end - m_at) >= bytes; }
+    const unsigned char* take(size_t bytes) {
+        const unsigned char* at = m_at;
+        m_at += bytes;
+        return at;
+    }
+    bool readByte(uint8_t& value) {
+        if (!has(1)) return false;
+        value = *m_at++;
+        return true;
+    }
+    bool readVarint(uint32_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            uint8_t byte;
+            if (!readByte(byte)) return false;
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+private:
+    const unsigned char* m_at;
+    const unsigned char* m_end;
+};
+
+}
+
+template <typename T>
+static void append(std::vector<unsigned char>& out, const T& value) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+static T readAt(std::span<const unsigned char> bytes, size_t offset) {
+    if (offset > bytes.size() || bytes.size() - offset < sizeof(T))
+        throw std::runtime_error("Truncated encoded mesh buffer");
+    T value;
+    std::memcpy(&value, bytes.data() + offset, sizeof(T));
+    return value;
+}
+
+static void appendVarint(std::vector<unsigned char>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+static uint16_t zigzag16(uint16_t delta) {
+    int16_t value = static_cast<int16_t>(delta);
+    return static_cast<uint16_t>((value << 1) ^ (value >> 15));
+}
+
+static uint16_t unzigzag16(uint16_t value) {
+    return static_cast<uint16_t>((value >> 1) ^ (0u - (value & 1u)));
+}
+
+static uint32_t zigzag32(int32_t value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+static int32_t unzigzag32(uint32_t value) {
+    return static_cast<int32_t>((value >> 1) ^ (0u - (value & 1u)));
+}
+
+static uint16_t quantizeUnorm(float value, float min, float inverseScale) {
+    return static_cast<uint16_t>(std::clamp((value - min) * inverseScale + 0.5f, 0.0f, 65535.0f));
+}
+
+static uint16_t quantizeSnorm(float value) {
+    return static_cast<uint16_t>(static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f)));
+}
+
+static float dequantizeSnorm(uint16_t value) {
+    return std::max(static_cast<float>(static_cast<int16_t>(value)) / 32767.0f, -1.0f);
+}
+
+/**
+ * @brief Octahedral form of a direction: two components that cover the
+ * sphere far more evenly than x and y would.
+ */
+static void encodeOctahedral(const glm::vec3& direction, uint16_t& x, uint16_t& y) {
+    float length = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+    if (length == 0.0f) {
+        x = y = 0;
+        return;
+    }
+    float u = direction.x / length;
+    float v = direction.y / length;
+    if (direction.z < 0.0f) {
+        float foldedU = (1.0f - std::abs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+        float foldedV = (1.0f - std::abs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+        u = foldedU;
+        v = foldedV;
+    }
+    x = quantizeSnorm(u);
+    y = quantizeSnorm(v);
+}
+
+static glm::vec3 decodeOctahedral(uint16_t x, uint16_t y) {
+    glm::vec3 direction(dequantizeSnorm(x), dequantizeSnorm(y), 0.0f);
+    direction.z = 1.0f - std::abs(direction.x) - std::abs(direction.y);
+    float fold = std::max(-direction.z, 0.0f);
+    direction.x += direction.x >= 0.0f ? -fold : fold;
+    direction.y += direction.y >= 0.0f ? -fold : fold;
+    return glm::normalize(direction);
+}
+
+/**
+ * @brief Append `count` bytes as groups of 16 packed at the narrowest of 0,
+ * 2, 4 or 8 bits, preceded by the 2-bit width of every group.
+ */
+static void encodePlane(const uint8_t* bytes, size_t count, std::vector<unsigned char>& out) {
+    const size_t groups = (count + GROUP_SIZE - 1) / GROUP_SIZE;
+    const size_t header = out.size();
+    out.resize(out.size() + (groups + 3) / 4, 0);
+
+    for (size_t g = 0; g < groups; g++) {
+        uint8_t values[GROUP_SIZE] = {};
+        size_t size = std::min(GROUP_SIZE, count - g * GROUP_SIZE);
+        std::memcpy(values, bytes + g * GROUP_SIZE, size);
+        uint8_t max = *std::max_element(values, values + GROUP_SIZE);
+        uint8_t code = max == 0 ? 0 : max < 4 ? 1 : max < 16 ? 2 : 3;
+        out[header + g / 4] |= static_cast<unsigned char>(code << ((g % 4) * 2));
+
+        if (code == 1) {
+            for (size_t i = 0; i < GROUP_SIZE; i += 4)
+                out.push_back(values[i] | values[i + 1] << 2 | values[i + 2] << 4 | values[i + 3] << 6);
+        } else if (code == 2) {
+            for (size_t i = 0; i < GROUP_SIZE; i += 2)
+                out.push_back(values[i] | values[i + 1] << 4);
+        } else if (code == 3) {
+            out.insert(out.end(), values, values + GROUP_SIZE);
+        }
+    }
+}
+
+static void unpack2Bits(const unsigned char* in, uint8_t* out) {
+#ifdef LAMB_SIMD_SSE
+    int32_t packed;
+    std::memcpy(&packed, in, sizeof(packed));
+    __m128i bytes = _mm_cvtsi32_si128(packed);
+    const __m128i mask = _mm_set1_epi8(3);
+    // Shifting 16-bit lanes by at most 6 keeps the low 2 bits of each byte
+    // from that byte.
+    __m128i v0 = _mm_and_si128(bytes, mask);
+    __m128i v1 = _mm_and_si128(_mm_srli_epi16(bytes, 2), mask);
+    __m128i v2 = _mm_and_si128(_mm_srli_epi16(bytes, 4), mask);
+    __m128i v3 = _mm_and_si128(_mm_srli_epi16(bytes, 6), mask);
+    __m128i result = _mm_unpacklo_epi16(_mm_unpacklo_epi8(v0, v1), _mm_unpacklo_epi8(v2, v3));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), result);
+#else
+    for (size_t i = 0; i < GROUP_SIZE; i++) out[i] = (in[i / 4] >> ((i % 4) * 2)) & 3;
+#endif
+}
+
+static void unpack4Bits(const unsigned char* in, uint8_t* out) {
+#ifdef LAMB_SIMD_SSE
+    __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in));
+    const __m128i mask = _mm_set1_epi8(15);
+    __m128i low = _mm_and_si128(bytes, mask);
+    __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), mask);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(low, high));
+#else
+    for (size_t i = 0; i < GROUP_SIZE; i++) out[i] = (in[i / 2] >> ((i % 2) * 4)) & 15;
+#endif
+}
+
+/**
+ * @brief Inverse of encodePlane() into `out`, padded to a multiple of 16.
+ */
+static bool decodePlane(Reader& reader, size_t count, uint8_t* out) {
+    const size_t groups = (count + GROUP_SIZE - 1) / GROUP_SIZE;
+    const size_t headerSize = (groups + 3) / 4;
+    if (!reader.has(headerSize)) return false;
+    const unsigned char* header = reader.take(headerSize);
+
+    for (size_t g = 0; g < groups; g++, out += GROUP_SIZE) {
+        uint8_t code = (header[g / 4] >> ((g % 4) * 2)) & 3;
+        if (code == 0) {
+            std::memset(out, 0, GROUP_SIZE);
+            continue;
+        }
+        const size_t size = GROUP_SIZE >> (3 - code);
+        if (!reader.has(size)) return false;
+        const unsigned char* payload = reader.take(size);
+        if (code == 1) unpack2Bits(payload, out);
+        else if (code == 2) unpack4Bits(payload, out);
+        else std::memcpy(out, payload, GROUP_SIZE);
+    }
+    return true;
+}
+
+static int getComponentCount(uint32_t streams) {
+    int count = 5;
+    if (streams & HAS_NORMALS) count += 2;
+    if (streams & HAS_TANGENTS) count += 4;
+    if (streams & HAS_BONES) count += 8;
+    return count;
+}
+
+/**
+ * @brief Quantized components of `vertex`, in stream order.
+ */
+static void quantizeVertex(const Vertex& vertex, const VertexHeader& header, const float inverseScale[5], uint16_t* out) {
+    for (int i = 0; i < 3; i++) *out++ = quantizeUnorm(vertex.position[i], header.positionMin[i], inverseScale[i]);
+    for (int i = 0; i < 2; i++) *out++ = quantizeUnorm(vertex.textureCoordinates[i], header.uvMin[i], inverseScale[3 + i]);
+    if (header.streams & HAS_NORMALS) {
+        encodeOctahedral(vertex.normal, out[0], out[1]);
+        out += 2;
+    }
+    if (header.streams & HAS_TANGENTS) {
+        encodeOctahedral(vertex.tangent, out[0], out[1]);
+        encodeOctahedral(vertex.biTangent, out[2], out[3]);
+        out += 4;
+    }
+    if (header.streams & HAS_BONES) {
+        for (int i = 0; i < MAX_BONE_INFLUENCE; i++) *out++ = static_cast<uint16_t>(vertex.m_BoneIDs[i]);
+        for (int i = 0; i < MAX_BONE_INFLUENCE; i++) *out++ = quantizeUnorm(vertex.m_Weights[i], 0.0f, 65535.0f);
+    }
+}
+
+static void encodeVertexBlock(std::span<const Vertex> vertices, const VertexHeader& header,
+                              const float inverseScale[5], std::vector<unsigned char>& out) {
+    const int components = getComponentCount(header.streams);
+    const size_t count = vertices.size();
+    std::vector<uint16_t> quantized(count * components);
+    for (size_t i = 0; i < count; i++)
+        quantizeVertex(vertices[i], header, inverseScale, &quantized[i * components]);
+
+    std::vector<uint8_t> low(count), high(count);
+    for (int c = 0; c < components; c++) {
+        uint16_t previous = 0;
+        for (size_t i = 0; i < count; i++) {
+            uint16_t value = quantized[i * components + c];
+            uint16_t delta = zigzag16(static_cast<uint16_t>(value - previous));
+            previous = value;
+            low[i] = static_cast<uint8_t>(delta);
+            high[i] = static_cast<uint8_t>(delta >> 8);
+        }
+        encodePlane(low.data(), count, out);
+        encodePlane(high.data(), count, out);
+    }
+}
+
+/**
+ * @brief Decode the next component of the block into `values`.
+ */
+static bool decodeComponent(Reader& reader, size_t count, std::vector<uint8_t>& low, std::vector<uint8_t>& high,
+                            uint16_t* values) {
+    if (!decodePlane(reader, count, low.data()) || !decodePlane(reader, count, high.data())) return false;
+    uint16_t previous = 0;
+    for (size_t i = 0; i < count; i++) {
+        previous = static_cast<uint16_t>(previous + unzigzag16(static_cast<uint16_t>(low[i] | high[i] << 8)));
+        values[i] = previous;
+    }
+    return true;
+}
+
+static bool decodeVertexBlock(Reader reader, const VertexHeader& header, std::span<Vertex> out) {
+    const size_t count = out.size();
+    const size_t padded = (count + GROUP_SIZE - 1) / GROUP_SIZE * GROUP_SIZE;
+    std::vector<uint8_t> low(padded), high(padded);
+    // One attribute at a time, so its components stay in cache.
+    std::vector<uint16_t> values(count * 4);
+    uint16_t* a = values.data();
+    uint16_t* b = a + count;
+    uint16_t* c = b + count;
+    uint16_t* d = c + count;
+    auto decode = [&](uint16_t* target) { return decodeComponent(reader, count, low, high, target); };
+
+    if (!decode(a) || !decode(b) || !decode(c)) return false;
+    for (size_t i = 0; i < count; i++) {
+        out[i].position = glm::vec3(header.positionMin[0] + a[i] * header.positionScale[0],
+                                    header.positionMin[1] + b[i] * header.positionScale[1],
+                                    header.positionMin[2] + c[i] * header.positionScale[2]);
+    }
+    if (!decode(a) || !decode(b)) return false;
+    for (size_t i = 0; i < count; i++) {
+        out[i].textureCoordinates = glm::vec2(header.uvMin[0] + a[i] * header.uvScale[0],
+                                              header.uvMin[1] + b[i] * header.uvScale[1]);
+    }
+
+    if (header.streams & HAS_NORMALS) {
+        if (!decode(a) || !decode(b)) return false;
+        for (size_t i = 0; i < count; i++) out[i].normal = decodeOctahedral(a[i], b[i]);
+    } else {
+        for (Vertex& vertex : out) vertex.normal = glm::vec3(0.0f);
+    }
+
+    if (header.streams & HAS_TANGENTS) {
+        if (!decode(a) || !decode(b) || !decode(c) || !decode(d)) return false;
+        for (size_t i = 0; i < count; i++) {
+            out[i].tangent = decodeOctahedral(a[i], b[i]);
+            out[i].biTangent = decodeOctahedral(c[i], d[i]);
+        }
+    } else {
+        for (Vertex& vertex : out) vertex.tangent = vertex.biTangent = glm::vec3(0.0f);
+    }
+
+    for (int influence = 0; influence < MAX_BONE_INFLUENCE; influence++) {
+        if (!(header.streams & HAS_BONES)) {
+            for (Vertex& vertex : out) vertex.m_BoneIDs[influence] = 0;
+        } else {
+            if (!decode(a)) return false;
+            for (size_t i = 0; i < count; i++) out[i].m_BoneIDs[influence] = a[i];
+        }
+    }
+    for (int influence = 0; influence < MAX_BONE_INFLUENCE; influence++) {
+        if (!(header.streams & HAS_BONES)) {
+            for (Vertex& vertex : out) vertex.m_Weights[influence] = 0.0f;
+        } else {
+            if (!decode(a)) return false;
+            for (size_t i = 0; i < count; i++) out[i].m_Weights[influence] = a[i] / 65535.0f;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 4-bit code of the vertex `v`, appending its value if explicit.
+ */
+static uint8_t encodeVertexCode(uint32_t v, IndexFifos& fifos, uint32_t& next, uint32_t& last,
+                                std::vector<unsigned char>& explicitValues) {
+    if (v == next) {
+        next++;
+        fifos.pushVertex(v);
+        return CODE_NEXT;
+    }
+    int fifo = fifos.findVertex(v);
+    if (fifo >= 0) return static_cast<uint8_t>(fifo + 1);
+
+    appendVarint(explicitValues, zigzag32(static_cast<int32_t>(v - last)));
+    last = v;
+    fifos.pushVertex(v);
+    return CODE_EXPLICIT;
+}
+
+static bool decodeVertexCode(uint8_t code, Reader& reader, IndexFifos& fifos, uint32_t& next, uint32_t& last,
+                             uint32_t& v) {
+    if (code == CODE_NEXT) {
+        v = next++;
+        fifos.pushVertex(v);
+        return true;
+    }
+    if (code != CODE_EXPLICIT) {
+        v = fifos.getVertex(code - 1);
+        return v != NO_VERTEX;
+    }
+    uint32_t delta;
+    if (!reader.readVarint(delta)) return false;
+    v = last + static_cast<uint32_t>(unzigzag32(delta));
+    last = v;
+    fifos.pushVertex(v);
+    return true;
+}
+
+static bool decodeIndexBlock(Reader reader, const IndexBlock& block, std::span<unsigned int> out) {
+    IndexFifos fifos;
+    uint32_t next = block.next;
+    uint32_t last = block.last;
+    for (size_t i = 0; i < out.size(); i += 3) {
+        uint8_t code;
+        if (!reader.readByte(code)) return false;
+        uint32_t a, b, c;
+        const uint8_t edge = code >> 4;
+        if (edge != NO_EDGE) {
+            std::tie(a, b) = fifos.getEdge(edge);
+            if (a == NO_VERTEX || !decodeVertexCode(code & 15, reader, fifos, next, last, c)) return false;
+        } else {
+            uint8_t codes;
+            if (!decodeVertexCode(code & 15, reader, fifos, next, last, a) || !reader.readByte(codes) ||
+                !decodeVertexCode(codes >> 4, reader, fifos, next, last, b) ||
+                !decodeVertexCode(codes & 15, reader, fifos, next, last, c))
+                return false;
+        }
+        out[i] = a;
+        out[i + 1] = b;
+        out[i + 2] = c;
+        fifos.pushEdge(b, a);
+        fifos.pushEdge(c, b);
+        fifos.pushEdge(a, c);
+    }
+    return true;
+}
+
+namespace MeshCodec {
+
+    void optimizeVertexOrder(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+        std::vector<uint32_t> remap(vertices.size(), NO_VERTEX);
+        std::vector<Vertex> ordered;
+        ordered.reserve(vertices.size());
+        for (unsigned int& index : indices) {
+            if (remap[index] == NO_VERTEX) {
+                remap[index] = static_cast<uint32_t>(ordered.size());
+                ordered.push_back(vertices[index]);
+            }
+            index = remap[index];
+        }
+        vertices = std::move(ordered);
+    }
+
+    std::vector<unsigned char> encodeVertices(std::span<const Vertex> vertices) {
+        VertexHeader header{};
+        header.magic = VERTEX_MAGIC;
+        header.vertexCount = static_cast<uint32_t>(vertices.size());
+        header.blockCount = (header.vertexCount + VERTEX_BLOCK_SIZE - 1) / VERTEX_BLOCK_SIZE;
+
+        glm::vec3 positionMin(0.0f), positionMax(0.0f);
+        glm::vec2 uvMin(0.0f), uvMax(0.0f);
+        if (!vertices.empty()) {
+            positionMin = positionMax = vertices[0].position;
+            uvMin = uvMax = vertices[0].textureCoordinates;
+        }
+        for (const Vertex& vertex : vertices) {
+            for (int i = 0; i < 3; i++) {
+                positionMin[i] = std::min(positionMin[i], vertex.position[i]);
+                positionMax[i] = std::max(positionMax[i], vertex.position[i]);
+            }
+            for (int i = 0; i < 2; i++) {
+                uvMin[i] = std::min(uvMin[i], vertex.textureCoordinates[i]);
+                uvMax[i] = std::max(uvMax[i], vertex.textureCoordinates[i]);
+            }
+            if (vertex.normal != glm::vec3(0.0f)) header.streams |= HAS_NORMALS;
+            if (vertex.tangent != glm::vec3(0.0f) || vertex.biTangent != glm::vec3(0.0f)) header.streams |= HAS_TANGENTS;
+            for (int i = 0; i < MAX_BONE_INFLUENCE; i++) {
+                if (vertex.m_BoneIDs[i] != 0 || vertex.m_Weights[i] != 0.0f) header.streams |= HAS_BONES;
+            }
+        }
+
+        float inverseScale[5];
+        for (int i = 0; i < 3; i++) {
+            header.positionMin[i] = positionMin[i];
+            header.positionScale[i] = (positionMax[i] - positionMin[i]) / 65535.0f;
+            inverseScale[i] = header.positionScale[i] > 0.0f ? 1.0f / header.positionScale[i] : 0.0f;
+        }
+        for (int i = 0; i < 2; i++) {
+            header.uvMin[i] = uvMin[i];
+            header.uvScale[i] = (uvMax[i] - uvMin[i]) / 65535.0f;
+            inverseScale[3 + i] = header.uvScale[i] > 0.0f ? 1.0f / header.uvScale[i] : 0.0f;
+        }
+
+        std::vector<unsigned char> out;
+        append(out, header);
+        const size_t offsets = out.size();
+        out.resize(out.size() + (header.blockCount + 1) * sizeof(uint32_t));
+        const size_t data = out.size();
+        for (uint32_t block = 0; block <= header.blockCount; block++) {
+            uint32_t offset = static_cast<uint32_t>(out.size() - data);
+            std::memcpy(out.data() + offsets + block * sizeof(uint32_t), &offset, sizeof(offset));
+            if (block == header.blockCount) break;
+
+            size_t first = static_cast<size_t>(block) * VERTEX_BLOCK_SIZE;
+            size_t count = std::min<size_t>(VERTEX_BLOCK_SIZE, vertices.size() - first);
+            encodeVertexBlock(vertices.subspan(first, count), header, inverseScale, out);
+        }
+        return out;
+    }
+
+    size_t getVertexCount(std::span<const unsigned char> encoded) {
+        VertexHeader header = readAt<VertexHeader>(encoded, 0);
+        if (header.magic != VERTEX_MAGIC) throw std::runtime_error("Not an encoded vertex buffer");
+        return header.vertexCount;
+    }
+
+    void decodeVertices(std::span<const unsigned char> encoded, std::span<Vertex> out, ThreadPool* pool) {
+        VertexHeader header = readAt<VertexHeader>(encoded, 0);
+        if (header.magic != VERTEX_MAGIC) throw std::runtime_error("Not an encoded vertex buffer");
+        if (out.size() != header.vertexCount) throw std::invalid_argument("Vertex buffer size differs from the encoded one");
+        if (header.blockCount != (header.vertexCount + VERTEX_BLOCK_SIZE - 1) / VERTEX_BLOCK_SIZE)
+            throw std::runtime_error("Malformed encoded vertex buffer");
+
+        const size_t data = sizeof(VertexHeader) + (header.blockCount + 1) * sizeof(uint32_t);
+        std::vector<uint32_t> offsets(header.blockCount + 1);
+        for (uint32_t block = 0; block <= header.blockCount; block++) {
+            offsets[block] = readAt<uint32_t>(encoded, sizeof(VertexHeader) + block * sizeof(uint32_t));
+            if (offsets[block] > encoded.size() - data || (block > 0 && offsets[block] < offsets[block - 1]))
+                throw std::runtime_error("Malformed encoded vertex buffer");
+        }
+
+        std::atomic<bool> failed{false};
+        ThreadPool& threads = pool ? *pool : ThreadPool::getInstance();
+        threads.parallelFor(header.blockCount, 1, [&](size_t begin, size_t end, size_t) {
+            for (size_t block = begin; block < end; block++) {
+                Reader reader(encoded.data() + data + offsets[block], encoded.data() + data + offsets[block + 1]);
+                size_t first = block * VERTEX_BLOCK_SIZE;
+                size_t count = std::min<size_t>(VERTEX_BLOCK_SIZE, out.size() - first);
+                if (!decodeVertexBlock(reader, header, out.subspan(first, count))) failed = true;
+            }
+        });
+        if (failed) throw std::runtime_error("Malformed encoded vertex buffer");
+    }
+
+    std::vector<unsigned char> encodeIndices(std::span<const unsigned int> indices) {
+        if (indices.size() % 3 != 0) throw std::invalid_argument("Index buffer is not a triangle list");
+
+        IndexHeader header{INDEX_MAGIC, static_cast<uint32_t>(indices.size()), 0};
+        const size_t triangles = indices.size() / 3;
+        header.blockCount = static_cast<uint32_t>((triangles + INDEX_BLOCK_TRIANGLES - 1) / INDEX_BLOCK_TRIANGLES);
+
+        std::vector<unsigned char> out;
+        append(out, header);
+        const size_t table = out.size();
+        out.resize(out.size() + header.blockCount * sizeof(IndexBlock) + sizeof(uint32_t));
+        const size_t data = out.size();
+
+        uint32_t next = 0, last = 0;
+        std::vector<unsigned char> explicitValues;
+        for (uint32_t block = 0; block < header.blockCount; block++) {
+            IndexBlock start{static_cast<uint32_t>(out.size() - data), next, last};
+            std::memcpy(out.data() + table + block * sizeof(IndexBlock), &start, sizeof(start));
+
+            IndexFifos fifos;
+            size_t end = std::min(triangles, static_cast<size_t>(block + 1) * INDEX_BLOCK_TRIANGLES);
+            for (size_t t = static_cast<size_t>(block) * INDEX_BLOCK_TRIANGLES; t < end; t++) {
+                uint32_t a = indices[t * 3], b = indices[t * 3 + 1], c = indices[t * 3 + 2];
+                // Rotations keep the winding: look for a known edge in any of them.
+                int edge = -1;
+                for (int rotation = 0; rotation < 3 && edge < 0; rotation++) {
+                    edge = fifos.findEdge(a, b);
+                    if (edge < 0) std::tie(a, b, c) = std::make_tuple(b, c, a);
+                }
+
+                explicitValues.clear();
+                if (edge >= 0) {
+                    uint8_t code = encodeVertexCode(c, fifos, next, last, explicitValues);
+                    out.push_back(static_cast<unsigned char>(edge << 4 | code));
+                    out.insert(out.end(), explicitValues.begin(), explicitValues.end());
+                } else {
+                    // The values follow the code byte they belong to.
+                    uint8_t codeA = encodeVertexCode(a, fifos, next, last, explicitValues);
+                    out.push_back(static_cast<unsigned char>(NO_EDGE << 4 | codeA));
+                    out.insert(out.end(), explicitValues.begin(), explicitValues.end());
+                    explicitValues.clear();
+                    uint8_t codeB = encodeVertexCode(b, fifos, next, last, explicitValues);
+                    uint8_t codeC = encodeVertexCode(c, fifos, next, last, explicitValues);
+                    out.push_back(static_cast<unsigned char>(codeB << 4 | codeC));
+                    out.insert(out.end(), explicitValues.begin(), explicitValues.end());
+                }
+                fifos.pushEdge(b, a);
+                fifos.pushEdge(c, b);
+                fifos.pushEdge(a, c);
+            }
+        }
+        uint32_t size = static_cast<uint32_t>(out.size() - data);
+        std::memcpy(out.data() + table + header.blockCount * sizeof(IndexBlock), &size, sizeof(size));
+        return out;
+    }
+
+    size_t getIndexCount(std::span<const unsigned char> encoded) {
+        IndexHeader header = readAt<IndexHeader>(encoded, 0);
+        if (header.magic != INDEX_MAGIC) throw std::runtime_error("Not an encoded index buffer");
+        return header.indexCount;
+    }
+
+    void decodeIndices(std::span<const unsigned char> encoded, std::span<unsigned int> out, ThreadPool* pool) {
+        IndexHeader header = readAt<IndexHeader>(encoded, 0);
+        if (header.magic != INDEX_MAGIC) throw std::runtime_error("Not an encoded index buffer");
+        if (out.size() != header.indexCount) throw std::invalid_argument("Index buffer size differs from the encoded one");
+        const size_t triangles = header.indexCount / 3;
+        if (header.indexCount % 3 != 0 ||
+            header.blockCount != (triangles + INDEX_BLOCK_TRIANGLES - 1) / INDEX_BLOCK_TRIANGLES)
+            throw std::runtime_error("Malformed encoded index buffer");
+
+        const size_t table = sizeof(IndexHeader);
+        const size_t data = table + header.blockCount * sizeof(IndexBlock) + sizeof(uint32_t);
+        std::vector<IndexBlock> blocks(header.blockCount + 1);
+        for (uint32_t block = 0; block < header.blockCount; block++)
+            blocks[block] = readAt<IndexBlock>(encoded, table + block * sizeof(IndexBlock));
+        blocks[header.blockCount].offset = readAt<uint32_t>(encoded, table + header.blockCount * sizeof(IndexBlock));
+        for (uint32_t block = 0; block <= header.blockCount; block++) {
+            if (blocks[block].offset > encoded.size() - data || (block > 0 && blocks[block].offset < blocks[block - 1].offset))
+                throw std::runtime_error("Malformed encoded index buffer");
+        }
+
+        std::atomic<bool> failed{false};
+        ThreadPool& threads = pool ? *pool : ThreadPool::getInstance();
+        threads.parallelFor(header.blockCount, 1, [&](size_t begin, size_t end, size_t) {
+            for (size_t block = begin; block < end; block++) {
+                Reader reader(encoded.data() + data + blocks[block].offset, encoded.data() + data + blocks[block + 1].offset);
+                size_t first = block * INDEX_BLOCK_TRIANGLES * 3;
+                size_t count = std::min<size_t>(INDEX_BLOCK_TRIANGLES * 3, out.size() - first);
+                if (!decodeIndexBlock(reader, blocks[block], out.subspan(first, count))) failed = true;
+            }
+        });
+        if (failed) throw std::runtime_error("Malformed encoded index buffer");
+    }
+
+}
@@ -0,0 +1,63 @@
+#ifndef MESH_CODEC_H_
+#define MESH_CODEC_H_
+
+#include <cstddef>
+#include <span>
+#include <vector>
+#include <vertex.hpp>
+
+class ThreadPool;
+
+/**
+ * @brief Compression of vertex and index buffers for cooked assets.
+ *
+ * Vertices are quantized to 16 bits per component: positions and texture
+ * coordinates over their bounds, directions in octahedral form, weights as
+ * unorm. Each component is delta coded between consecutive vertices, and the
+ * low and high bytes of the deltas are stored as separate planes, packed in
+ * groups of 16 at 0, 2, 4 or 8 bits.
+ *
+ * Triangles are coded against a FIFO of recent edges and one of recent
+ * vertices, so that a triangle sharing an edge with a recent one usually
+ * takes a single byte. Decoded triangles keep their winding but may start
+ * from another corner.
+ *
+ * Both buffers are split into blocks coded independently, which are decoded
+ * in parallel. Encoded buffers are self-describing and little-endian.
+ */
+namespace MeshCodec {
+
+    /**
+     * @brief Renumber vertices in order of first use by `indices`, which is
+     * what the index codec codes best. Unused vertices are dropped.
+     */
+    void optimizeVertexOrder(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+    std::vector<unsigned char> encodeVertices(std::span<const Vertex> vertices);
+    /**
+     * @throws std::runtime_error if `encoded` is not an encoded vertex buffer.
+     */
+    size_t getVertexCount(std::span<const unsigned char> encoded);
+    /**
+     * @brief Decode into `out`, which holds getVertexCount() vertices, on
+     * `pool` or the shared ThreadPool.
+     * @throws std::runtime_error if `encoded` is malformed.
+     */
+    void decodeVertices(std::span<const unsigned char> encoded, std::span<Vertex> out, ThreadPool* pool = nullptr);
+
+    /**
+     * @throws std::invalid_argument if `indices` is not a triangle list.
+     */
+    std::vector<unsigned char> encodeIndices(std::span<const unsigned int> indices);
+    /**
+     * @throws std::runtime_error if `encoded` is not an encoded index buffer.
+     */
+    size_t getIndexCount(std::span<const unsigned char> encoded);
+    /**
+     * @brief Decode into `out`, which holds getIndexCount() indices.
+     * @throws std::runtime_error if `encoded` is malformed.
+     */
+    void decodeIndices(std::span<const unsigned char> encoded, std::span<unsigned int> out, ThreadPool* pool = nullptr);
+}
+
+#endif
@@ -0,0 +1,293 @@
+#include <gltf_document.hpp>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+using json = nlohmann::json;
+
+static constexpr uint32_t GLB_MAGIC = 0x46546C67;      // "glTF"
+static constexpr uint32_t GLB_CHUNK_JSON = 0x4E4F534A; // "JSON"
+static constexpr uint32_t GLB_CHUNK_BIN = 0x004E4942;  // "BIN\0"
+static constexpr size_t GLB_HEADER_SIZE = 12;
+static constexpr size_t GLB_CHUNK_HEADER_SIZE = 8;
+
+
+static uint32_t readUint32(const unsigned char* bytes) {
+    uint32_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+static int getComponentCount(const std::string& type) {
+    if (type == "SCALAR") return 1;
+    if (type == "VEC2") return 2;
+    if (type == "VEC3") return 3;
+    if (type == "VEC4" || type == "MAT2") return 4;
+    if (type == "MAT3") return 9;
+    if (type == "MAT4") return 16;
+    throw std::runtime_error("Unknown glTF accessor type: " + type);
+}
+
+static size_t getComponentSize(IO::GltfComponentType type) {
+    switch (type) {
+        case IO::GltfComponentType::BYTE:
+        case IO::GltfComponentType::UNSIGNED_BYTE: return 1;
+        case IO::GltfComponentType::SHORT:
+        case IO::GltfComponentType::UNSIGNED_SHORT: return 2;
+        case IO::GltfComponentType::UNSIGNED_INT:
+        case IO::GltfComponentType::FLOAT: return 4;
+    }
+    throw std::runtime_error("Unknown glTF component type: " + std::to_string(static_cast<uint32_t>(type)));
+}
+
+static std::vector<unsigned char> decodeBase64(std::string_view text) {
+    auto value = [](char c) -> int {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if (c >= '0' && c <= '9') return c - '0' + 52;
+        if (c == '+' || c == '-') return 62;
+        if (c == '/' || c == '_') return 63;
+        return -1;
+    };
+
+    std::vector<unsigned char> bytes;
+    bytes.reserve(text.size() * 3 / 4);
+    uint32_t bits = 0;
+    int bitCount = 0;
+    for (char c : text) {
+        if (c == '=') break;
+        int digit = value(c);
+        if (digit < 0) throw std::runtime_error("Invalid base64 in glTF data URI");
+        bits = (bits << 6) | static_cast<uint32_t>(digit);
+        bitCount += 6;
+        if (bitCount >= 8) {
+            bitCount -= 8;
+            bytes.push_back(static_cast<unsigned char>(bits >> bitCount));
+        }
+    }
+    return bytes;
+}
+
+// Data URIs embed a buffer or image in the JSON instead of naming a file.
+static bool isDataUri(std::string_view uri) {
+    return uri.starts_with("data:");
+}
+
+static std::string_view getDataUriPayload(std::string_view uri) {
+    size_t comma = uri.find(',');
+    if (comma == std::string_view::npos || uri.substr(0, comma).find(";base64") == std::string_view::npos)
+        throw std::runtime_error("Unsupported glTF data URI");
+    return uri.substr(comma + 1);
+}
+
+namespace IO {
+
+    GltfDocument GltfDocument::load(const std::string& path) {
+        FileData file = VirtualFileSystem::getInstance().open(path);
+        size_t slash = path.find_last_of("/\\");
+        std::string directory = slash == std::string::npos ? "." : path.substr(0, slash);
+
+        GltfDocument document = fromBytes(file.getBytes(), directory);
+        // Views into the file stay valid: FileData shares its mapping.
+        document.m_file = std::move(file);
+        return document;
+    }
+
+    GltfDocument GltfDocument::fromBytes(std::span<const unsigned char> bytes, const std::string& directory) {
+        GltfDocument document;
+        std::span<const unsigned char> jsonChunk = bytes;
+        std::span<const unsigned char> binaryChunk;
+
+        if (bytes.size() >= GLB_HEADER_SIZE && readUint32(bytes.data()) == GLB_MAGIC) {
+            uint32_t version = readUint32(bytes.data() + 4);
+            uint32_t length = readUint32(bytes.data() + 8);
+            if (version != 2) throw std::runtime_error("Unsupported GLB version: " + std::to_string(version));
+            if (length > bytes.size()) throw std::runtime_error("Truncated GLB file");
+
+            // The JSON chunk comes first, followed by at most one binary chunk.
+            jsonChunk = {};
+            size_t offset = GLB_HEADER_SIZE;
+            while (offset + GLB_CHUNK_HEADER_SIZE <= length) {
+                uint32_t chunkLength = readUint32(bytes.data() + offset);
+                uint32_t chunkType = readUint32(bytes.data() + offset + 4);
+                offset += GLB_CHUNK_HEADER_SIZE;
+                if (chunkLength > length - offset) throw std::runtime_error("Truncated GLB chunk");
+
+                std::span<const unsigned char> chunk = bytes.subspan(offset, chunkLength);
+                if (chunkType == GLB_CHUNK_JSON && jsonChunk.empty()) jsonChunk = chunk;
+                else if (chunkType == GLB_CHUNK_BIN && binaryChunk.empty()) binaryChunk = chunk;
+                // Unknown chunks must be ignored.
+                offset += chunkLength;
+            }
+            if (jsonChunk.empty()) throw std::runtime_error("GLB file without JSON chunk");
+        }
+
+        try {
+            document.m_json = json::parse(jsonChunk.begin(), jsonChunk.end());
+            const std::string version = document.m_json.at("asset").at("version");
+            if (!version.starts_with("2."))
+                throw std::runtime_error("Unsupported glTF version: " + version);
+            document.resolveBuffers(binaryChunk, directory);
+            document.resolveImages();
+        } catch (const json::exception& e) {
+            throw std::runtime_error(std::string("Malformed glTF: ") + e.what());
+        }
+        return document;
+    }
+
+    void GltfDocument::resolveBuffers(std::span<const unsigned char> binaryChunk, const std::string& directory) {
+        const json& buffers = m_json.value("buffers", json::array());
+        m_buffers.reserve(buffers.size());
+        for (size_t i = 0; i < buffers.size(); i++) {
+            const json& buffer = buffers[i];
+            size_t byteLength = buffer.at("byteLength");
+            std::span<const unsigned char> bytes;
+
+            if (!buffer.contains("uri")) {
+                // Only the first buffer of a GLB may refer to the binary chunk.
+                if (i != 0 || binaryChunk.empty()) throw std::runtime_error("glTF buffer without data");
+                bytes = binaryChunk;
+            } else {
+                const std::string& uri = buffer["uri"].get_ref<const std::string&>();
+                if (isDataUri(uri)) {
+                    bytes = m_decoded.emplace_back(decodeBase64(getDataUriPayload(uri)));
+                } else {
+                    FileData& file = m_externalBuffers.emplace_back(
+                        VirtualFileSystem::getInstance().open(directory + '/' + uri));
+                    bytes = file.getBytes();
+                }
+            }
+            if (bytes.size() < byteLength) throw std::runtime_error("glTF buffer shorter than its byteLength");
+            m_buffers.push_back(bytes.first(byteLength));
+        }
+    }
+
+    void GltfDocument::resolveImages() {
+        const json& images = m_json.value("images", json::array());
+        m_images.resize(images.size());
+        for (size_t i = 0; i < images.size(); i++) {
+            const json& image = images[i];
+            if (image.contains("bufferView")) {
+                m_images[i] = getBufferView(image["bufferView"]);
+            } else if (image.contains("uri") && isDataUri(image["uri"].get_ref<const std::string&>())) {
+                m_images[i] = m_decoded.emplace_back(decodeBase64(getDataUriPayload(image["uri"].get_ref<const std::string&>())));
+            }
+        }
+    }
+
+    std::span<const unsigned char> GltfDocument::getBufferView(size_t index) const {
+        try {
+            const json& view = m_json.at("bufferViews").at(index);
+            size_t buffer = view.at("buffer");
+            size_t offset = view.value("byteOffset", size_t(0));
+            size_t length = view.at("byteLength");
+            if (buffer >= m_buffers.size() || offset > m_buffers[buffer].size() ||
+                length > m_buffers[buffer].size() - offset)
+                throw std::runtime_error("glTF buffer view " + std::to_string(index) + " out of its buffer");
+            return m_buffers[buffer].subspan(offset, length);
+        } catch (const json::exception& e) {
+            throw std::runtime_error(std::string("Malformed glTF buffer view: ") + e.what());
+        }
+    }
+
+    std::span<const unsigned char> GltfDocument::getImage(size_t index) const {
+        return index < m_images.size() ? m_images[index] : std::span<const unsigned char>();
+    }
+
+    GltfAccessor GltfDocument::getAccessor(size_t index) const {
+        try {
+            const json& source = m_json.at("accessors").at(index);
+            GltfAccessor accessor;
+            accessor.count = source.at("count");
+            accessor.componentType = static_cast<GltfComponentType>(source.at("componentType").get<uint32_t>());
+            accessor.components = getComponentCount(source.at("type"));
+            accessor.normalized = source.value("normalized", false);
+            const size_t elementSize = getComponentSize(accessor.componentType) * accessor.components;
+            accessor.stride = elementSize;
+
+            if (source.contains("sparse")) {
+                std::cerr << "GLTF::WARNING::sparse accessor " << index
+                          << " read without its sparse values" << std::endl;
+            }
+            if (!source.contains("bufferView")) return accessor;
+
+            size_t viewIndex = source["bufferView"];
+            std::span<const unsigned char> view = getBufferView(viewIndex);
+            accessor.stride = m_json["bufferViews"][viewIndex].value("byteStride", elementSize);
+            size_t offset = source.value("byteOffset", size_t(0));
+            size_t end = accessor.count == 0 ? offset : offset + accessor.stride * (accessor.count - 1) + elementSize;
+            if (accessor.stride < elementSize || end > view.size())
+                throw std::runtime_error("glTF accessor " + std::to_string(index) + " out of its buffer view");
+            accessor.data = view.data() + offset;
+            return accessor;
+        } catch (const json::exception& e) {
+            throw std::runtime_error(std::string("Malformed glTF accessor: ") + e.what());
+        }
+    }
+
+    /**
+     * @brief Conversion loop for one component type, so the type is switched
+     * on once per accessor rather than once per component.
+     */
+    template <typename T>
+    static void readComponents(const GltfAccessor& accessor, int components, float* out, size_t outStride) {
+        const float scale = std::is_integral_v<T> && accessor.normalized
+            ? 1.0f / static_cast<float>(std::numeric_limits<T>::max()) : 1.0f;
+        // The most negative normalized integer maps to -1, not below.
+        const float minimum = std::is_signed_v<T> && std::is_integral_v<T> && accessor.normalized
+            ? -1.0f : std::numeric_limits<float>::lowest();
+        const unsigned char* element = accessor.data;
+        T values[16];
+        for (size_t i = 0; i < accessor.count; i++, element += accessor.stride, out += outStride) {
+            std::memcpy(values, element, sizeof(T) * components);
+            for (int c = 0; c < components; c++) {
+                out[c] = std::max(static_cast<float>(values[c]) * scale, minimum);
+            }
+        }
+    }
+
+    void readFloats(const GltfAccessor& accessor, int components, float* out, size_t outStride) {
+        components = std::min(components, accessor.components);
+        if (!accessor.data) {
+            for (size_t i = 0; i < accessor.count; i++, out += outStride)
+                std::fill(out, out + components, 0.0f);
+            return;
+        }
+        switch (accessor.componentType) {
+            case GltfComponentType::FLOAT: readComponents<float>(accessor, components, out, outStride); break;
+            case GltfComponentType::BYTE: readComponents<int8_t>(accessor, components, out, outStride); break;
+            case GltfComponentType::UNSIGNED_BYTE: readComponents<uint8_t>(accessor, components, out, outStride); break;
+            case GltfComponentType::SHORT: readComponents<int16_t>(accessor, components, out, outStride); break;
+            case GltfComponentType::UNSIGNED_SHORT: readComponents<uint16_t>(accessor, components, out, outStride); break;
+            case GltfComponentType::UNSIGNED_INT: readComponents<uint32_t>(accessor, components, out, outStride); break;
+        }
+    }
+
+    template <typename T>
+    static void readIndexType(const GltfAccessor& accessor, unsigned int* out) {
+        const unsigned char* element = accessor.data;
+        for (size_t i = 0; i < accessor.count; i++, element += accessor.stride) {
+            T index;
+            std::memcpy(&index, element, sizeof(T));
+            out[i] = index;
+        }
+    }
+
+    void readIndices(const GltfAccessor& accessor, unsigned int* out) {
+        if (!accessor.data) {
+            std::fill(out, out + accessor.count, 0u);
+            return;
+        }
+        switch (accessor.componentType) {
+            case GltfComponentType::UNSIGNED_BYTE: readIndexType<uint8_t>(accessor, out); break;
+            case GltfComponentType::UNSIGNED_SHORT: readIndexType<uint16_t>(accessor, out); break;
+            case GltfComponentType::UNSIGNED_INT: readIndexType<uint32_t>(accessor, out); break;
+            default: throw std::runtime_error("glTF indices must be unsigned integers");
+        }
+    }
+
+}
@@ -0,0 +1,104 @@
+#ifndef GLTF_DOCUMENT_H_
+#define GLTF_DOCUMENT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <virtual_file_system.hpp>
+
+namespace IO {
+
+    // Component types of glTF accessors, as defined by the specification.
+    enum class GltfComponentType : uint32_t {
+        BYTE = 5120,
+        UNSIGNED_BYTE = 5121,
+        SHORT = 5122,
+        UNSIGNED_SHORT = 5123,
+        UNSIGNED_INT = 5125,
+        FLOAT = 5126
+    };
+
+    /**
+     * @brief Typed view of an accessor, pointing into the mapped buffers.
+     */
+    struct GltfAccessor {
+        // First element, or nullptr if the accessor has no buffer view and
+        // reads as zeros.
+        const unsigned char* data{nullptr};
+        size_t count{0};
+        // Bytes between consecutive elements.
+        size_t stride{0};
+        GltfComponentType componentType{GltfComponentType::FLOAT};
+        // 1 for SCALAR up to 16 for MAT4.
+        int components{0};
+        bool normalized{false};
+    };
+
+    /**
+     * @class GltfDocument
+     * @brief A glTF 2.0 asset, either binary (.glb) or JSON (.gltf) with its
+     * buffers in separate files or data URIs.
+     *
+     * Files are memory mapped and the JSON is parsed once. Accessors are views
+     * into the mappings: reading them converts straight from the file pages
+     * into the destination arrays, without intermediate copies. Buffers are
+     * assumed little-endian, as the specification requires.
+     */
+    class GltfDocument {
+    public:
+        /**
+         * @throws std::runtime_error if a file is missing or malformed.
+         */
+        static GltfDocument load(const std::string& path);
+        /**
+         * @brief Document read from `bytes` holding a GLB or JSON file, which
+         * must outlive the document. External buffers are resolved in
+         * `directory`.
+         * @throws std::runtime_error if the document is malformed.
+         */
+        static GltfDocument fromBytes(std::span<const unsigned char> bytes, const std::string& directory = ".");
+
+        const nlohmann::json& getJson() const { return m_json; }
+        /**
+         * @throws std::runtime_error if the accessor does not fit its buffer.
+         */
+        GltfAccessor getAccessor(size_t index) const;
+        std::span<const unsigned char> getBufferView(size_t index) const;
+        /**
+         * @brief Encoded bytes of an image stored in a buffer view or a data
+         * URI, empty if the image is an external file.
+         */
+        std::span<const unsigned char> getImage(size_t index) const;
+
+    private:
+        nlohmann::json m_json;
+        FileData m_file;
+        std::vector<FileData> m_externalBuffers;
+        // Data URIs, decoded once. Moving the vectors keeps their data in place.
+        std::vector<std::vector<unsigned char>> m_decoded;
+        std::vector<std::span<const unsigned char>> m_buffers;
+        std::vector<std::span<const unsigned char>> m_images;
+
+        GltfDocument() = default;
+        void resolveBuffers(std::span<const unsigned char> binaryChunk, const std::string& directory);
+        void resolveImages();
+    };
+
+    /**
+     * @brief Read `components` floats per element of `accessor` into `out`,
+     * advancing by `outStride` floats per element. Normalized integers are
+     * converted to [0, 1] or [-1, 1]; missing components are left untouched.
+     */
+    void readFloats(const GltfAccessor& accessor, int components, float* out, size_t outStride);
+
+    /**
+     * @brief Read the scalar integer `accessor` into `out`, which holds
+     * `accessor.count` elements.
+     */
+    void readIndices(const GltfAccessor& accessor, unsigned int* out);
+}
+
+#endif
@@ -1,64 +1,236 @@
 #include <mtl_parser.hpp>
 #include <material.hpp>
-#include <unordered_map>
-#include <string>
-#include <fstream>
+#include <virtual_file_system.hpp>
+#include <algorithm>
+#include <charconv>
 #include <iostream>
 #include <stdexcept>
 
+
+namespace {
+
+/**
+ * @brief Whitespace-separated tokens of one statement, read front to back.
+ */
+class Tokens {
+public:
+    explicit Tokens(std::string_view line) : m_rest(line) {}
+
+    std::string_view next() {
+        std::string_view token = peek();
+        m_rest.remove_prefix(std::min(m_rest.size(), skipSpaces() + token.size()));
+        return token;
+    }
+
+    std::string_view peek() const {
+        size_t begin = skipSpaces();
+        size_t end = m_rest.find_first_of(" \t", begin);
+        return m_rest.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin);
+    }
+
+    // Everything not read yet, e.g. a file name containing spaces.
+    std::string_view remainder() const {
+        std::string_view rest = m_rest.substr(std::min(m_rest.size(), skipSpaces()));
+        size_t end = rest.find_last_not_of(" \t");
+        return end == std::string_view::npos ? std::string_view() : rest.substr(0, end + 1);
+    }
+
+private:
+    std::string_view m_rest;
+
+    size_t skipSpaces() const {
+        size_t begin = m_rest.find_first_not_of(" \t");
+        return begin == std::string_view::npos ? m_rest.size() : begin;
+    }
+};
+
+}
+
+static bool parseFloat(std::string_view token, float& value) {
+    // from_chars rejects the sign some exporters write before positive numbers.
+    if (!token.empty() && token[0] == '+') token.remove_prefix(1);
+    const char* end = token.data() + token.size();
+    auto [last, error] = std::from_chars(token.data(), end, value);
+    return !token.empty() && error == std::errc() && last == end;
+}
+
+static bool parseInt(std::string_view token, int& value) {
+    const char* end = token.data() + token.size();
+    auto [last, error] = std::from_chars(token.data(), end, value);
+    return !token.empty() && error == std::errc() && last == end;
+}
+
+static bool parseSwitch(std::string_view token, bool& value) {
+    if (token != "on" && token != "off") return false;
+    value = token == "on";
+    return true;
+}
+
+/**
+ * @brief Read up to three floats, the missing ones copying `fill`.
+ * @return Whether at least one was read.
+ */
+static bool parseVector(Tokens& tokens, glm::vec3& vector, float fill) {
+    int count = 0;
+    float value;
+    while (count < 3 && parseFloat(tokens.peek(), value)) {
+        vector[count++] = value;
+        tokens.next();
+    }
+    for (int i = count; i < 3 && count > 0; i++) vector[i] = fill;
+    return count > 0;
+}
+
+static glm::vec3 xyzToLinearRgb(const glm::vec3& xyz) {
+    return glm::vec3( 3.2406f * xyz.x - 1.5372f * xyz.y - 0.4986f * xyz.z,
+                     -0.9689f * xyz.x + 1.8758f * xyz.y + 0.0415f * xyz.z,
+                      0.0557f * xyz.x - 0.2040f * xyz.y + 1.0570f * xyz.z);
+}
+
+/**
+ * @brief "r [g b]" or "xyz x [y z]", a single value applying to every
+ * component. Spectral curves are not supported.
+ */
+static bool parseColor(Tokens& tokens, glm::vec3& color) {
+    bool xyz = tokens.peek() == "xyz";
+    if (xyz) tokens.next();
+
+    float first;
+    if (!parseFloat(tokens.peek(), first)) return false;
+    glm::vec3 value(first);
+    parseVector(tokens, value, first);
+    color = xyz ? xyzToLinearRgb(value) : value;
+    return true;
+}
+
+/**
+ * @brief Options of a map statement, then its file name.
+ */
+static bool parseMap(Tokens& tokens, MaterialMap& map) {
+    map = MaterialMap();
+    while (!tokens.peek().empty() && tokens.peek()[0] == '-') {
+        std::string_view option = tokens.next();
+        bool valid = true;
+        if (option == "-blendu") valid = parseSwitch(tokens.next(), map.blendU);
+        else if (option == "-blendv") valid = parseSwitch(tokens.next(), map.blendV);
+        else if (option == "-cc") valid = parseSwitch(tokens.next(), map.colorCorrection);
+        else if (option == "-clamp") valid = parseSwitch(tokens.next(), map.clamp);
+        else if (option == "-bm") valid = parseFloat(tokens.next(), map.bumpMultiplier);
+        else if (option == "-boost") valid = parseFloat(tokens.next(), map.boost);
+        else if (option == "-texres") valid = parseInt(tokens.next(), map.resolution);
+        else if (option == "-mm") valid = parseFloat(tokens.next(), map.rangeBase) && parseFloat(tokens.next(), map.rangeGain);
+        else if (option == "-o") valid = parseVector(tokens, map.offset, 0.0f);
+        else if (option == "-s") valid = parseVector(tokens, map.scale, 1.0f);
+        else if (option == "-t") valid = parseVector(tokens, map.turbulence, 0.0f);
+        else if (option == "-type") map.type = tokens.next();
+        else if (option == "-imfchan") {
+            std::string_view channel = tokens.next();
+            valid = channel.size() == 1 && std::string_view("rgbmlz").find(channel[0]) != std::string_view::npos;
+            if (valid) map.channel = channel[0];
+        }
+        else valid = false;
+        if (!valid) return false;
+    }
+    map.path = tokens.remainder();
+    return !map.path.empty();
+}
+
+static MaterialMap* findMap(std::string_view keyword, Material& material) {
+    struct Entry { std::string_view keyword; MaterialMapType type; };
+    static constexpr Entry MAPS[] = {
+        {"map_Ka", MaterialMapType::AMBIENT}, {"map_Kd", MaterialMapType::DIFFUSE},
+        {"map_Ks", MaterialMapType::SPECULAR}, {"map_Ke", MaterialMapType::EMISSIVE},
+        {"map_Ns", MaterialMapType::SPECULAR_EXPONENT}, {"map_d", MaterialMapType::DISSOLVE},
+        {"map_bump", MaterialMapType::BUMP}, {"map_Bump", MaterialMapType::BUMP}, {"bump", MaterialMapType::BUMP},
+        {"disp", MaterialMapType::DISPLACEMENT}, {"decal", MaterialMapType::DECAL},
+        {"refl", MaterialMapType::REFLECTION}
+    };
+    for (const Entry& entry : MAPS) {
+        if (entry.keyword == keyword) return &material.getMap(entry.type);
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Apply one statement to `material`.
+ * @return false if the statement is unknown or malformed.
+ */
+static bool parseStatement(std::string_view keyword, Tokens& tokens, Material& material) {
+    if (keyword == "Ka") return parseColor(tokens, material.ambient);
+    if (keyword == "Kd") return parseColor(tokens, material.diffuse);
+    if (keyword == "Ks") return parseColor(tokens, material.specular);
+    if (keyword == "Ke") return parseColor(tokens, material.emissive);
+    if (keyword == "Tf") return parseColor(tokens, material.transmissionFilter);
+    if (keyword == "Ns") return parseFloat(tokens.next(), material.shininess);
+    if (keyword == "Ni") return parseFloat(tokens.next(), material.opticalDensity);
+    if (keyword == "sharpness") return parseFloat(tokens.next(), material.sharpness);
+    if (keyword == "illum") return parseInt(tokens.next(), material.illumination);
+    if (keyword == "map_aat") return parseSwitch(tokens.next(), material.textureAntiAliasing);
+    if (keyword == "d") {
+        material.dissolveHalo = tokens.peek() == "-halo";
+        if (material.dissolveHalo) tokens.next();
+        return parseFloat(tokens.next(), material.dissolve);
+    }
+    if (keyword == "Tr") {
+        float transparency;
+        if (!parseFloat(tokens.next(), transparency)) return false;
+        material.dissolve = 1.0f - transparency;
+        return true;
+    }
+    if (MaterialMap* map = findMap(keyword, material)) return parseMap(tokens, *map);
+    return false;
+}
+
 namespace IO {
 
-    std::unordered_map<MaterialType, Material> parseMTL(const std::string& path) {    
-        std::ifstream file(path);
-        if (!file) {
+    std::vector<Material> parseMTL(const std::string& path) {
+        VirtualFileSystem& files = VirtualFileSystem::getInstance();
+        if (!files.exists(path)) {
             std::cerr << "Error when opening MTL file: " << path << std::endl;
             throw std::runtime_error("File not found: " + path);
         }
+        // Parsing works on views into the mapping.
+        FileData file = files.open(path);
+        return parseMTLSource(file.getText(), path);
+    }
+
+    std::vector<Material> parseMTLSource(std::string_view source, std::string_view sourceName) {
+        std::vector<Material> materials;
+        size_t count = 0;
+        for (size_t at = source.find("newmtl"); at != std::string_view::npos; at = source.find("newmtl", at + 6))
+            count++;
+        materials.reserve(count);
 
-        std::unordered_map<MaterialType, Material> materials;
-        std::string line;
         Material* material = nullptr;
+        size_t lineNumber = 0;
+        while (!source.empty()) {
+            size_t end = source.find('\n');
+            std::string_view line = source.substr(0, end);
+            source.remove_prefix(end == std::string_view::npos ? source.size() : end + 1);
+            lineNumber++;
+
+            // Comments may follow a statement.
+            line = line.substr(0, line.find('#'));
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            Tokens tokens(line);
+            std::string_view keyword = tokens.next();
+            if (keyword.empty()) continue;
 
-        while (std::getline(file, line)) {
-            std::istringstream iss(line);
-            std::string identifier;
-            iss >> identifier;
-
-            if (identifier == "newmtl") {
-                std::string typeString;
-                iss >> typeString;
-                MaterialType type = Material::getMaterialType(typeString);
-                
-                material = &materials[type];
-                material->type = type;
-            } else if (material) {
-                if (identifier == "#" || iss.str().size() == 0)
-                    continue;
-                switch (identifier[0]) {
-                    case 'K':
-                        if (identifier == "Ka") {
-                            iss >> material->ambient[0] >> material->ambient[1] >> material->ambient[2];
-                        } else if (identifier == "Kd") {
-                            iss >> material->diffuse[0] >> material->diffuse[1] >> material->diffuse[2];
-                        } else if (identifier == "Ks") {
-                            iss >> material->specular[0] >> material->specular[1] >> material->specular[2];
-                        }
-                        break;
-                    case 'N':
-                        if (identifier == "Ns") {
-                            iss >> material->shininess;
-                        }
-                        break;
-                    case 'd':
-                        break;
-                    default:
-                        std::cerr << "Unexpected identifier: " << identifier << std::endl;
-                }
-            } else {
-                std::cerr << "Warning: No material defined yet, line: " << line << std::endl;
+            if (keyword == "newmtl") {
+                material = &materials.emplace_back();
+                material->name = tokens.remainder();
+                continue;
+            }
+            if (!material) {
+                std::cerr << "MTL_PARSER::WARNING::" << sourceName << ":" << lineNumber
+                          << " statement before newmtl: " << keyword << std::endl;
+                continue;
+            }
+            if (!parseStatement(keyword, tokens, *material)) {
+                std::cerr << "MTL_PARSER::WARNING::" << sourceName << ":" << lineNumber
+                          << " unsupported statement: " << line << std::endl;
             }
         }
-        
         return materials;
     }
 
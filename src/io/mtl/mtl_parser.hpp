@@ -1,12 +1,23 @@
 #ifndef MTL_PARSER_H_
 #define MTL_PARSER_H_
 
-#include <unordered_map>
 #include <string>
+#include <string_view>
+#include <vector>
 #include <material.hpp>
 
 namespace IO {
-    std::unordered_map<MaterialType, Material> parseMTL(const std::string& path);
+    /**
+     * @brief Every material of the MTL library at `path`, in file order.
+     * @throws std::runtime_error if the file cannot be opened.
+     */
+    std::vector<Material> parseMTL(const std::string& path);
+
+    /**
+     * @brief Materials of the MTL library `source`. Unsupported statements are
+     * reported on std::cerr, prefixed by `sourceName`, and skipped.
+     */
+    std::vector<Material> parseMTLSource(std::string_view source, std::string_view sourceName = "");
 };
 
 #endif
@@ -0,0 +1,402 @@
+#include <obj_parser.hpp>
+#include <virtual_file_system.hpp>
+#include <thread_pool.hpp>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+// Chunks are large enough for the per-chunk bookkeeping to be negligible.
+static constexpr size_t MIN_CHUNK_SIZE = 1 << 20;
+// Chunks per thread, so that a slow chunk does not hold the whole pass.
+static constexpr size_t CHUNKS_PER_THREAD = 4;
+static constexpr uint32_t NO_ATTRIBUTE = UINT32_MAX;
+
+
+namespace {
+
+/**
+ * @brief Position, texture coordinate and normal indices of a face corner,
+ * 0-based and absolute, NO_ATTRIBUTE if absent.
+ */
+struct Corner {
+    uint32_t position;
+    uint32_t texture;
+    uint32_t normal;
+
+    bool operator==(const Corner&) const = default;
+};
+
+struct CornerHash {
+    size_t operator()(const Corner& corner) const {
+        uint64_t hash = corner.position * 0x9E3779B97F4A7C15ull;
+        hash ^= (corner.texture + 0x7F4A7C15ull) * 0xC2B2AE3D27D4EB4Full + (hash >> 29);
+        hash ^= (corner.normal + 0x165667B1ull) * 0x165667B19E3779F9ull + (hash >> 32);
+        return static_cast<size_t>(hash ^ (hash >> 31));
+    }
+};
+
+struct Chunk {
+    std::string_view text;
+    // Counted by the first pass.
+    size_t lineCount = 0;
+    uint32_t positionCount = 0, textureCount = 0, normalCount = 0;
+    // Prefix sums of the counts: where the chunk's attributes go.
+    size_t firstLine = 0;
+    uint32_t positionBase = 0, textureBase = 0, normalBase = 0;
+
+    // Corners in order of first use within the chunk, and the triangles as
+    // indices into them.
+    std::vector<Corner> corners;
+    std::vector<uint32_t> indices;
+    // usemtl statements: index in `indices` where each starts.
+    std::vector<std::pair<uint32_t, std::string>> materials;
+    std::vector<std::string> libraries;
+
+    size_t warningCount = 0;
+    size_t firstWarningLine = 0;
+    std::string_view firstWarning;
+};
+
+/**
+ * @brief Attribute arrays shared by every chunk, each writing its own range.
+ */
+struct Attributes {
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec2> textures;
+    std::vector<glm::vec3> normals;
+};
+
+class Cursor {
+public:
+    explicit Cursor(std::string_view line) : m_at(line.data()), m_end(line.data() + line.size()) {}
+
+    void skipSpaces() {
+        while (m_at < m_end && (*m_at == ' ' || *m_at == '\t')) m_at++;
+    }
+    bool atEnd() {
+        skipSpaces();
+        return m_at == m_end;
+    }
+
+    std::string_view word() {
+        skipSpaces();
+        const char* begin = m_at;
+        while (m_at < m_end && *m_at != ' ' && *m_at != '\t') m_at++;
+        return std::string_view(begin, m_at - begin);
+    }
+
+    // Everything not read yet, e.g. a file name containing spaces.
+    std::string_view remainder() {
+        skipSpaces();
+        const char* end = m_end;
+        while (end > m_at && (end[-1] == ' ' || end[-1] == '\t')) end--;
+        return std::string_view(m_at, end - m_at);
+    }
+
+    bool readFloat(float& value) {
+        skipSpaces();
+        // from_chars rejects the sign some exporters write before positive numbers.
+        if (m_at < m_end && *m_at == '+') m_at++;
+        auto [last, error] = std::from_chars(m_at, m_end, value);
+        if (error != std::errc() || (last < m_end && *last != ' ' && *last != '\t')) return false;
+        m_at = last;
+        return true;
+    }
+
+    /**
+     * @brief One index of a face corner, without the separating slash.
+     * @return false if there is no number.
+     */
+    bool readIndex(int64_t& value) {
+        auto [last, error] = std::from_chars(m_at, m_end, value);
+        if (error != std::errc()) return false;
+        m_at = last;
+        return true;
+    }
+
+    bool consume(char c) {
+        if (m_at < m_end && *m_at == c) {
+            m_at++;
+            return true;
+        }
+        return false;
+    }
+
+    bool atSeparator() const { return m_at == m_end || *m_at == ' ' || *m_at == '\t'; }
+
+private:
+    const char* m_at;
+    const char* m_end;
+};
+
+}
+
+/**
+ * @brief Next line of `text`, without its line break, removed from `text`.
+ */
+static std::string_view nextLine(std::string_view& text) {
+    const void* found = std::memchr(text.data(), '\n', text.size());
+    size_t end = found ? static_cast<const char*>(found) - text.data() : text.size();
+    std::string_view line = text.substr(0, end);
+    text.remove_prefix(std::min(text.size(), end + 1));
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    return line;
+}
+
+/**
+ * @brief Line without the comment that may follow the statement.
+ */
+static std::string_view stripComment(std::string_view line) {
+    const void* comment = std::memchr(line.data(), '#', line.size());
+    return comment ? line.substr(0, static_cast<const char*>(comment) - line.data()) : line;
+}
+
+/**
+ * @brief First pass: how many lines and attributes the chunk holds, so that
+ * the second pass knows where its attributes go and can resolve relative
+ * indices. Statements are recognized exactly as in the second pass.
+ */
+static void countChunk(Chunk& chunk) {
+    std::string_view text = chunk.text;
+    while (!text.empty()) {
+        std::string_view line = nextLine(text);
+        chunk.lineCount++;
+        // Only attribute statements start with a v.
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string_view::npos || line[start] != 'v') continue;
+
+        std::string_view keyword = Cursor(stripComment(line)).word();
+        if (keyword == "v") chunk.positionCount++;
+        else if (keyword == "vt") chunk.textureCount++;
+        else if (keyword == "vn") chunk.normalCount++;
+    }
+}
+
+/**
+ * @brief Absolute 0-based index of `value`, which is 1-based, or relative to
+ * the `declared` elements before it if negative.
+ */
+static bool resolveIndex(int64_t value, uint32_t declared, uint32_t total, uint32_t& index) {
+    int64_t resolved = value > 0 ? value - 1 : static_cast<int64_t>(declared) + value;
+    if (value == 0 || resolved < 0 || resolved >= total) return false;
+    index = static_cast<uint32_t>(resolved);
+    return true;
+}
+
+static bool parseCorner(Cursor& cursor, const Chunk& chunk, uint32_t positions, uint32_t textures, uint32_t normals,
+                        const Attributes& attributes, Corner& corner) {
+    corner = {NO_ATTRIBUTE, NO_ATTRIBUTE, NO_ATTRIBUTE};
+    int64_t value;
+    if (!cursor.readIndex(value) ||
+        !resolveIndex(value, chunk.positionBase + positions, static_cast<uint32_t>(attributes.positions.size()), corner.position))
+        return false;
+    if (cursor.consume('/')) {
+        if (cursor.readIndex(value) &&
+            !resolveIndex(value, chunk.textureBase + textures, static_cast<uint32_t>(attributes.textures.size()), corner.texture))
+            return false;
+        if (cursor.consume('/') && (!cursor.readIndex(value) ||
+            !resolveIndex(value, chunk.normalBase + normals, static_cast<uint32_t>(attributes.normals.size()), corner.normal)))
+            return false;
+    }
+    return cursor.atSeparator();
+}
+
+/**
+ * @brief Second pass: write the chunk's attributes into `attributes`, and its
+ * faces as triangles over the chunk's distinct corners.
+ */
+static void parseChunk(Chunk& chunk, Attributes& attributes) {
+    uint32_t positions = 0, textures = 0, normals = 0;
+    std::unordered_map<Corner, uint32_t, CornerHash> cornerIds;
+    std::vector<Corner> face;
+    std::vector<uint32_t> faceIds;
+
+    std::string_view text = chunk.text;
+    for (size_t lineNumber = chunk.firstLine + 1; !text.empty(); lineNumber++) {
+        std::string_view line = stripComment(nextLine(text));
+        Cursor cursor(line);
+        std::string_view keyword = cursor.word();
+        if (keyword.empty()) continue;
+
+        bool valid = true;
+        if (keyword == "v") {
+            // The count of the first pass decides where it goes, even if malformed.
+            glm::vec3& position = attributes.positions[chunk.positionBase + positions++];
+            valid = cursor.readFloat(position.x) && cursor.readFloat(position.y) && cursor.readFloat(position.z);
+        } else if (keyword == "vt") {
+            glm::vec2& texture = attributes.textures[chunk.textureBase + textures++];
+            // v is optional, and a third w coordinate is ignored.
+            valid = cursor.readFloat(texture.x);
+            if (valid && !cursor.atEnd()) valid = cursor.readFloat(texture.y);
+        } else if (keyword == "vn") {
+            glm::vec3& normal = attributes.normals[chunk.normalBase + normals++];
+            valid = cursor.readFloat(normal.x) && cursor.readFloat(normal.y) && cursor.readFloat(normal.z);
+        } else if (keyword == "f") {
+            face.clear();
+            Corner corner;
+            while (valid && !cursor.atEnd()) {
+                valid = parseCorner(cursor, chunk, positions, textures, normals, attributes, corner);
+                face.push_back(corner);
+            }
+            valid = valid && face.size() >= 3;
+            if (valid) {
+                faceIds.clear();
+                for (const Corner& faceCorner : face) {
+                    auto [entry, inserted] = cornerIds.try_emplace(faceCorner, static_cast<uint32_t>(chunk.corners.size()));
+                    if (inserted) chunk.corners.push_back(faceCorner);
+                    faceIds.push_back(entry->second);
+                }
+                for (size_t i = 1; i + 1 < faceIds.size(); i++) {
+                    chunk.indices.push_back(faceIds[0]);
+                    chunk.indices.push_back(faceIds[i]);
+                    chunk.indices.push_back(faceIds[i + 1]);
+                }
+            }
+        } else if (keyword == "usemtl") {
+            chunk.materials.emplace_back(static_cast<uint32_t>(chunk.indices.size()), cursor.remainder());
+        } else if (keyword == "mtllib") {
+            chunk.libraries.emplace_back(cursor.remainder());
+        } else if (keyword == "o" || keyword == "g" || keyword == "s") {
+            // Grouping and smoothing do not change the geometry.
+        } else {
+            valid = false;
+        }
+
+        if (!valid) {
+            if (chunk.warningCount++ == 0) {
+                chunk.firstWarningLine = lineNumber;
+                chunk.firstWarning = line;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Split `source` into chunks of about `chunkSize` bytes ending on line
+ * breaks.
+ */
+static std::vector<Chunk> splitChunks(std::string_view source, size_t chunkSize) {
+    std::vector<Chunk> chunks;
+    while (!source.empty()) {
+        size_t end = std::min(chunkSize, source.size());
+        if (end < source.size()) {
+            size_t lineEnd = source.find('\n', end);
+            end = lineEnd == std::string_view::npos ? source.size() : lineEnd + 1;
+        }
+        chunks.emplace_back().text = source.substr(0, end);
+        source.remove_prefix(end);
+    }
+    return chunks;
+}
+
+namespace IO {
+
+    ObjGeometry parseOBJ(const std::string& path) {
+        FileData file = VirtualFileSystem::getInstance().open(path);
+        return parseOBJSource(file.getText(), path);
+    }
+
+    ObjGeometry parseOBJSource(std::string_view source, std::string_view sourceName, size_t chunkSize, ThreadPool* pool) {
+        ThreadPool& threads = pool ? *pool : ThreadPool::getInstance();
+        if (chunkSize == 0)
+            chunkSize = std::max(MIN_CHUNK_SIZE, source.size() / (threads.getThreadCount() * CHUNKS_PER_THREAD) + 1);
+        std::vector<Chunk> chunks = splitChunks(source, chunkSize);
+
+        threads.parallelFor(chunks.size(), 1, [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; i++) countChunk(chunks[i]);
+        });
+
+        Attributes attributes;
+        size_t lines = 0;
+        uint32_t positions = 0, textures = 0, normals = 0;
+        for (Chunk& chunk : chunks) {
+            chunk.firstLine = lines;
+            chunk.positionBase = positions;
+            chunk.textureBase = textures;
+            chunk.normalBase = normals;
+            lines += chunk.lineCount;
+            positions += chunk.positionCount;
+            textures += chunk.textureCount;
+            normals += chunk.normalCount;
+        }
+        attributes.positions.resize(positions, glm::vec3(0.0f));
+        attributes.textures.resize(textures, glm::vec2(0.0f));
+        attributes.normals.resize(normals, glm::vec3(0.0f));
+
+        threads.parallelFor(chunks.size(), 1, [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; i++) parseChunk(chunks[i], attributes);
+        });
+
+        // Number the distinct corners in order of first use across the file,
+        // so the result is the same however the file was split.
+        ObjGeometry geometry;
+        std::unordered_map<Corner, uint32_t, CornerHash> vertexIds;
+        std::vector<Corner> vertexCorners;
+        std::vector<std::vector<uint32_t>> chunkToVertex(chunks.size());
+        std::vector<size_t> indexBase(chunks.size());
+        size_t indexCount = 0;
+        std::string material;
+        for (size_t i = 0; i < chunks.size(); i++) {
+            Chunk& chunk = chunks[i];
+            chunkToVertex[i].reserve(chunk.corners.size());
+            for (const Corner& corner : chunk.corners) {
+                auto [entry, inserted] = vertexIds.try_emplace(corner, static_cast<uint32_t>(vertexCorners.size()));
+                if (inserted) vertexCorners.push_back(corner);
+                chunkToVertex[i].push_back(entry->second);
+            }
+
+            for (auto& [first, name] : chunk.materials)
+                geometry.groups.push_back({std::move(name), static_cast<uint32_t>(indexCount + first), 0});
+            indexBase[i] = indexCount;
+            indexCount += chunk.indices.size();
+            for (std::string& library : chunk.libraries)
+                geometry.materialLibraries.push_back(std::move(library));
+
+            if (chunk.warningCount > 0) {
+                std::cerr << "OBJ_PARSER::WARNING::" << sourceName << ":" << chunk.firstWarningLine
+                          << " unsupported statement: " << chunk.firstWarning;
+                if (chunk.warningCount > 1) std::cerr << " (and " << chunk.warningCount - 1 << " more)";
+                std::cerr << std::endl;
+            }
+        }
+        vertexIds = {};
+
+        // Each usemtl runs up to the next one. Faces before the first use no
+        // material, and groups left empty let their neighbours merge.
+        std::vector<ObjGroup> groups;
+        groups.reserve(geometry.groups.size() + 1);
+        for (size_t i = 0; i <= geometry.groups.size(); i++) {
+            ObjGroup group = i == 0 ? ObjGroup{std::string(), 0, 0} : std::move(geometry.groups[i - 1]);
+            size_t end = i < geometry.groups.size() ? geometry.groups[i].firstIndex : indexCount;
+            group.indexCount = static_cast<uint32_t>(end - group.firstIndex);
+            if (group.indexCount == 0) continue;
+            if (!groups.empty() && groups.back().material == group.material) groups.back().indexCount += group.indexCount;
+            else groups.push_back(std::move(group));
+        }
+        geometry.groups = std::move(groups);
+
+        geometry.indices.resize(indexCount);
+        threads.parallelFor(chunks.size(), 1, [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; i++) {
+                const std::vector<uint32_t>& toVertex = chunkToVertex[i];
+                unsigned int* out = geometry.indices.data() + indexBase[i];
+                for (uint32_t local : chunks[i].indices) *out++ = toVertex[local];
+            }
+        });
+
+        geometry.vertices.resize(vertexCorners.size(), Vertex{});
+        threads.parallelFor(vertexCorners.size(), 16384, [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; i++) {
+                const Corner& corner = vertexCorners[i];
+                Vertex& vertex = geometry.vertices[i];
+                vertex.position = attributes.positions[corner.position];
+                if (corner.texture != NO_ATTRIBUTE) vertex.textureCoordinates = attributes.textures[corner.texture];
+                if (corner.normal != NO_ATTRIBUTE) vertex.normal = attributes.normals[corner.normal];
+            }
+        });
+        return geometry;
+    }
+
+}
@@ -0,0 +1,59 @@
+#ifndef OBJ_PARSER_H_
+#define OBJ_PARSER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <vertex.hpp>
+
+class ThreadPool;
+
+namespace IO {
+
+    /**
+     * @brief Range of indices drawn with one material.
+     */
+    struct ObjGroup {
+        // usemtl name, empty for faces before the first usemtl.
+        std::string material;
+        uint32_t firstIndex;
+        uint32_t indexCount;
+    };
+
+    /**
+     * @brief Geometry of an OBJ file, ready to upload as a Renderable.
+     *
+     * Each distinct position/texture/normal triple is one vertex, numbered in
+     * order of first use. Polygons are split into triangle fans. Texture
+     * coordinates are kept as written, with the origin at the bottom left.
+     */
+    struct ObjGeometry {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+        // In file order, consecutive faces of the same material merged.
+        std::vector<ObjGroup> groups;
+        // mtllib file names, relative to the OBJ file.
+        std::vector<std::string> materialLibraries;
+    };
+
+    /**
+     * @brief Geometry of the OBJ file at `path`, mapped and parsed in parallel
+     * on the ThreadPool.
+     * @throws std::runtime_error if the file cannot be opened.
+     */
+    ObjGeometry parseOBJ(const std::string& path);
+
+    /**
+     * @brief Geometry of the OBJ source `source`. It is split into line-aligned
+     * chunks of about `chunkSize` bytes, 0 picking a size for the thread count,
+     * which are parsed on `pool`. The result does not depend on the chunks.
+     * Unsupported statements and invalid faces are reported on std::cerr,
+     * prefixed by `sourceName`, and skipped.
+     */
+    ObjGeometry parseOBJSource(std::string_view source, std::string_view sourceName = "",
+                               size_t chunkSize = 0, ThreadPool* pool = nullptr);
+}
+
+#endif
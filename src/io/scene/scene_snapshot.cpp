@@ -0,0 +1,150 @@
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "scene_snapshot.hpp"
+
+namespace {
+
+constexpr uint32_t SCENE_MAGIC = 0x4E43534C; // "LSCN"
+constexpr uint32_t SCENE_VERSION = 1;
+// Every section starts on this boundary, so the columns can be read in place.
+constexpr size_t SECTION_ALIGNMENT = 16;
+
+struct SceneHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entityCount;
+    uint32_t materialNameCount;
+    uint32_t assetCount;
+    uint32_t stringsSize;
+    uint64_t parentsOffset;
+    uint64_t transformsOffset;
+    uint64_t materialsOffset;
+    uint64_t modelsOffset;
+    uint64_t materialNamesOffset;
+    uint64_t assetsOffset;
+    uint64_t stringsOffset;
+};
+
+static_assert(sizeof(IO::SceneTransform) == 9 * sizeof(float), "Scene transforms are stored unpadded.");
+
+// Append `size` bytes at the next section boundary, returning their offset.
+uint64_t appendSection(std::vector<unsigned char>& bytes, const void* data, size_t size) {
+    bytes.resize((bytes.size() + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT);
+    uint64_t offset = bytes.size();
+    const unsigned char* begin = static_cast<const unsigned char*>(data);
+    bytes.insert(bytes.end(), begin, begin + size);
+    return offset;
+}
+
+std::vector<IO::SceneString> appendStrings(std::string& strings, const std::vector<std::string>& values) {
+    std::vector<IO::SceneString> refs;
+    for (const std::string& value : values) {
+        refs.push_back({static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(value.size())});
+        strings += value;
+    }
+    return refs;
+}
+
+// View of `count` elements of T at `offset`, checked against the file.
+template <typename T>
+std::span<const T> getSection(std::span<const unsigned char> bytes, uint64_t offset, uint64_t count) {
+    if (offset % SECTION_ALIGNMENT != 0 || offset > bytes.size() || count > (bytes.size() - offset) / sizeof(T))
+        throw std::runtime_error("Truncated scene snapshot");
+    return {reinterpret_cast<const T*>(bytes.data() + offset), static_cast<size_t>(count)};
+}
+
+}
+
+namespace IO {
+
+std::vector<unsigned char> serializeScene(const SceneData& scene) {
+    size_t count = scene.parents.size();
+    if (scene.transforms.size() != count || scene.materials.size() != count || scene.models.size() != count)
+        throw std::invalid_argument("Scene columns differ in length");
+
+    std::string strings;
+    std::vector<SceneString> materialNames = appendStrings(strings, scene.materialNames);
+    std::vector<SceneString> assets = appendStrings(strings, scene.assets);
+
+    SceneHeader header{};
+    header.magic = SCENE_MAGIC;
+    header.version = SCENE_VERSION;
+    header.entityCount = static_cast<uint32_t>(count);
+    header.materialNameCount = static_cast<uint32_t>(materialNames.size());
+    header.assetCount = static_cast<uint32_t>(assets.size());
+    header.stringsSize = static_cast<uint32_t>(strings.size());
+
+    std::vector<unsigned char> bytes(sizeof(SceneHeader));
+    header.parentsOffset = appendSection(bytes, scene.parents.data(), count * sizeof(int32_t));
+    header.transformsOffset = appendSection(bytes, scene.transforms.data(), count * sizeof(SceneTransform));
+    header.materialsOffset = appendSection(bytes, scene.materials.data(), count * sizeof(uint32_t));
+    header.modelsOffset = appendSection(bytes, scene.models.data(), count * sizeof(uint32_t));
+    header.materialNamesOffset = appendSection(bytes, materialNames.data(), materialNames.size() * sizeof(SceneString));
+    header.assetsOffset = appendSection(bytes, assets.data(), assets.size() * sizeof(SceneString));
+    header.stringsOffset = appendSection(bytes, strings.data(), strings.size());
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    return bytes;
+}
+
+void writeScene(const std::string& path, const SceneData& scene) {
+    std::vector<unsigned char> bytes = serializeScene(scene);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) throw std::runtime_error("Cannot open file for writing: " + path);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file) throw std::runtime_error("Cannot write file: " + path);
+}
+
+SceneSnapshot::SceneSnapshot(const std::string& path) : SceneSnapshot(VirtualFileSystem::getInstance().open(path)) {}
+
+SceneSnapshot::SceneSnapshot(FileData file) : m_file(std::move(file)) {
+    std::span<const unsigned char> bytes = m_file.getBytes();
+    SceneHeader header;
+    if (bytes.size() < sizeof(header)) throw std::runtime_error("Not a scene snapshot");
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (header.magic != SCENE_MAGIC) throw std::runtime_error("Not a scene snapshot");
+    if (header.version != SCENE_VERSION)
+        throw std::runtime_error("Unsupported scene snapshot version " + std::to_string(header.version));
+    if (reinterpret_cast<uintptr_t>(bytes.data()) % SECTION_ALIGNMENT != 0)
+        throw std::runtime_error("Scene snapshot is not aligned");
+
+    // The fix-up: offsets become views into the file.
+    m_parents = getSection<int32_t>(bytes, header.parentsOffset, header.entityCount);
+    m_transforms = getSection<SceneTransform>(bytes, header.transformsOffset, header.entityCount);
+    m_materials = getSection<uint32_t>(bytes, header.materialsOffset, header.entityCount);
+    m_models = getSection<uint32_t>(bytes, header.modelsOffset, header.entityCount);
+    m_materialNames = getSection<SceneString>(bytes, header.materialNamesOffset, header.materialNameCount);
+    m_assets = getSection<SceneString>(bytes, header.assetsOffset, header.assetCount);
+    std::span<const char> strings = getSection<char>(bytes, header.stringsOffset, header.stringsSize);
+    m_strings = std::string_view(strings.data(), strings.size());
+
+    // Checked once here so that users can index with the references.
+    for (const auto* table : {&m_materialNames, &m_assets}) {
+        for (const SceneString& string : *table) {
+            if (string.offset > m_strings.size() || string.length > m_strings.size() - string.offset)
+                throw std::runtime_error("Invalid string in scene snapshot");
+        }
+    }
+    int32_t count = static_cast<int32_t>(header.entityCount);
+    for (int32_t i = 0; i < count; i++) {
+        if (m_parents[i] < -1 || m_parents[i] >= count || m_parents[i] == i ||
+            (m_materials[i] != NO_SCENE_REFERENCE && m_materials[i] >= header.materialNameCount) ||
+            (m_models[i] != NO_SCENE_REFERENCE && m_models[i] >= header.assetCount))
+            throw std::runtime_error("Invalid entity " + std::to_string(i) + " in scene snapshot");
+    }
+
+    // Every chain of parents must end at a root. Each entity is walked once:
+    // a walk stops at the first entity already known to reach one.
+    enum : uint8_t { UNVISITED, WALKING, ROOTED };
+    std::vector<uint8_t> states(header.entityCount, UNVISITED);
+    for (int32_t i = 0; i < count; i++) {
+        int32_t entity = i;
+        for (; entity >= 0 && states[entity] == UNVISITED; entity = m_parents[entity]) states[entity] = WALKING;
+        if (entity >= 0 && states[entity] == WALKING)
+            throw std::runtime_error("Parent cycle at entity " + std::to_string(entity) + " in scene snapshot");
+        for (entity = i; entity >= 0 && states[entity] == WALKING; entity = m_parents[entity]) states[entity] = ROOTED;
+    }
+}
+
+}
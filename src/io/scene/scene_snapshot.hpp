@@ -0,0 +1,104 @@
+#ifndef SCENE_SNAPSHOT_H_
+#define SCENE_SNAPSHOT_H_
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <virtual_file_system.hpp>
+
+namespace IO {
+
+    // Material or asset reference of an entity without one.
+    constexpr uint32_t NO_SCENE_REFERENCE = UINT32_MAX;
+
+    struct SceneTransform {
+        glm::vec3 position;
+        glm::vec3 rotation;
+        glm::vec3 scale;
+    };
+
+    // Range of the string table of a snapshot.
+    struct SceneString {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    /**
+     * @brief Contents of a ".lscene" file, one column per component, all
+     * indexed by entity. Materials are referenced by name and assets by path
+     * through the two tables, so the file does not depend on the ids of the
+     * run that wrote it.
+     */
+    struct SceneData {
+        // Index of the parent entity, -1 for a root.
+        std::vector<int32_t> parents;
+        std::vector<SceneTransform> transforms;
+        // Index in materialNames, or NO_SCENE_REFERENCE.
+        std::vector<uint32_t> materials;
+        // Index in assets, or NO_SCENE_REFERENCE.
+        std::vector<uint32_t> models;
+        std::vector<std::string> materialNames;
+        std::vector<std::string> assets;
+    };
+
+    /**
+     * @throws std::invalid_argument if the columns differ in length.
+     */
+    std::vector<unsigned char> serializeScene(const SceneData& scene);
+    /**
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void writeScene(const std::string& path, const SceneData& scene);
+
+    /**
+     * @class SceneSnapshot
+     * @brief A ".lscene" file read in place.
+     *
+     * The columns are stored with the layout they have in memory, so opening a
+     * snapshot maps the file, checks the header and every reference once,
+     * parent cycles included, and turns the section offsets into views.
+     * Nothing is parsed per entity.
+     */
+    class SceneSnapshot {
+    public:
+        /**
+         * @throws std::runtime_error if the file cannot be read or is malformed.
+         */
+        explicit SceneSnapshot(const std::string& path);
+        /**
+         * @brief Snapshot of `file`, which must be aligned to 16 bytes.
+         * @throws std::runtime_error if it is malformed.
+         */
+        explicit SceneSnapshot(FileData file);
+
+        size_t getEntityCount() const { return m_parents.size(); }
+        std::span<const int32_t> getParents() const { return m_parents; }
+        std::span<const SceneTransform> getTransforms() const { return m_transforms; }
+        std::span<const uint32_t> getMaterials() const { return m_materials; }
+        std::span<const uint32_t> getModels() const { return m_models; }
+
+        size_t getMaterialNameCount() const { return m_materialNames.size(); }
+        std::string_view getMaterialName(size_t index) const { return getString(m_materialNames[index]); }
+        size_t getAssetCount() const { return m_assets.size(); }
+        std::string_view getAsset(size_t index) const { return getString(m_assets[index]); }
+
+    private:
+        FileData m_file;
+        std::span<const int32_t> m_parents;
+        std::span<const SceneTransform> m_transforms;
+        std::span<const uint32_t> m_materials;
+        std::span<const uint32_t> m_models;
+        std::span<const SceneString> m_materialNames;
+        std::span<const SceneString> m_assets;
+        std::string_view m_strings;
+
+        std::string_view getString(const SceneString& string) const {
+            return m_strings.substr(string.offset, string.length);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "pak_archive.hpp"
+#include "asset_path.hpp"
+#include "hash.hpp"
+#include "mapped_file.hpp"
+
+namespace {
+
+constexpr uint32_t PAK_MAGIC = 0x4B41504C; // "LPAK"
+constexpr uint32_t PAK_VERSION = 1;
+
+struct PakHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t alignment;
+    uint32_t entryCount;
+    uint32_t slotCount;
+    uint32_t reserved;
+    uint64_t tocOffset;
+    uint64_t namesOffset;
+    uint64_t namesSize;
+};
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Whether [offset, offset + size) lies within `total` bytes.
+bool inRange(uint64_t offset, uint64_t size, uint64_t total) {
+    return offset <= total && size <= total - offset;
+}
+
+}
+
+struct PakArchive::TocEntry {
+    uint64_t hash;
+    uint64_t offset;
+    uint64_t size;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+};
+
+PakArchive::PakArchive(const std::string& path) {
+    auto file = std::make_shared<const MappedFile>(path);
+    PakHeader header;
+    if (file->size() < sizeof(header)) throw std::runtime_error("Not a pak archive: " + path);
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (header.magic != PAK_MAGIC) throw std::runtime_error("Not a pak archive: " + path);
+    if (header.version != PAK_VERSION)
+        throw std::runtime_error("Unsupported pak archive version " + std::to_string(header.version));
+
+    // Everything is checked here so lookups can trust the table. The slot
+    // table must keep an empty slot, or probing for a missing path never ends.
+    uint64_t size = file->size();
+    uint64_t tocSize = static_cast<uint64_t>(header.entryCount) * sizeof(TocEntry);
+    uint64_t slotsOffset = header.tocOffset + tocSize;
+    if (header.tocOffset % alignof(TocEntry) != 0 || !inRange(header.tocOffset, tocSize, size) ||
+        !std::has_single_bit(header.slotCount) || header.slotCount <= header.entryCount ||
+        !inRange(slotsOffset, static_cast<uint64_t>(header.slotCount) * sizeof(uint32_t), size) ||
+        !inRange(header.namesOffset, header.namesSize, size))
+        throw std::runtime_error("Invalid pak archive: " + path);
+
+    m_entries = reinterpret_cast<const TocEntry*>(file->data() + header.tocOffset);
+    m_entryCount = header.entryCount;
+    m_slots = reinterpret_cast<const uint32_t*>(file->data() + slotsOffset);
+    m_slotCount = header.slotCount;
+    m_names = reinterpret_cast<const char*>(file->data() + header.namesOffset);
+    for (size_t i = 0; i < m_entryCount; i++) {
+        const TocEntry& entry = m_entries[i];
+        if (!inRange(entry.offset, entry.size, size) ||
+            !inRange(entry.nameOffset, entry.nameLength, header.namesSize))
+            throw std::runtime_error("Invalid pak archive entry in " + path);
+    }
+    for (size_t i = 0; i < m_slotCount; i++) {
+        if (m_slots[i] > m_entryCount) throw std::runtime_error("Invalid pak archive table in " + path);
+    }
+    m_file = std::move(file);
+}
+
+void PakArchive::write(const std::string& path, const std::vector<Entry>& entries) {
+    std::vector<TocEntry> toc(entries.size());
+    std::string names;
+    std::vector<std::string> paths(entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        paths[i] = AssetPath::normalize(entries[i].path);
+        toc[i].hash = Hash::fnv1a(std::string_view(paths[i]));
+        toc[i].nameOffset = static_cast<uint32_t>(names.size());
+        toc[i].nameLength = static_cast<uint32_t>(paths[i].size());
+        names += paths[i];
+    }
+
+    uint32_t slotCount = std::bit_ceil(static_cast<uint32_t>(entries.size() * 2 + 1));
+    std::vector<uint32_t> slots(slotCount, 0);
+    for (size_t i = 0; i < entries.size(); i++) {
+        size_t slot = toc[i].hash & (slotCount - 1);
+        while (slots[slot] != 0) {
+            if (paths[slots[slot] - 1] == paths[i]) throw std::runtime_error("Duplicate pak archive path: " + paths[i]);
+            slot = (slot + 1) & (slotCount - 1);
+        }
+        slots[slot] = static_cast<uint32_t>(i + 1);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) throw std::runtime_error("Cannot open file for writing: " + path);
+    const char padding[PakArchive::ALIGNMENT] = {};
+    size_t offset = sizeof(PakHeader);
+    file.write(padding, sizeof(PakHeader));
+
+    // One file mapped at a time, so archives larger than memory can be built.
+    for (size_t i = 0; i < entries.size(); i++) {
+        size_t aligned = alignUp(offset, PakArchive::ALIGNMENT);
+        file.write(padding, static_cast<std::streamsize>(aligned - offset));
+        MappedFile source(entries[i].nativePath);
+        file.write(reinterpret_cast<const char*>(source.data()), static_cast<std::streamsize>(source.size()));
+        toc[i].offset = aligned;
+        toc[i].size = source.size();
+        offset = aligned + source.size();
+    }
+
+    PakHeader header{PAK_MAGIC, PAK_VERSION, static_cast<uint32_t>(PakArchive::ALIGNMENT),
+                     static_cast<uint32_t>(entries.size()), slotCount, 0,
+                     alignUp(offset, alignof(TocEntry)), 0, names.size()};
+    file.write(padding, static_cast<std::streamsize>(header.tocOffset - offset));
+    file.write(reinterpret_cast<const char*>(toc.data()), static_cast<std::streamsize>(toc.size() * sizeof(TocEntry)));
+    file.write(reinterpret_cast<const char*>(slots.data()), static_cast<std::streamsize>(slots.size() * sizeof(uint32_t)));
+    header.namesOffset = header.tocOffset + toc.size() * sizeof(TocEntry) + slots.size() * sizeof(uint32_t);
+    file.write(names.data(), static_cast<std::streamsize>(names.size()));
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!file) throw std::runtime_error("Cannot write file: " + path);
+}
+
+void PakArchive::writeDirectory(const std::string& path, const std::string& directory) {
+    namespace fs = std::filesystem;
+    fs::path archive = fs::weakly_canonical(path);
+    std::vector<Entry> entries;
+    for (const fs::directory_entry& file : fs::recursive_directory_iterator(directory)) {
+        if (!file.is_regular_file() || fs::weakly_canonical(file.path()) == archive) continue;
+        entries.push_back({fs::relative(file.path(), directory).generic_string(), file.path().string()});
+    }
+    // Sorted so the same tree always gives the same archive.
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.path < b.path; });
+    write(path, entries);
+}
+
+std::optional<FileData> PakArchive::open(const std::string& path) const {
+    const TocEntry* entry = find(path);
+    if (!entry) return std::nullopt;
+    return FileData(m_file, m_file->getBytes().subspan(entry->offset, entry->size));
+}
+
+std::vector<std::string> PakArchive::getPaths() const {
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < m_entryCount; i++) paths.emplace_back(getName(m_entries[i]));
+    return paths;
+}
+
+const PakArchive::TocEntry* PakArchive::find(std::string_view path) const {
+    if (m_slotCount == 0) return nullptr;
+    uint64_t hash = Hash::fnv1a(path);
+    for (size_t slot = hash & (m_slotCount - 1);; slot = (slot + 1) & (m_slotCount - 1)) {
+        uint32_t index = m_slots[slot];
+        if (index == 0) return nullptr;
+        const TocEntry& entry = m_entries[index - 1];
+        if (entry.hash == hash && getName(entry) == path) return &entry;
+    }
+}
+
+std::string_view PakArchive::getName(const TocEntry& entry) const {
+    return {m_names + entry.nameOffset, entry.nameLength};
+}
@@ -0,0 +1,73 @@
+#ifndef PAK_ARCHIVE_H_
+#define PAK_ARCHIVE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "virtual_file_system.hpp"
+
+class MappedFile;
+
+/**
+ * @class PakArchive
+ * @brief Read-only archive of many files in one memory mapped file.
+ *
+ * A ".pak" holds the contents of its files, each aligned for direct use, a
+ * table of contents and an open addressing hash table over their normalized
+ * paths. Opening a file is a hash lookup and a view into the mapping: nothing
+ * is read or copied until the pages are touched.
+ */
+class PakArchive : public FileSource {
+public:
+    // Alignment of the file contents inside the archive.
+    static constexpr size_t ALIGNMENT = 64;
+
+    struct Entry {
+        // Path inside the archive, normalized on write.
+        std::string path;
+        std::string nativePath;
+    };
+
+    /**
+     * @throws std::runtime_error if the file cannot be mapped or is not a
+     * valid archive.
+     */
+    explicit PakArchive(const std::string& path);
+
+    /**
+     * @brief Write an archive of `entries` at `path`.
+     * @throws std::runtime_error if a file cannot be read or written, or two
+     * entries have the same path.
+     */
+    static void write(const std::string& path, const std::vector<Entry>& entries);
+    /**
+     * @brief Write an archive of every file under `directory`, with paths
+     * relative to it.
+     */
+    static void writeDirectory(const std::string& path, const std::string& directory);
+
+    bool exists(const std::string& path) const override { return find(path) != nullptr; }
+    std::optional<FileData> open(const std::string& path) const override;
+    std::string getNativePath(const std::string&) const override { return ""; }
+
+    size_t getFileCount() const { return m_entryCount; }
+    std::vector<std::string> getPaths() const;
+
+private:
+    struct TocEntry;
+
+    std::shared_ptr<const MappedFile> m_file;
+    const TocEntry* m_entries{nullptr};
+    size_t m_entryCount{0};
+    const uint32_t* m_slots{nullptr};
+    size_t m_slotCount{0};
+    const char* m_names{nullptr};
+
+    const TocEntry* find(std::string_view path) const;
+    std::string_view getName(const TocEntry& entry) const;
+};
+
+#endif
@@ -0,0 +1,108 @@
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+
+#include "virtual_file_system.hpp"
+#include "pak_archive.hpp"
+#include "asset_path.hpp"
+#include "mapped_file.hpp"
+
+static bool isAbsolute(std::string_view path) {
+    return (!path.empty() && (path[0] == '/' || path[0] == '\\')) || (path.size() > 1 && path[1] == ':');
+}
+
+DirectorySource::DirectorySource(std::string directory) : m_directory(AssetPath::normalize(directory)) {}
+
+bool DirectorySource::exists(const std::string& path) const {
+    std::error_code error;
+    return std::filesystem::is_regular_file(getNativePath(path), error);
+}
+
+std::optional<FileData> DirectorySource::open(const std::string& path) const {
+    std::string nativePath = getNativePath(path);
+    if (!exists(path)) return std::nullopt;
+    auto file = std::make_shared<const MappedFile>(nativePath);
+    return FileData(file, file->getBytes());
+}
+
+std::string DirectorySource::getNativePath(const std::string& path) const {
+    return m_directory.empty() ? path : m_directory + '/' + path;
+}
+
+VirtualFileSystem& VirtualFileSystem::getInstance() {
+    static VirtualFileSystem& instance = [] () -> VirtualFileSystem& {
+        static VirtualFileSystem fileSystem;
+        fileSystem.mountDirectory("", ".");
+        return fileSystem;
+    }();
+    return instance;
+}
+
+void VirtualFileSystem::mount(std::string_view mountPoint, std::shared_ptr<FileSource> source) {
+    std::unique_lock lock(m_mutex);
+    m_mounts.push_back({AssetPath::normalize(mountPoint), std::move(source)});
+}
+
+void VirtualFileSystem::mountDirectory(std::string_view mountPoint, const std::string& directory) {
+    mount(mountPoint, std::make_shared<DirectorySource>(directory));
+}
+
+void VirtualFileSystem::mountArchive(std::string_view mountPoint, const std::string& archivePath) {
+    mount(mountPoint, std::make_shared<PakArchive>(archivePath));
+}
+
+void VirtualFileSystem::unmountAll() {
+    std::unique_lock lock(m_mutex);
+    m_mounts.clear();
+}
+
+template <typename Visitor>
+bool VirtualFileSystem::visit(std::string_view path, Visitor&& visitor) const {
+    std::string normalized = AssetPath::normalize(path);
+    if (isAbsolute(path)) {
+        static const DirectorySource disk("");
+        return visitor(static_cast<const FileSource&>(disk), normalized);
+    }
+
+    std::shared_lock lock(m_mutex);
+    for (auto mount = m_mounts.rbegin(); mount != m_mounts.rend(); ++mount) {
+        std::string relative;
+        if (mount->point.empty()) {
+            relative = normalized;
+        } else if (normalized.size() > mount->point.size() && normalized[mount->point.size()] == '/' &&
+                   normalized.compare(0, mount->point.size(), mount->point) == 0) {
+            relative = normalized.substr(mount->point.size() + 1);
+        } else {
+            continue;
+        }
+        if (visitor(static_cast<const FileSource&>(*mount->source), relative)) return true;
+    }
+    return false;
+}
+
+bool VirtualFileSystem::exists(std::string_view path) const {
+    return visit(path, [](const FileSource& source, const std::string& relative) {
+        return source.exists(relative);
+    });
+}
+
+FileData VirtualFileSystem::open(std::string_view path) const {
+    std::optional<FileData> data;
+    visit(path, [&](const FileSource& source, const std::string& relative) {
+        data = source.open(relative);
+        return data.has_value();
+    });
+    if (!data) throw std::runtime_error("Cannot open file: " + std::string(path));
+    return std::move(*data);
+}
+
+std::string VirtualFileSystem::getNativePath(std::string_view path) const {
+    std::string nativePath;
+    visit(path, [&](const FileSource& source, const std::string& relative) {
+        if (!source.exists(relative)) return false;
+        // Found first in an archive: the file on disk, if any, is hidden.
+        nativePath = source.getNativePath(relative);
+        return true;
+    });
+    return nativePath;
+}
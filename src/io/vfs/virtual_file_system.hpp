@@ -0,0 +1,130 @@
+#ifndef VIRTUAL_FILE_SYSTEM_H_
+#define VIRTUAL_FILE_SYSTEM_H_
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Read-only contents of a file opened through the VirtualFileSystem.
+ * Keeps its mapping alive, so views into it stay valid as long as it does.
+ */
+class FileData {
+public:
+    FileData() = default;
+    FileData(std::shared_ptr<const void> owner, std::span<const unsigned char> bytes)
+        : m_owner(std::move(owner)), m_bytes(bytes) {}
+
+    const unsigned char* data() const { return m_bytes.data(); }
+    size_t size() const { return m_bytes.size(); }
+    std::span<const unsigned char> getBytes() const { return m_bytes; }
+    std::string_view getText() const { return {reinterpret_cast<const char*>(m_bytes.data()), m_bytes.size()}; }
+
+private:
+    std::shared_ptr<const void> m_owner;
+    std::span<const unsigned char> m_bytes;
+};
+
+/**
+ * @brief Files mounted in the VirtualFileSystem. Paths given to a source are
+ * normalized and relative to its mount point.
+ */
+class FileSource {
+public:
+    virtual ~FileSource() = default;
+
+    virtual bool exists(const std::string& path) const = 0;
+    // std::nullopt if the source has no such file.
+    virtual std::optional<FileData> open(const std::string& path) const = 0;
+    /**
+     * @brief Path of the file on disk, for libraries that only open files by
+     * name. Empty if the file is not a loose file.
+     */
+    virtual std::string getNativePath(const std::string& path) const = 0;
+};
+
+/**
+ * @brief A directory on disk. Files are memory mapped when opened.
+ */
+class DirectorySource : public FileSource {
+public:
+    explicit DirectorySource(std::string directory);
+
+    bool exists(const std::string& path) const override;
+    std::optional<FileData> open(const std::string& path) const override;
+    std::string getNativePath(const std::string& path) const override;
+
+private:
+    std::string m_directory;
+};
+
+/**
+ * @class VirtualFileSystem
+ * @brief Single namespace for the files of the application, made of
+ * directories and archives mounted at virtual paths.
+ * This class is a Singleton.
+ *
+ * Paths are normalized before lookup, so ".\\res\\teapot.fbx" and
+ * "res/teapot.fbx" name the same file. A path is looked up in the sources
+ * whose mount point contains it, the most recently mounted first: an archive
+ * mounted over a directory overrides the files it holds. Absolute paths
+ * bypass the mounts and are read from disk.
+ *
+ * Mounting is meant for startup; lookups are thread safe.
+ */
+class VirtualFileSystem {
+public:
+    /**
+     * @brief File system with the working directory mounted at the root.
+     */
+    static VirtualFileSystem& getInstance();
+
+    VirtualFileSystem() = default;
+    VirtualFileSystem(const VirtualFileSystem&) = delete;
+    VirtualFileSystem& operator=(const VirtualFileSystem&) = delete;
+
+    void mount(std::string_view mountPoint, std::shared_ptr<FileSource> source);
+    void mountDirectory(std::string_view mountPoint, const std::string& directory);
+    /**
+     * @throws std::runtime_error if the archive cannot be opened.
+     */
+    void mountArchive(std::string_view mountPoint, const std::string& archivePath);
+    void unmountAll();
+
+    bool exists(std::string_view path) const;
+    /**
+     * @throws std::runtime_error if no mounted source has the file.
+     */
+    FileData open(std::string_view path) const;
+    std::string readText(std::string_view path) const { return std::string(open(path).getText()); }
+    /**
+     * @brief Path on disk of `path`, empty if the file is missing or only
+     * found in an archive.
+     */
+    std::string getNativePath(std::string_view path) const;
+
+private:
+    struct Mount {
+        // Normalized, empty for the root.
+        std::string point;
+        std::shared_ptr<FileSource> source;
+    };
+
+    // Most recent last, searched backwards.
+    std::vector<Mount> m_mounts;
+    mutable std::shared_mutex m_mutex;
+
+    /**
+     * @brief Call `visit(source, relativePath)` for each source that may
+     * hold `path`, in priority order, until it returns true.
+     */
+    template <typename Visitor>
+    bool visit(std::string_view path, Visitor&& visitor) const;
+};
+
+#endif
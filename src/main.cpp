@@ -27,13 +27,40 @@
 #include <material.hpp>
 
 #include <input.hpp>
-#include <materials.hpp>
+#include <material_registry.hpp>
+#include <material_table.hpp>
 #include <entity.hpp>
 #include <entity_manager.hpp>
+#include <transform_hierarchy.hpp>
+#include <memory_report.hpp>
+#include <virtual_file_system.hpp>
+#include <gpu_budget.hpp>
+#include <allocation_tracker.hpp>
+#include <frame_arena.hpp>
+#include <stream_buffer.hpp>
+#include <frame_uniforms.hpp>
+#include <config_manager.hpp>
+#include <render_thread.hpp>
+#include <render_path.hpp>
+#include <deferred_renderer.hpp>
+#include <depth_prepass.hpp>
+#include <gpu_timer.hpp>
+#include <shadow_planner.hpp>
+#include <shadow_renderer.hpp>
+#include <shader_permutations.hpp>
+#include <skin_palette.hpp>
+#include <animator.hpp>
+#include <asset_loader.hpp>
+#include <async_assets.hpp>
+#include <cmath>
+#include <cstring>
 
 
 constexpr unsigned int WINDOW_WIDTH = 1980;
 constexpr unsigned int WINDOW_HEIGHT = 1080;
+constexpr float FAR_PLANE = 100.0f;
+// GL thread time given each frame to finishing asset loads.
+constexpr std::chrono::microseconds ASSET_UPLOAD_BUDGET(2000);
 
 void GLAPIENTRY openglDebugCallback(GLenum source,
                                     GLenum type,
@@ -75,6 +102,9 @@ int main(int argc, char* argv[]) {
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 6);
+    // Matches the G-buffer depth format, which is blitted into it.
+    SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 24);
+    SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE, 8);
 
     SDL_Window* window = SDL_CreateWindow(
         "OpenGL Engine", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
@@ -150,47 +180,90 @@ int main(int argc, char* argv[]) {
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;     // Enable Keyboard Controls
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;      // Enable Gamepad Controls
     io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;      // Enable Docking
-    io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;    // Enable Multi-Viewport
 
     ImGui::StyleColorsDark();
 
     ImGui_ImplSDL2_InitForOpenGL(window, context);
     ImGui_ImplOpenGL3_Init();
 
-    ShaderEngine shaderEngineLighting;
-    ShaderEngine shaderEngineLight;
-
-    Shader lightingVertexShader = ShaderFactory::createShader(".\\shaders\\lighting_vertex.glsl", GL_VERTEX_SHADER);
-    shaderEngineLighting.addShader(lightingVertexShader);
-    Shader lightingFragmentShader = ShaderFactory::createShader(".\\shaders\\lighting_fragment.glsl", GL_FRAGMENT_SHADER);
-    shaderEngineLighting.addShader(lightingFragmentShader);
-    shaderEngineLighting.compile();
-
-    Shader lightVertexShader = ShaderFactory::createShader(".\\shaders\\light_vertex.glsl", GL_VERTEX_SHADER);
-    shaderEngineLight.addShader(lightVertexShader);
-    Shader lightFragmentShader = ShaderFactory::createShader(".\\shaders\\light_fragment.glsl", GL_FRAGMENT_SHADER);
-    shaderEngineLight.addShader(lightFragmentShader);
-    shaderEngineLight.compile();
+    // Packed assets override the loose files of the working directory.
+    for (const auto& [mountPoint, archive] : ConfigurationManager::getInstance()->getArchives()) {
+        try {
+            VirtualFileSystem::getInstance().mountArchive(mountPoint, archive);
+            std::cout << "VFS::MOUNTED::" << archive << " at \"" << mountPoint << "\"" << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "ERROR::VFS::" << e.what() << std::endl;
+        }
+    }
 
-    ShaderEngine basicEngine = ShaderEngineFactory::createEngine(".\\shaders\\basic_vertex.glsl", ".\\shaders\\basic_fragment.glsl");
+    // Startup assets load concurrently, read and decoded on worker threads;
+    // their uploads run on this thread in waitAll() below.
+    AssetLoader& assetLoader = AssetLoader::getInstance();
+    AssetHandle<ShaderEngine> lightingEngineLoad = AsyncAssets::loadShaderEngine("shaders/lighting_vertex.glsl", "shaders/lighting_fragment.glsl");
+    AssetHandle<ShaderEngine> lightEngineLoad = AsyncAssets::loadShaderEngine("shaders/light_vertex.glsl", "shaders/light_fragment.glsl");
+    AssetHandle<ShaderEngine> basicEngineLoad = AsyncAssets::loadShaderEngine("shaders/basic_vertex.glsl", "shaders/basic_fragment.glsl");
+    // Lit forward draws get a variant per texture set and frame lighting.
+    auto lightingPermutations = std::make_shared<ShaderPermutations>("shaders/lighting_vertex.glsl", "shaders/lighting_fragment.glsl",
+        ALL_SHADER_FEATURES);
 
     glEnable(GL_DEPTH_TEST);
     glDepthFunc(GL_LESS);
 
+    DepthPrepass depthPrepass;
+    bool depthPrepassEnabled = ConfigurationManager::getInstance()->getDepthPrepass();
+    std::unique_ptr<DeferredRenderer> deferredRenderer;
+    if (ConfigurationManager::getInstance()->getRenderPath() == RenderPath::DEFERRED)
+        deferredRenderer = std::make_unique<DeferredRenderer>(currentWindowWidth, currentWindowHeight);
+
     Cube cube(1.0f);
     // cube.setTexture("C:\\Users\\NULL\\Documents\\Games\\LambEngine\\res\\box.bmp", TextureType::DIFFUSE);
-    cube.setShaderEngine(shaderEngineLight);
     Sphere sphere(1.0f);
 
     Cube cubeLighting(1.0f);
-    cubeLighting.setShaderEngine(shaderEngineLighting);
-    cubeLighting.setTexture(".\\res\\box.bmp", TextureType::DIFFUSE);
-    cubeLighting.setTexture(".\\res\\box_specular_map.png", TextureType::SPECULAR);
+    cubeLighting.setShaderPermutations(lightingPermutations);
+    AssetHandle<GpuTexture> boxDiffuseLoad = AsyncAssets::loadTexture("res/box.bmp");
+    AssetHandle<GpuTexture> boxSpecularLoad = AsyncAssets::loadTexture("res/box_specular_map.png");
 
     SDL_SetRelativeMouseMode(SDL_TRUE);
 
-    Model teapot(".\\res\\teapot.fbx");
-    teapot.setShaderEngine(basicEngine);
+    AssetHandle<Model> teapotLoad = AsyncAssets::loadModel("res/teapot.fbx");
+
+    // Optional animated model drawn as a crowd, every character on its own
+    // clip and time.
+    ConfigurationManager* config = ConfigurationManager::getInstance();
+    AssetHandle<Model> crowdLoad;
+    if (!config->getCrowdModel().empty())
+        crowdLoad = AsyncAssets::loadModel(config->getCrowdModel());
+
+    assetLoader.waitAll();
+    std::shared_ptr<ShaderEngine> shaderEngineLighting = lightingEngineLoad.get();
+    std::shared_ptr<ShaderEngine> shaderEngineLight = lightEngineLoad.get();
+    std::shared_ptr<ShaderEngine> basicEngine = basicEngineLoad.get();
+    cube.setShaderEngine(shaderEngineLight);
+    cubeLighting.setTexture(boxDiffuseLoad.get(), TextureType::DIFFUSE, "res/box.bmp");
+    cubeLighting.setTexture(boxSpecularLoad.get(), TextureType::SPECULAR, "res/box_specular_map.png");
+
+    // Null if the load failed, like the crowd model.
+    std::shared_ptr<Model> teapot = teapotLoad.get();
+    if (teapot) teapot->setShaderEngine(basicEngine);
+    std::shared_ptr<Model> crowdModel = crowdLoad.isValid() ? crowdLoad.get() : nullptr;
+    if (crowdModel) crowdModel->setShaderPermutations(lightingPermutations);
+    Animator animator;
+    std::vector<glm::mat4> crowdTransforms;
+    if (crowdModel && crowdModel->isSkinned()) {
+        const std::vector<AnimationClip>& clips = crowdModel->getAnimations();
+        uint32_t count = config->getCrowdCount();
+        uint32_t columns = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(count))));
+        for (uint32_t i = 0; i < count; i++) {
+            const AnimationClip* clip = clips.empty() ? nullptr : &clips[i % clips.size()];
+            float time = clip ? clip->getDuration() * (i % 17) / 17.0f : 0.0f;
+            animator.add(crowdModel->getSkeleton(), clip, time);
+            glm::vec3 position(2.0f * (i % columns), -3.0f, -5.0f - 2.0f * (i / columns));
+            crowdTransforms.push_back(glm::translate(glm::mat4(1.0f), position));
+        }
+    }
+
+    MemoryReport::getInstance().print(std::cout);
 
     Camera camera; 
 
@@ -210,127 +283,238 @@ int main(int argc, char* argv[]) {
     InputHandler::CursorMovementCallback callback = std::bind(&Camera::computeCursorCameraMovements, &camera, std::placeholders::_1, std::placeholders::_2);
     InputHandlerFactory::createInputHandler(callback);
 
-    Material goldMaterial = MaterialManager::getInstance()->getMaterial(MaterialType::GOLD);
-    Material silverMaterial = MaterialManager::getInstance()->getMaterial(MaterialType::SILVER);
-    Material copperMaterial = MaterialManager::getInstance()->getMaterial(MaterialType::COPPER);
+    MaterialRegistry& materials = MaterialRegistry::getInstance();
+    MaterialId gold = materials.find("Gold");
+    if (teapot && gold != INVALID_MATERIAL) teapot->setMaterial(gold);
 
-    Entity entity = EntityFactory::createEntity();
+    Entity& entity = EntityFactory::createEntity();
 
-    while (InputSystem::getInstance()->shouldStop()) {
+    TransformHierarchy transforms;
+    TransformHandle pointLightsRoot = transforms.create();
+    TransformHandle pointLightHandles[4];
+    for (int i = 0; i < 4; i++) {
+        Transform local;
+        local.position = pointLightPositions[i];
+        local.scale = glm::vec3(0.2f);
+        pointLightHandles[i] = transforms.create(pointLightsRoot, local);
+    }
 
-        Time::getInstance().computeDeltaTime();
-        InputSystem::getInstance()->update(window);
+    // Transient per-frame data, such as the shadow casters, released all at
+    // once at the start of the next frame.
+    FrameArena frameArena(1 << 20);
+    // Per-frame GPU data, written while the GPU still reads earlier frames.
+    StreamBuffer frameStream(config->getStreamBufferBytes(), config->getFramesInFlight());
+    // GPU time of the depth pre-pass and of shading the lit draws.
+    GpuTimer prepassTimer(config->getFramesInFlight() + 1);
+    GpuTimer shadingTimer(config->getFramesInFlight() + 1);
+    GpuTimer shadowTimer(config->getFramesInFlight() + 1);
+
+    // Shadow views are planned on this thread and rendered on the render thread.
+    ShadowSettings shadowSettings = config->getShadowSettings();
+    ShadowPlanner shadowPlanner(shadowSettings);
+    ShadowRenderer shadowRenderer(shadowSettings.atlasSize);
+    bool shadowsEnabled = true;
+    // Draws index the materials of the registry from this table.
+    MaterialTable materialTable;
+
+    // Everything below runs on the render thread, one frame behind the loop.
+    auto renderFrame = [&](RenderSnapshot& snapshot) {
+        GpuBudget::getInstance().beginFrame();
+        frameStream.beginFrame();
+        ShaderPermutations::updateAll();
+        assetLoader.runGlTasks(ASSET_UPLOAD_BUDGET);
+        materialTable.update(materials);
+
+        // Shadows, the pre-pass and shading all read the same palettes.
+        if (!snapshot.skinPalettes.empty()) {
+            size_t bytes = snapshot.skinPalettes.size() * sizeof(glm::mat4);
+            StreamBuffer::Allocation palettes = frameStream.allocate(bytes);
+            std::memcpy(palettes.data, snapshot.skinPalettes.data(), bytes);
+            frameStream.bindRange(GL_SHADER_STORAGE_BUFFER, SKIN_PALETTE_BINDING, palettes);
+        }
 
-        ImGui_ImplOpenGL3_NewFrame();
-        ImGui_ImplSDL2_NewFrame();
-        ImGui::NewFrame();
+        shadowTimer.begin();
+        shadowRenderer.render(snapshot.shadows, frameStream);
+        shadowTimer.end();
+        glViewport(0, 0, currentWindowWidth, currentWindowHeight);
 
-        ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // Handle platform windows for multi-viewports
-        ImGuiIO& io = ImGui::GetIO();
-        if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable) {
-            SDL_Window* backup_current_window = SDL_GL_GetCurrentWindow();
-            SDL_GLContext backup_current_context = SDL_GL_GetCurrentContext();
+        frameStream.bindRange(GL_UNIFORM_BUFFER, FRAME_UNIFORMS_BINDING,
+                              frameStream.push(snapshot.camera));
+        snapshot.lightClusters.upload(frameStream);
+
+        DepthPrepass* prepass = snapshot.depthPrepass ? &depthPrepass : nullptr;
+        if (deferredRenderer) {
+            deferredRenderer->setDirectionalLight(snapshot.directionalLight);
+            // The pre-pass is part of the geometry pass, timed as a whole.
+            shadingTimer.begin();
+            deferredRenderer->render(snapshot.commands, snapshot.camera, snapshot.cameraPosition,
+                                     snapshot.shaderFeatures, prepass);
+            shadingTimer.end();
+        } else {
+            if (prepass) {
+                prepassTimer.begin();
+                prepass->render(snapshot.commands);
+                prepassTimer.end();
+                DepthPrepass::beginShading();
+            }
+            shadingTimer.begin();
+            snapshot.commands.execute({.features = snapshot.shaderFeatures});
+            shadingTimer.end();
+            if (prepass) DepthPrepass::endShading();
+        }
+        snapshot.unlitCommands.execute();
 
-            ImGui::UpdatePlatformWindows();
-            ImGui::RenderPlatformWindowsDefault();
+        // shaderEngineLighting->use();
 
-            SDL_GL_MakeCurrent(backup_current_window, backup_current_context);
-        }
+        // shaderEngineLighting->setVec3("directionalLight.direction", -0.2f, -1.0f, -0.3f); 
+        // shaderEngineLighting->setVec3("directionalLight.ambient", 0.05f, 0.05f, 0.05f); 
+        // shaderEngineLighting->setVec3("directionalLight.diffuse", 0.4f, 0.4f, 0.4f);
+        // shaderEngineLighting->setVec3("directionalLight.specular", 0.5f, 0.5f, 0.5f);
 
-        const Uint8* keystate = SDL_GetKeyboardState(NULL);
-        std::vector<Action> actions = getActions(keystate);
-        camera.computeActions(actions);
+        // shaderEngineLighting->setFloat("material.shininess", 64.0f);
 
-        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        // shaderEngineLighting->setVec3("spotlight.ambient", 0.05f, 0.05f, 0.05f); 
+        // shaderEngineLighting->setVec3("spotlight.diffuse", 0.8f, 0.8f, 0.8f);
+        // shaderEngineLighting->setVec3("spotlight.specular", 1.0f, 1.0f, 1.0f);
+        // shaderEngineLighting->setFloat("spotlight.constant",  1.0f);
+        // shaderEngineLighting->setFloat("spotlight.linear",    0.09f);
+        // shaderEngineLighting->setFloat("spotlight.quadratic", 0.032f);
+        // shaderEngineLighting->setVec3("spotlight.position", snapshot.cameraPosition);
+        // shaderEngineLighting->setVec3("spotlight.direction", snapshot.cameraDirection);
+        // shaderEngineLighting->setFloat("spotlight.radius", glm::cos(glm::radians(12.5f)));
+        // shaderEngineLighting->setFloat("spotlight.outerRadius", glm::cos(glm::radians(17.5f)));
 
-        glm::mat4 view(1.0f);
-        view = camera.getViewMatrix();
+        // shaderEngineLighting->setVec3("cameraPosition", snapshot.cameraPosition);
 
-        glm::mat4 projection;
-        projection = glm::perspective(glm::radians(45.0f),
-            currrentWindowRatio, 0.1f, 100.0f);
+        // for (int i = 0; i < 10; i++) {
+        //     glm::mat4 model(1.0f);
+        //     model = glm::translate(model, cubePositions[i]);
+        //     float angle = 20.0f * i;
+        //     model = glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
+        //     shaderEngineLighting->setMat4("model", model);
+        //     cubeLighting.draw();
+        // }
 
-        shaderEngineLight.use();
-        shaderEngineLight.setMat4("projection", projection);
-        shaderEngineLight.setMat4("view", view);
+        ImGui_ImplOpenGL3_NewFrame();
+        if (ImDrawData* drawData = snapshot.ui.getDrawData())
+            ImGui_ImplOpenGL3_RenderDrawData(drawData);
 
-        glm::mat4 modelMatrix;
-        for (int i = 0; i < 4; i++) {
-            modelMatrix = glm::mat4(1.0f);
-            modelMatrix = glm::translate(modelMatrix, pointLightPositions[i]);
-            modelMatrix = glm::scale(modelMatrix, glm::vec3(0.2f));
-            shaderEngineLight.setMat4("model", modelMatrix);
-            cube.draw();
-        }
+        GpuBudget::getInstance().enforce();
+        frameStream.endFrame();
+    };
 
-        modelMatrix = glm::mat4(1.0f);
-        shaderEngineLight.setMat4("model", modelMatrix);
+    // Creates the ImGui font texture while the context is still current here.
+    ImGui_ImplOpenGL3_NewFrame();
+    RenderThread renderThread(window, context, renderFrame);
 
-        // shaderEngineLighting.use();
+    while (InputSystem::getInstance()->shouldStop()) {
 
-        // for (int i = 0; i < 4; i++) {
-        //     std::string lightPositionID = std::format("pointLights[{}]", i);
-        //     shaderEngineLighting.setVec3(lightPositionID + ".position", pointLightPositions[i]);
-        //     shaderEngineLighting.setVec3(lightPositionID + ".ambient", 0.05f, 0.05f, 0.05f); 
-        //     shaderEngineLighting.setVec3(lightPositionID + ".diffuse", 0.8f, 0.8f, 0.8f);
-        //     shaderEngineLighting.setVec3(lightPositionID + ".specular", 1.0f, 1.0f, 1.0f);
+        AllocationTracker::newFrame();
+        frameArena.reset();
 
-        //     shaderEngineLighting.setFloat(lightPositionID + ".constant",  1.0f);
-        //     shaderEngineLighting.setFloat(lightPositionID + ".linear",    0.09f);
-        //     shaderEngineLighting.setFloat(lightPositionID + ".quadratic", 0.032f);
-        // }
+        Time::getInstance().computeDeltaTime();
+        {
+            ScopedAllocationTag inputTag(AllocationTag::INPUT);
+            InputSystem::getInstance()->update(window);
+        }
+
+        ScopedAllocationTag uiTag(AllocationTag::UI);
+        ImGui_ImplSDL2_NewFrame();
+        ImGui::NewFrame();
+        ImGui::Begin("Renderer");
+        ImGui::Checkbox("Depth pre-pass", &depthPrepassEnabled);
+        ImGui::Checkbox("Shadows", &shadowsEnabled);
+        if (depthPrepassEnabled && !deferredRenderer)
+            ImGui::Text("Depth pre-pass: %.3f ms", prepassTimer.getMilliseconds());
+        ImGui::Text("Shading: %.3f ms", shadingTimer.getMilliseconds());
+        if (shadowsEnabled) {
+            ImGui::Text("Shadows: %.3f ms, %u of %u views rendered", shadowTimer.getMilliseconds(),
+                        shadowPlanner.getDirtyViewCount(), shadowPlanner.getViewCount());
+        }
+        ImGui::End();
+        ImGui::Render();
+
+        const Uint8* keystate = SDL_GetKeyboardState(NULL);
+        ActionList actions = getActions(keystate);
+        camera.computeActions(actions);
 
-        // shaderEngineLighting.setVec3("directionalLight.direction", -0.2f, -1.0f, -0.3f); 
-        // shaderEngineLighting.setVec3("directionalLight.ambient", 0.05f, 0.05f, 0.05f); 
-        // shaderEngineLighting.setVec3("directionalLight.diffuse", 0.4f, 0.4f, 0.4f);
-        // shaderEngineLighting.setVec3("directionalLight.specular", 0.5f, 0.5f, 0.5f);
+        ScopedAllocationTag rendererTag(AllocationTag::RENDERER);
+        RenderSnapshot& snapshot = renderThread.beginFrame();
+        snapshot.ui.capture(ImGui::GetDrawData());
 
-        // shaderEngineLighting.setFloat("material.shininess", 64.0f);
+        glm::mat4 view(1.0f);
+        view = camera.getViewMatrix();
 
-        // shaderEngineLighting.setVec3("spotlight.ambient", 0.05f, 0.05f, 0.05f); 
-        // shaderEngineLighting.setVec3("spotlight.diffuse", 0.8f, 0.8f, 0.8f);
-        // shaderEngineLighting.setVec3("spotlight.specular", 1.0f, 1.0f, 1.0f);
-        // shaderEngineLighting.setFloat("spotlight.constant",  1.0f);
-        // shaderEngineLighting.setFloat("spotlight.linear",    0.09f);
-        // shaderEngineLighting.setFloat("spotlight.quadratic", 0.032f);
-        // shaderEngineLighting.setVec3("spotlight.position", camera.getPosition());
-        // shaderEngineLighting.setVec3("spotlight.direction", camera.getDirection());
-        // shaderEngineLighting.setFloat("spotlight.radius", glm::cos(glm::radians(12.5f)));
-        // shaderEngineLighting.setFloat("spotlight.outerRadius", glm::cos(glm::radians(17.5f)));
+        glm::mat4 projection;
+        projection = glm::perspective(glm::radians(45.0f),
+            currrentWindowRatio, 0.1f, FAR_PLANE);
 
-        // shaderEngineLighting.setVec3("cameraPosition", camera.getPosition());
+        snapshot.camera = FrameUniforms{view, projection};
+        snapshot.cameraPosition = camera.getPosition();
+        snapshot.cameraDirection = camera.getDirection();
+        snapshot.depthPrepass = depthPrepassEnabled;
 
-        // shaderEngineLighting.setMat4("view", view);
-        // shaderEngineLighting.setMat4("projection", projection);
+        transforms.update();
+
+        // Draws are recorded across the thread pool, each thread into its own
+        // command list, then merged into a single sorted stream.
+        snapshot.unlitCommands.record(4, 1, [&](CommandList& commands, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                const glm::mat4& world = transforms.getWorldMatrix(pointLightHandles[i]);
+                float depth = glm::length(glm::vec3(world[3]) - snapshot.cameraPosition) / FAR_PLANE;
+                commands.draw(shaderEngineLight.get(), &cube, world, depth);
+            }
+        });
 
-        // for (int i = 0; i < 10; i++) {
-        //     glm::mat4 model(1.0f);
-        //     model = glm::translate(model, cubePositions[i]);
-        //     float angle = 20.0f * i;
-        //     model = glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
-        //     shaderEngineLighting.setMat4("model", model);
-        //     cubeLighting.draw();
-        // }
-        basicEngine.use();
         glm::mat4 model(1.0f);
+        if (teapot) teapot->recordDraws(snapshot.commands.getList(), model);
+
+        if (animator.size() > 0) {
+            animator.update(Time::getInstance().getDeltaTime(), snapshot.skinPalettes);
+            snapshot.commands.record(animator.size(), 32, [&](CommandList& commands, size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    const glm::mat4& world = crowdTransforms[i];
+                    float depth = glm::length(glm::vec3(world[3]) - snapshot.cameraPosition) / FAR_PLANE;
+                    crowdModel->recordSkinnedDraws(commands, world,
+                                                   animator.getPaletteOffset(static_cast<uint32_t>(i)), depth);
+                }
+            });
+        }
+        snapshot.commands.merge();
+        snapshot.unlitCommands.merge();
 
-        basicEngine.setMat4("model", model);
-        basicEngine.setMat4("view", view);
-        basicEngine.setMat4("projection", projection);
-        // shaderEngineLighting.setMat4("model", model);
-        teapot.draw();
+        for (int i = 0; i < 4; i++) {
+            PointLight light;
+            light.position = glm::vec3(transforms.getWorldMatrix(pointLightHandles[i])[3]);
+            light.radius = light.computeRadius();
+            snapshot.pointLights.push_back(light);
+        }
 
-        glBindVertexArray(0);
+        // Lit draws cast shadows; light cubes would only shadow their own light.
+        if (shadowsEnabled) {
+            FrameVector<ShadowCaster> shadowCasters{ArenaAllocator<ShadowCaster>(frameArena)};
+            shadowCasters.reserve(snapshot.commands.size());
+            snapshot.commands.forEachPacket([&shadowCasters](const DrawPacket& packet) {
+                shadowCasters.push_back({packet.renderable, packet.model, packet.paletteOffset});
+            });
+            shadowPlanner.plan(snapshot.pointLights, {}, snapshot.directionalLight, shadowCasters,
+                               view, projection, snapshot.shadows);
+        }
+        // Disabled features are compiled out of the shaders rather than skipped at runtime.
+        snapshot.shaderFeatures = DIRECTIONAL_LIGHT;
+        if (!snapshot.pointLights.empty()) snapshot.shaderFeatures |= POINT_LIGHTS;
+        if (shadowsEnabled) snapshot.shaderFeatures |= SHADOWS;
+        snapshot.lightClusters.build(snapshot.pointLights, view, projection);
 
-        ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-        SDL_GL_SwapWindow(window);
+        renderThread.submit();
     }
 
+    renderThread.stop();
+    deferredRenderer.reset();
+
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplSDL2_Shutdown();
     ImGui::DestroyContext();
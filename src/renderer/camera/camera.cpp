@@ -2,6 +2,7 @@
 #include <time.hpp>
 #include <input.hpp>
 #include <vector>
+#include <span>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -46,7 +47,7 @@ void Camera::computeAction(Action action) {
     }
 }
 
-void Camera::computeActions(const std::vector<Action> &actions) {
+void Camera::computeActions(std::span<const Action> actions) {
     for (auto action : actions)
         computeAction(action);
 }
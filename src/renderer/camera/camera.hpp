@@ -7,6 +7,7 @@
 
 #include <input.hpp>
 #include <vector>
+#include <span>
 
 class Camera {
 public:
@@ -19,7 +20,7 @@ public:
 
     void computeCursorCameraMovements(int, int);
 
-    void computeActions(const std::vector<Action> &actions);
+    void computeActions(std::span<const Action> actions);
 
     glm::mat4 getViewMatrix() const {
         return glm::lookAt(m_position, m_position + m_direction, m_up);
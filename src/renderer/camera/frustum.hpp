@@ -0,0 +1,46 @@
+#ifndef FRUSTUM_H_
+#define FRUSTUM_H_
+
+#include <glm/glm.hpp>
+
+/**
+ * @struct Frustum
+ * @brief Six planes bounding the clip volume of a view-projection matrix,
+ * normals pointing inside.
+ */
+struct Frustum {
+    glm::vec4 planes[6];
+
+    /**
+     * @brief Planes of `viewProjection`, extracted from its rows.
+     */
+    static Frustum fromMatrix(const glm::mat4& viewProjection) {
+        const glm::mat4& m = viewProjection;
+        glm::vec4 row[4];
+        for (int i = 0; i < 4; i++)
+            row[i] = glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+
+        Frustum frustum;
+        frustum.planes[0] = row[3] + row[0];
+        frustum.planes[1] = row[3] - row[0];
+        frustum.planes[2] = row[3] + row[1];
+        frustum.planes[3] = row[3] - row[1];
+        frustum.planes[4] = row[3] + row[2];
+        frustum.planes[5] = row[3] - row[2];
+        for (glm::vec4& plane : frustum.planes)
+            plane /= glm::length(glm::vec3(plane));
+        return frustum;
+    }
+
+    /**
+     * @brief False only if the sphere is entirely outside one of the planes.
+     */
+    bool intersectsSphere(const glm::vec3& center, float radius) const {
+        for (const glm::vec4& plane : planes) {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) return false;
+        }
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,55 @@
+#include <deferred_renderer.hpp>
+#include <command_list.hpp>
+#include <shader_engine.hpp>
+#include <shader_permutations.hpp>
+#include <gl_state.hpp>
+#include <depth_prepass.hpp>
+
+
+DeferredRenderer::DeferredRenderer(GLsizei width, GLsizei height)
+    : m_gbuffer(width, height),
+      m_geometryPermutations(std::make_unique<ShaderPermutations>("shaders/gbuffer_vertex.glsl", "shaders/gbuffer_fragment.glsl",
+          DIFFUSE_MAP | SPECULAR_MAP | SKINNING)),
+      m_lightingPermutations(std::make_unique<ShaderPermutations>("shaders/deferred_lighting_vertex.glsl", "shaders/deferred_lighting_fragment.glsl",
+          SHADOWS | POINT_LIGHTS | DIRECTIONAL_LIGHT)),
+      m_fullscreenVertexArray(GL::createVertexArray()) {}
+
+DeferredRenderer::~DeferredRenderer() = default;
+
+void DeferredRenderer::render(const CommandQueue& commands, const FrameUniforms& camera, const glm::vec3& cameraPosition,
+                              ShaderFeatures features, DepthPrepass* prepass) {
+    GLState& state = GLState::getInstance();
+
+    m_gbuffer.bindForWriting();
+    if (prepass) {
+        prepass->render(commands);
+        DepthPrepass::beginShading();
+    }
+    commands.execute({.permutations = m_geometryPermutations.get()});
+    if (prepass) DepthPrepass::endShading();
+
+    // Every pixel is lit once; depth is neither tested nor written.
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glDisable(GL_DEPTH_TEST);
+    glDepthMask(GL_FALSE);
+
+    // The variant can change from one frame to the next, and uniforms belong
+    // to its program, so all of them are set every frame.
+    ShaderEngine* lighting = m_lightingPermutations->get(features);
+    if (lighting) {
+        m_gbuffer.bindTextures(0);
+        lighting->use();
+        lighting->setMat4("inverseViewProjection", glm::inverse(camera.projection * camera.view));
+        lighting->setVec3("cameraPosition", cameraPosition);
+        lighting->setVec3("directionalLight.direction", m_directionalLight.direction);
+        lighting->setVec3("directionalLight.ambient", m_directionalLight.ambient);
+        lighting->setVec3("directionalLight.diffuse", m_directionalLight.diffuse);
+        lighting->setVec3("directionalLight.specular", m_directionalLight.specular);
+        state.bindVertexArray(m_fullscreenVertexArray.get());
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+    }
+
+    glDepthMask(GL_TRUE);
+    glEnable(GL_DEPTH_TEST);
+    m_gbuffer.blitDepth(0);
+}
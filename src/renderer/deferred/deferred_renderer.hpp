@@ -0,0 +1,59 @@
+#ifndef DEFERRED_RENDERER_H_
+#define DEFERRED_RENDERER_H_
+
+#include <glad/glad.h>
+#include <memory>
+#include <glm/glm.hpp>
+#include <gbuffer.hpp>
+#include <gl_handle.hpp>
+#include <frame_uniforms.hpp>
+#include <light.hpp>
+#include <shader_features.hpp>
+
+class ShaderPermutations;
+class CommandQueue;
+class DepthPrepass;
+
+/**
+ * @class DeferredRenderer
+ * @brief Alternative to forward shading: opaque draws write surface
+ * attributes into a GBuffer, then a single fullscreen pass lights every pixel
+ * once.
+ *
+ * Lighting walks the same light clusters as the forward path, so the
+ * LightClusters of the frame must already be uploaded. Surface colors come
+ * from each draw's entry in the MaterialTable, textures modulating them when
+ * present. Both
+ * passes use the shader variant of the features each draw and the frame
+ * actually have.
+ */
+class DeferredRenderer {
+public:
+    DeferredRenderer(GLsizei width, GLsizei height);
+    ~DeferredRenderer();
+
+    void resize(GLsizei width, GLsizei height) { m_gbuffer.resize(width, height); }
+
+    /**
+     * @brief Geometry pass of `commands`, whatever engine they were recorded
+     * with, then lighting into the default framebuffer. The G-buffer depth is
+     * copied there too, so forward draws can follow.
+     * @param features Lighting features of the frame, e.g. SHADOWS.
+     * @param prepass If not null, lays down the G-buffer depth first.
+     */
+    void render(const CommandQueue& commands, const FrameUniforms& camera, const glm::vec3& cameraPosition,
+                ShaderFeatures features, DepthPrepass* prepass = nullptr);
+
+    void setDirectionalLight(const DirectionalLight& light) { m_directionalLight = light; }
+    const GBuffer& getGBuffer() const { return m_gbuffer; }
+
+private:
+    GBuffer m_gbuffer;
+    std::unique_ptr<ShaderPermutations> m_geometryPermutations;
+    std::unique_ptr<ShaderPermutations> m_lightingPermutations;
+    DirectionalLight m_directionalLight;
+    // Attribute-less vertex array for the fullscreen triangle.
+    VertexArrayHandle m_fullscreenVertexArray;
+};
+
+#endif
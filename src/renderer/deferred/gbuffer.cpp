@@ -0,0 +1,77 @@
+#include <gbuffer.hpp>
+#include <gl_state.hpp>
+#include <memory_report.hpp>
+#include <iostream>
+
+
+static constexpr GLenum TARGET_FORMATS[GBuffer::TARGET_COUNT] = {
+    GL_RGBA8,
+    GL_RGB10_A2,
+    GL_DEPTH24_STENCIL8
+};
+static constexpr size_t TARGET_BYTES_PER_PIXEL = 4 + 4 + 4;
+
+GBuffer::GBuffer(GLsizei width, GLsizei height) : m_width(width), m_height(height) {
+    create();
+}
+
+GBuffer::~GBuffer() {
+    MemoryReport::getInstance().remove(MemorySubsystem::RENDER_TARGETS_GPU, getBytes());
+}
+
+size_t GBuffer::getBytes() const {
+    return size_t(m_width) * size_t(m_height) * TARGET_BYTES_PER_PIXEL;
+}
+
+void GBuffer::create() {
+    m_framebuffer = GL::createFramebuffer();
+    for (GLuint target = 0; target < TARGET_COUNT; target++) {
+        m_textures[target] = GL::createTexture2D(1, TARGET_FORMATS[target], m_width, m_height);
+        // Sampled one texel per pixel, never filtered.
+        glTextureParameteri(m_textures[target].get(), GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTextureParameteri(m_textures[target].get(), GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTextureParameteri(m_textures[target].get(), GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTextureParameteri(m_textures[target].get(), GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+
+    GLuint framebuffer = m_framebuffer.get();
+    glNamedFramebufferTexture(framebuffer, GL_COLOR_ATTACHMENT0, m_textures[ALBEDO_SPECULAR].get(), 0);
+    glNamedFramebufferTexture(framebuffer, GL_COLOR_ATTACHMENT1, m_textures[NORMAL_SHININESS].get(), 0);
+    glNamedFramebufferTexture(framebuffer, GL_DEPTH_STENCIL_ATTACHMENT, m_textures[DEPTH].get(), 0);
+    const GLenum drawBuffers[] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+    glNamedFramebufferDrawBuffers(framebuffer, 2, drawBuffers);
+
+    if (glCheckNamedFramebufferStatus(framebuffer, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cerr << "ERROR::GBUFFER::Framebuffer is incomplete." << std::endl;
+
+    MemoryReport::getInstance().add(MemorySubsystem::RENDER_TARGETS_GPU, getBytes());
+}
+
+void GBuffer::resize(GLsizei width, GLsizei height) {
+    if (width == m_width && height == m_height) return;
+
+    MemoryReport::getInstance().remove(MemorySubsystem::RENDER_TARGETS_GPU, getBytes());
+    m_width = width;
+    m_height = height;
+    create();
+}
+
+void GBuffer::bindForWriting() const {
+    static constexpr GLfloat ZERO[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_framebuffer.get());
+    glClearNamedFramebufferfv(m_framebuffer.get(), GL_COLOR, 0, ZERO);
+    glClearNamedFramebufferfv(m_framebuffer.get(), GL_COLOR, 1, ZERO);
+    glClearNamedFramebufferfi(m_framebuffer.get(), GL_DEPTH_STENCIL, 0, 1.0f, 0);
+}
+
+void GBuffer::bindTextures(GLuint firstUnit) const {
+    GLState& state = GLState::getInstance();
+    for (GLuint target = 0; target < TARGET_COUNT; target++)
+        state.bindTextureUnit(firstUnit + target, m_textures[target].get());
+}
+
+void GBuffer::blitDepth(GLuint framebuffer) const {
+    glBlitNamedFramebuffer(m_framebuffer.get(), framebuffer,
+        0, 0, m_width, m_height, 0, 0, m_width, m_height,
+        GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+}
@@ -0,0 +1,66 @@
+#ifndef GBUFFER_H_
+#define GBUFFER_H_
+
+#include <glad/glad.h>
+#include <array>
+#include <gl_handle.hpp>
+
+/**
+ * @class GBuffer
+ * @brief Render targets of the deferred geometry pass, 12 bytes per pixel.
+ *
+ * - ALBEDO_SPECULAR (RGBA8): albedo, specular intensity.
+ * - NORMAL_SHININESS (RGB10_A2): octahedral world normal, shininess / MAX_SHININESS.
+ * - DEPTH (DEPTH24_STENCIL8): positions are rebuilt from it, and it matches
+ *   the default framebuffer so it can be blitted there for forward passes.
+ */
+class GBuffer {
+public:
+    enum Target : GLuint {
+        ALBEDO_SPECULAR,
+        NORMAL_SHININESS,
+        DEPTH,
+        TARGET_COUNT
+    };
+
+    static constexpr float MAX_SHININESS = 256.0f;
+
+    GBuffer(GLsizei width, GLsizei height);
+    ~GBuffer();
+    GBuffer(const GBuffer&) = delete;
+    GBuffer& operator=(const GBuffer&) = delete;
+
+    /**
+     * @brief Recreate the targets, no-op if the size did not change.
+     */
+    void resize(GLsizei width, GLsizei height);
+
+    /**
+     * @brief Bind as the draw framebuffer and clear every target.
+     */
+    void bindForWriting() const;
+    /**
+     * @brief Bind the targets to texture units [firstUnit, firstUnit + TARGET_COUNT).
+     */
+    void bindTextures(GLuint firstUnit = 0) const;
+    /**
+     * @brief Copy depth into `framebuffer`, 0 being the default one.
+     */
+    void blitDepth(GLuint framebuffer) const;
+
+    GLuint getFramebuffer() const { return m_framebuffer.get(); }
+    GLuint getTexture(Target target) const { return m_textures[target].get(); }
+    GLsizei getWidth() const { return m_width; }
+    GLsizei getHeight() const { return m_height; }
+    size_t getBytes() const;
+
+private:
+    FramebufferHandle m_framebuffer;
+    std::array<TextureHandle, TARGET_COUNT> m_textures;
+    GLsizei m_width{0};
+    GLsizei m_height{0};
+
+    void create();
+};
+
+#endif
@@ -0,0 +1,100 @@
+#include <command_list.hpp>
+#include <renderable.hpp>
+#include <shader_engine.hpp>
+#include <shader_permutations.hpp>
+#include <algorithm>
+
+
+uint64_t makeSortKey(GLuint program, GLuint vertexArray, float depth) {
+    constexpr uint64_t DEPTH_MAX = (1ull << 24) - 1;
+    uint64_t quantizedDepth = static_cast<uint64_t>(std::clamp(depth, 0.0f, 1.0f) * DEPTH_MAX);
+    return (uint64_t(program & 0xFFFF) << 48) | (uint64_t(vertexArray & 0xFFFFFF) << 24) | quantizedDepth;
+}
+
+void CommandList::draw(ShaderEngine* engine, Renderable* renderable, const glm::mat4& model, float depth) {
+    GLuint program = engine ? engine->getShaderProgramID() : 0;
+    m_packets.push_back({makeSortKey(program, renderable->getVertexArray(), depth), engine, nullptr,
+                         renderable->getShaderFeatures(), renderable, renderable->getMaterial(), model});
+}
+
+void CommandList::draw(Renderable* renderable, const glm::mat4& model, float depth) {
+    ShaderPermutations* permutations = renderable->getShaderPermutations();
+    if (!permutations) {
+        draw(renderable->getShaderEngine(), renderable, model, depth);
+        return;
+    }
+    // Variants are only picked at replay, so sort on the features instead.
+    ShaderFeatures features = renderable->getShaderFeatures();
+    m_packets.push_back({makeSortKey(permutations->getSortId(features), renderable->getVertexArray(), depth),
+                         nullptr, permutations, features, renderable, renderable->getMaterial(), model});
+}
+
+void CommandList::drawSkinned(Renderable* renderable, const glm::mat4& model, uint32_t paletteOffset, float depth) {
+    ShaderPermutations* permutations = renderable->getShaderPermutations();
+    if (!permutations) {
+        // Without permutations there is no skinned program, draw the bind pose.
+        draw(renderable->getShaderEngine(), renderable, model, depth);
+        return;
+    }
+    ShaderFeatures features = renderable->getShaderFeatures() | SKINNING;
+    m_packets.push_back({makeSortKey(permutations->getSortId(features), renderable->getVertexArray(), depth),
+                         nullptr, permutations, features, renderable, renderable->getMaterial(), model,
+                         paletteOffset});
+}
+
+void CommandQueue::merge() {
+    m_order.clear();
+    size_t total = 0;
+    for (const CommandList& list : m_lists) total += list.size();
+    m_order.reserve(total);
+
+    for (uint32_t l = 0; l < m_lists.size(); l++) {
+        const std::vector<DrawPacket>& packets = m_lists[l].getPackets();
+        for (uint32_t p = 0; p < packets.size(); p++)
+            m_order.push_back({packets[p].sortKey, l, p});
+    }
+    // Sorting small entries rather than packets, which carry a whole matrix.
+    std::stable_sort(m_order.begin(), m_order.end(),
+        [](const Entry& a, const Entry& b) { return a.sortKey < b.sortKey; });
+}
+
+void CommandQueue::execute(const ReplaySettings& settings) const {
+    for (const Entry& entry : m_order) {
+        const DrawPacket& packet = m_lists[entry.list].getPackets()[entry.packet];
+        ShaderEngine* engine = settings.engine;
+        if (!engine) {
+            ShaderPermutations* permutations = settings.permutations ? settings.permutations : packet.permutations;
+            engine = permutations ? permutations->get(packet.features | settings.features) : packet.engine;
+        }
+        if (engine) {
+            engine->use();
+            engine->setMat4("model", packet.model);
+            if (packet.paletteOffset != NO_SKIN_PALETTE)
+                engine->setInt("paletteOffset", static_cast<int>(packet.paletteOffset));
+            engine->setInt("materialIndex", static_cast<int>(packet.material));
+        }
+        packet.renderable->draw(engine);
+    }
+}
+
+void CommandQueue::executeDepth(ShaderPermutations& permutations) const {
+    ShaderEngine* current = nullptr;
+    for (const Entry& entry : m_order) {
+        const DrawPacket& packet = m_lists[entry.list].getPackets()[entry.packet];
+        bool skinned = packet.paletteOffset != NO_SKIN_PALETTE;
+        ShaderEngine* engine = permutations.get(skinned ? ShaderFeatures(SKINNING) : ShaderFeatures(0));
+        if (!engine) continue;
+        if (engine != current) {
+            engine->use();
+            current = engine;
+        }
+        engine->setMat4("model", packet.model);
+        if (skinned) engine->setInt("paletteOffset", static_cast<int>(packet.paletteOffset));
+        packet.renderable->drawDepth(skinned);
+    }
+}
+
+void CommandQueue::clear() {
+    for (CommandList& list : m_lists) list.clear();
+    m_order.clear();
+}
@@ -0,0 +1,146 @@
+#ifndef COMMAND_LIST_H_
+#define COMMAND_LIST_H_
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <thread_pool.hpp>
+#include <shader_features.hpp>
+#include <skin_palette.hpp>
+#include <material.hpp>
+
+class Renderable;
+class ShaderEngine;
+class ShaderPermutations;
+
+/**
+ * @brief One recorded draw: `renderable` drawn with `engine`, or with the
+ * variant of `permutations` for `features` if not null, its "model" uniform
+ * set to `model` and its "materialIndex" uniform to `material`.
+ * Skinned draws also read their bones from `paletteOffset` on.
+ */
+struct DrawPacket {
+    uint64_t sortKey;
+    ShaderEngine* engine;
+    ShaderPermutations* permutations;
+    ShaderFeatures features;
+    Renderable* renderable;
+    MaterialId material;
+    glm::mat4 model;
+    uint32_t paletteOffset = NO_SKIN_PALETTE;
+};
+
+/**
+ * @brief Key ordering draws by program, then vertex array, then front to
+ * back, so that replay changes state as rarely as possible.
+ * @param depth Normalized distance to the camera, clamped to [0, 1].
+ */
+uint64_t makeSortKey(GLuint program, GLuint vertexArray, float depth);
+
+/**
+ * @brief How CommandQueue::execute() picks the program of each packet.
+ */
+struct ReplaySettings {
+    // Used instead of every packet's engine if not null.
+    ShaderEngine* engine = nullptr;
+    // Otherwise used instead of every packet's engine or permutations.
+    ShaderPermutations* permutations = nullptr;
+    // Added to the features of every packet, e.g. shadows being enabled.
+    ShaderFeatures features = 0;
+};
+
+/**
+ * @class CommandList
+ * @brief Draw packets recorded by a single thread. Recording does not touch
+ * GL, so it can happen on any thread.
+ */
+class CommandList {
+public:
+    void draw(ShaderEngine* engine, Renderable* renderable, const glm::mat4& model, float depth = 0.0f);
+    /**
+     * @brief Draw with the renderable's own permutations, or its engine if
+     * it has none.
+     */
+    void draw(Renderable* renderable, const glm::mat4& model, float depth = 0.0f);
+    /**
+     * @brief Draw a skinned renderable with the SKINNING variant of its
+     * permutations, posed by the palette starting at `paletteOffset`.
+     */
+    void drawSkinned(Renderable* renderable, const glm::mat4& model, uint32_t paletteOffset, float depth = 0.0f);
+
+    size_t size() const { return m_packets.size(); }
+    const std::vector<DrawPacket>& getPackets() const { return m_packets; }
+    void clear() { m_packets.clear(); }
+
+private:
+    std::vector<DrawPacket> m_packets;
+};
+
+/**
+ * @class CommandQueue
+ * @brief One CommandList per ThreadPool thread, merged into a single sorted
+ * stream replayed on the GL thread.
+ */
+class CommandQueue {
+public:
+    CommandQueue() : m_lists(ThreadPool::getInstance().getThreadCount()) {}
+
+    /**
+     * @brief Record [0, count) in parallel, `recordRange(list, begin, end)`
+     * writing into the list of the thread it runs on.
+     */
+    template <typename RecordRange>
+    void record(size_t count, size_t grain, RecordRange&& recordRange) {
+        ThreadPool::getInstance().parallelFor(count, grain, [&](size_t begin, size_t end, size_t slot) {
+            recordRange(m_lists[slot], begin, end);
+        });
+    }
+
+    /**
+     * @brief List for recording from the current thread outside of record().
+     */
+    CommandList& getList(size_t slot = 0) { return m_lists[slot]; }
+
+    /**
+     * @brief Order the packets of every list by sort key. Ties keep the
+     * order of their list, which for parallel recording depends on which
+     * thread ran which range.
+     */
+    void merge();
+    /**
+     * @brief Issue every merged packet. GL thread only.
+     */
+    void execute(const ReplaySettings& settings = {}) const;
+    /**
+     * @brief Issue every merged packet as positions only, with the variant of
+     * `permutations` without features, or with SKINNING for skinned packets.
+     * GL thread only.
+     */
+    void executeDepth(ShaderPermutations& permutations) const;
+
+    /**
+     * @brief Call `visit(packet)` for every merged packet, in replay order.
+     */
+    template <typename Visit>
+    void forEachPacket(Visit&& visit) const {
+        for (const Entry& entry : m_order)
+            visit(m_lists[entry.list].getPackets()[entry.packet]);
+    }
+
+    size_t size() const { return m_order.size(); }
+    void clear();
+
+private:
+    // (sort key, list, packet) of every packet, sorted by merge().
+    struct Entry {
+        uint64_t sortKey;
+        uint32_t list;
+        uint32_t packet;
+    };
+
+    std::vector<CommandList> m_lists;
+    std::vector<Entry> m_order;
+};
+
+#endif
@@ -0,0 +1,28 @@
+#include <depth_prepass.hpp>
+#include <command_list.hpp>
+#include <shader_permutations.hpp>
+
+
+DepthPrepass::DepthPrepass()
+    : m_permutations(std::make_unique<ShaderPermutations>("shaders/depth_vertex.glsl", "shaders/depth_fragment.glsl",
+          SKINNING)) {}
+
+DepthPrepass::~DepthPrepass() = default;
+
+void DepthPrepass::render(const CommandQueue& commands) {
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+    commands.executeDepth(*m_permutations);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+}
+
+void DepthPrepass::beginShading() {
+    glDepthFunc(GL_EQUAL);
+    glDepthMask(GL_FALSE);
+}
+
+void DepthPrepass::endShading() {
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+}
@@ -0,0 +1,43 @@
+#ifndef DEPTH_PREPASS_H_
+#define DEPTH_PREPASS_H_
+
+#include <memory>
+
+class ShaderPermutations;
+class CommandQueue;
+
+/**
+ * @class DepthPrepass
+ * @brief Lays down the depth of opaque draws with a position-only stream and
+ * an empty fragment shader, so that the shading pass that follows runs its
+ * fragment shader once per visible pixel.
+ *
+ * Shading then tests GL_EQUAL with depth writes off. Every vertex shader
+ * drawing into this depth declares gl_Position invariant, so both passes
+ * produce bit-identical depths. Skinned draws use the SKINNING variant, which
+ * runs the same skinning code as their shading variant.
+ */
+class DepthPrepass {
+public:
+    DepthPrepass();
+    ~DepthPrepass();
+
+    /**
+     * @brief Depth-only pass over `commands`, color writes off.
+     */
+    void render(const CommandQueue& commands);
+
+    /**
+     * @brief Depth state for shading the draws of the last render().
+     */
+    static void beginShading();
+    /**
+     * @brief Restore GL_LESS with depth writes on.
+     */
+    static void endShading();
+
+private:
+    std::unique_ptr<ShaderPermutations> m_permutations;
+};
+
+#endif
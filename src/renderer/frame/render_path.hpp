@@ -0,0 +1,23 @@
+#ifndef RENDER_PATH_H_
+#define RENDER_PATH_H_
+
+#include <string>
+#include <stdexcept>
+
+/**
+ * @brief How opaque geometry is lit.
+ */
+enum class RenderPath {
+    // Clustered forward shading, lights evaluated while drawing each object.
+    FORWARD,
+    // G-buffer pass, then one clustered lighting pass over the screen.
+    DEFERRED
+};
+
+inline RenderPath renderPathFromString(const std::string& str) {
+    if (str == "forward") return RenderPath::FORWARD;
+    if (str == "deferred") return RenderPath::DEFERRED;
+    throw std::invalid_argument("Invalid render path: " + str);
+}
+
+#endif
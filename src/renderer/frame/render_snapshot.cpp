@@ -0,0 +1,18 @@
+#include <render_snapshot.hpp>
+
+
+void UiSnapshot::capture(const ImDrawData* drawData) {
+    clear();
+    if (!drawData || !drawData->Valid) return;
+
+    m_drawData = *drawData;
+    m_drawData.CmdLists.clear();
+    for (ImDrawList* list : drawData->CmdLists)
+        m_drawData.CmdLists.push_back(list->CloneOutput());
+}
+
+void UiSnapshot::clear() {
+    for (ImDrawList* list : m_drawData.CmdLists)
+        IM_DELETE(list);
+    m_drawData = ImDrawData();
+}
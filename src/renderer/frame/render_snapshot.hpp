@@ -0,0 +1,80 @@
+#ifndef RENDER_SNAPSHOT_H_
+#define RENDER_SNAPSHOT_H_
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <imgui.h>
+#include <frame_uniforms.hpp>
+#include <command_list.hpp>
+#include <light.hpp>
+#include <light_clusters.hpp>
+#include <shadow_frame.hpp>
+#include <shader_features.hpp>
+
+/**
+ * @class UiSnapshot
+ * @brief Copy of a frame's ImGui draw lists, so that the next ImGui frame can
+ * start while this one is still being rendered.
+ */
+class UiSnapshot {
+public:
+    UiSnapshot() = default;
+    ~UiSnapshot() { clear(); }
+    UiSnapshot(const UiSnapshot&) = delete;
+    UiSnapshot& operator=(const UiSnapshot&) = delete;
+
+    void capture(const ImDrawData* drawData);
+    void clear();
+    // nullptr if nothing was captured.
+    ImDrawData* getDrawData() { return m_drawData.Valid ? &m_drawData : nullptr; }
+
+private:
+    ImDrawData m_drawData;
+};
+
+/**
+ * @struct RenderSnapshot
+ * @brief Everything the render thread needs to draw one frame, extracted from
+ * the scene by the simulation thread.
+ *
+ * Lights and the camera are copied, with the lights already binned into
+ * clusters and their shadow views planned; draws are recorded as merged command lists. Packets reference renderables and engines, which are created before
+ * the render thread starts and never modified by the simulation afterwards.
+ */
+struct RenderSnapshot {
+    uint64_t frame = 0;
+    FrameUniforms camera;
+    glm::vec3 cameraPosition{0.0f};
+    glm::vec3 cameraDirection{0.0f, 0.0f, -1.0f};
+    // Lit opaque draws, shaded by the forward or the deferred path.
+    CommandQueue commands;
+    // Drawn forward after lighting, on top of `commands`.
+    CommandQueue unlitCommands;
+    // Lay down the depth of `commands` before shading them.
+    bool depthPrepass = false;
+    // Lighting features of the frame, added to those of every lit draw.
+    ShaderFeatures shaderFeatures = 0;
+    DirectionalLight directionalLight;
+    std::vector<PointLight> pointLights;
+    LightClusters lightClusters;
+    ShadowFrame shadows;
+    // Bone matrices of every animated character, read by skinned packets
+    // from their palette offset on.
+    std::vector<glm::mat4> skinPalettes;
+    UiSnapshot ui;
+
+    /**
+     * @brief Empty the snapshot, keeping the capacity for the next frame.
+     */
+    void clear() {
+        commands.clear();
+        unlitCommands.clear();
+        pointLights.clear();
+        shadows.clear();
+        skinPalettes.clear();
+        ui.clear();
+    }
+};
+
+#endif
@@ -0,0 +1,45 @@
+#include <render_thread.hpp>
+#include <allocation_tracker.hpp>
+#include <iostream>
+
+
+RenderThread::RenderThread(SDL_Window* window, SDL_GLContext context, RenderCallback render)
+    : m_window(window), m_context(context), m_render(std::move(render)) {
+    // A context can only be current on one thread at a time.
+    SDL_GL_MakeCurrent(m_window, nullptr);
+    m_thread = std::thread(&RenderThread::run, this);
+}
+
+RenderSnapshot& RenderThread::beginFrame() {
+    RenderSnapshot& snapshot = m_snapshots.getWriteBuffer();
+    snapshot.clear();
+    snapshot.frame = m_frame++;
+    return snapshot;
+}
+
+void RenderThread::stop() {
+    if (!m_thread.joinable()) return;
+
+    m_snapshots.stop();
+    m_thread.join();
+    SDL_GL_MakeCurrent(m_window, m_context);
+}
+
+void RenderThread::run() {
+    if (SDL_GL_MakeCurrent(m_window, m_context) != 0) {
+        std::cerr << "ERROR::RENDER_THREAD::" << SDL_GetError() << std::endl;
+        m_snapshots.stop();
+        return;
+    }
+    AllocationTracker::setCurrentTag(AllocationTag::RENDERER);
+
+    while (RenderSnapshot* snapshot = m_snapshots.acquire()) {
+        m_render(*snapshot);
+        // Release before swapping so the simulation can publish the next frame
+        // while the swap waits for vsync.
+        m_snapshots.release();
+        SDL_GL_SwapWindow(m_window);
+    }
+
+    SDL_GL_MakeCurrent(m_window, nullptr);
+}
@@ -0,0 +1,55 @@
+#ifndef RENDER_THREAD_H_
+#define RENDER_THREAD_H_
+
+#include <SDL2/SDL.h>
+#include <functional>
+#include <thread>
+#include <double_buffer.hpp>
+#include <render_snapshot.hpp>
+
+/**
+ * @class RenderThread
+ * @brief Thread owning the GL context, drawing the snapshots submitted by the
+ * simulation thread one frame behind it.
+ *
+ * The context is taken away from the creating thread for the lifetime of the
+ * RenderThread: that thread must not issue GL calls until stop() returns,
+ * which makes the context current on it again.
+ */
+class RenderThread {
+public:
+    using RenderCallback = std::function<void(RenderSnapshot&)>;
+
+    /**
+     * @param render Called on the render thread for every submitted snapshot,
+     * before the window is swapped.
+     */
+    RenderThread(SDL_Window* window, SDL_GLContext context, RenderCallback render);
+    ~RenderThread() { stop(); }
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    /**
+     * @brief Cleared snapshot to fill for the next frame.
+     */
+    RenderSnapshot& beginFrame();
+    /**
+     * @brief Hand the snapshot to the render thread, waiting for it to finish
+     * the previous one if needed.
+     */
+    void submit() { m_snapshots.publish(); }
+
+    void stop();
+
+private:
+    SDL_Window* m_window;
+    SDL_GLContext m_context;
+    RenderCallback m_render;
+    DoubleBuffer<RenderSnapshot> m_snapshots;
+    std::thread m_thread;
+    uint64_t m_frame{0};
+
+    void run();
+};
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef GL_HANDLE_H_
+#define GL_HANDLE_H_
+
+#include <glad/glad.h>
+#include <utility>
+#include <gl_state.hpp>
+
+/**
+ * @class GLHandle
+ * @brief Move-only owner of an OpenGL object name, deleted on destruction.
+ *
+ * Copies would delete the object twice, so sharing an object must go through
+ * an explicit std::shared_ptr to the owner.
+ */
+template <typename Traits>
+class GLHandle {
+public:
+    GLHandle() = default;
+    explicit GLHandle(GLuint id) : m_id(id) {}
+    ~GLHandle() { reset(); }
+
+    GLHandle(GLHandle&& other) noexcept : m_id(std::exchange(other.m_id, 0)) {}
+    GLHandle& operator=(GLHandle&& other) noexcept {
+        if (this != &other) {
+            reset();
+            m_id = std::exchange(other.m_id, 0);
+        }
+        return *this;
+    }
+
+    GLHandle(const GLHandle&) = delete;
+    GLHandle& operator=(const GLHandle&) = delete;
+
+    GLuint get() const { return m_id; }
+    explicit operator bool() const { return m_id != 0; }
+
+    void reset() {
+        if (m_id != 0) Traits::destroy(m_id);
+        m_id = 0;
+    }
+
+private:
+    GLuint m_id{0};
+};
+
+struct BufferTraits { static void destroy(GLuint id) { glDeleteBuffers(1, &id); } };
+// Objects the GLState caches bindings of are forgotten before deletion.
+struct TextureTraits {
+    static void destroy(GLuint id) {
+        GLState::getInstance().forgetTexture(id);
+        glDeleteTextures(1, &id);
+    }
+};
+struct VertexArrayTraits {
+    static void destroy(GLuint id) {
+        GLState::getInstance().forgetVertexArray(id);
+        glDeleteVertexArrays(1, &id);
+    }
+};
+struct QueryTraits { static void destroy(GLuint id) { glDeleteQueries(1, &id); } };
+struct FramebufferTraits { static void destroy(GLuint id) { glDeleteFramebuffers(1, &id); } };
+struct ProgramTraits {
+    static void destroy(GLuint id) {
+        GLState::getInstance().forgetProgram(id);
+        glDeleteProgram(id);
+    }
+};
+
+using BufferHandle = GLHandle<BufferTraits>;
+using TextureHandle = GLHandle<TextureTraits>;
+using VertexArrayHandle = GLHandle<VertexArrayTraits>;
+using ProgramHandle = GLHandle<ProgramTraits>;
+using FramebufferHandle = GLHandle<FramebufferTraits>;
+using QueryHandle = GLHandle<QueryTraits>;
+
+/**
+ * Creation goes through direct state access, so nothing has to be bound to be
+ * created or edited.
+ */
+namespace GL {
+
+    /**
+     * @brief Buffer with immutable storage of `size` bytes, initialized from
+     * `data` if not null. `flags` are glNamedBufferStorage flags.
+     */
+    inline BufferHandle createBuffer(GLsizeiptr size, const void* data, GLbitfield flags = 0) {
+        GLuint id = 0;
+        glCreateBuffers(1, &id);
+        glNamedBufferStorage(id, size, data, flags);
+        return BufferHandle(id);
+    }
+
+    /**
+     * @brief 2D texture with immutable storage for `levels` mip levels.
+     */
+    inline TextureHandle createTexture2D(GLsizei levels, GLenum internalFormat, GLsizei width, GLsizei height) {
+        GLuint id = 0;
+        glCreateTextures(GL_TEXTURE_2D, 1, &id);
+        glTextureStorage2D(id, levels, internalFormat, width, height);
+        return TextureHandle(id);
+    }
+
+    inline VertexArrayHandle createVertexArray() {
+        GLuint id = 0;
+        glCreateVertexArrays(1, &id);
+        return VertexArrayHandle(id);
+    }
+
+    inline FramebufferHandle createFramebuffer() {
+        GLuint id = 0;
+        glCreateFramebuffers(1, &id);
+        return FramebufferHandle(id);
+    }
+
+    inline QueryHandle createQuery(GLenum target) {
+        GLuint id = 0;
+        glCreateQueries(target, 1, &id);
+        return QueryHandle(id);
+    }
+
+    inline ProgramHandle createProgram() {
+        return ProgramHandle(glCreateProgram());
+    }
+
+    /**
+     * @brief Number of mip levels of a full chain for a `width` x `height` image.
+     */
+    inline GLsizei getMipLevelCount(GLsizei width, GLsizei height) {
+        GLsizei levels = 1;
+        GLsizei size = width > height ? width : height;
+        while (size > 1) {
+            size >>= 1;
+            levels++;
+        }
+        return levels;
+    }
+
+}
+
+#endif
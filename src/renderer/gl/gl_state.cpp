@@ -0,0 +1,24 @@
+#include <gl_state.hpp>
+
+
+void GLState::forgetProgram(GLuint program) {
+    // A deleted program stays in use until another one is installed, but its
+    // name must not match a new program that reuses it.
+    if (m_program == program) m_program = UNKNOWN;
+}
+
+void GLState::forgetVertexArray(GLuint vertexArray) {
+    if (m_vertexArray == vertexArray) m_vertexArray = UNKNOWN;
+}
+
+void GLState::forgetTexture(GLuint texture) {
+    for (GLuint& bound : m_textures) {
+        if (bound == texture) bound = UNKNOWN;
+    }
+}
+
+void GLState::invalidate() {
+    m_program = UNKNOWN;
+    m_vertexArray = UNKNOWN;
+    m_textures.fill(UNKNOWN);
+}
@@ -0,0 +1,80 @@
+#ifndef GL_STATE_H_
+#define GL_STATE_H_
+
+#include <glad/glad.h>
+#include <array>
+#include <cstdint>
+
+/**
+ * @class GLState
+ * @brief Shadow copy of the GL bindings the renderer changes per draw. This
+ * class is a Singleton.
+ *
+ * Binds that would not change the current state are dropped before reaching
+ * the driver. Every program, vertex array and texture bind of the renderer
+ * must go through this class, otherwise the cache goes stale; code that
+ * touches GL state behind its back must call invalidate() afterwards.
+ */
+class GLState {
+public:
+    static constexpr GLuint MAX_TEXTURE_UNITS = 32;
+
+    static GLState& getInstance() {
+        static GLState instance;
+        return instance;
+    }
+
+    GLState(const GLState&) = delete;
+    GLState& operator=(const GLState&) = delete;
+
+    void useProgram(GLuint program) {
+        if (m_program == program) { m_skipped++; return; }
+        m_program = program;
+        glUseProgram(program);
+    }
+
+    void bindVertexArray(GLuint vertexArray) {
+        if (m_vertexArray == vertexArray) { m_skipped++; return; }
+        m_vertexArray = vertexArray;
+        glBindVertexArray(vertexArray);
+    }
+
+    void bindTextureUnit(GLuint unit, GLuint texture) {
+        if (unit < MAX_TEXTURE_UNITS) {
+            if (m_textures[unit] == texture) { m_skipped++; return; }
+            m_textures[unit] = texture;
+        }
+        glBindTextureUnit(unit, texture);
+    }
+
+    /**
+     * @brief Drop cached bindings of a deleted object. GL unbinds deleted
+     * objects itself and may hand the same name out again.
+     */
+    void forgetProgram(GLuint program);
+    void forgetVertexArray(GLuint vertexArray);
+    void forgetTexture(GLuint texture);
+
+    /**
+     * @brief Forget everything, so that the next binds are all issued.
+     */
+    void invalidate();
+
+    // Number of binds dropped since the last call to resetSkippedCount().
+    uint64_t getSkippedCount() const { return m_skipped; }
+    void resetSkippedCount() { m_skipped = 0; }
+
+private:
+    // Never a valid GL name, so nothing compares equal after invalidate().
+    static constexpr GLuint UNKNOWN = UINT32_MAX;
+
+    GLuint m_program{UNKNOWN};
+    GLuint m_vertexArray{UNKNOWN};
+    std::array<GLuint, MAX_TEXTURE_UNITS> m_textures;
+    uint64_t m_skipped{0};
+
+    GLState() { invalidate(); }
+    ~GLState() {}
+};
+
+#endif
@@ -0,0 +1,36 @@
+#include <gpu_timer.hpp>
+
+
+GpuTimer::GpuTimer(uint32_t latency) : m_pending(latency > 0 ? latency : 1, 0) {
+    m_queries.reserve(m_pending.size());
+    for (size_t i = 0; i < m_pending.size(); i++)
+        m_queries.push_back(GL::createQuery(GL_TIME_ELAPSED));
+}
+
+void GpuTimer::begin() {
+    GLuint query = m_queries[m_current].get();
+    if (m_pending[m_current]) {
+        GLint available = 0;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            m_measuring = false;
+            return;
+        }
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+        m_milliseconds.store(nanoseconds / 1e6, std::memory_order_relaxed);
+        m_pending[m_current] = 0;
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, query);
+    m_measuring = true;
+}
+
+void GpuTimer::end() {
+    if (!m_measuring) return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    m_pending[m_current] = 1;
+    m_current = (m_current + 1) % m_queries.size();
+    m_measuring = false;
+}
@@ -0,0 +1,46 @@
+#ifndef GPU_TIMER_H_
+#define GPU_TIMER_H_
+
+#include <glad/glad.h>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include <gl_handle.hpp>
+
+/**
+ * @class GpuTimer
+ * @brief GPU time spent between begin() and end(), measured with
+ * GL_TIME_ELAPSED queries.
+ *
+ * Each frame uses the next query of a ring, whose previous result is read
+ * back only once available, so timing never stalls the pipeline. A frame
+ * whose query is still in flight is simply not measured. Timers cannot
+ * overlap one another.
+ */
+class GpuTimer {
+public:
+    /**
+     * @param latency Frames a result may take to come back.
+     */
+    explicit GpuTimer(uint32_t latency = 4);
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    // GL thread only.
+    void begin();
+    void end();
+
+    /**
+     * @brief Latest measurement, in milliseconds. Safe from any thread.
+     */
+    double getMilliseconds() const { return m_milliseconds.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<QueryHandle> m_queries;
+    std::vector<uint8_t> m_pending;
+    uint32_t m_current{0};
+    bool m_measuring{false};
+    std::atomic<double> m_milliseconds{0.0};
+};
+
+#endif
@@ -0,0 +1,86 @@
+#include <stream_buffer.hpp>
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+// One second; a fence this late means the GPU is hung rather than busy.
+static constexpr GLuint64 FENCE_TIMEOUT_NS = 1000000000;
+
+static size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+StreamBuffer::StreamBuffer(size_t bytesPerFrame, uint32_t framesInFlight)
+    : m_fences(std::max(framesInFlight, 1u), nullptr) {
+    // Allocations may be bound as uniform or storage buffers.
+    for (GLenum query : {GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT}) {
+        GLint alignment = 0;
+        glGetIntegerv(query, &alignment);
+        m_alignment = std::max(m_alignment, static_cast<size_t>(std::max(alignment, 1)));
+    }
+    // Keep every region start aligned as well.
+    m_regionSize = alignUp(std::max<size_t>(bytesPerFrame, 1), m_alignment);
+
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const GLsizeiptr size = static_cast<GLsizeiptr>(m_regionSize * m_fences.size());
+    m_buffer = GL::createBuffer(size, nullptr, flags);
+    m_mapping = static_cast<unsigned char*>(glMapNamedBufferRange(m_buffer.get(), 0, size, flags));
+    if (!m_mapping)
+        throw std::runtime_error("Failed to map stream buffer.");
+}
+
+StreamBuffer::~StreamBuffer() {
+    for (GLsync& fence : m_fences) {
+        if (fence) glDeleteSync(fence);
+        fence = nullptr;
+    }
+    if (m_buffer) glUnmapNamedBuffer(m_buffer.get());
+}
+
+void StreamBuffer::waitFence(uint32_t region) {
+    GLsync& fence = m_fences[region];
+    if (!fence) return;
+
+    // Poll once without flushing: when the GPU keeps up this never blocks.
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+        m_stalls++;
+        do {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT_NS);
+        } while (result == GL_TIMEOUT_EXPIRED);
+    }
+    if (result == GL_WAIT_FAILED)
+        std::cerr << "ERROR::STREAM_BUFFER::Fence wait failed." << std::endl;
+
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void StreamBuffer::beginFrame() {
+    m_region = (m_region + 1) % m_fences.size();
+    m_head = 0;
+    waitFence(m_region);
+}
+
+void StreamBuffer::endFrame() {
+    GLsync& fence = m_fences[m_region];
+    if (fence) glDeleteSync(fence);
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+StreamBuffer::Allocation StreamBuffer::allocate(size_t bytes, size_t alignment) {
+    size_t offset = alignUp(m_head, std::max(alignment, m_alignment));
+    if (offset + bytes > m_regionSize)
+        throw std::overflow_error("Stream buffer region is full, raise stream_buffer_kb.");
+    m_head = offset + bytes;
+
+    Allocation allocation;
+    allocation.data = m_mapping + m_region * m_regionSize + offset;
+    allocation.offset = static_cast<GLintptr>(m_region * m_regionSize + offset);
+    allocation.size = static_cast<GLsizeiptr>(bytes);
+    return allocation;
+}
+
+void StreamBuffer::bindRange(GLenum target, GLuint index, const Allocation& allocation) const {
+    glBindBufferRange(target, index, m_buffer.get(), allocation.offset, allocation.size);
+}
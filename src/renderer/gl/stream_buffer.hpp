@@ -0,0 +1,85 @@
+#ifndef STREAM_BUFFER_H_
+#define STREAM_BUFFER_H_
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <gl_handle.hpp>
+
+/**
+ * @class StreamBuffer
+ * @brief Persistently mapped ring buffer for data rewritten every frame:
+ * per-frame uniforms, instance data and dynamic vertices.
+ *
+ * The buffer is split in one region per frame in flight. The CPU writes the
+ * region of frame N+1 while the GPU still reads the ones of earlier frames;
+ * a fence placed at the end of each frame guards its region against being
+ * overwritten before the GPU is done with it. The mapping is coherent, so
+ * writes need no explicit flush.
+ */
+class StreamBuffer {
+public:
+    struct Allocation {
+        // Write-only pointer into the mapping, valid until the region is reused.
+        void* data = nullptr;
+        GLintptr offset = 0;
+        GLsizeiptr size = 0;
+    };
+
+    StreamBuffer(size_t bytesPerFrame, uint32_t framesInFlight);
+    ~StreamBuffer();
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    /**
+     * @brief Move to the next region, waiting for the GPU if it still reads it.
+     */
+    void beginFrame();
+    /**
+     * @brief Fence every command issued so far against the current region.
+     */
+    void endFrame();
+
+    /**
+     * @brief Reserve `bytes` in the current region, aligned for uniform and
+     * storage buffer bindings unless a larger `alignment` is given.
+     * @throws std::overflow_error if the region is full.
+     */
+    Allocation allocate(size_t bytes, size_t alignment = 0);
+    /**
+     * @brief Reserve a copy of `value`.
+     */
+    template <typename T>
+    Allocation push(const T& value) {
+        Allocation allocation = allocate(sizeof(T));
+        std::memcpy(allocation.data, &value, sizeof(T));
+        return allocation;
+    }
+
+    /**
+     * @brief Bind an allocation to an indexed target such as GL_UNIFORM_BUFFER.
+     */
+    void bindRange(GLenum target, GLuint index, const Allocation& allocation) const;
+
+    GLuint getBuffer() const { return m_buffer.get(); }
+    uint32_t getFramesInFlight() const { return static_cast<uint32_t>(m_fences.size()); }
+    size_t getBytesPerFrame() const { return m_regionSize; }
+    // Frames for which beginFrame() had to block on the GPU.
+    uint64_t getStallCount() const { return m_stalls; }
+
+private:
+    BufferHandle m_buffer;
+    unsigned char* m_mapping{nullptr};
+    size_t m_regionSize;
+    size_t m_alignment{256};
+    std::vector<GLsync> m_fences;
+    uint32_t m_region{0};
+    size_t m_head{0};
+    uint64_t m_stalls{0};
+
+    void waitFence(uint32_t region);
+};
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef LIGHT_H_
+#define LIGHT_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+// Value of a light's shadowView when it casts no shadow.
+constexpr int32_t NO_SHADOW = -1;
+
+struct DirectionalLight {
+    glm::vec3 direction{-0.2f, -1.0f, -0.3f};
+
+    glm::vec3 ambient{0.05f};
+    glm::vec3 diffuse{0.4f};
+    glm::vec3 specular{0.5f};
+
+    bool castShadows = true;
+};
+
+struct PointLight {
+    glm::vec3 position{0.0f};
+
+    glm::vec3 ambient{0.05f};
+    glm::vec3 diffuse{0.8f};
+    glm::vec3 specular{1.0f};
+
+    float constant = 1.0f;
+    float linear = 0.09f;
+    float quadratic = 0.032f;
+
+    // Distance beyond which the light is ignored, see computeRadius().
+    float radius = 0.0f;
+
+    bool castShadows = true;
+    // First of the six cube face views in ShadowFrame::views, set by the ShadowPlanner.
+    int32_t shadowView = NO_SHADOW;
+
+    /**
+     * @brief Distance at which the attenuated light falls to `threshold` of
+     * its brightest channel. Shaders fade the light to zero at this radius,
+     * so lights can be culled past it without a visible edge.
+     */
+    float computeRadius(float threshold = 1.0f / 256.0f) const {
+        float brightest = std::max({diffuse.x, diffuse.y, diffuse.z, specular.x, specular.y, specular.z});
+        float target = brightest / threshold;
+        if (target <= constant) return 0.0f;
+        if (quadratic <= 0.0f)
+            return linear > 0.0f ? (target - constant) / linear : INFINITY;
+        return (-linear + std::sqrt(linear * linear - 4.0f * quadratic * (constant - target))) / (2.0f * quadratic);
+    }
+};
+
+struct Spotlight {
+    glm::vec3 position{0.0f};
+    glm::vec3 direction{0.0f, 0.0f, -1.0f};
+
+    float constant = 1.0f;
+    float linear = 0.09f;
+    float quadratic = 0.032f;
+
+    glm::vec3 ambient{0.05f};
+    glm::vec3 diffuse{0.8f};
+    glm::vec3 specular{1.0f};
+
+    // Cosines of the inner and outer cone angles.
+    float radius = 0.976f;
+    float outerRadius = 0.954f;
+    // Far plane of the shadow map.
+    float range = 50.0f;
+
+    bool castShadows = true;
+    // View in ShadowFrame::views, set by the ShadowPlanner.
+    int32_t shadowView = NO_SHADOW;
+};
+
+#endif
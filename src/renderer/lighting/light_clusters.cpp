@@ -0,0 +1,126 @@
+#include <light_clusters.hpp>
+#include <stream_buffer.hpp>
+#include <thread_pool.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+static GpuPointLight toGpuLight(const PointLight& light) {
+    return {
+        glm::vec4(light.position, light.radius),
+        glm::vec4(light.ambient, 0.0f),
+        glm::vec4(light.diffuse, 0.0f),
+        glm::vec4(light.specular, 0.0f),
+        glm::vec4(light.constant, light.linear, light.quadratic, static_cast<float>(light.shadowView)),
+    };
+}
+
+static uint16_t toCell(float value, uint32_t cells) {
+    float cell = std::floor(value);
+    return static_cast<uint16_t>(std::clamp(cell, 0.0f, static_cast<float>(cells - 1)));
+}
+
+LightClusters::Bounds LightClusters::computeBounds(const PointLight& light, const glm::mat4& view,
+                                                   const glm::mat4& projection) const {
+    const Bounds culled{{1, 0, 0}, {0, 0, 0}};
+    const float near = m_uniforms.depthParams.x, far = m_uniforms.depthParams.y;
+    const float scale = m_uniforms.depthParams.z, bias = m_uniforms.depthParams.w;
+
+    glm::vec3 center = glm::vec3(view * glm::vec4(light.position, 1.0f));
+    float radius = light.radius;
+    // The camera looks down -Z.
+    float minDepth = -center.z - radius, maxDepth = -center.z + radius;
+    if (radius <= 0.0f || maxDepth < near || minDepth > far) return culled;
+    minDepth = std::max(minDepth, near);
+    maxDepth = std::min(maxDepth, far);
+
+    // The projection of a box is bounded by the projection of its corners.
+    float ndcMin[2] = {INFINITY, INFINITY}, ndcMax[2] = {-INFINITY, -INFINITY};
+    const float focal[2] = {projection[0][0], projection[1][1]};
+    for (int axis = 0; axis < 2; axis++) {
+        for (float offset : {-radius, radius}) {
+            for (float depth : {minDepth, maxDepth}) {
+                float ndc = focal[axis] * (center[axis] + offset) / depth;
+                ndcMin[axis] = std::min(ndcMin[axis], ndc);
+                ndcMax[axis] = std::max(ndcMax[axis], ndc);
+            }
+        }
+        if (ndcMax[axis] < -1.0f || ndcMin[axis] > 1.0f) return culled;
+    }
+
+    Bounds bounds;
+    const uint32_t grid[2] = {GRID_X, GRID_Y};
+    for (int axis = 0; axis < 2; axis++) {
+        bounds.min[axis] = toCell((ndcMin[axis] * 0.5f + 0.5f) * grid[axis], grid[axis]);
+        bounds.max[axis] = toCell((ndcMax[axis] * 0.5f + 0.5f) * grid[axis], grid[axis]);
+    }
+    bounds.min[2] = toCell(std::log(minDepth) * scale + bias, GRID_Z);
+    bounds.max[2] = toCell(std::log(maxDepth) * scale + bias, GRID_Z);
+    return bounds;
+}
+
+void LightClusters::build(std::span<const PointLight> lights, const glm::mat4& view, const glm::mat4& projection) {
+    // Planes of a standard OpenGL perspective matrix.
+    float near = projection[3][2] / (projection[2][2] - 1.0f);
+    float far = projection[3][2] / (projection[2][2] + 1.0f);
+    float logRatio = std::log(far / near);
+    m_uniforms.gridSize = glm::uvec4(GRID_X, GRID_Y, GRID_Z, 0);
+    m_uniforms.depthParams = glm::vec4(near, far, GRID_Z / logRatio, -(GRID_Z * std::log(near)) / logRatio);
+
+    m_lights.resize(lights.size());
+    m_bounds.resize(lights.size());
+    ThreadPool::getInstance().parallelFor(lights.size(), 256, [&](size_t begin, size_t end, size_t) {
+        for (size_t i = begin; i < end; i++) {
+            m_lights[i] = toGpuLight(lights[i]);
+            m_bounds[i] = computeBounds(lights[i], view, projection);
+        }
+    });
+
+    // Count, then turn counts into offsets and fill: no atomics, and the
+    // indices of a cluster stay sorted by light.
+    m_clusters.assign(CLUSTER_COUNT, {0, 0});
+    m_visibleLights = 0;
+    auto forEachCluster = [this](const Bounds& bounds, auto&& visit) {
+        for (uint32_t z = bounds.min[2]; z <= bounds.max[2]; z++)
+            for (uint32_t y = bounds.min[1]; y <= bounds.max[1]; y++)
+                for (uint32_t x = bounds.min[0]; x <= bounds.max[0]; x++)
+                    visit(m_clusters[getClusterIndex(x, y, z)]);
+    };
+
+    for (const Bounds& bounds : m_bounds) {
+        if (bounds.min[0] > bounds.max[0]) continue;
+        m_visibleLights++;
+        forEachCluster(bounds, [](LightClusterRange& cluster) { cluster.count++; });
+    }
+
+    uint32_t offset = 0;
+    for (LightClusterRange& cluster : m_clusters) {
+        cluster.offset = offset;
+        offset += cluster.count;
+        cluster.count = 0;
+    }
+    m_indices.resize(offset);
+
+    for (uint32_t light = 0; light < m_bounds.size(); light++) {
+        const Bounds& bounds = m_bounds[light];
+        if (bounds.min[0] > bounds.max[0]) continue;
+        forEachCluster(bounds, [this, light](LightClusterRange& cluster) {
+            m_indices[cluster.offset + cluster.count++] = light;
+        });
+    }
+}
+
+void LightClusters::upload(StreamBuffer& stream) const {
+    stream.bindRange(GL_UNIFORM_BUFFER, CLUSTER_UNIFORMS_BINDING, stream.push(m_uniforms));
+
+    auto bindStorage = [&stream](GLuint binding, const void* data, size_t bytes) {
+        // Empty ranges cannot be bound.
+        StreamBuffer::Allocation allocation = stream.allocate(std::max<size_t>(bytes, 16));
+        if (bytes > 0) std::memcpy(allocation.data, data, bytes);
+        stream.bindRange(GL_SHADER_STORAGE_BUFFER, binding, allocation);
+    };
+    bindStorage(POINT_LIGHTS_BINDING, m_lights.data(), m_lights.size() * sizeof(GpuPointLight));
+    bindStorage(LIGHT_CLUSTERS_BINDING, m_clusters.data(), m_clusters.size() * sizeof(LightClusterRange));
+    bindStorage(LIGHT_INDICES_BINDING, m_indices.data(), m_indices.size() * sizeof(uint32_t));
+}
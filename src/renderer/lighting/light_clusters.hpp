@@ -0,0 +1,104 @@
+#ifndef LIGHT_CLUSTERS_H_
+#define LIGHT_CLUSTERS_H_
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <glm/glm.hpp>
+#include <light.hpp>
+
+class StreamBuffer;
+
+// Bindings shared with lighting_fragment.glsl.
+constexpr GLuint CLUSTER_UNIFORMS_BINDING = 1;
+constexpr GLuint POINT_LIGHTS_BINDING = 1;
+constexpr GLuint LIGHT_CLUSTERS_BINDING = 2;
+constexpr GLuint LIGHT_INDICES_BINDING = 3;
+
+/**
+ * @brief Range of LightClusters::getLightIndices() lighting one cluster.
+ */
+struct LightClusterRange {
+    uint32_t offset;
+    uint32_t count;
+};
+
+/**
+ * @brief std140 ClusterUniforms block.
+ */
+struct ClusterUniforms {
+    glm::uvec4 gridSize;
+    // near, far, and the scale and bias mapping log(depth) to a slice.
+    glm::vec4 depthParams;
+};
+
+/**
+ * @brief std430 point light as read by the shaders.
+ */
+struct GpuPointLight {
+    glm::vec4 positionRadius;
+    glm::vec4 ambient;
+    glm::vec4 diffuse;
+    glm::vec4 specular;
+    // constant, linear, quadratic, first shadow view or -1
+    glm::vec4 attenuation;
+};
+
+/**
+ * @class LightClusters
+ * @brief Bins point lights into a view-space grid of clusters so that each
+ * fragment only evaluates the lights that can reach it.
+ *
+ * Tiles split the screen evenly and depth slices grow exponentially with the
+ * distance to the camera. A light is added to every cluster overlapped by the
+ * screen-space bounds of its sphere. The result is a compact index list with
+ * one (offset, count) range per cluster, built without atomics so it is the
+ * same whatever the number of threads.
+ */
+class LightClusters {
+public:
+    static constexpr uint32_t GRID_X = 16;
+    static constexpr uint32_t GRID_Y = 9;
+    static constexpr uint32_t GRID_Z = 24;
+    static constexpr uint32_t CLUSTER_COUNT = GRID_X * GRID_Y * GRID_Z;
+
+    /**
+     * @param projection Perspective projection the grid is fitted to; its
+     * near and far planes bound the depth slices.
+     */
+    void build(std::span<const PointLight> lights, const glm::mat4& view, const glm::mat4& projection);
+
+    /**
+     * @brief Copy the lights, clusters and indices into `stream` and bind them.
+     * GL thread only.
+     */
+    void upload(StreamBuffer& stream) const;
+
+    static uint32_t getClusterIndex(uint32_t x, uint32_t y, uint32_t z) {
+        return (z * GRID_Y + y) * GRID_X + x;
+    }
+    std::span<const LightClusterRange> getClusters() const { return m_clusters; }
+    std::span<const uint32_t> getLightIndices() const { return m_indices; }
+    const ClusterUniforms& getUniforms() const { return m_uniforms; }
+    // Lights touching at least one cluster.
+    uint32_t getVisibleLightCount() const { return m_visibleLights; }
+
+private:
+    // Inclusive cluster-space bounds of one light; min.x > max.x when culled.
+    struct Bounds {
+        uint16_t min[3];
+        uint16_t max[3];
+    };
+
+    std::vector<GpuPointLight> m_lights;
+    std::vector<Bounds> m_bounds;
+    std::vector<LightClusterRange> m_clusters;
+    std::vector<uint32_t> m_indices;
+    ClusterUniforms m_uniforms{};
+    uint32_t m_visibleLights{0};
+
+    Bounds computeBounds(const PointLight& light, const glm::mat4& view, const glm::mat4& projection) const;
+};
+
+#endif
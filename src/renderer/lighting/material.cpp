@@ -0,0 +1,11 @@
+#include <material.hpp>
+
+
+GpuMaterial toGpuMaterial(const Material& material) {
+    return {
+        glm::vec4(material.ambient, material.dissolve),
+        glm::vec4(material.diffuse, material.shininess),
+        glm::vec4(material.specular, material.opticalDensity),
+        glm::vec4(material.emissive, static_cast<float>(material.illumination))
+    };
+}
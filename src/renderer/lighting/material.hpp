@@ -2,64 +2,93 @@
 #define MATERIAL_H_
 
 #include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
 #include <iostream>
-#include <sstream>
-#include <shader.hpp>
+#include <string>
 
+/**
+ * @brief Index of a material in the MaterialRegistry and in the GPU material
+ * table. Stable for the lifetime of the registry.
+ */
+using MaterialId = uint32_t;
+// Registered first, used by draws that never set a material.
+constexpr MaterialId DEFAULT_MATERIAL = 0;
+constexpr MaterialId INVALID_MATERIAL = UINT32_MAX;
 
-enum class MaterialType {
-    NOT_MATERIAL = -1,
-    SILVER,
-    GOLD,
-    COPPER
+/**
+ * @brief Texture maps of an MTL material, by statement.
+ */
+enum class MaterialMapType : uint8_t {
+    AMBIENT,            // map_Ka
+    DIFFUSE,            // map_Kd
+    SPECULAR,           // map_Ks
+    EMISSIVE,           // map_Ke
+    SPECULAR_EXPONENT,  // map_Ns
+    DISSOLVE,           // map_d
+    BUMP,               // map_bump, bump
+    DISPLACEMENT,       // disp
+    DECAL,              // decal
+    REFLECTION,         // refl
+    COUNT
 };
 
-struct Material {
-    Material()
-        : ambient(glm::vec3(0.0f)), diffuse(glm::vec3(0.0f)), specular(glm::vec3(0.0f)),
-          type(MaterialType::NOT_MATERIAL), shininess(0.0f), vertex(nullptr), fragment(nullptr) {}
-
-    Material(glm::vec3 ambient, glm::vec3 diffuse, glm::vec3 specular, float shininess,
-             const Shader* vertex, const Shader* fragment)
-        : ambient(ambient), diffuse(diffuse), specular(specular), shininess(shininess),
-          type(MaterialType::NOT_MATERIAL), vertex(vertex), fragment(fragment) {}
-
-    MaterialType type = MaterialType::NOT_MATERIAL;
-    glm::vec3 ambient;
-    glm::vec3 diffuse;
-    glm::vec3 specular;
-    float shininess;
+constexpr size_t MATERIAL_MAP_COUNT = static_cast<size_t>(MaterialMapType::COUNT);
 
-    const Shader* vertex;
-    const Shader* fragment;
+/**
+ * @brief A texture map with its MTL options. Unused if `path` is empty.
+ */
+struct MaterialMap {
+    std::string path;
+    // -o, -s and -t.
+    glm::vec3 offset{0.0f};
+    glm::vec3 scale{1.0f};
+    glm::vec3 turbulence{0.0f};
+    // -bm, bump maps only.
+    float bumpMultiplier = 1.0f;
+    // -boost
+    float boost = 0.0f;
+    // -mm base gain
+    float rangeBase = 0.0f;
+    float rangeGain = 1.0f;
+    // -texres, 0 if not given.
+    int resolution = 0;
+    // -imfchan: 'r', 'g', 'b', 'm', 'l' or 'z', 0 if not given.
+    char channel = 0;
+    bool blendU = true;
+    bool blendV = true;
+    bool clamp = false;
+    bool colorCorrection = false;
+    // -type of reflection maps: "sphere", "cube_top"...
+    std::string type;
+};
 
-    static MaterialType getMaterialType(const std::string& mtl_type) {
-        if (mtl_type == "Silver") {
-            return MaterialType::SILVER;
-        } else if (mtl_type == "Gold") {
-            return MaterialType::GOLD;
-        } else if (mtl_type == "Copper") {
-            return MaterialType::COPPER;
-        } else {
-            return MaterialType::NOT_MATERIAL;
-        }
-    }
+/**
+ * @brief Surface description of the MTL format.
+ */
+struct Material {
+    std::string name;
+    glm::vec3 ambient{0.0f};
+    glm::vec3 diffuse{0.0f};
+    glm::vec3 specular{0.0f};
+    glm::vec3 emissive{0.0f};
+    glm::vec3 transmissionFilter{1.0f};
+    float shininess = 0.0f;
+    float opticalDensity = 1.0f;
+    // 1 is opaque.
+    float dissolve = 1.0f;
+    bool dissolveHalo = false;
+    int illumination = 2;
+    float sharpness = 60.0f;
+    // map_aat
+    bool textureAntiAliasing = false;
+    std::array<MaterialMap, MATERIAL_MAP_COUNT> maps;
 
-    static std::string getMaterialString(MaterialType type) {
-        switch (type) {
-            case MaterialType::GOLD:
-                return "Gold";
-            case MaterialType::SILVER:
-                return "Silver";
-            case MaterialType::COPPER:
-                return "Copper";
-            default:
-                return "Not material";
-        }
-    }
+    const MaterialMap& getMap(MaterialMapType type) const { return maps[static_cast<size_t>(type)]; }
+    MaterialMap& getMap(MaterialMapType type) { return maps[static_cast<size_t>(type)]; }
 
     friend std::ostream& operator<<(std::ostream& os, const Material& material) {
-        os << "Material(type: " << Material::getMaterialString(material.type)
+        os << "Material(name: " << material.name
            << ", ambient: [" << material.ambient[0] << ", " << material.ambient[1] << ", " << material.ambient[2] << "]"
            << ", diffuse: [" << material.diffuse[0] << ", " << material.diffuse[1] << ", " << material.diffuse[2] << "]"
            << ", specular: [" << material.specular[0] << ", " << material.specular[1] << ", " << material.specular[2] << "])";
@@ -67,4 +96,20 @@ struct Material {
     }
 };
 
+/**
+ * @brief std430 material as read by the shaders from the material table.
+ */
+struct GpuMaterial {
+    // rgb, dissolve
+    glm::vec4 ambient;
+    // rgb, shininess
+    glm::vec4 diffuse;
+    // rgb, optical density
+    glm::vec4 specular;
+    // rgb, illumination model
+    glm::vec4 emissive;
+};
+
+GpuMaterial toGpuMaterial(const Material& material);
+
 #endif
@@ -0,0 +1,87 @@
+#include <material_registry.hpp>
+#include <mtl_parser.hpp>
+#include <config_manager.hpp>
+#include <algorithm>
+#include <iostream>
+
+
+static MaterialRegistry& loadConfiguredRegistry() {
+    static MaterialRegistry registry;
+    const std::string path = ConfigurationManager::getInstance()->getMaterialsPath();
+    size_t count = registry.loadLibrary(path);
+    std::cout << "MATERIALS::LOAD::" << path << " materials: " << count << std::endl;
+    return registry;
+}
+
+MaterialRegistry& MaterialRegistry::getInstance() {
+    static MaterialRegistry& instance = loadConfiguredRegistry();
+    return instance;
+}
+
+MaterialRegistry::MaterialRegistry() {
+    Material material;
+    material.name = "default";
+    material.ambient = glm::vec3(1.0f);
+    material.diffuse = glm::vec3(1.0f);
+    material.specular = glm::vec3(0.5f);
+    material.shininess = 32.0f;
+    add(std::move(material));
+}
+
+MaterialId MaterialRegistry::add(Material material) {
+    std::lock_guard lock(m_mutex);
+    auto [entry, inserted] = m_ids.try_emplace(material.name, static_cast<MaterialId>(m_materials.size()));
+    MaterialId id = entry->second;
+    if (inserted) {
+        m_gpuMaterials.push_back(toGpuMaterial(material));
+        m_materials.push_back(std::move(material));
+    } else {
+        m_gpuMaterials[id] = toGpuMaterial(material);
+        m_materials[id] = std::move(material);
+    }
+
+    if (m_changedBegin == m_changedEnd) {
+        m_changedBegin = id;
+        m_changedEnd = id + 1;
+    } else {
+        m_changedBegin = std::min(m_changedBegin, id);
+        m_changedEnd = std::max(m_changedEnd, id + 1);
+    }
+    return id;
+}
+
+size_t MaterialRegistry::loadLibrary(const std::string& path, std::string_view prefix) {
+    // The cooked library was checked when cooked and has nothing left to skip.
+    std::string cooked = ConfigurationManager::getInstance()->getCookedPath(path);
+    std::vector<Material> materials = IO::parseMTL(cooked.empty() ? path : cooked);
+    for (Material& material : materials) {
+        if (!prefix.empty()) material.name.insert(0, prefix);
+        add(std::move(material));
+    }
+    return materials.size();
+}
+
+MaterialId MaterialRegistry::find(std::string_view name) const {
+    std::lock_guard lock(m_mutex);
+    auto entry = m_ids.find(name);
+    return entry == m_ids.end() ? INVALID_MATERIAL : entry->second;
+}
+
+Material MaterialRegistry::get(MaterialId id) const {
+    std::lock_guard lock(m_mutex);
+    return m_materials[id];
+}
+
+size_t MaterialRegistry::size() const {
+    std::lock_guard lock(m_mutex);
+    return m_materials.size();
+}
+
+MaterialId MaterialRegistry::collectChanges(std::vector<GpuMaterial>& out, bool all) {
+    std::lock_guard lock(m_mutex);
+    MaterialId begin = all ? 0 : m_changedBegin;
+    MaterialId end = all ? static_cast<MaterialId>(m_gpuMaterials.size()) : m_changedEnd;
+    out.assign(m_gpuMaterials.begin() + begin, m_gpuMaterials.begin() + end);
+    m_changedBegin = m_changedEnd = 0;
+    return begin;
+}
@@ -0,0 +1,80 @@
+#ifndef MATERIAL_REGISTRY_H_
+#define MATERIAL_REGISTRY_H_
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <hash.hpp>
+#include <material.hpp>
+
+/**
+ * @class MaterialRegistry
+ * @brief Every material of the application, found by name and referenced by
+ * a stable MaterialId, which is also its index in the GPU material table.
+ *
+ * Names are looked up without allocating, through a transparent hash of the
+ * lookup table. Registering a name again replaces the material in place, so its
+ * id and the draws holding it stay valid. Materials are never removed.
+ *
+ * Every member is thread safe. Materials may be registered from any thread,
+ * e.g. by models loaded on the GL thread, so get() returns a copy taken under
+ * the lock rather than a reference that a registration could overwrite.
+ */
+class MaterialRegistry {
+public:
+    /**
+     * @brief Registry holding the library of the configuration file.
+     */
+    static MaterialRegistry& getInstance();
+
+    /**
+     * @brief Registry holding only DEFAULT_MATERIAL.
+     */
+    MaterialRegistry();
+    MaterialRegistry(const MaterialRegistry&) = delete;
+    MaterialRegistry& operator=(const MaterialRegistry&) = delete;
+
+    /**
+     * @brief Register `material` under its name, replacing any material of
+     * the same name.
+     */
+    MaterialId add(Material material);
+    /**
+     * @brief Register every material of the MTL library at `path`, each
+     * under `prefix` followed by its name.
+     * @return Number of materials read.
+     */
+    size_t loadLibrary(const std::string& path, std::string_view prefix = "");
+
+    // INVALID_MATERIAL if no material has that name.
+    MaterialId find(std::string_view name) const;
+    Material get(MaterialId id) const;
+    size_t size() const;
+
+    /**
+     * @brief Copy the GPU form of the materials changed since the last call,
+     * or of all of them if `all`, into `out`.
+     * @return Id of the first material copied.
+     */
+    MaterialId collectChanges(std::vector<GpuMaterial>& out, bool all = false);
+
+private:
+    struct NameHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view name) const { return static_cast<size_t>(Hash::fnv1a(name)); }
+    };
+
+    std::deque<Material> m_materials;
+    std::unordered_map<std::string, MaterialId, NameHash, std::equal_to<>> m_ids;
+    // GPU form of m_materials, and the range changed since collectChanges().
+    std::vector<GpuMaterial> m_gpuMaterials;
+    MaterialId m_changedBegin{0};
+    MaterialId m_changedEnd{0};
+    mutable std::mutex m_mutex;
+};
+
+#endif
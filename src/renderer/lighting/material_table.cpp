@@ -0,0 +1,30 @@
+#include <material_table.hpp>
+#include <material_registry.hpp>
+#include <memory_report.hpp>
+#include <algorithm>
+
+
+static constexpr size_t MIN_CAPACITY = 64;
+
+MaterialTable::~MaterialTable() {
+    MemoryReport::getInstance().remove(MemorySubsystem::MATERIALS_GPU, m_capacity * sizeof(GpuMaterial));
+}
+
+void MaterialTable::update(MaterialRegistry& registry) {
+    MaterialId first = registry.collectChanges(m_changes, m_capacity == 0);
+    // Immutable storage cannot grow: reallocate and upload everything.
+    while (first + m_changes.size() > m_capacity) {
+        MemoryReport& report = MemoryReport::getInstance();
+        report.remove(MemorySubsystem::MATERIALS_GPU, m_capacity * sizeof(GpuMaterial));
+        m_capacity = std::max({MIN_CAPACITY, first + m_changes.size(), m_capacity * 2});
+        m_buffer = GL::createBuffer(m_capacity * sizeof(GpuMaterial), nullptr, GL_DYNAMIC_STORAGE_BIT);
+        report.add(MemorySubsystem::MATERIALS_GPU, m_capacity * sizeof(GpuMaterial));
+        first = registry.collectChanges(m_changes, true);
+    }
+
+    if (!m_changes.empty()) {
+        glNamedBufferSubData(m_buffer.get(), first * sizeof(GpuMaterial), m_changes.size() * sizeof(GpuMaterial),
+                             m_changes.data());
+    }
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MATERIALS_BINDING, m_buffer.get());
+}
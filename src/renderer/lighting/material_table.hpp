@@ -0,0 +1,44 @@
+#ifndef MATERIAL_TABLE_H_
+#define MATERIAL_TABLE_H_
+
+#include <glad/glad.h>
+#include <vector>
+#include <gl_handle.hpp>
+#include <material.hpp>
+
+class MaterialRegistry;
+
+// Binding shared with the lit shaders.
+constexpr GLuint MATERIALS_BINDING = 6;
+
+/**
+ * @class MaterialTable
+ * @brief GPU copy of a MaterialRegistry, one GpuMaterial per MaterialId in a
+ * storage buffer, so draws only pass the index of their material. GL thread
+ * only.
+ *
+ * Only materials changed since the last update are uploaded. The buffer grows
+ * by doubling, re-uploading the whole registry.
+ */
+class MaterialTable {
+public:
+    MaterialTable() = default;
+    ~MaterialTable();
+    MaterialTable(const MaterialTable&) = delete;
+    MaterialTable& operator=(const MaterialTable&) = delete;
+
+    /**
+     * @brief Upload the changes of `registry` and bind the table to
+     * MATERIALS_BINDING.
+     */
+    void update(MaterialRegistry& registry);
+
+    size_t getCapacity() const { return m_capacity; }
+
+private:
+    BufferHandle m_buffer;
+    size_t m_capacity{0};
+    std::vector<GpuMaterial> m_changes;
+};
+
+#endif
@@ -1,3 +0,0 @@
-#include <materials.hpp>
-
-MaterialManager* MaterialManager::instance = nullptr;
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <iostream>
+#include <optional>
+
+#include "async_assets.hpp"
+#include "config_manager.hpp"
+#include "cooked_model.hpp"
+#include "mtl_parser.hpp"
+#include "shader.hpp"
+
+// Coroutines take their strings by value: the caller's may be gone when they resume.
+
+// Between checks of a shader program the driver is still linking.
+static constexpr std::chrono::microseconds SHADER_POLL_INTERVAL(1000);
+
+static Task<std::shared_ptr<GpuTexture>> textureTask(AssetLoader& loader, std::string path) {
+    co_await loader.toWorker();
+    TextureSource source = GpuTexture::decodeFile(path);
+    if (!source.isValid()) co_return nullptr;
+
+    co_await loader.toGlThread();
+    co_return GpuTexture::fromSource(source);
+}
+
+static Task<std::shared_ptr<ShaderEngine>> shaderEngineTask(AssetLoader& loader, std::string vertex,
+                                                            std::string fragment) {
+    co_await loader.toWorker();
+    std::string vertexSource = ShaderFactory::readSource(vertex);
+    std::string fragmentSource = ShaderFactory::readSource(fragment);
+
+    co_await loader.toGlThread();
+    auto engine = std::make_shared<ShaderEngine>();
+    engine->compileAsync(vertexSource, fragmentSource);
+    while (!engine->isCompileComplete())
+        co_await loader.toGlThread(SHADER_POLL_INTERVAL);
+    // Returned even if it failed, as ShaderEngineFactory does.
+    if (!engine->finishCompile())
+        std::cerr << "ERROR::ASYNC_ASSETS::Shader " << vertex << " + " << fragment << " failed to compile." << std::endl;
+    co_return engine;
+}
+
+static Task<std::shared_ptr<std::vector<Material>>> materialLibraryTask(AssetLoader& loader, std::string path) {
+    co_await loader.toWorker();
+    std::string cooked = ConfigurationManager::getInstance()->getCookedPath(path);
+    co_return std::make_shared<std::vector<Material>>(IO::parseMTL(cooked.empty() ? path : cooked));
+}
+
+static Task<std::shared_ptr<Model>> modelTask(AssetLoader& loader, std::string path) {
+    co_await loader.toWorker();
+    ImportProfile profile = ConfigurationManager::getInstance()->getImportProfile(path);
+    std::string cooked = Model::getCookedModelPath(path);
+    std::optional<IO::CookedModel> model = cooked.empty() ? std::nullopt : Model::readCooked(cooked);
+    if (!model) {
+        co_await loader.toGlThread();
+        co_return Model::fromSource(path, profile);
+    }
+
+    // Every texture decodes on its own worker.
+    std::vector<std::string> texturePaths;
+    for (const IO::CookedMesh& mesh : model->meshes) {
+        for (const IO::CookedTexture& texture : mesh.textures) {
+            std::string texturePath = Model::getCookedTexturePath(cooked, texture.path);
+            if (std::find(texturePaths.begin(), texturePaths.end(), texturePath) == texturePaths.end())
+                texturePaths.push_back(std::move(texturePath));
+        }
+    }
+    std::vector<AssetHandle<GpuTexture>> textureHandles;
+    for (const std::string& texturePath : texturePaths)
+        textureHandles.push_back(AsyncAssets::loadTexture(texturePath, loader));
+    Model::TextureMap textures;
+    for (size_t i = 0; i < texturePaths.size(); i++)
+        textures[texturePaths[i]] = co_await textureHandles[i];
+
+    co_await loader.toGlThread();
+    co_return Model::fromCooked(std::move(*model), cooked, profile, textures);
+}
+
+AssetHandle<GpuTexture> AsyncAssets::loadTexture(const std::string& path, AssetLoader& loader) {
+    return loader.load(textureTask(loader, path));
+}
+
+AssetHandle<ShaderEngine> AsyncAssets::loadShaderEngine(const std::string& vertex, const std::string& fragment,
+                                                        AssetLoader& loader) {
+    return loader.load(shaderEngineTask(loader, vertex, fragment));
+}
+
+AssetHandle<std::vector<Material>> AsyncAssets::loadMaterialLibrary(const std::string& path, AssetLoader& loader) {
+    return loader.load(materialLibraryTask(loader, path));
+}
+
+AssetHandle<Model> AsyncAssets::loadModel(const std::string& path, AssetLoader& loader) {
+    return loader.load(modelTask(loader, path));
+}
@@ -0,0 +1,51 @@
+#ifndef ASYNC_ASSETS_H_
+#define ASYNC_ASSETS_H_
+
+#include <string>
+#include <vector>
+#include <asset_loader.hpp>
+#include <material.hpp>
+#include <model.hpp>
+#include <shader_engine.hpp>
+#include <texture.hpp>
+
+/**
+ * @brief Asynchronous versions of the engine's loaders, run by an AssetLoader:
+ * files are read and decoded on worker threads, then uploaded on the GL
+ * thread. Each call returns at once; its handle is ready once the GL thread
+ * has run the upload in AssetLoader::runGlTasks() or waitAll().
+ *
+ * A failed load gives nullptr, like the synchronous loader gives an empty or
+ * null asset, and its message is printed.
+ *
+ * Loads only build new assets: the GL thread is the render thread once
+ * rendering starts, so applying a result to an existing object, e.g. with
+ * Renderable::setTexture(), is left to the thread that owns it, once the
+ * handle is ready.
+ */
+namespace AsyncAssets {
+    /**
+     * @brief GpuTexture::fromFile() of `path`.
+     */
+    AssetHandle<GpuTexture> loadTexture(const std::string& path, AssetLoader& loader = AssetLoader::getInstance());
+    /**
+     * @brief ShaderEngineFactory::createEngine() of `vertex` and `fragment`.
+     * The GL thread does not wait for the driver to compile: the program is
+     * checked again at each runGlTasks() until it is linked.
+     */
+    AssetHandle<ShaderEngine> loadShaderEngine(const std::string& vertex, const std::string& fragment,
+                                               AssetLoader& loader = AssetLoader::getInstance());
+    /**
+     * @brief IO::parseMTL() of `path`, or of its cooked library. No GL step.
+     */
+    AssetHandle<std::vector<Material>> loadMaterialLibrary(const std::string& path,
+                                                           AssetLoader& loader = AssetLoader::getInstance());
+    /**
+     * @brief Model(path). A cooked model is decoded and its textures loaded
+     * concurrently on workers, leaving only uploads to the GL thread. Other
+     * formats upload while they import, so they are imported on the GL thread.
+     */
+    AssetHandle<Model> loadModel(const std::string& path, AssetLoader& loader = AssetLoader::getInstance());
+}
+
+#endif
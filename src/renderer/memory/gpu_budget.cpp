@@ -0,0 +1,82 @@
+#include <gpu_budget.hpp>
+#include <config_manager.hpp>
+#include <algorithm>
+#include <iostream>
+
+
+GpuBudget::GpuBudget() {
+    m_budget = ConfigurationManager::getInstance()->getGpuBudgetBytes();
+}
+
+void GpuBudget::setBytes(Record& record, size_t bytes) {
+    MemoryReport& report = MemoryReport::getInstance();
+    report.remove(record.subsystem, record.bytes);
+    report.add(record.subsystem, bytes);
+    m_usedBytes = m_usedBytes - record.bytes + bytes;
+    record.bytes = bytes;
+}
+
+GpuResourceId GpuBudget::add(GpuBudgetResource* resource, MemorySubsystem subsystem, size_t bytes) {
+    GpuResourceId id;
+    if (!m_freeIds.empty()) {
+        id = m_freeIds.back();
+        m_freeIds.pop_back();
+    } else {
+        id = static_cast<GpuResourceId>(m_records.size());
+        m_records.emplace_back();
+    }
+
+    Record& record = m_records[id];
+    record = Record();
+    record.resource = resource;
+    record.subsystem = subsystem;
+    record.lastUsedFrame = m_frame;
+    setBytes(record, bytes);
+    return id;
+}
+
+void GpuBudget::remove(GpuResourceId id) {
+    if (id >= m_records.size() || !m_records[id].resource) return;
+
+    setBytes(m_records[id], 0);
+    m_records[id].resource = nullptr;
+    m_freeIds.push_back(id);
+}
+
+void GpuBudget::touch(GpuResourceId id) {
+    if (id >= m_records.size() || !m_records[id].resource) return;
+
+    Record& record = m_records[id];
+    bool firstUse = record.lastUsedFrame != m_frame;
+    record.lastUsedFrame = m_frame;
+    if (record.evicted && firstUse) {
+        setBytes(record, record.resource->restore());
+        record.evicted = record.resource->isDegraded();
+    }
+}
+
+void GpuBudget::enforce() {
+    if (m_usedBytes <= m_budget) return;
+
+    m_candidates.clear();
+    for (GpuResourceId id = 0; id < m_records.size(); id++) {
+        const Record& record = m_records[id];
+        if (record.resource && record.lastUsedFrame < m_frame && record.resource->canEvict())
+            m_candidates.push_back(id);
+    }
+    std::sort(m_candidates.begin(), m_candidates.end(), [this](GpuResourceId a, GpuResourceId b) {
+        return m_records[a].lastUsedFrame < m_records[b].lastUsedFrame;
+    });
+
+    for (GpuResourceId id : m_candidates) {
+        if (m_usedBytes <= m_budget) break;
+        Record& record = m_records[id];
+        setBytes(record, record.resource->evict());
+        record.evicted = true;
+    }
+
+    if (m_usedBytes > m_budget) {
+        std::cerr << "GPU_BUDGET::WARNING::" << m_usedBytes / (1024 * 1024) << " MB in use, budget is "
+                  << m_budget / (1024 * 1024) << " MB" << std::endl;
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef GPU_BUDGET_H_
+#define GPU_BUDGET_H_
+
+#include <cstdint>
+#include <vector>
+#include <memory_report.hpp>
+
+using GpuResourceId = uint32_t;
+constexpr GpuResourceId INVALID_GPU_RESOURCE = UINT32_MAX;
+
+/**
+ * @class GpuBudgetResource
+ * @brief GPU allocation that the budget may degrade when memory runs short.
+ */
+class GpuBudgetResource {
+public:
+    virtual ~GpuBudgetResource() = default;
+
+    virtual bool canEvict() const = 0;
+    /**
+     * @brief Shrink or release the GPU copy.
+     * @return Bytes still used on the GPU.
+     */
+    virtual size_t evict() = 0;
+    /**
+     * @brief Bring the resource back toward full quality. Called at most once
+     * a frame while it is used, until isDegraded() is false, so a resource may
+     * restore over several frames and keep drawing degraded meanwhile.
+     * @return Bytes used on the GPU.
+     */
+    virtual size_t restore() = 0;
+    virtual bool isDegraded() const = 0;
+};
+
+/**
+ * @class GpuBudget
+ * @brief Accounts every mesh buffer and texture against a VRAM budget and
+ * evicts the least recently used ones when it is exceeded. This class is a
+ * Singleton.
+ *
+ * Resources are stamped with the current frame whenever they are drawn. At the
+ * end of a frame, resources not used during that frame are evicted oldest
+ * first until the budget is met. Touching an evicted resource restores it a
+ * step per frame.
+ */
+class GpuBudget {
+public:
+    static GpuBudget& getInstance() {
+        static GpuBudget instance;
+        return instance;
+    }
+
+    GpuBudget(const GpuBudget&) = delete;
+    GpuBudget& operator=(const GpuBudget&) = delete;
+
+    /**
+     * @brief Start tracking `resource`, which must call remove() before it dies.
+     */
+    GpuResourceId add(GpuBudgetResource* resource, MemorySubsystem subsystem, size_t bytes);
+    void remove(GpuResourceId id);
+
+    /**
+     * @brief Mark a resource as used this frame, taking a restore step at the
+     * first use of the frame if it is evicted.
+     */
+    void touch(GpuResourceId id);
+
+    void beginFrame() { m_frame++; }
+    /**
+     * @brief Evict least recently used resources until under budget.
+     */
+    void enforce();
+
+    void setBudget(size_t bytes) { m_budget = bytes; }
+    size_t getBudget() const { return m_budget; }
+    size_t getUsedBytes() const { return m_usedBytes; }
+    uint64_t getFrame() const { return m_frame; }
+
+private:
+    struct Record {
+        GpuBudgetResource* resource = nullptr;
+        MemorySubsystem subsystem = MemorySubsystem::GEOMETRY_GPU;
+        size_t bytes = 0;
+        uint64_t lastUsedFrame = 0;
+        bool evicted = false;
+    };
+
+    std::vector<Record> m_records;
+    std::vector<GpuResourceId> m_freeIds;
+    std::vector<GpuResourceId> m_candidates;
+    size_t m_budget;
+    size_t m_usedBytes{0};
+    uint64_t m_frame{0};
+
+    void setBytes(Record& record, size_t bytes);
+
+    GpuBudget();
+    ~GpuBudget() {}
+};
+
+#endif
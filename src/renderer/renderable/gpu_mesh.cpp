@@ -0,0 +1,83 @@
+#include <gpu_mesh.hpp>
+#include <cstddef>
+
+
+static void setAttribute(GLuint vertexArray, GLuint index, GLint size, GLuint offset) {
+    glEnableVertexArrayAttrib(vertexArray, index);
+    glVertexArrayAttribFormat(vertexArray, index, size, GL_FLOAT, GL_FALSE, offset);
+    glVertexArrayAttribBinding(vertexArray, index, 0);
+}
+
+static void setIntegerAttribute(GLuint vertexArray, GLuint index, GLint size, GLuint offset) {
+    glEnableVertexArrayAttrib(vertexArray, index);
+    glVertexArrayAttribIFormat(vertexArray, index, size, GL_INT, offset);
+    glVertexArrayAttribBinding(vertexArray, index, 0);
+}
+
+GpuMesh::GpuMesh(std::span<const Vertex> vertices, std::span<const unsigned int> indices)
+    : m_vertexBytes(vertices.size_bytes()), m_positionBytes(vertices.size() * sizeof(glm::vec3)),
+      m_indexBytes(indices.size_bytes()),
+      m_indexCount(static_cast<GLsizei>(indices.size())) {
+    m_vertexArray = GL::createVertexArray();
+    GLuint vertexArray = m_vertexArray.get();
+    setAttribute(vertexArray, 0, 3, offsetof(Vertex, position));
+    setAttribute(vertexArray, 1, 3, offsetof(Vertex, normal));
+    setAttribute(vertexArray, 2, 2, offsetof(Vertex, textureCoordinates));
+    setAttribute(vertexArray, 3, 3, offsetof(Vertex, tangent));
+    setAttribute(vertexArray, 4, 3, offsetof(Vertex, biTangent));
+    setIntegerAttribute(vertexArray, 5, MAX_BONE_INFLUENCE, offsetof(Vertex, m_BoneIDs));
+    setAttribute(vertexArray, 6, MAX_BONE_INFLUENCE, offsetof(Vertex, m_Weights));
+
+    m_positionVertexArray = GL::createVertexArray();
+    setAttribute(m_positionVertexArray.get(), 0, 3, 0);
+
+    attachBuffers(vertices.data(), indices.data());
+    m_gpuResource = GpuBudget::getInstance().add(this, MemorySubsystem::GEOMETRY_GPU, getGpuBytes());
+}
+
+GpuMesh::~GpuMesh() {
+    GpuBudget::getInstance().remove(m_gpuResource);
+}
+
+void GpuMesh::setSource(std::span<const Vertex> vertices, std::span<const unsigned int> indices) {
+    m_sourceVertices = vertices;
+    m_sourceIndices = indices;
+    m_hasSource = true;
+}
+
+void GpuMesh::attachBuffers(const void* vertices, const void* indices) {
+    // Immutable storage cannot be empty.
+    if (m_vertexBytes > 0) {
+        m_vertexBuffer = GL::createBuffer(m_vertexBytes, vertices);
+        glVertexArrayVertexBuffer(m_vertexArray.get(), 0, m_vertexBuffer.get(), 0, sizeof(Vertex));
+
+        // Depth-only passes fetch 12 bytes per vertex instead of a whole Vertex.
+        const Vertex* source = static_cast<const Vertex*>(vertices);
+        std::vector<glm::vec3> positions(m_vertexBytes / sizeof(Vertex));
+        for (size_t i = 0; i < positions.size(); i++) positions[i] = source[i].position;
+        m_positionBuffer = GL::createBuffer(m_positionBytes, positions.data());
+        glVertexArrayVertexBuffer(m_positionVertexArray.get(), 0, m_positionBuffer.get(), 0, sizeof(glm::vec3));
+    }
+    if (m_indexBytes > 0) {
+        m_indexBuffer = GL::createBuffer(m_indexBytes, indices);
+        glVertexArrayElementBuffer(m_vertexArray.get(), m_indexBuffer.get());
+        glVertexArrayElementBuffer(m_positionVertexArray.get(), m_indexBuffer.get());
+    }
+}
+
+size_t GpuMesh::evict() {
+    // The vertex array keeps its buffers alive, so detach them before deleting.
+    glVertexArrayVertexBuffer(m_vertexArray.get(), 0, 0, 0, sizeof(Vertex));
+    glVertexArrayElementBuffer(m_vertexArray.get(), 0);
+    glVertexArrayVertexBuffer(m_positionVertexArray.get(), 0, 0, 0, sizeof(glm::vec3));
+    glVertexArrayElementBuffer(m_positionVertexArray.get(), 0);
+    m_vertexBuffer.reset();
+    m_positionBuffer.reset();
+    m_indexBuffer.reset();
+    return 0;
+}
+
+size_t GpuMesh::restore() {
+    attachBuffers(m_sourceVertices.data(), m_sourceIndices.data());
+    return getGpuBytes();
+}
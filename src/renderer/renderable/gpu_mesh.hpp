@@ -0,0 +1,64 @@
+#ifndef GPU_MESH_H_
+#define GPU_MESH_H_
+
+#include <glad/glad.h>
+#include <span>
+#include <vector>
+#include <gl_handle.hpp>
+#include <gl_state.hpp>
+#include <gpu_budget.hpp>
+#include "vertex.hpp"
+
+
+/**
+ * @class GpuMesh
+ * @brief Vertex array with immutable vertex and index buffers, tracked by the
+ * GpuBudget.
+ *
+ * The attribute layout is recorded once on the vertex array; eviction only
+ * releases the buffers attached to it, which are uploaded again from the CPU
+ * copy given to setSource() when the mesh is drawn again. A mesh without one
+ * has its only copy on the GPU and is never evicted.
+ *
+ * A second vertex array reads tightly packed positions only, for depth-only
+ * passes. It shares the index buffer and is rebuilt from the same vertices.
+ */
+class GpuMesh : public GpuBudgetResource {
+public:
+    GpuMesh(std::span<const Vertex> vertices, std::span<const unsigned int> indices);
+    ~GpuMesh() override;
+    GpuMesh(const GpuMesh&) = delete;
+    GpuMesh& operator=(const GpuMesh&) = delete;
+
+    void bind() const { GLState::getInstance().bindVertexArray(m_vertexArray.get()); }
+    void bindPositions() const { GLState::getInstance().bindVertexArray(m_positionVertexArray.get()); }
+    GLuint getVertexArray() const { return m_vertexArray.get(); }
+    GLsizei getIndexCount() const { return m_indexCount; }
+    GpuResourceId getGpuResource() const { return m_gpuResource; }
+    /**
+     * @brief Restore from `vertices` and `indices`, the data uploaded, after
+     * an eviction. They must stay unchanged while the mesh lives.
+     */
+    void setSource(std::span<const Vertex> vertices, std::span<const unsigned int> indices);
+
+    bool canEvict() const override { return m_hasSource && (m_vertexBuffer || m_indexBuffer); }
+    size_t evict() override;
+    size_t restore() override;
+    // Restored in a single step.
+    bool isDegraded() const override { return false; }
+
+private:
+    VertexArrayHandle m_vertexArray, m_positionVertexArray;
+    BufferHandle m_vertexBuffer, m_positionBuffer, m_indexBuffer;
+    size_t m_vertexBytes, m_positionBytes, m_indexBytes;
+    GLsizei m_indexCount;
+    std::span<const Vertex> m_sourceVertices;
+    std::span<const unsigned int> m_sourceIndices;
+    bool m_hasSource{false};
+    GpuResourceId m_gpuResource{INVALID_GPU_RESOURCE};
+
+    void attachBuffers(const void* vertices, const void* indices);
+    size_t getGpuBytes() const { return m_vertexBytes + m_positionBytes + m_indexBytes; }
+};
+
+#endif
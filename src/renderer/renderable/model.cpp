@@ -3,104 +3,221 @@
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 #include <iostream>
-#include <stb_image.h>
+#include <algorithm>
+#include <cctype>
 
 #include "model.hpp"
 #include "shader.hpp"
 #include "shader_engine.hpp"
 #include "texture.hpp"
+#include "simd.hpp"
+#include "config_manager.hpp"
+#include "animation_import.hpp"
+#include "assimp_import.hpp"
+#include "asset_path.hpp"
+#include "cooked_model.hpp"
 
-Mesh::Mesh(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
-    std::vector<Texture>& textures) : Renderable() {
-    m_vertices = vertices;
-    m_indices = indices;
-    m_textures = textures;
+Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices,
+    std::vector<Texture> textures, GeometryResidency residency, bool skinned) : Renderable() {
+    m_vertices = std::move(vertices);
+    m_indices = std::move(indices);
+    m_textures = std::move(textures);
+    m_residency = residency;
+    m_skinned = skinned;
 
     setup();
 };
 
+struct ImportStats {
+    size_t meshes = 0;
+    size_t vertices = 0;
+    size_t indices = 0;
+
+    // Size of the data once converted to Vertex/index buffers.
+    size_t bytes() const { return vertices * sizeof(Vertex) + indices * sizeof(unsigned int); }
+};
+
+static ImportStats computeImportStats(const aiScene* scene) {
+    ImportStats stats;
+    stats.meshes = scene->mNumMeshes;
+    for (unsigned int i = 0; i < scene->mNumMeshes; i++) {
+        const aiMesh* mesh = scene->mMeshes[i];
+        stats.vertices += mesh->mNumVertices;
+        for (unsigned int j = 0; j < mesh->mNumFaces; j++)
+            stats.indices += mesh->mFaces[j].mNumIndices;
+    }
+    return stats;
+}
+
 Model::Model(std::string const path) {
     loadModel(path);
 }
 
-Model::Model(Primitive& primitive) {
-    m_meshes.push_back(primitive);
+Model::Model(Primitive&& primitive) {
+    m_meshes.push_back(std::move(primitive));
+    m_nodes.push_back({"root", -1, glm::mat4(1.0f), glm::mat4(1.0f)});
+    m_instances.push_back({0, 0});
 }
 
-void Model::draw() {
-    for (unsigned int i = 0; i < m_meshes.size(); i++) {
-        m_meshes[i].draw();
+void Model::draw(const glm::mat4& model) {
+    glm::mat4 instanceModel;
+    for (const MeshInstance& instance : m_instances) {
+        Simd::mat4Mul(model, m_nodes[instance.node].globalTransform, instanceModel);
+        m_engine->use();
+        m_engine->setMat4("model", instanceModel);
+        m_meshes[instance.mesh].draw();
     }
 };
 
-void Model::setShaderEngine(ShaderEngine engine) {
+void Model::recordDraws(CommandList& commands, const glm::mat4& model, float depth) {
+    glm::mat4 instanceModel;
+    for (const MeshInstance& instance : m_instances) {
+        Simd::mat4Mul(model, m_nodes[instance.node].globalTransform, instanceModel);
+        commands.draw(&m_meshes[instance.mesh], instanceModel, depth);
+    }
+}
+
+void Model::recordSkinnedDraws(CommandList& commands, const glm::mat4& model, uint32_t paletteOffset, float depth) {
+    glm::mat4 instanceModel;
+    for (const MeshInstance& instance : m_instances) {
+        Renderable& mesh = m_meshes[instance.mesh];
+        if (mesh.isSkinned()) {
+            commands.drawSkinned(&mesh, model, paletteOffset, depth);
+            continue;
+        }
+        Simd::mat4Mul(model, m_nodes[instance.node].globalTransform, instanceModel);
+        commands.draw(&mesh, instanceModel, depth);
+    }
+}
+
+void Model::setShaderEngine(std::shared_ptr<ShaderEngine> engine) {
+    m_engine = engine;
     for (auto& mesh : m_meshes)
         mesh.setShaderEngine(engine);
 }
 
+void Model::setShaderPermutations(std::shared_ptr<ShaderPermutations> permutations) {
+    for (auto& mesh : m_meshes)
+        mesh.setShaderPermutations(permutations);
+}
+
+void Model::setMaterial(MaterialId material) {
+    for (auto& mesh : m_meshes)
+        mesh.setMaterial(material);
+}
+
 void Model::loadModel(std::string path) {
+    ImportProfile profile = ConfigurationManager::getInstance()->getImportProfile(path);
+    m_residency = profile.residency;
+
+    // Cooked by lamb_cook: nothing left to import or decode.
+    std::string cookedPath = getCookedModelPath(path);
+    std::optional<IO::CookedModel> cooked = cookedPath.empty() ? std::nullopt : readCooked(cookedPath);
+    if (cooked) {
+        buildCooked(*cooked, cookedPath, profile, {});
+        return;
+    }
+    importSource(path, profile);
+}
+
+std::shared_ptr<Model> Model::fromSource(const std::string& path, const ImportProfile& profile) {
+    std::shared_ptr<Model> model(new Model());
+    model->importSource(path, profile);
+    return model;
+}
+
+void Model::importSource(const std::string& path, const ImportProfile& profile) {
+    m_residency = profile.residency;
+    std::string extension = AssetPath::getExtension(path);
+    // Unreadable, already reported by readCooked().
+    if (extension == ".lmodel") return;
+    if (profile.nativeGltf && (extension == ".glb" || extension == ".gltf")) {
+        loadGltf(path, profile);
+        return;
+    }
+    if (profile.nativeObj && extension == ".obj") {
+        loadObj(path, profile);
+        return;
+    }
+
     Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs);
+    const aiScene* scene = AssimpImport::readFile(importer, path, profile);
 
     if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
         std::cout << "ERROR::ASSIMP::" << importer.GetErrorString() << std::endl;
         return;
     }
 
+    ImportStats before = computeImportStats(scene);
+    unsigned int postProcessFlags = AssimpImport::getPostProcessFlags(profile);
+    if (postProcessFlags != 0) {
+        scene = importer.ApplyPostProcessing(postProcessFlags);
+        if (!scene || !scene->mRootNode) {
+            std::cout << "ERROR::ASSIMP::" << importer.GetErrorString() << std::endl;
+            return;
+        }
+    }
+    ImportStats after = computeImportStats(scene);
+
+    std::cout << "MODEL::IMPORT::" << path
+              << " meshes: " << before.meshes << " -> " << after.meshes
+              << ", vertices: " << before.vertices << " -> " << after.vertices
+              << ", indices: " << before.indices << " -> " << after.indices
+              << ", memory: " << before.bytes() / 1024 << " KB -> " << after.bytes() / 1024 << " KB"
+              << std::endl;
+
     m_directory = path.substr(0, path.find_last_of('/'));
 
-    processNode(scene->mRootNode, scene);
-};
+    std::vector<int32_t> sceneMeshToMesh(scene->mNumMeshes, -1);
+    processNode(scene->mRootNode, scene, -1, sceneMeshToMesh);
+    buildSkeleton();
 
-void Model::processNode(aiNode* node, const aiScene* scene) {
-    for (unsigned int i = 0; i < node->mNumMeshes; i++) {
-        aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-        m_meshes.push_back(std::move(processMesh(mesh, scene)));
+    if (isSkinned()) {
+        for (unsigned int i = 0; i < scene->mNumAnimations; i++)
+            m_animations.push_back(importAnimationClip(*scene->mAnimations[i], m_skeleton, profile.animationSampleRate));
+        std::cout << "MODEL::SKELETON::" << path << " joints: " << m_skeleton.getJointCount()
+                  << ", bones: " << m_skeleton.getBoneCount() << ", clips: " << m_animations.size() << std::endl;
     }
 
-    for (unsigned int i = 0; i < node->mNumChildren; i++) {
-        processNode(node->mChildren[i], scene);
-    }
+    // Keep instances of the same mesh adjacent so consecutive draws share buffers.
+    std::stable_sort(m_instances.begin(), m_instances.end(),
+        [](const MeshInstance& a, const MeshInstance& b) { return a.mesh < b.mesh; });
 };
 
-Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene) {
-    std::vector<Vertex> vertices;
-    std::vector<unsigned int> indices;
-    std::vector<Texture> textures;
+void Model::processNode(aiNode* node, const aiScene* scene, int32_t parent,
+                        std::vector<int32_t>& sceneMeshToMesh) {
+    ModelNode modelNode;
+    modelNode.name = node->mName.C_Str();
+    modelNode.parent = parent;
+    modelNode.localTransform = AssimpImport::toGlm(node->mTransformation);
+    if (parent < 0)
+        modelNode.globalTransform = modelNode.localTransform;
+    else
+        Simd::mat4Mul(m_nodes[parent].globalTransform, modelNode.localTransform,
+                      modelNode.globalTransform);
 
-    for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
-        Vertex vertex;
-        glm::vec3 vector;
-        vector.x = mesh->mVertices[i].x;
-        vector.y = mesh->mVertices[i].y;
-        vector.z = mesh->mVertices[i].z;
-        vertex.position = vector;
-
-        if (mesh->HasNormals()) {
-            vector.x = mesh->mNormals[i].x;
-            vector.y = mesh->mNormals[i].y;
-            vector.z = mesh->mNormals[i].z;
-            vertex.normal = vector;
-        }
+    uint32_t nodeIndex = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.push_back(std::move(modelNode));
 
-        if (mesh->mTextureCoords[0]) {
-            glm::vec2 vec;
-            vec.x = mesh->mTextureCoords[0][i].x;
-            vec.y = mesh->mTextureCoords[0][i].y;
-            vertex.textureCoordinates = vec;
-        }
-        else {
-            vertex.textureCoordinates = glm::vec2(0.0f, 0.0f);
+    for (unsigned int i = 0; i < node->mNumMeshes; i++) {
+        unsigned int sceneMesh = node->mMeshes[i];
+        // Each aiMesh is uploaded once, further references only add an instance.
+        if (sceneMeshToMesh[sceneMesh] < 0) {
+            sceneMeshToMesh[sceneMesh] = static_cast<int32_t>(m_meshes.size());
+            m_meshes.push_back(processMesh(scene->mMeshes[sceneMesh], scene));
         }
-        vertices.push_back(vertex);
-
+        m_instances.push_back({static_cast<uint32_t>(sceneMeshToMesh[sceneMesh]), nodeIndex});
     }
 
-    for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
-        aiFace face = mesh->mFaces[i];
-        for (unsigned int j = 0; j < face.mNumIndices; j++)
-            indices.push_back(face.mIndices[j]);
+    for (unsigned int i = 0; i < node->mNumChildren; i++) {
+        processNode(node->mChildren[i], scene, static_cast<int32_t>(nodeIndex), sceneMeshToMesh);
     }
+};
+
+Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene) {
+    std::vector<Vertex> vertices = AssimpImport::readVertices(*mesh);
+    std::vector<unsigned int> indices = AssimpImport::readIndices(*mesh);
+    std::vector<Texture> textures;
 
     if (mesh->mMaterialIndex >= 0) {
         aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
@@ -112,47 +229,80 @@ Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene) {
         textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
     }
 
-    return Mesh(vertices, indices, textures);
+    bool skinned = mesh->HasBones();
+    if (skinned) processBones(mesh, vertices);
+
+    return Mesh(std::move(vertices), std::move(indices), std::move(textures), m_residency, skinned);
 };
 
-unsigned int textureFromFile(const char *path, const std::string &directory)
-{
-    std::string filename = std::string(path);
-    filename = directory + '/' + filename;
+void Model::processBones(const aiMesh* mesh, std::vector<Vertex>& vertices) {
+    for (unsigned int i = 0; i < mesh->mNumBones; i++) {
+        const aiBone* bone = mesh->mBones[i];
+        auto [entry, inserted] = m_boneIndices.try_emplace(bone->mName.C_Str(),
+            static_cast<uint32_t>(m_skeleton.inverseBindMatrices.size()));
+        if (inserted)
+            m_skeleton.inverseBindMatrices.push_back(AssimpImport::toGlm(bone->mOffsetMatrix));
+        int boneIndex = static_cast<int>(entry->second);
 
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
+        for (unsigned int j = 0; j < bone->mNumWeights; j++) {
+            const aiVertexWeight& weight = bone->mWeights[j];
+            Vertex& vertex = vertices[weight.mVertexId];
+            // Keep the strongest influences, replacing the weakest one.
+            int weakest = 0;
+            for (int k = 1; k < MAX_BONE_INFLUENCE; k++) {
+                if (vertex.m_Weights[k] < vertex.m_Weights[weakest]) weakest = k;
+            }
+            if (weight.mWeight <= vertex.m_Weights[weakest]) continue;
+            vertex.m_BoneIDs[weakest] = boneIndex;
+            vertex.m_Weights[weakest] = weight.mWeight;
+        }
+    }
 
-    int width, height, nrComponents;
-    unsigned char *data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
-    if (data)
-    {
-        GLenum format;
-        if (nrComponents == 1)
-            format = GL_RED;
-        else if (nrComponents == 3)
-            format = GL_RGB;
-        else if (nrComponents == 4)
-            format = GL_RGBA;
+    // Dropped influences leave the sum below one.
+    for (Vertex& vertex : vertices) {
+        float sum = 0.0f;
+        for (float weight : vertex.m_Weights) sum += weight;
+        if (sum <= 0.0f) continue;
+        for (float& weight : vertex.m_Weights) weight /= sum;
+    }
+}
 
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
+void Model::buildSkeleton() {
+    if (m_boneIndices.empty()) return;
 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    // Every node is a joint: bones reference nodes, and their parents must be
+    // animated too for the palette to follow the hierarchy.
+    const size_t jointCount = m_nodes.size();
+    m_skeleton.jointNames.reserve(jointCount);
+    m_skeleton.jointParents.reserve(jointCount);
+    m_skeleton.bindPose.reserve(jointCount);
+    for (const ModelNode& node : m_nodes) {
+        m_skeleton.jointNames.push_back(node.name);
+        m_skeleton.jointParents.push_back(node.parent);
+        m_skeleton.bindPose.push_back(fromMatrix(node.localTransform));
+    }
 
-        stbi_image_free(data);
+    m_skeleton.boneJoints.resize(m_boneIndices.size(), 0);
+    for (const auto& [name, bone] : m_boneIndices) {
+        int32_t joint = m_skeleton.findJoint(name);
+        if (joint < 0)
+            std::cout << "MODEL::SKELETON::no node for bone " << name << std::endl;
+        m_skeleton.boneJoints[bone] = joint < 0 ? 0 : static_cast<uint32_t>(joint);
     }
-    else
-    {
+    m_boneIndices.clear();
+}
+
+static Texture textureFromFile(const char *path, const std::string &directory)
+{
+    std::string filename = std::string(path);
+    filename = directory + '/' + filename;
+
+    Texture texture;
+    texture.texture = GpuTexture::fromFile(filename);
+    if (!texture.texture)
         std::cout << "Texture failed to load at path: " << path << std::endl;
-        stbi_image_free(data);
-    }
 
-    return textureID; 
+    return texture;
 };
 
 std::vector<Texture> Model::loadMaterialTextures(aiMaterial *mat,
@@ -175,8 +325,8 @@ std::vector<Texture> Model::loadMaterialTextures(aiMaterial *mat,
         }
         if(!skip)
         {
-            Texture texture;
-            texture.id = textureFromFile(str.C_Str(), m_directory);
+            Texture texture = textureFromFile(str.C_Str(), m_directory);
+            if (!texture.texture) continue;
             texture.type = lambTextureType;
             texture.path = str.C_Str();
             textures.push_back(texture);
@@ -5,7 +5,12 @@
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
+#include <cstdint>
+#include <optional>
 #include <vector>
+#include <span>
+#include <string>
+#include <unordered_map>
 #include <iostream>
 
 #include "shader.hpp"
@@ -13,31 +18,142 @@
 #include "primitive.hpp"
 #include "renderable.hpp"
 #include "texture.hpp"
+#include "command_list.hpp"
+#include "skeleton.hpp"
+#include "animation_clip.hpp"
+#include "import_profile.hpp"
 
+namespace IO { struct CookedModel; }
 
 class Mesh : public Renderable {
 public:
-    Mesh(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
-         std::vector<Texture>& textures);
+    Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices,
+         std::vector<Texture> textures, GeometryResidency residency = GeometryResidency::KEEP,
+         bool skinned = false);
+};
+
+/**
+ * @brief Flattened scene node. Nodes are stored parent first, so a node's
+ * global transform can be computed in a single forward pass.
+ */
+struct ModelNode {
+    std::string name;
+    int32_t parent;
+    glm::mat4 localTransform;
+    glm::mat4 globalTransform;
+};
+
+/**
+ * @brief One reference from a node to a shared mesh.
+ */
+struct MeshInstance {
+    uint32_t mesh;
+    uint32_t node;
 };
 
 class Model {
 public:
+    // Uploaded textures by path, e.g. loaded ahead of the model.
+    using TextureMap = std::unordered_map<std::string, std::shared_ptr<GpuTexture>>;
+
     Model(std::string const path);
-    Model(Primitive& primitive);
-    void draw();
-    void setShaderEngine(ShaderEngine engine);
-    std::vector<Renderable> getMeshes() {
-        return m_meshes;
-    }
+    Model(Primitive&& primitive);
+    /**
+     * @brief Model of a cooked model already read from the ".lmodel" file at
+     * `path`. Its textures are taken from `textures` when there, loaded
+     * otherwise. GL thread only.
+     */
+    static std::shared_ptr<Model> fromCooked(IO::CookedModel&& cooked, const std::string& path,
+                                             const ImportProfile& profile, const TextureMap& textures = {});
+    /**
+     * @brief Model imported from the source asset at `path`, without looking
+     * for its cooked model. GL thread only.
+     */
+    static std::shared_ptr<Model> fromSource(const std::string& path, const ImportProfile& profile);
+    /**
+     * @brief ".lmodel" file to read for the model at `path`: `path` itself if
+     * it is one, its artifact cooked by lamb_cook otherwise, empty if none.
+     */
+    static std::string getCookedModelPath(const std::string& path);
+    /**
+     * @brief Read the cooked model at `cookedPath`, printing why it failed.
+     * @return std::nullopt if it cannot be read or has no mesh.
+     */
+    static std::optional<IO::CookedModel> readCooked(const std::string& cookedPath);
+    /**
+     * @brief Path of the texture `texture` of the cooked model at `modelPath`,
+     * the key of the TextureMap given to fromCooked().
+     */
+    static std::string getCookedTexturePath(const std::string& modelPath, const std::string& texture);
+    /**
+     * @brief Draw every mesh instance with `model * node.globalTransform`
+     * bound to the "model" uniform.
+     */
+    void draw(const glm::mat4& model = glm::mat4(1.0f));
+    /**
+     * @brief Record the same draws as draw() into `commands`.
+     */
+    void recordDraws(CommandList& commands, const glm::mat4& model = glm::mat4(1.0f), float depth = 0.0f);
+    /**
+     * @brief Record the draws of one animated instance whose palette starts at
+     * `paletteOffset`. Skinned meshes are placed by the palette alone, so they
+     * get `model` without their node transform.
+     */
+    void recordSkinnedDraws(CommandList& commands, const glm::mat4& model, uint32_t paletteOffset,
+                            float depth = 0.0f);
+    void setShaderEngine(std::shared_ptr<ShaderEngine> engine);
+    void setShaderPermutations(std::shared_ptr<ShaderPermutations> permutations);
+    /**
+     * @brief Override the material of every mesh.
+     */
+    void setMaterial(MaterialId material);
+    std::span<const Renderable> getMeshes() const { return m_meshes; }
+    const std::vector<ModelNode>& getNodes() const { return m_nodes; }
+    const std::vector<MeshInstance>& getInstances() const { return m_instances; }
+    const Skeleton& getSkeleton() const { return m_skeleton; }
+    const std::vector<AnimationClip>& getAnimations() const { return m_animations; }
+    bool isSkinned() const { return m_skeleton.getBoneCount() > 0; }
 private:
+    // One entry per unique aiMesh, shared by every node that references it.
     std::vector<Renderable> m_meshes;
+    std::vector<ModelNode> m_nodes;
+    std::vector<MeshInstance> m_instances;
+    std::shared_ptr<ShaderEngine> m_engine;
     std::string m_directory;
+    // Shares one GpuTexture between every mesh using the same image.
     std::vector<Texture> m_texturesLoaded;
+    GeometryResidency m_residency{GeometryResidency::KEEP};
+    Skeleton m_skeleton;
+    std::vector<AnimationClip> m_animations;
+    // Bone index by name while importing, bones are shared between meshes.
+    std::unordered_map<std::string, uint32_t> m_boneIndices;
 
+    Model() = default;
     void loadModel(std::string path);
-    void processNode(aiNode* node, const aiScene* scene);
+    /**
+     * @brief Native import of a glTF 2.0 asset, without Assimp. Skins and
+     * animations are not read.
+     */
+    void loadGltf(const std::string& path, const ImportProfile& profile);
+    /**
+     * @brief Native import of an OBJ file, one mesh per material.
+     */
+    void loadObj(const std::string& path, const ImportProfile& profile);
+    /**
+     * @brief Import `path` with the importer its extension and profile select.
+     */
+    void importSource(const std::string& path, const ImportProfile& profile);
+    /**
+     * @brief Build from a ".lmodel" file written by the asset cook, whose
+     * meshes are compressed with MeshCodec. Skins and animations are not stored.
+     */
+    void buildCooked(IO::CookedModel& cooked, const std::string& path, const ImportProfile& profile,
+                     const TextureMap& uploaded);
+    void processNode(aiNode* node, const aiScene* scene, int32_t parent,
+                     std::vector<int32_t>& sceneMeshToMesh);
     Mesh processMesh(aiMesh* mesh, const aiScene* scene);
+    void processBones(const aiMesh* mesh, std::vector<Vertex>& vertices);
+    void buildSkeleton();
     std::vector<Texture> loadMaterialTextures(aiMaterial* mat,
         aiTextureType assimpTextureType, TextureType lambTextureType);
 };
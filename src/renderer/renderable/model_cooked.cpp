@@ -0,0 +1,102 @@
+#include <glm/glm.hpp>
+#include <iostream>
+#include <stdexcept>
+
+#include "model.hpp"
+#include "asset_path.hpp"
+#include "config_manager.hpp"
+#include "cooked_model.hpp"
+#include "material_registry.hpp"
+#include "simd.hpp"
+
+
+std::string Model::getCookedTexturePath(const std::string& modelPath, const std::string& texture) {
+    return AssetPath::getDirectory(modelPath) + '/' + texture;
+}
+
+std::shared_ptr<Model> Model::fromCooked(IO::CookedModel&& cooked, const std::string& path,
+                                         const ImportProfile& profile, const TextureMap& textures) {
+    std::shared_ptr<Model> model(new Model());
+    model->buildCooked(cooked, path, profile, textures);
+    return model;
+}
+
+std::string Model::getCookedModelPath(const std::string& path) {
+    if (AssetPath::getExtension(path) == ".lmodel") return path;
+    return ConfigurationManager::getInstance()->getCookedPath(path);
+}
+
+std::optional<IO::CookedModel> Model::readCooked(const std::string& cookedPath) {
+    try {
+        IO::CookedModel cooked = IO::readCookedModel(cookedPath);
+        if (!cooked.meshes.empty()) return cooked;
+        std::cout << "ERROR::COOKED::" << cookedPath << "::No mesh" << std::endl;
+    } catch (const std::exception& e) {
+        std::cout << "ERROR::COOKED::" << cookedPath << "::" << e.what() << std::endl;
+    }
+    return std::nullopt;
+}
+
+void Model::buildCooked(IO::CookedModel& cooked, const std::string& path, const ImportProfile& profile,
+                        const TextureMap& uploaded) {
+    m_directory = AssetPath::getDirectory(path);
+    m_residency = profile.residency;
+
+    MaterialRegistry& registry = MaterialRegistry::getInstance();
+    for (const std::string& library : cooked.materialLibraries) {
+        try {
+            registry.loadLibrary(m_directory + '/' + library);
+        } catch (const std::exception& e) {
+            std::cout << "MODEL::IMPORT::" << path << " skipped material library: " << e.what() << std::endl;
+        }
+    }
+
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    for (IO::CookedMesh& source : cooked.meshes) {
+        std::vector<Texture> textures;
+        for (const IO::CookedTexture& cookedTexture : source.textures) {
+            bool shared = false;
+            for (const Texture& loaded : m_texturesLoaded) {
+                if (loaded.path == cookedTexture.path) {
+                    textures.push_back({loaded.texture, cookedTexture.type, cookedTexture.path});
+                    shared = true;
+                    break;
+                }
+            }
+            if (shared) continue;
+            std::string texturePath = m_directory + '/' + cookedTexture.path;
+            auto preloaded = uploaded.find(texturePath);
+            Texture texture{preloaded != uploaded.end() ? preloaded->second : GpuTexture::fromFile(texturePath),
+                            cookedTexture.type, cookedTexture.path};
+            if (!texture.texture) continue;
+            m_texturesLoaded.push_back(texture);
+            textures.push_back(std::move(texture));
+        }
+
+        vertexCount += source.vertices.size();
+        indexCount += source.indices.size();
+        MaterialId material = source.material.empty() ? INVALID_MATERIAL : registry.find(source.material);
+        Mesh mesh(std::move(source.vertices), std::move(source.indices), std::move(textures), m_residency,
+                  source.skinned);
+        if (material != INVALID_MATERIAL) mesh.setMaterial(material);
+        m_meshes.push_back(std::move(mesh));
+    }
+
+    // Nodes are stored parent first, as Model keeps them.
+    for (IO::CookedNode& source : cooked.nodes) {
+        ModelNode node{std::move(source.name), source.parent, source.localTransform, source.localTransform};
+        if (node.parent >= 0)
+            Simd::mat4Mul(m_nodes[node.parent].globalTransform, node.localTransform, node.globalTransform);
+        m_nodes.push_back(std::move(node));
+    }
+    for (const IO::CookedInstance& instance : cooked.instances)
+        m_instances.push_back({instance.mesh, instance.node});
+
+    std::cout << "MODEL::IMPORT::" << path << " (cooked)"
+              << " meshes: " << m_meshes.size()
+              << ", vertices: " << vertexCount
+              << ", indices: " << indexCount
+              << ", memory: " << (vertexCount * sizeof(Vertex) + indexCount * sizeof(unsigned int)) / 1024 << " KB"
+              << std::endl;
+}
@@ -0,0 +1,274 @@
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+
+#include "model.hpp"
+#include "gltf_document.hpp"
+#include "material_registry.hpp"
+#include "joint_pose.hpp"
+#include "simd.hpp"
+
+using json = nlohmann::json;
+
+static constexpr int GLTF_MODE_TRIANGLES = 4;
+static constexpr size_t VERTEX_FLOATS = sizeof(Vertex) / sizeof(float);
+static_assert(sizeof(Vertex) % sizeof(float) == 0, "Vertex attributes are read with a float stride");
+
+
+static glm::vec3 readVec3(const json& object, const char* key, const glm::vec3& fallback) {
+    if (!object.contains(key)) return fallback;
+    const json& value = object[key];
+    return glm::vec3(value.at(0).get<float>(), value.at(1).get<float>(), value.at(2).get<float>());
+}
+
+/**
+ * @brief Local transform of a node, given either as a column-major matrix or
+ * as translation, rotation and scale.
+ */
+static glm::mat4 readNodeTransform(const json& node) {
+    if (node.contains("matrix")) {
+        const json& values = node["matrix"];
+        glm::mat4 matrix;
+        for (int column = 0; column < 4; column++) {
+            for (int row = 0; row < 4; row++)
+                matrix[column][row] = values.at(column * 4 + row).get<float>();
+        }
+        return matrix;
+    }
+
+    JointPose pose;
+    pose.translation = readVec3(node, "translation", glm::vec3(0.0f));
+    pose.scale = readVec3(node, "scale", glm::vec3(1.0f));
+    if (node.contains("rotation")) {
+        // glTF stores x, y, z, w.
+        const json& q = node["rotation"];
+        pose.rotation = glm::quat(q.at(3).get<float>(), q.at(0).get<float>(), q.at(1).get<float>(), q.at(2).get<float>());
+    }
+    return toMatrix(pose);
+}
+
+/**
+ * @brief Register the metallic-roughness material `source` as the closest
+ * Blinn-Phong material.
+ */
+static MaterialId registerGltfMaterial(const json& source, std::string name) {
+    Material material;
+    material.name = std::move(name);
+
+    const json pbr = source.value("pbrMetallicRoughness", json::object());
+    glm::vec4 baseColor(1.0f);
+    if (pbr.contains("baseColorFactor")) {
+        for (int i = 0; i < 4; i++) baseColor[i] = pbr["baseColorFactor"].at(i).get<float>();
+    }
+    float metallic = pbr.value("metallicFactor", 1.0f);
+    float roughness = pbr.value("roughnessFactor", 1.0f);
+
+    material.diffuse = glm::vec3(baseColor);
+    material.ambient = material.diffuse;
+    material.dissolve = baseColor.w;
+    // Metals reflect their base color, dielectrics about 4% of white light.
+    material.specular = glm::mix(glm::vec3(0.04f), material.diffuse, metallic);
+    // Phong exponent with the same highlight width: 2 / alpha^2 - 2, alpha being roughness^2.
+    float alpha = roughness * roughness;
+    material.shininess = std::clamp(2.0f / std::max(alpha * alpha, 1e-4f) - 2.0f, 1.0f, 1024.0f);
+    material.emissive = readVec3(source, "emissiveFactor", glm::vec3(0.0f));
+    return MaterialRegistry::getInstance().add(std::move(material));
+}
+
+/**
+ * @brief Vertices and indices of a triangle primitive, read straight from its
+ * accessors into the interleaved Vertex layout.
+ */
+static Mesh readGltfPrimitive(const IO::GltfDocument& document, const json& primitive,
+                              std::vector<Texture> textures, const ImportProfile& profile,
+                              size_t& vertexCount, size_t& indexCount) {
+    const json& attributes = primitive.at("attributes");
+    IO::GltfAccessor positions = document.getAccessor(attributes.at("POSITION"));
+
+    // Value-initialized: attributes the primitive lacks read as zeros.
+    std::vector<Vertex> vertices(positions.count, Vertex{});
+    if (vertices.empty())
+        return Mesh(std::move(vertices), {}, std::move(textures), profile.residency);
+    IO::readFloats(positions, 3, &vertices[0].position.x, VERTEX_FLOATS);
+
+    auto getAttribute = [&](const char* name) {
+        IO::GltfAccessor accessor = document.getAccessor(attributes[name]);
+        if (accessor.count != vertices.size())
+            throw std::runtime_error(std::string("attribute ") + name + " and POSITION counts differ");
+        return accessor;
+    };
+
+    if (attributes.contains("NORMAL"))
+        IO::readFloats(getAttribute("NORMAL"), 3, &vertices[0].normal.x, VERTEX_FLOATS);
+
+    if (attributes.contains("TEXCOORD_0")) {
+        IO::readFloats(getAttribute("TEXCOORD_0"), 2, &vertices[0].textureCoordinates.x, VERTEX_FLOATS);
+        // glTF puts the origin of UVs at the top left, Assimp flips them to the
+        // bottom left unless asked to flip: match it so profiles behave alike.
+        if (!profile.flipUVs) {
+            for (Vertex& vertex : vertices)
+                vertex.textureCoordinates.y = 1.0f - vertex.textureCoordinates.y;
+        }
+    }
+
+    if (attributes.contains("TANGENT")) {
+        // xyz, then the handedness of the bitangent in w.
+        std::vector<float> tangents(vertices.size() * 4);
+        IO::readFloats(getAttribute("TANGENT"), 4, tangents.data(), 4);
+        for (size_t i = 0; i < vertices.size(); i++) {
+            const float* tangent = &tangents[i * 4];
+            vertices[i].tangent = glm::vec3(tangent[0], tangent[1], tangent[2]);
+            vertices[i].biTangent = glm::cross(vertices[i].normal, vertices[i].tangent) * tangent[3];
+        }
+    }
+
+    std::vector<unsigned int> indices;
+    if (primitive.contains("indices")) {
+        IO::GltfAccessor accessor = document.getAccessor(primitive["indices"]);
+        indices.resize(accessor.count);
+        IO::readIndices(accessor, indices.data());
+        if (!indices.empty() && *std::max_element(indices.begin(), indices.end()) >= vertices.size())
+            throw std::runtime_error("index out of the vertex range");
+    } else {
+        indices.resize(vertices.size());
+        std::iota(indices.begin(), indices.end(), 0u);
+    }
+    vertexCount += vertices.size();
+    indexCount += indices.size();
+
+    return Mesh(std::move(vertices), std::move(indices), std::move(textures), profile.residency);
+}
+
+/**
+ * @brief Texture of `image`, embedded in the document or next to it.
+ */
+static std::shared_ptr<GpuTexture> loadGltfImage(const IO::GltfDocument& document, size_t image,
+                                                 const std::string& path, const std::string& directory) {
+    std::span<const unsigned char> bytes = document.getImage(image);
+    if (!bytes.empty())
+        return GpuTexture::fromMemory(bytes, path + "#image" + std::to_string(image));
+
+    const json& source = document.getJson().at("images").at(image);
+    if (!source.contains("uri")) return nullptr;
+    return GpuTexture::fromFile(directory + '/' + source["uri"].get<std::string>());
+}
+
+void Model::loadGltf(const std::string& path, const ImportProfile& profile) {
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    try {
+        IO::GltfDocument document = IO::GltfDocument::load(path);
+        const json& gltf = document.getJson();
+        size_t slash = path.find_last_of("/\\");
+        m_directory = slash == std::string::npos ? "." : path.substr(0, slash);
+
+        // Materials are registered under the asset path so that common names
+        // such as "Material" do not replace those of other assets.
+        const json materialSources = gltf.value("materials", json::array());
+        std::vector<MaterialId> materials;
+        std::vector<std::vector<Texture>> materialTextures(materialSources.size());
+        std::vector<std::shared_ptr<GpuTexture>> images(gltf.value("images", json::array()).size());
+        const json textureSources = gltf.value("textures", json::array());
+        for (size_t i = 0; i < materialSources.size(); i++) {
+            const json& source = materialSources[i];
+            materials.push_back(registerGltfMaterial(source, path + '#' + source.value("name", std::to_string(i))));
+
+            const json pbr = source.value("pbrMetallicRoughness", json::object());
+            if (!pbr.contains("baseColorTexture")) continue;
+            const json& texture = textureSources.at(pbr["baseColorTexture"].at("index").get<size_t>());
+            if (!texture.contains("source")) continue;
+            size_t image = texture["source"];
+            if (!images.at(image)) images[image] = loadGltfImage(document, image, path, m_directory);
+            if (images[image])
+                materialTextures[i].push_back({images[image], TextureType::DIFFUSE, images[image]->getPath()});
+        }
+
+        // Each glTF mesh becomes one Renderable per triangle primitive.
+        const json meshSources = gltf.value("meshes", json::array());
+        std::vector<std::pair<uint32_t, uint32_t>> meshRanges;
+        meshRanges.reserve(meshSources.size());
+        for (const json& mesh : meshSources) {
+            uint32_t first = static_cast<uint32_t>(m_meshes.size());
+            for (const json& primitive : mesh.at("primitives")) {
+                if (primitive.value("mode", GLTF_MODE_TRIANGLES) != GLTF_MODE_TRIANGLES) {
+                    std::cout << "GLTF::WARNING::" << path << " skipped a primitive that is not a triangle list" << std::endl;
+                    continue;
+                }
+                int material = primitive.value("material", -1);
+                std::vector<Texture> textures = material >= 0 ? materialTextures.at(material) : std::vector<Texture>();
+                Mesh loaded = readGltfPrimitive(document, primitive, std::move(textures), profile,
+                                                vertexCount, indexCount);
+                if (material >= 0) loaded.setMaterial(materials.at(material));
+                m_meshes.push_back(std::move(loaded));
+            }
+            meshRanges.push_back({first, static_cast<uint32_t>(m_meshes.size())});
+        }
+
+        // A single root, as Assimp produces, above the scene's root nodes.
+        m_nodes.push_back({"root", -1, glm::mat4(1.0f), glm::mat4(1.0f)});
+        const json nodeSources = gltf.value("nodes", json::array());
+        std::vector<size_t> roots;
+        if (gltf.contains("scenes")) {
+            const json& scene = gltf["scenes"].at(gltf.value("scene", 0));
+            roots = scene.value("nodes", std::vector<size_t>());
+        } else {
+            std::vector<bool> isChild(nodeSources.size(), false);
+            for (const json& node : nodeSources) {
+                for (size_t child : node.value("children", std::vector<size_t>())) isChild.at(child) = true;
+            }
+            for (size_t i = 0; i < nodeSources.size(); i++) {
+                if (!isChild[i]) roots.push_back(i);
+            }
+        }
+
+        // Depth first, so nodes are stored parent first. Visited nodes are
+        // skipped, malformed files could otherwise loop forever.
+        std::vector<std::pair<size_t, int32_t>> pending;
+        for (auto root = roots.rbegin(); root != roots.rend(); ++root) pending.push_back({*root, 0});
+        std::vector<bool> visited(nodeSources.size(), false);
+        while (!pending.empty()) {
+            auto [index, parent] = pending.back();
+            pending.pop_back();
+            if (visited.at(index)) continue;
+            visited[index] = true;
+
+            const json& source = nodeSources[index];
+            ModelNode node;
+            node.name = source.value("name", std::string());
+            node.parent = parent;
+            node.localTransform = readNodeTransform(source);
+            Simd::mat4Mul(m_nodes[parent].globalTransform, node.localTransform, node.globalTransform);
+            int32_t nodeIndex = static_cast<int32_t>(m_nodes.size());
+            m_nodes.push_back(std::move(node));
+
+            if (source.contains("mesh")) {
+                auto [first, last] = meshRanges.at(source["mesh"].get<size_t>());
+                for (uint32_t mesh = first; mesh < last; mesh++)
+                    m_instances.push_back({mesh, static_cast<uint32_t>(nodeIndex)});
+            }
+            std::vector<size_t> children = source.value("children", std::vector<size_t>());
+            for (auto child = children.rbegin(); child != children.rend(); ++child)
+                pending.push_back({*child, nodeIndex});
+        }
+    } catch (const std::exception& e) {
+        std::cout << "ERROR::GLTF::" << path << "::" << e.what() << std::endl;
+        m_meshes.clear();
+        m_nodes.clear();
+        m_instances.clear();
+        return;
+    }
+
+    std::cout << "MODEL::IMPORT::" << path << " (native glTF)"
+              << " meshes: " << m_meshes.size()
+              << ", instances: " << m_instances.size()
+              << ", vertices: " << vertexCount
+              << ", indices: " << indexCount
+              << ", memory: " << (vertexCount * sizeof(Vertex) + indexCount * sizeof(unsigned int)) / 1024 << " KB"
+              << std::endl;
+
+    // Keep instances of the same mesh adjacent so consecutive draws share buffers.
+    std::stable_sort(m_instances.begin(), m_instances.end(),
+        [](const MeshInstance& a, const MeshInstance& b) { return a.mesh < b.mesh; });
+}
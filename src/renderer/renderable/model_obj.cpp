@@ -0,0 +1,105 @@
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+
+#include "model.hpp"
+#include "obj_parser.hpp"
+#include "material_registry.hpp"
+
+
+void Model::loadObj(const std::string& path, const ImportProfile& profile) {
+    IO::ObjGeometry geometry;
+    try {
+        geometry = IO::parseOBJ(path);
+    } catch (const std::exception& e) {
+        std::cout << "ERROR::OBJ::" << path << "::" << e.what() << std::endl;
+        return;
+    }
+    size_t slash = path.find_last_of("/\\");
+    m_directory = slash == std::string::npos ? "." : path.substr(0, slash);
+    m_residency = profile.residency;
+
+    // Materials are registered under the asset path, as glTF ones are, so
+    // that common names such as "Material" do not replace those of other assets.
+    MaterialRegistry& registry = MaterialRegistry::getInstance();
+    const std::string materialPrefix = path + '#';
+    for (const std::string& library : geometry.materialLibraries) {
+        try {
+            registry.loadLibrary(m_directory + '/' + library, materialPrefix);
+        } catch (const std::exception& e) {
+            std::cout << "MODEL::IMPORT::" << path << " skipped material library: " << e.what() << std::endl;
+        }
+    }
+
+    // OBJ puts the UV origin at the bottom left, as OpenGL does: flip like Assimp would.
+    if (profile.flipUVs) {
+        for (Vertex& vertex : geometry.vertices)
+            vertex.textureCoordinates.y = 1.0f - vertex.textureCoordinates.y;
+    }
+
+    // Shares one GpuTexture between every group using the same map.
+    auto loadTexture = [&](const std::string& file, TextureType type, std::vector<Texture>& textures) {
+        if (file.empty()) return;
+        for (const Texture& loaded : m_texturesLoaded) {
+            if (loaded.path == file) {
+                textures.push_back({loaded.texture, type, file});
+                return;
+            }
+        }
+        Texture texture{GpuTexture::fromFile(m_directory + '/' + file), type, file};
+        if (!texture.texture) return;
+        m_texturesLoaded.push_back(texture);
+        textures.push_back(std::move(texture));
+    };
+
+    m_nodes.push_back({"root", -1, glm::mat4(1.0f), glm::mat4(1.0f)});
+    const size_t vertexCount = geometry.vertices.size();
+    const size_t indexCount = geometry.indices.size();
+    // Vertex index within the current group's mesh, UINT32_MAX if not used yet.
+    std::vector<uint32_t> remap;
+    std::vector<uint32_t> used;
+    for (const IO::ObjGroup& group : geometry.groups) {
+        std::vector<Vertex> vertices;
+        std::vector<unsigned int> indices;
+        if (geometry.groups.size() == 1) {
+            vertices = std::move(geometry.vertices);
+            indices = std::move(geometry.indices);
+        } else {
+            // Each material gets its own mesh, holding only the vertices it uses.
+            remap.resize(vertexCount, UINT32_MAX);
+            indices.reserve(group.indexCount);
+            for (uint32_t i = group.firstIndex; i < group.firstIndex + group.indexCount; i++) {
+                uint32_t vertex = geometry.indices[i];
+                if (remap[vertex] == UINT32_MAX) {
+                    remap[vertex] = static_cast<uint32_t>(vertices.size());
+                    vertices.push_back(geometry.vertices[vertex]);
+                    used.push_back(vertex);
+                }
+                indices.push_back(remap[vertex]);
+            }
+            for (uint32_t vertex : used) remap[vertex] = UINT32_MAX;
+            used.clear();
+        }
+
+        MaterialId material = group.material.empty() ? INVALID_MATERIAL : registry.find(materialPrefix + group.material);
+        std::vector<Texture> textures;
+        if (material != INVALID_MATERIAL) {
+            Material source = registry.get(material);
+            loadTexture(source.getMap(MaterialMapType::DIFFUSE).path, TextureType::DIFFUSE, textures);
+            loadTexture(source.getMap(MaterialMapType::SPECULAR).path, TextureType::SPECULAR, textures);
+        }
+
+        Mesh mesh(std::move(vertices), std::move(indices), std::move(textures), m_residency);
+        if (material != INVALID_MATERIAL) mesh.setMaterial(material);
+        m_instances.push_back({static_cast<uint32_t>(m_meshes.size()), 0});
+        m_meshes.push_back(std::move(mesh));
+    }
+
+    std::cout << "MODEL::IMPORT::" << path << " (native OBJ)"
+              << " meshes: " << m_meshes.size()
+              << ", vertices: " << vertexCount
+              << ", indices: " << indexCount
+              << ", memory: " << (vertexCount * sizeof(Vertex) + indexCount * sizeof(unsigned int)) / 1024 << " KB"
+              << std::endl;
+}
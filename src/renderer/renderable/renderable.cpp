@@ -1,143 +1,179 @@
 #include <renderable.hpp>
 #include <iostream>
+#include <array>
+#include <algorithm>
 #include <glad/glad.h>
-#include "stb_image.h"
 #include <texture.hpp>
 #include <shader.hpp>
 #include "shader_engine.hpp"
+#include "memory_report.hpp"
+#include "gpu_budget.hpp"
+#include "gl_state.hpp"
+
+
+static constexpr unsigned int MAX_TEXTURES_PER_TYPE = 8;
+
+/**
+ * @brief "material.texture_<type><number>", built once instead of on every draw.
+ */
+static const char* getTextureUniformName(TextureType type, unsigned int number) {
+    static const auto names = [] {
+        std::array<std::array<std::string, MAX_TEXTURES_PER_TYPE>, 2> names;
+        for (int t = 0; t < 2; t++) {
+            for (unsigned int n = 0; n < MAX_TEXTURES_PER_TYPE; n++)
+                names[t][n] = "material." + toString(static_cast<TextureType>(t)) + std::to_string(n + 1);
+        }
+        return names;
+    }();
 
+    if (type < 0 || type > TextureType::SPECULAR || number == 0 || number > MAX_TEXTURES_PER_TYPE)
+        return nullptr;
+    return names[type][number - 1].c_str();
+}
 
-void Renderable::setup() {
-    glGenVertexArrays(1, &m_VAO);
-    glGenBuffers(1, &m_VBO);
-    glGenBuffers(1, &m_EBO);
-
-    if (m_VAO == 0 || m_VBO == 0 || m_EBO == 0) {
-        std::cerr << "Error: Failed to generate buffers!" << std::endl;
-        return;
-    }
-
-    glBindVertexArray(m_VAO);
+static ShaderFeatures getTextureFeature(TextureType type) {
+    return type == TextureType::DIFFUSE ? DIFFUSE_MAP : SPECULAR_MAP;
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-    glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(Vertex),
-                    &m_vertices[0], GL_STATIC_DRAW);
+void Renderable::setup() {
+    m_mesh = std::make_unique<GpuMesh>(m_vertices, m_indices);
+    for (const Texture& texture : m_textures)
+        m_features |= getTextureFeature(texture.type);
+    computeBounds();
+    applyResidency();
+    // Only a kept copy can bring the mesh back after the GpuBudget evicts it.
+    if (m_residency == GeometryResidency::KEEP) m_mesh->setSource(m_vertices, m_indices);
+}
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(unsigned int),
-                    &m_indices[0], GL_STATIC_DRAW);
+void Renderable::computeBounds() {
+    if (m_vertices.empty()) return;
 
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+    glm::vec3 min = m_vertices[0].position, max = min;
+    for (const Vertex& vertex : m_vertices) {
+        min = glm::min(min, vertex.position);
+        max = glm::max(max, vertex.position);
+    }
+    m_boundsCenter = (min + max) * 0.5f;
+    m_boundsRadius = 0.0f;
+    for (const Vertex& vertex : m_vertices)
+        m_boundsRadius = std::max(m_boundsRadius, glm::length(vertex.position - m_boundsCenter));
+}
 
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+size_t Renderable::getCpuBytes() const {
+    return m_vertices.size() * sizeof(Vertex) + m_indices.size() * sizeof(unsigned int);
+}
 
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, textureCoordinates));
+size_t Renderable::getCollisionBytes() const {
+    return m_collisionPositions.size() * sizeof(glm::vec3) + m_indices.size() * sizeof(unsigned int);
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+void Renderable::applyResidency() {
+    MemoryReport& report = MemoryReport::getInstance();
+    switch (m_residency) {
+        case GeometryResidency::KEEP:
+            report.add(MemorySubsystem::GEOMETRY_CPU, getCpuBytes());
+            break;
+        case GeometryResidency::COLLISION_ONLY:
+            m_collisionPositions.reserve(m_vertices.size());
+            for (const Vertex& vertex : m_vertices)
+                m_collisionPositions.push_back(vertex.position);
+            std::vector<Vertex>().swap(m_vertices);
+            report.add(MemorySubsystem::COLLISION_CPU, getCollisionBytes());
+            break;
+        case GeometryResidency::DISCARD_AFTER_UPLOAD:
+            // swap() rather than clear() so the capacity is released as well.
+            std::vector<Vertex>().swap(m_vertices);
+            std::vector<unsigned int>().swap(m_indices);
+            break;
+    }
 }
 
 void Renderable::destroy() {
-    if (m_VBO != 0) {
-        glDeleteBuffers(1, &m_VBO);
-        m_VBO = 0;
-    }
-    if (m_EBO != 0) {
-        glDeleteBuffers(1, &m_EBO);
-        m_EBO = 0;
-    }
-    if (m_VAO != 0) {
-        glDeleteVertexArrays(1, &m_VAO);
-        m_VAO = 0;
-    }
+    m_mesh.reset();
+
+    MemoryReport& report = MemoryReport::getInstance();
+    if (m_residency == GeometryResidency::KEEP)
+        report.remove(MemorySubsystem::GEOMETRY_CPU, getCpuBytes());
+    else if (m_residency == GeometryResidency::COLLISION_ONLY)
+        report.remove(MemorySubsystem::COLLISION_CPU, getCollisionBytes());
+    std::vector<Vertex>().swap(m_vertices);
+    std::vector<unsigned int>().swap(m_indices);
+    std::vector<glm::vec3>().swap(m_collisionPositions);
 }
 
 
-void Renderable::draw() {
-    if (!glIsVertexArray(m_VAO)) std::cerr << "No VAO bound." << std::endl;
-    if (!glIsBuffer(m_EBO)) std::cerr << "No EBO bound." << std::endl;
-    if (!glIsBuffer(m_VBO)) std::cerr << "No VBO bound." << std::endl;
+void Renderable::draw(ShaderEngine* engine) {
+    if (!engine) engine = m_engine.get();
+    if (!m_mesh || !engine) {
+        std::cerr << "Renderable drawn before setup." << std::endl;
+        return;
+    }
+#ifdef DEBUG
+    // glIs* queries can stall the driver, keep them out of release builds.
+    if (!glIsVertexArray(m_mesh->getVertexArray())) std::cerr << "No VAO bound." << std::endl;
+#endif
 
-    if (m_engine.size() <= 0) {
+    if (engine->size() <= 0) {
         // m_engine.addShader(Renderable::basicVertexShader);
         // m_engine.addShader(Renderable::basicFragmentShader);
     }
 
-    m_engine.use();
-    glBindVertexArray(m_VAO);
+    GpuBudget& budget = GpuBudget::getInstance();
+    GLState& state = GLState::getInstance();
+    budget.touch(m_mesh->getGpuResource());
+
+    engine->use();
     if (!m_textures.empty()) {
         unsigned int diffuseNumber = 1, specularNumber = 1;
         for (int i = 0; i < m_textures.size(); i++) {
-            glActiveTexture(GL_TEXTURE0 + i);
-            std::string number;
             TextureType type = m_textures[i].type;
+            unsigned int number = 0;
             switch (type) {
                 case TextureType::DIFFUSE:
-                    number = std::to_string(diffuseNumber++);
+                    number = diffuseNumber++;
                     break;
                 case TextureType::SPECULAR:
-                    number = std::to_string(specularNumber++);
+                    number = specularNumber++;
                     break;
             };
 
-            std::string typeStr = toString(type);
-            std::string textureUniformName = "material." + typeStr + number;
-            m_engine.setInt(textureUniformName.c_str(), i); // c_str() need to be called directly, otherwise pointer will be lose.
-            glBindTexture(GL_TEXTURE_2D, m_textures[i].id);
+            const char* textureUniformName = getTextureUniformName(type, number);
+            if (textureUniformName)
+                engine->setInt(textureUniformName, i);
+            // Touch before binding: restoring an evicted texture changes its name.
+            const GpuTexture& texture = *m_textures[i].texture;
+            budget.touch(texture.getGpuResource());
+            state.bindTextureUnit(i, texture.getId());
         }
     }
-    glActiveTexture(GL_TEXTURE0);
 
-    glBindVertexArray(m_VAO);
-    glDrawElements(GL_TRIANGLES, m_indices.size(), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    m_mesh->bind();
+    glDrawElements(GL_TRIANGLES, m_mesh->getIndexCount(), GL_UNSIGNED_INT, 0);
+}
+
+void Renderable::drawDepth(bool skinned) {
+    if (!m_mesh) return;
+
+    GpuBudget::getInstance().touch(m_mesh->getGpuResource());
+    if (skinned)
+        m_mesh->bind();
+    else
+        m_mesh->bindPositions();
+    glDrawElements(GL_TRIANGLES, m_mesh->getIndexCount(), GL_UNSIGNED_INT, 0);
 }
 
 
 void Renderable::setTexture(const char* path, TextureType type) {
-    std::string filename(path);
-
-    Texture texture;
-    texture.type = type;
-    texture.path = std::string(path);
-    glGenTextures(1, &texture.id);
-    if (texture.id == 0) {
-        std::cerr << "Error: Failed to generate texture ID!" << std::endl;
-        return;
-    }
+    setTexture(GpuTexture::fromFile(path), type, path);
+}
 
-    int width, height, nrComponents;
-    unsigned char *data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
-    if (data) {
-        GLenum format = GL_RGB;
-        if (nrComponents == 1)
-            format = GL_RED;
-        else if (nrComponents == 3)
-            format = GL_RGB;
-        else if (nrComponents == 4)
-            format = GL_RGBA;
-
-        glBindTexture(GL_TEXTURE_2D, texture.id);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glBindTexture(GL_TEXTURE_2D, 0);
-
-        stbi_image_free(data);
-
-        m_textures.push_back(texture);
-    } else {
+void Renderable::setTexture(std::shared_ptr<GpuTexture> texture, TextureType type, std::string path) {
+    if (!texture) {
         std::cerr << "Texture failed to load at path: " << path << std::endl;
-        stbi_image_free(data);
+        return;
     }
+    m_features |= getTextureFeature(type);
+    m_textures.push_back({std::move(texture), type, std::move(path)});
 }
 
 std::ostream& operator<<(std::ostream& os, const Renderable& renderable) {
@@ -157,7 +193,7 @@ std::ostream& operator<<(std::ostream& os, const Renderable& renderable) {
 
     os << "Textures:\n";
     for (const auto& texture : renderable.m_textures) {
-        os << "  ID: " << texture.id << ", Type: " << texture.type << ", Path: " << texture.path << "\n";
+        os << "  ID: " << texture.texture->getId() << ", Type: " << texture.type << ", Path: " << texture.path << "\n";
     }
     
     return os;
@@ -4,52 +4,101 @@
 
 #include <glad/glad.h>
 #include <vector>
+#include <span>
+#include <memory>
 #include "texture.hpp"
 #include "shader.hpp"
 #include "shader_engine.hpp"
+#include "residency.hpp"
+#include "vertex.hpp"
+#include "gpu_mesh.hpp"
+#include "material.hpp"
+#include "shader_features.hpp"
 
+class ShaderPermutations;
 
-#define MAX_BONE_INFLUENCE 4
-
-
-struct Vertex {
-    // position
-    glm::vec3 position;
-    // normal
-    glm::vec3 normal;
-    // texCoords
-    glm::vec2 textureCoordinates;
-    // tangent
-    glm::vec3 tangent;
-    // bitangent
-    glm::vec3 biTangent;
-    // bone indexes which will influence this vertex
-    int m_BoneIDs[MAX_BONE_INFLUENCE];
-    // weights from each bone
-    float m_Weights[MAX_BONE_INFLUENCE];
-};
 
 class Renderable {
 public:
-    Renderable() : m_VAO(0), m_VBO(0), m_EBO(0) {}
-    //TODO: handle object destruction implicitly
-    // The problem with ~Renderable is that return by copy could cause
-    // OpenGL to delete OpenGL context buffers
+    Renderable() = default;
+    // GPU objects are owned through move-only handles, so a Renderable can be
+    // moved but never copied.
+    Renderable(Renderable&&) = default;
+    Renderable& operator=(Renderable&&) = default;
+    Renderable(const Renderable&) = delete;
+    Renderable& operator=(const Renderable&) = delete;
+    ~Renderable() { destroy(); }
+
     void destroy();
-    void draw();
+    /**
+     * @brief Draw with `engine`, or with the renderable's own engine if null.
+     */
+    void draw(ShaderEngine* engine = nullptr);
+    /**
+     * @brief Draw positions only, with whatever depth program is in use.
+     * @param skinned Read bone attributes too, from the full vertex stream.
+     */
+    void drawDepth(bool skinned = false);
+    /**
+     * @brief Upload vertices and indices, then apply the residency policy to
+     * the CPU copy.
+     */
     void setup();
-    std::vector<Vertex> getVertices() { return m_vertices; }
-    std::vector<unsigned int> getIndices() { return m_indices; }
+    // Empty unless the residency policy keeps the data.
+    std::span<const Vertex> getVertices() const { return m_vertices; }
+    std::span<const unsigned int> getIndices() const { return m_indices; }
+    std::span<const glm::vec3> getCollisionPositions() const { return m_collisionPositions; }
+    GLsizei getIndexCount() const { return m_mesh ? m_mesh->getIndexCount() : 0; }
+    GLuint getVertexArray() const { return m_mesh ? m_mesh->getVertexArray() : 0; }
+    // Local-space bounding sphere, computed by setup().
+    const glm::vec3& getBoundsCenter() const { return m_boundsCenter; }
+    float getBoundsRadius() const { return m_boundsRadius; }
+    // Whether vertices carry bone weights.
+    bool isSkinned() const { return m_skinned; }
+
+    void setResidency(GeometryResidency residency) { m_residency = residency; }
+    GeometryResidency getResidency() const { return m_residency; }
     void setTexture(const char* path, TextureType type);
-    void setShaderEngine(ShaderEngine engine) { m_engine = engine; }
+    /**
+     * @brief Add a texture already uploaded, e.g. by AsyncAssets::loadTexture().
+     * Ignored if null.
+     */
+    void setTexture(std::shared_ptr<GpuTexture> texture, TextureType type, std::string path);
+    void setShaderEngine(std::shared_ptr<ShaderEngine> engine) { m_engine = std::move(engine); }
+    ShaderEngine* getShaderEngine() const { return m_engine.get(); }
+    /**
+     * @brief Draw with the variant of `permutations` matching the
+     * renderable's features instead of a fixed engine.
+     */
+    void setShaderPermutations(std::shared_ptr<ShaderPermutations> permutations) { m_permutations = std::move(permutations); }
+    ShaderPermutations* getShaderPermutations() const { return m_permutations.get(); }
+    // DIFFUSE_MAP and SPECULAR_MAP for the texture types it has.
+    ShaderFeatures getShaderFeatures() const { return m_features; }
+    void setMaterial(MaterialId material) { m_material = material; }
+    // DEFAULT_MATERIAL if no material was set.
+    MaterialId getMaterial() const { return m_material; }
 
     friend std::ostream& operator<<(std::ostream& os, const Renderable& renderable);
 protected:
-    GLuint m_VAO, m_VBO, m_EBO;
-    ShaderEngine m_engine;
+    std::unique_ptr<GpuMesh> m_mesh;
+    std::shared_ptr<ShaderEngine> m_engine;
+    std::shared_ptr<ShaderPermutations> m_permutations;
+    ShaderFeatures m_features{0};
+    bool m_skinned{false};
+    MaterialId m_material{DEFAULT_MATERIAL};
     std::vector<Vertex> m_vertices;
     std::vector<unsigned int> m_indices;
     std::vector<Texture> m_textures;
+    std::vector<glm::vec3> m_collisionPositions;
+    GeometryResidency m_residency{GeometryResidency::KEEP};
+    glm::vec3 m_boundsCenter{0.0f};
+    float m_boundsRadius{0.0f};
+
+private:
+    size_t getCpuBytes() const;
+    size_t getCollisionBytes() const;
+    void computeBounds();
+    void applyResidency();
 };
 
 #endif
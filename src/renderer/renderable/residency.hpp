@@ -0,0 +1,27 @@
+#ifndef RESIDENCY_H_
+#define RESIDENCY_H_
+
+#include <string>
+#include <stdexcept>
+
+/**
+ * @brief What happens to a mesh's CPU-side geometry once it is on the GPU.
+ */
+enum class GeometryResidency {
+    // Keep vertices and indices.
+    KEEP,
+    // Free everything, only the GPU copy remains, so it is never evicted.
+    DISCARD_AFTER_UPLOAD,
+    // Keep positions and indices only, enough for collision queries. The
+    // GPU copy is never evicted.
+    COLLISION_ONLY
+};
+
+inline GeometryResidency residencyFromString(const std::string& str) {
+    if (str == "keep") return GeometryResidency::KEEP;
+    if (str == "discard") return GeometryResidency::DISCARD_AFTER_UPLOAD;
+    if (str == "collision") return GeometryResidency::COLLISION_ONLY;
+    throw std::invalid_argument("Invalid geometry residency: " + str);
+}
+
+#endif
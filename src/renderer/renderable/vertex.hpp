@@ -0,0 +1,27 @@
+#ifndef VERTEX_H_
+#define VERTEX_H_
+
+#include <glm/glm.hpp>
+
+
+#define MAX_BONE_INFLUENCE 4
+
+
+struct Vertex {
+    // position
+    glm::vec3 position;
+    // normal
+    glm::vec3 normal;
+    // texCoords
+    glm::vec2 textureCoordinates;
+    // tangent
+    glm::vec3 tangent;
+    // bitangent
+    glm::vec3 biTangent;
+    // bone indexes which will influence this vertex
+    int m_BoneIDs[MAX_BONE_INFLUENCE];
+    // weights from each bone
+    float m_Weights[MAX_BONE_INFLUENCE];
+};
+
+#endif
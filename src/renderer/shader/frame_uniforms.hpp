@@ -0,0 +1,18 @@
+#ifndef FRAME_UNIFORMS_H_
+#define FRAME_UNIFORMS_H_
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Uniform block binding shared by every shader declaring FrameUniforms.
+constexpr GLuint FRAME_UNIFORMS_BINDING = 0;
+
+/**
+ * @brief Per-frame camera data, laid out as the std140 FrameUniforms block.
+ */
+struct FrameUniforms {
+    glm::mat4 view;
+    glm::mat4 projection;
+};
+
+#endif
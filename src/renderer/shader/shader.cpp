@@ -1,6 +1,6 @@
 #include "shader.hpp"
-#include <fstream>
-#include <sstream>
+#include "shader_preprocessor.hpp"
+#include "config_manager.hpp"
 #include <iostream>
 #include <glad/glad.h>
 #include <string>
@@ -9,17 +9,17 @@
 Shader ShaderFactory::createShader(const std::string& filePath, unsigned int shaderType) {
     Shader shader;
     shader.id = glCreateShader(shaderType);
+    shader.source = readSource(filePath);
+    return shader;
+}
 
-    // Read the shader file
-    std::ifstream fileStream(filePath);
-    if (!fileStream.is_open()) {
-        std::cerr << "Failed to open shader file: " << filePath << std::endl;
-        return shader;
+std::string ShaderFactory::readSource(const std::string& filePath) {
+    // Cooked shaders already have their includes expanded.
+    std::string cooked = ConfigurationManager::getInstance()->getCookedPath(filePath);
+    try {
+        return ShaderPreprocessor::expandIncludes(cooked.empty() ? filePath : cooked);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to read shader file: " << filePath << ": " << e.what() << std::endl;
+        return {};
     }
-
-    std::stringstream shaderStream;
-    shaderStream << fileStream.rdbuf();
-    shader.source = shaderStream.str();
-
-    return shader;
 }
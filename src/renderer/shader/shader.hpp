@@ -15,6 +15,8 @@ struct Shader {
 class ShaderFactory {
     public:
         static Shader createShader(const std::string& filePath, unsigned int shaderType);
+        // With its includes expanded, empty if a file cannot be read.
+        static std::string readSource(const std::string& filePath);
 };
 
 #endif
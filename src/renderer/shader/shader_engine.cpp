@@ -1,5 +1,32 @@
 #include <shader_engine.hpp>
 #include <iostream>
+#include <cstring>
+#include <gl_state.hpp>
+
+// KHR_parallel_shader_compile, not part of the 4.6 core headers.
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+
+/**
+ * @brief Whether the driver compiles on its own threads and can be polled
+ * for completion. Queried once, from the GL thread.
+ */
+static bool hasParallelShaderCompile() {
+    static const bool supported = [] {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; i++) {
+            const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+            if (name && (std::strcmp(name, "GL_KHR_parallel_shader_compile") == 0
+                      || std::strcmp(name, "GL_ARB_parallel_shader_compile") == 0))
+                return true;
+        }
+        return false;
+    }();
+    return supported;
+}
 
 
 void ShaderEngine::addShader(Shader& shader) {
@@ -19,19 +46,20 @@ void ShaderEngine::addShader(Shader& shader) {
 }
 
 void ShaderEngine::compile() {
-    m_shaderProgramID = glCreateProgram();
+    m_program = GL::createProgram();
+    GLuint program = m_program.get();
 
     for (Shader shader : m_shaders) {
-        glAttachShader(m_shaderProgramID, shader.id);
+        glAttachShader(program, shader.id);
     }
 
-    glLinkProgram(m_shaderProgramID);
+    glLinkProgram(program);
 
     int success;
     char infoLog[512];
-    glGetProgramiv(m_shaderProgramID, GL_LINK_STATUS, &success);
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
     if (!success) {
-        glGetProgramInfoLog(m_shaderProgramID, 512, NULL, infoLog);
+        glGetProgramInfoLog(program, 512, NULL, infoLog);
         std::cerr << "Failed to link shader program: " << infoLog << std::endl;
     }
 
@@ -42,6 +70,57 @@ void ShaderEngine::compile() {
     m_shaders.clear();
 }
 
+void ShaderEngine::compileAsync(const std::string& vertexSource, const std::string& fragmentSource) {
+    m_program = GL::createProgram();
+    GLuint program = m_program.get();
+
+    // No status query until finishCompile(): any of them would wait for the driver.
+    for (auto [source, type] : {std::pair{&vertexSource, GL_VERTEX_SHADER}, std::pair{&fragmentSource, GL_FRAGMENT_SHADER}}) {
+        Shader shader;
+        shader.id = glCreateShader(type);
+        shader.source = *source;
+        const char* sourceCstr = shader.source.c_str();
+        glShaderSource(shader.id, 1, &sourceCstr, NULL);
+        glCompileShader(shader.id);
+        glAttachShader(program, shader.id);
+        m_shaders.push_back(std::move(shader));
+    }
+    glLinkProgram(program);
+}
+
+bool ShaderEngine::isCompileComplete() const {
+    if (!hasParallelShaderCompile()) return true;
+
+    int complete = GL_TRUE;
+    glGetProgramiv(m_program.get(), GL_COMPLETION_STATUS_KHR, &complete);
+    return complete == GL_TRUE;
+}
+
+bool ShaderEngine::finishCompile() {
+    int success;
+    char infoLog[512];
+    glGetProgramiv(m_program.get(), GL_LINK_STATUS, &success);
+    if (!success) {
+        for (const Shader& shader : m_shaders) {
+            int compiled;
+            glGetShaderiv(shader.id, GL_COMPILE_STATUS, &compiled);
+            if (!compiled) {
+                glGetShaderInfoLog(shader.id, 512, NULL, infoLog);
+                std::cerr << "Failed to compile shader: " << infoLog << std::endl;
+            }
+        }
+        glGetProgramInfoLog(m_program.get(), 512, NULL, infoLog);
+        std::cerr << "Failed to link shader program: " << infoLog << std::endl;
+    }
+
+    for (const Shader& shader : m_shaders) {
+        glDeleteShader(shader.id);
+    }
+
+    m_shaders.clear();
+    return success;
+}
+
 void ShaderEngine::use() {
-    glUseProgram(m_shaderProgramID);
+    GLState::getInstance().useProgram(m_program.get());
 }
@@ -2,38 +2,67 @@
 #define SHADER_ENGINE_HPP_
 
 #include <vector>
+#include <memory>
 #include <shader.hpp>
+#include <gl_handle.hpp>
 
+/**
+ * Owns its program object: engines are move-only and shared between
+ * renderables through std::shared_ptr.
+ */
 class ShaderEngine {
     private:
         std::vector<Shader> m_shaders;
-        unsigned int m_shaderProgramID;
+        ProgramHandle m_program;
     public:
         void addShader(Shader& shader);
         void compile();
+        /**
+         * @brief Compile and link `vertexSource` and `fragmentSource` without
+         * waiting for the driver. finishCompile() collects the result.
+         */
+        void compileAsync(const std::string& vertexSource, const std::string& fragmentSource);
+        /**
+         * @brief Whether compileAsync() is done. Always true when the driver
+         * does not compile in parallel, finishCompile() then blocks instead.
+         */
+        bool isCompileComplete() const;
+        /**
+         * @brief Report errors of compileAsync() and release its shaders.
+         * @return false if compiling or linking failed.
+         */
+        bool finishCompile();
 
-        unsigned int getShaderProgramID() { return m_shaderProgramID; };
+        GLuint getShaderProgramID() const { return m_program.get(); };
         void use();
-        void setInt(const std::string& name, int value) { 
-            glUniform1i(glGetUniformLocation(m_shaderProgramID, name.c_str()), value); 
+        // Names are taken as C strings so that string literals do not build
+        // a temporary std::string on every call.
+        void setInt(const char* name, int value) {
+            glUniform1i(glGetUniformLocation(m_program.get(), name), value);
         };
-        void setVec3(const std::string& name, float x, float y, float z) {
-            glUniform3f(glGetUniformLocation(m_shaderProgramID, name.c_str()),
+        void setVec3(const char* name, float x, float y, float z) {
+            glUniform3f(glGetUniformLocation(m_program.get(), name),
                         x, y, z);
         };
-        void setVec3(const std::string& name, glm::vec3 value) {
+        void setVec3(const char* name, glm::vec3 value) {
             ShaderEngine::setVec3(name, value.x, value.y, value.z);
         }
-        void setMat4(const std::string& name, glm::mat4 mat) {
-            glUniformMatrix4fv(glGetUniformLocation(m_shaderProgramID, name.c_str()),
+        void setMat4(const char* name, const glm::mat4& mat) {
+            glUniformMatrix4fv(glGetUniformLocation(m_program.get(), name),
                 1, GL_FALSE, glm::value_ptr(mat));
         }
 
-        void setFloat(const std::string& name, float value) {
-            glUniform1f(glGetUniformLocation(m_shaderProgramID, name.c_str()),
+        void setFloat(const char* name, float value) {
+            glUniform1f(glGetUniformLocation(m_program.get(), name),
                 value);
         }
 
+        void setInt(const std::string& name, int value) { setInt(name.c_str(), value); }
+        void setVec3(const std::string& name, float x, float y, float z) { setVec3(name.c_str(), x, y, z); }
+        void setVec3(const std::string& name, glm::vec3 value) { setVec3(name.c_str(), value); }
+        void setMat4(const std::string& name, const glm::mat4& mat) { setMat4(name.c_str(), mat); }
+        void setFloat(const std::string& name, float value) { setFloat(name.c_str(), value); }
+
         int size() {
             return m_shaders.size();
         }
@@ -42,13 +71,13 @@ class ShaderEngine {
 
 class ShaderEngineFactory {
 public:
-    static ShaderEngine createEngine(const std::string& vertex, const std::string& fragment) {
-        ShaderEngine engine;
+    static std::shared_ptr<ShaderEngine> createEngine(const std::string& vertex, const std::string& fragment) {
+        auto engine = std::make_shared<ShaderEngine>();
         Shader vertexShader = ShaderFactory::createShader(vertex, GL_VERTEX_SHADER);
         Shader fragmentShader = ShaderFactory::createShader(fragment, GL_FRAGMENT_SHADER);
-        engine.addShader(vertexShader);
-        engine.addShader(fragmentShader);
-        engine.compile();
+        engine->addShader(vertexShader);
+        engine->addShader(fragmentShader);
+        engine->compile();
         return engine;
     }
 };
@@ -0,0 +1,66 @@
+#include <shader_features.hpp>
+#include <bit>
+
+
+const char* getShaderFeatureName(ShaderFeatures feature) {
+    switch (feature) {
+        case DIFFUSE_MAP: return "DIFFUSE_MAP";
+        case SPECULAR_MAP: return "SPECULAR_MAP";
+        case SHADOWS: return "SHADOWS";
+        case SKINNING: return "SKINNING";
+        case POINT_LIGHTS: return "POINT_LIGHTS";
+        case DIRECTIONAL_LIGHT: return "DIRECTIONAL_LIGHT";
+        case SPOTLIGHT: return "SPOTLIGHT";
+        default: return nullptr;
+    }
+}
+
+std::string injectDefines(std::string_view source, ShaderFeatures features,
+                          std::span<const ShaderConstant> constants) {
+    // #version must stay the first statement, so the defines go after it.
+    size_t insertAt = 0;
+    size_t nextLine = 1;
+    size_t version = source.find("#version");
+    if (version != std::string_view::npos) {
+        size_t end = source.find('\n', version);
+        insertAt = end == std::string_view::npos ? source.size() : end + 1;
+        for (size_t i = 0; i < insertAt; i++)
+            if (source[i] == '\n') nextLine++;
+    }
+
+    // A #version without a newline would otherwise swallow the first define.
+    bool addNewline = insertAt > 0 && source[insertAt - 1] != '\n';
+    if (addNewline) nextLine++;
+
+    std::string defines;
+    for (uint32_t bit = 0; bit < SHADER_FEATURE_COUNT; bit++) {
+        if (features & (1u << bit)) {
+            defines += "#define ";
+            defines += getShaderFeatureName(1u << bit);
+            defines += '\n';
+        }
+    }
+    for (const ShaderConstant& constant : constants)
+        defines += "#define " + constant.name + " " + constant.value + "\n";
+
+    std::string result;
+    result.reserve(source.size() + defines.size() + 16);
+    result.append(source.substr(0, insertAt));
+    if (addNewline) result += '\n';
+    result += defines;
+    result += "#line " + std::to_string(nextLine) + "\n";
+    result.append(source.substr(insertAt));
+    return result;
+}
+
+std::optional<ShaderFeatures> findFallbackVariant(std::span<const ShaderFeatures> available,
+                                                  ShaderFeatures requested) {
+    std::optional<ShaderFeatures> best;
+    for (ShaderFeatures features : available) {
+        if ((features & ~requested) != 0) continue;
+        if (!best || std::popcount(features) > std::popcount(*best)
+                  || (std::popcount(features) == std::popcount(*best) && features < *best))
+            best = features;
+    }
+    return best;
+}
@@ -0,0 +1,57 @@
+#ifndef SHADER_FEATURES_H_
+#define SHADER_FEATURES_H_
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+using ShaderFeatures = uint32_t;
+
+/**
+ * @brief Optional parts of a shader, each compiled in by a #define of the
+ * same name rather than branched on at runtime.
+ */
+enum ShaderFeature : ShaderFeatures {
+    DIFFUSE_MAP = 1 << 0,
+    SPECULAR_MAP = 1 << 1,
+    SHADOWS = 1 << 2,
+    SKINNING = 1 << 3,
+    POINT_LIGHTS = 1 << 4,
+    DIRECTIONAL_LIGHT = 1 << 5,
+    SPOTLIGHT = 1 << 6,
+};
+constexpr uint32_t SHADER_FEATURE_COUNT = 7;
+constexpr ShaderFeatures ALL_SHADER_FEATURES = (1u << SHADER_FEATURE_COUNT) - 1;
+
+/**
+ * @brief #define name of a single feature bit, nullptr if unknown.
+ */
+const char* getShaderFeatureName(ShaderFeatures feature);
+
+/**
+ * @brief "#define NAME VALUE" added to every variant of a shader.
+ */
+struct ShaderConstant {
+    std::string name;
+    std::string value;
+};
+
+/**
+ * @brief `source` with a #define for every feature of `features` and every
+ * constant, inserted right after its #version line. A #line directive follows
+ * them so that compile errors still point at lines of the file.
+ */
+std::string injectDefines(std::string_view source, ShaderFeatures features,
+                          std::span<const ShaderConstant> constants = {});
+
+/**
+ * @brief Variant of `available` to draw with while `requested` is not
+ * compiled: the one with the most requested features and none that was not
+ * requested, the smaller mask on ties. nullopt if none qualifies.
+ */
+std::optional<ShaderFeatures> findFallbackVariant(std::span<const ShaderFeatures> available,
+                                                  ShaderFeatures requested);
+
+#endif
@@ -0,0 +1,87 @@
+#include <shader_permutations.hpp>
+#include <shader_engine.hpp>
+#include <algorithm>
+#include <iostream>
+
+
+// Every live instance, drained by updateAll(). GL thread only.
+static std::vector<ShaderPermutations*>& getInstances() {
+    static std::vector<ShaderPermutations*> instances;
+    return instances;
+}
+
+ShaderPermutations::ShaderPermutations(const std::string& vertexPath, const std::string& fragmentPath,
+                                       ShaderFeatures supported, std::vector<ShaderConstant> constants)
+    : m_vertexSource(ShaderFactory::readSource(vertexPath)),
+      m_fragmentSource(ShaderFactory::readSource(fragmentPath)),
+      m_supported(supported),
+      m_constants(std::move(constants)) {
+    static uint32_t nextId = 0;
+    m_id = nextId++;
+    getInstances().push_back(this);
+
+    Variant& base = m_variants[0];
+    start(0, base);
+    finish(0, base);
+}
+
+ShaderPermutations::~ShaderPermutations() {
+    std::vector<ShaderPermutations*>& instances = getInstances();
+    instances.erase(std::remove(instances.begin(), instances.end(), this), instances.end());
+}
+
+ShaderEngine* ShaderPermutations::get(ShaderFeatures features) {
+    features &= m_supported;
+    auto [it, inserted] = m_variants.try_emplace(features);
+    if (inserted) m_queue.push_back(features);
+    if (it->second.state == VariantState::READY) return it->second.engine.get();
+
+    // Failed variants keep falling back, queued ones until they are linked.
+    std::optional<ShaderFeatures> fallback = findFallbackVariant(m_ready, features);
+    return fallback ? m_variants[*fallback].engine.get() : nullptr;
+}
+
+void ShaderPermutations::updateAll(uint32_t maxStarts) {
+    for (ShaderPermutations* permutations : getInstances())
+        permutations->update(maxStarts);
+}
+
+void ShaderPermutations::update(uint32_t maxStarts) {
+    // Variants started last frame had a whole frame to compile in the background.
+    std::erase_if(m_compiling, [this](ShaderFeatures features) {
+        Variant& variant = m_variants[features];
+        if (!variant.engine->isCompileComplete()) return false;
+        finish(features, variant);
+        return true;
+    });
+
+    size_t count = std::min<size_t>(maxStarts, m_queue.size());
+    for (size_t i = 0; i < count; i++) {
+        start(m_queue[i], m_variants[m_queue[i]]);
+        m_compiling.push_back(m_queue[i]);
+    }
+    m_queue.erase(m_queue.begin(), m_queue.begin() + count);
+}
+
+uint32_t ShaderPermutations::getSortId(ShaderFeatures features) const {
+    return (m_id << SHADER_FEATURE_COUNT) | (features & m_supported);
+}
+
+void ShaderPermutations::start(ShaderFeatures features, Variant& variant) {
+    variant.engine = std::make_unique<ShaderEngine>();
+    variant.engine->compileAsync(injectDefines(m_vertexSource, features, m_constants),
+                                 injectDefines(m_fragmentSource, features, m_constants));
+    variant.state = VariantState::COMPILING;
+}
+
+void ShaderPermutations::finish(ShaderFeatures features, Variant& variant) {
+    if (!variant.engine->finishCompile()) {
+        std::cerr << "ERROR::SHADER_PERMUTATIONS::Variant 0x" << std::hex << features << std::dec
+                  << " failed to compile." << std::endl;
+        variant.engine.reset();
+        variant.state = VariantState::FAILED;
+        return;
+    }
+    variant.state = VariantState::READY;
+    m_ready.push_back(features);
+}
@@ -0,0 +1,91 @@
+#ifndef SHADER_PERMUTATIONS_H_
+#define SHADER_PERMUTATIONS_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <shader_features.hpp>
+
+class ShaderEngine;
+
+/**
+ * @class ShaderPermutations
+ * @brief Specialized variants of one vertex/fragment source pair, one per
+ * combination of features, so that each draw runs only the code it needs
+ * instead of branching on uniforms.
+ *
+ * Variants are compiled the first time they are asked for and cached by
+ * feature mask. Compiling goes through a queue drained a few variants per
+ * frame by updateAll(), without waiting on the driver: until a variant is
+ * linked, get() returns the closest one already available. The variant
+ * without features is compiled up front so that there always is one.
+ *
+ * GL thread only.
+ */
+class ShaderPermutations {
+public:
+    /**
+     * @param supported Features the sources react to, others are ignored.
+     * @param constants Defined in every variant.
+     */
+    ShaderPermutations(const std::string& vertexPath, const std::string& fragmentPath,
+                       ShaderFeatures supported, std::vector<ShaderConstant> constants = {});
+    ~ShaderPermutations();
+    ShaderPermutations(const ShaderPermutations&) = delete;
+    ShaderPermutations& operator=(const ShaderPermutations&) = delete;
+
+    /**
+     * @brief Variant for the supported subset of `features`, queued for
+     * compilation if never requested before. nullptr only if even the
+     * featureless variant failed to compile.
+     */
+    ShaderEngine* get(ShaderFeatures features);
+
+    /**
+     * @brief Collect finished variants and start compiling up to
+     * `maxStarts` queued ones, for every live ShaderPermutations.
+     */
+    static void updateAll(uint32_t maxStarts = 2);
+
+    /**
+     * @brief Stand-in for a program name in draw sort keys, grouping the
+     * draws of each variant.
+     */
+    uint32_t getSortId(ShaderFeatures features) const;
+    ShaderFeatures getSupported() const { return m_supported; }
+    size_t getReadyCount() const { return m_ready.size(); }
+    size_t getPendingCount() const { return m_queue.size() + m_compiling.size(); }
+
+private:
+    enum class VariantState {
+        QUEUED,
+        COMPILING,
+        READY,
+        FAILED
+    };
+
+    struct Variant {
+        std::unique_ptr<ShaderEngine> engine;
+        VariantState state = VariantState::QUEUED;
+    };
+
+    std::string m_vertexSource;
+    std::string m_fragmentSource;
+    ShaderFeatures m_supported;
+    std::vector<ShaderConstant> m_constants;
+    uint32_t m_id;
+
+    std::unordered_map<ShaderFeatures, Variant> m_variants;
+    // Oldest request first.
+    std::vector<ShaderFeatures> m_queue;
+    std::vector<ShaderFeatures> m_compiling;
+    std::vector<ShaderFeatures> m_ready;
+
+    void update(uint32_t maxStarts);
+    void start(ShaderFeatures features, Variant& variant);
+    void finish(ShaderFeatures features, Variant& variant);
+};
+
+#endif
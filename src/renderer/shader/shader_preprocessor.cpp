@@ -0,0 +1,80 @@
+#include <stdexcept>
+#include <algorithm>
+
+#include "shader_preprocessor.hpp"
+#include "asset_path.hpp"
+#include "virtual_file_system.hpp"
+
+namespace {
+
+// File named by an `#include "file"` line, empty if `line` is not one.
+std::string_view getIncludedFile(std::string_view line) {
+    size_t begin = line.find_first_not_of(" \t");
+    if (begin == std::string_view::npos || line[begin] != '#') return {};
+    begin = line.find_first_not_of(" \t", begin + 1);
+    if (begin == std::string_view::npos || line.substr(begin, 7) != "include") return {};
+    size_t open = line.find('"', begin + 7);
+    size_t close = open == std::string_view::npos ? open : line.find('"', open + 1);
+    if (close == std::string_view::npos) return {};
+    return line.substr(open + 1, close - open - 1);
+}
+
+void expand(const std::string& path, std::vector<std::string>& stack, std::vector<std::string>* includes,
+            std::string& out) {
+    std::string normalized = AssetPath::normalize(path);
+    if (std::find(stack.begin(), stack.end(), normalized) != stack.end())
+        throw std::runtime_error("Shader includes itself: " + path);
+    std::string source = VirtualFileSystem::getInstance().readText(path);
+    stack.push_back(normalized);
+
+    std::string_view rest = source;
+    while (!rest.empty()) {
+        size_t end = rest.find('\n');
+        std::string_view line = rest.substr(0, end == std::string_view::npos ? rest.size() : end + 1);
+        rest.remove_prefix(line.size());
+
+        std::string_view file = getIncludedFile(line);
+        if (file.empty()) {
+            out += line;
+            continue;
+        }
+        std::string included = AssetPath::getDirectory(path) + '/' + std::string(file);
+        if (includes) includes->push_back(included);
+        expand(included, stack, includes, out);
+        if (!out.empty() && out.back() != '\n') out += '\n';
+    }
+    stack.pop_back();
+}
+
+}
+
+namespace ShaderPreprocessor {
+
+std::string expandIncludes(const std::string& path, std::vector<std::string>* includes) {
+    std::string out;
+    std::vector<std::string> stack;
+    expand(path, stack, includes, out);
+    return out;
+}
+
+std::string stripComments(std::string_view source) {
+    std::string out;
+    out.reserve(source.size());
+    for (size_t i = 0; i < source.size(); i++) {
+        if (source.compare(i, 2, "//") == 0) {
+            while (i < source.size() && source[i] != '\n') i++;
+            if (i < source.size()) out += '\n';
+        } else if (source.compare(i, 2, "/*") == 0) {
+            size_t end = source.find("*/", i + 2);
+            end = end == std::string_view::npos ? source.size() : end + 2;
+            out += ' ';
+            out.append(std::count(source.begin() + i, source.begin() + end, '\n'), '\n');
+            i = end - 1;
+        } else {
+            out += source[i];
+        }
+    }
+    return out;
+}
+
+}
@@ -0,0 +1,30 @@
+#ifndef SHADER_PREPROCESSOR_H_
+#define SHADER_PREPROCESSOR_H_
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Source-level steps applied to GLSL files before they reach the
+ * driver, which knows nothing about files.
+ */
+namespace ShaderPreprocessor {
+
+    /**
+     * @brief Source of the shader at `path` with each `#include "file"` line
+     * replaced by that file, read relative to the including file.
+     * @param includes If not null, receives every file included, directly or
+     * not, as opened.
+     * @throws std::runtime_error if a file cannot be read or includes itself.
+     */
+    std::string expandIncludes(const std::string& path, std::vector<std::string>* includes = nullptr);
+
+    /**
+     * @brief `source` without its comments. Line breaks are kept so that
+     * compiler messages still point at the right line.
+     */
+    std::string stripComments(std::string_view source);
+}
+
+#endif
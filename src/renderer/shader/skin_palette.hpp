@@ -0,0 +1,12 @@
+#ifndef SKIN_PALETTE_H_
+#define SKIN_PALETTE_H_
+
+#include <glad/glad.h>
+#include <cstdint>
+
+// Shader storage binding of the SkinPalettes block, see Animator.
+constexpr GLuint SKIN_PALETTE_BINDING = 5;
+// Palette offset of draws that are not skinned.
+constexpr uint32_t NO_SKIN_PALETTE = UINT32_MAX;
+
+#endif
@@ -0,0 +1,79 @@
+#include <shadow_atlas_allocator.hpp>
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+
+ShadowAtlasAllocator::ShadowAtlasAllocator(uint32_t atlasSize, uint32_t minTileSize)
+    : m_atlasSize(atlasSize), m_minTileSize(minTileSize) {
+    if (!std::has_single_bit(atlasSize) || !std::has_single_bit(minTileSize) || minTileSize > atlasSize)
+        throw std::invalid_argument("Shadow atlas and tile sizes must be powers of two.");
+
+    m_free.resize(std::countr_zero(atlasSize) - std::countr_zero(minTileSize) + 1);
+    m_free[0].push_back({0, 0, atlasSize});
+}
+
+uint32_t ShadowAtlasAllocator::getLevel(uint32_t size) const {
+    return std::countr_zero(m_atlasSize) - std::countr_zero(size);
+}
+
+bool ShadowAtlasAllocator::allocateLevel(uint32_t level) {
+    if (!m_free[level].empty()) return true;
+    if (level == 0 || !allocateLevel(level - 1)) return false;
+
+    ShadowTile parent = m_free[level - 1].back();
+    m_free[level - 1].pop_back();
+    uint32_t half = parent.size / 2;
+    // Pushed in reverse so that the top-left quarter is handed out first.
+    m_free[level].push_back({parent.x + half, parent.y + half, half});
+    m_free[level].push_back({parent.x, parent.y + half, half});
+    m_free[level].push_back({parent.x + half, parent.y, half});
+    m_free[level].push_back({parent.x, parent.y, half});
+    return true;
+}
+
+std::optional<ShadowTile> ShadowAtlasAllocator::allocate(uint32_t size) {
+    size = std::bit_ceil(std::max(size, m_minTileSize));
+    if (size > m_atlasSize) return std::nullopt;
+
+    uint32_t level = getLevel(size);
+    if (!allocateLevel(level)) return std::nullopt;
+
+    ShadowTile tile = m_free[level].back();
+    m_free[level].pop_back();
+    return tile;
+}
+
+void ShadowAtlasAllocator::free(const ShadowTile& tile) {
+    ShadowTile current = tile;
+    for (uint32_t level = getLevel(current.size); ; level--) {
+        std::vector<ShadowTile>& freeTiles = m_free[level];
+        if (level == 0) {
+            freeTiles.push_back(current);
+            return;
+        }
+
+        // The four siblings share the parent's corner.
+        uint32_t parentSize = current.size * 2;
+        ShadowTile parent{current.x & ~(parentSize - 1), current.y & ~(parentSize - 1), parentSize};
+        auto isSibling = [&](const ShadowTile& other) {
+            return (other.x & ~(parentSize - 1)) == parent.x && (other.y & ~(parentSize - 1)) == parent.y;
+        };
+        if (std::count_if(freeTiles.begin(), freeTiles.end(), isSibling) < 3) {
+            freeTiles.push_back(current);
+            return;
+        }
+
+        freeTiles.erase(std::remove_if(freeTiles.begin(), freeTiles.end(), isSibling), freeTiles.end());
+        current = parent;
+    }
+}
+
+uint64_t ShadowAtlasAllocator::getFreeTexels() const {
+    uint64_t texels = 0;
+    for (const std::vector<ShadowTile>& freeTiles : m_free) {
+        for (const ShadowTile& tile : freeTiles)
+            texels += uint64_t(tile.size) * tile.size;
+    }
+    return texels;
+}
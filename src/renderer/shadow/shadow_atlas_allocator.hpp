@@ -0,0 +1,61 @@
+#ifndef SHADOW_ATLAS_ALLOCATOR_H_
+#define SHADOW_ATLAS_ALLOCATOR_H_
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+/**
+ * @brief Square region of the shadow atlas, in texels.
+ */
+struct ShadowTile {
+    uint32_t x = 0;
+    uint32_t y = 0;
+    uint32_t size = 0;
+
+    bool operator==(const ShadowTile&) const = default;
+};
+
+/**
+ * @class ShadowAtlasAllocator
+ * @brief Quadtree allocator of power-of-two tiles in a square atlas.
+ *
+ * A tile is taken from the free list of its size, splitting a larger tile in
+ * four if that list is empty. Freed tiles merge back with their three
+ * siblings as soon as all four are free, so a tile stays where it is for as
+ * long as it is held, which is what lets cached shadow maps survive other
+ * lights coming and going.
+ */
+class ShadowAtlasAllocator {
+public:
+    /**
+     * @param atlasSize Power of two.
+     * @param minTileSize Power of two, smaller requests are rounded up to it.
+     */
+    ShadowAtlasAllocator(uint32_t atlasSize, uint32_t minTileSize);
+
+    /**
+     * @brief Tile of at least `size` texels, rounded up to a power of two.
+     * @return std::nullopt if the atlas has no room left for it.
+     */
+    std::optional<ShadowTile> allocate(uint32_t size);
+    void free(const ShadowTile& tile);
+
+    uint32_t getAtlasSize() const { return m_atlasSize; }
+    uint32_t getMinTileSize() const { return m_minTileSize; }
+    /**
+     * @brief Texels not held by any tile.
+     */
+    uint64_t getFreeTexels() const;
+
+private:
+    uint32_t m_atlasSize;
+    uint32_t m_minTileSize;
+    // Free tiles of every level, level 0 being the whole atlas.
+    std::vector<std::vector<ShadowTile>> m_free;
+
+    uint32_t getLevel(uint32_t size) const;
+    bool allocateLevel(uint32_t level);
+};
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef SHADOW_FRAME_H_
+#define SHADOW_FRAME_H_
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <shadow_atlas_allocator.hpp>
+#include <skin_palette.hpp>
+
+class Renderable;
+
+constexpr GLuint SHADOW_UNIFORMS_BINDING = 2;
+constexpr GLuint SHADOW_VIEWS_BINDING = 4;
+// Clear of the material texture units.
+constexpr GLuint SHADOW_ATLAS_UNIT = 8;
+constexpr uint32_t MAX_SHADOW_CASCADES = 4;
+
+/**
+ * @brief Draw of a renderable into shadow maps.
+ */
+struct ShadowCaster {
+    Renderable* renderable;
+    glm::mat4 model;
+    // Animated casters change every frame, so views drawing them never cache.
+    uint32_t paletteOffset = NO_SKIN_PALETTE;
+};
+
+/**
+ * @brief A light's view of the scene, rendered into one atlas tile.
+ */
+struct ShadowView {
+    glm::mat4 viewProjection;
+    ShadowTile tile;
+    // Whether the tile must be rendered this frame; otherwise the cached
+    // content from an earlier frame is still valid.
+    bool dirty;
+    // Range of ShadowFrame::casters drawn into the tile, empty unless dirty.
+    uint32_t casterOffset;
+    uint32_t casterCount;
+};
+
+/**
+ * @brief std430 shadow view as read by the shaders.
+ */
+struct GpuShadowView {
+    // World space to atlas texture coordinates and depth.
+    glm::mat4 matrix;
+    // Tile bounds in atlas coordinates, filtering is clamped to them.
+    glm::vec4 rect;
+};
+
+/**
+ * @brief std140 ShadowUniforms block.
+ */
+struct ShadowUniforms {
+    // View-space distance at which each cascade ends.
+    glm::vec4 cascadeSplits{0.0f};
+    // Cascade count, view of the first cascade.
+    glm::ivec4 cascades{0, -1, 0, 0};
+    // Atlas texel size, depth bias.
+    glm::vec4 params{0.0f};
+};
+
+/**
+ * @struct ShadowFrame
+ * @brief Shadow views sampled by a frame, planned by the ShadowPlanner on the
+ * simulation thread and rendered by the ShadowRenderer.
+ */
+struct ShadowFrame {
+    std::vector<ShadowView> views;
+    std::vector<ShadowCaster> casters;
+    ShadowUniforms uniforms;
+
+    void clear() {
+        views.clear();
+        casters.clear();
+        uniforms = ShadowUniforms();
+    }
+};
+
+#endif
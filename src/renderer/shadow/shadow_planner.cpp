@@ -0,0 +1,258 @@
+#include <shadow_planner.hpp>
+#include <frustum.hpp>
+#include <renderable.hpp>
+#include <hash.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+
+static constexpr float SHADOW_NEAR_PLANE = 0.05f;
+// How far behind a cascade casters are still captured.
+static constexpr float CASCADE_CASTER_MARGIN = 50.0f;
+// Blend between uniform (0) and logarithmic (1) cascade splits.
+static constexpr float CASCADE_SPLIT_LAMBDA = 0.75f;
+
+// Cube faces in the order the shaders select them: +X, -X, +Y, -Y, +Z, -Z.
+static const glm::vec3 CUBE_FACE_DIRECTIONS[6] = {
+    { 1.0f,  0.0f,  0.0f}, {-1.0f,  0.0f,  0.0f},
+    { 0.0f,  1.0f,  0.0f}, { 0.0f, -1.0f,  0.0f},
+    { 0.0f,  0.0f,  1.0f}, { 0.0f,  0.0f, -1.0f}
+};
+static const glm::vec3 CUBE_FACE_UPS[6] = {
+    {0.0f, -1.0f,  0.0f}, {0.0f, -1.0f,  0.0f},
+    {0.0f,  0.0f,  1.0f}, {0.0f,  0.0f, -1.0f},
+    {0.0f, -1.0f,  0.0f}, {0.0f, -1.0f,  0.0f}
+};
+
+/**
+ * @brief Fraction of the screen height covered by a sphere, 1 if the camera
+ * is inside it.
+ */
+static float computeCoverage(const glm::vec3& center, float radius, const glm::mat4& view,
+                             const glm::mat4& projection) {
+    float distance = glm::length(glm::vec3(view * glm::vec4(center, 1.0f)));
+    if (distance <= radius) return 1.0f;
+    return std::min(1.0f, projection[1][1] * radius / std::sqrt(distance * distance - radius * radius));
+}
+
+static glm::vec3 getUpVector(const glm::vec3& direction) {
+    return std::abs(direction.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+}
+
+ShadowPlanner::ShadowPlanner(const ShadowSettings& settings)
+    : m_settings(settings), m_allocator(settings.atlasSize, settings.minTileSize) {
+    uint32_t cascadeCount = std::min(settings.cascadeCount, MAX_SHADOW_CASCADES);
+    // Cascades are rendered every time the camera moves, they keep their tiles for good.
+    for (uint32_t i = 0; i < cascadeCount; i++) {
+        std::optional<ShadowTile> tile = m_allocator.allocate(settings.cascadeSize);
+        if (!tile) break;
+        m_cascades.push_back({*tile});
+    }
+}
+
+uint32_t ShadowPlanner::chooseTileSize(float coverage) const {
+    float texels = std::clamp(coverage, 0.0f, 1.0f) * m_settings.maxTileSize;
+    uint32_t size = std::bit_ceil(std::max(static_cast<uint32_t>(texels), 1u));
+    return std::clamp(size, m_settings.minTileSize, m_settings.maxTileSize);
+}
+
+void ShadowPlanner::releaseSlot(LightSlot& slot) {
+    for (const CachedView& view : slot.views)
+        m_allocator.free(view.tile);
+    slot.views.clear();
+    slot.tileSize = 0;
+}
+
+bool ShadowPlanner::resizeSlot(LightSlot& slot, uint32_t viewCount, uint32_t tileSize) {
+    releaseSlot(slot);
+    slot.requestedSize = tileSize;
+    for (uint32_t size = tileSize; size >= m_settings.minTileSize; size /= 2) {
+        for (uint32_t i = 0; i < viewCount; i++) {
+            std::optional<ShadowTile> tile = m_allocator.allocate(size);
+            if (!tile) break;
+            slot.views.push_back({*tile});
+        }
+        if (slot.views.size() == viewCount) {
+            slot.tileSize = size;
+            return true;
+        }
+        releaseSlot(slot);
+    }
+    return false;
+}
+
+void ShadowPlanner::addView(CachedView& cached, const glm::mat4& viewProjection,
+                            std::span<const ShadowCaster> casters, ShadowFrame& frame) {
+    Frustum frustum = Frustum::fromMatrix(viewProjection);
+    uint64_t key = Hash::fnv1a(cached.tile, Hash::fnv1a(viewProjection));
+    m_visibleCasters.clear();
+    bool animated = false;
+    for (uint32_t i = 0; i < casters.size(); i++) {
+        const glm::vec4& sphere = m_casterSpheres[i];
+        if (!frustum.intersectsSphere(glm::vec3(sphere), sphere.w)) continue;
+        m_visibleCasters.push_back(i);
+        key = Hash::fnv1a(casters[i].renderable, key);
+        key = Hash::fnv1a(casters[i].model, key);
+        animated |= casters[i].paletteOffset != NO_SKIN_PALETTE;
+    }
+
+    ShadowView shadowView{viewProjection, cached.tile, animated || key != cached.key,
+                          static_cast<uint32_t>(frame.casters.size()), 0};
+    if (shadowView.dirty) {
+        for (uint32_t i : m_visibleCasters) frame.casters.push_back(casters[i]);
+        shadowView.casterCount = static_cast<uint32_t>(m_visibleCasters.size());
+        cached.key = key;
+        m_dirtyViewCount++;
+    }
+    frame.views.push_back(shadowView);
+    m_viewCount++;
+}
+
+void ShadowPlanner::plan(std::span<PointLight> pointLights, std::span<Spotlight> spotlights,
+                         const DirectionalLight& directional, std::span<const ShadowCaster> casters,
+                         const glm::mat4& view, const glm::mat4& projection, ShadowFrame& frame) {
+    m_viewCount = 0;
+    m_dirtyViewCount = 0;
+    frame.uniforms.params = glm::vec4(1.0f / m_settings.atlasSize, 0.0015f, 0.0f, 0.0f);
+
+    m_casterSpheres.clear();
+    for (const ShadowCaster& caster : casters) {
+        const Renderable& renderable = *caster.renderable;
+        float scale = std::max({glm::length(glm::vec3(caster.model[0])), glm::length(glm::vec3(caster.model[1])),
+                                glm::length(glm::vec3(caster.model[2]))});
+        glm::vec3 center = glm::vec3(caster.model * glm::vec4(renderable.getBoundsCenter(), 1.0f));
+        m_casterSpheres.emplace_back(center, renderable.getBoundsRadius() * scale);
+    }
+
+    planCascades(directional, view, projection, casters, frame);
+
+    // Lights that cannot light anything on screen keep their tiles, and so
+    // their cache, but are not sampled.
+    Frustum cameraFrustum = Frustum::fromMatrix(projection * view);
+    m_pointSlots.resize(std::max(m_pointSlots.size(), pointLights.size()));
+    m_spotSlots.resize(std::max(m_spotSlots.size(), spotlights.size()));
+    for (size_t i = pointLights.size(); i < m_pointSlots.size(); i++) releaseSlot(m_pointSlots[i]);
+    for (size_t i = spotlights.size(); i < m_spotSlots.size(); i++) releaseSlot(m_spotSlots[i]);
+    m_pointSlots.resize(pointLights.size());
+    m_spotSlots.resize(spotlights.size());
+
+    // Tile sizes first, freeing every tile that changes size before
+    // allocating any, largest lights first so they get the room.
+    m_order.clear();
+    auto requestSize = [&](LightSlot& slot, uint32_t viewCount, bool castShadows, const glm::vec3& center,
+                           float radius, uint32_t index) {
+        if (!castShadows || radius <= 0.0f) {
+            releaseSlot(slot);
+            return;
+        }
+        float coverage = computeCoverage(center, radius, view, projection);
+        // Empty slots retry every frame, in case other lights freed room.
+        if (chooseTileSize(coverage) != slot.requestedSize || slot.views.size() != viewCount) {
+            releaseSlot(slot);
+            m_order.push_back({coverage, index});
+        }
+    };
+    for (uint32_t i = 0; i < pointLights.size(); i++) {
+        const PointLight& light = pointLights[i];
+        requestSize(m_pointSlots[i], 6, light.castShadows, light.position, light.radius, i);
+    }
+    for (uint32_t i = 0; i < spotlights.size(); i++) {
+        const Spotlight& light = spotlights[i];
+        requestSize(m_spotSlots[i], 1, light.castShadows, light.position, light.range,
+                    static_cast<uint32_t>(pointLights.size()) + i);
+    }
+    std::sort(m_order.begin(), m_order.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    for (const auto& [coverage, index] : m_order) {
+        bool isPoint = index < pointLights.size();
+        LightSlot& slot = isPoint ? m_pointSlots[index] : m_spotSlots[index - pointLights.size()];
+        resizeSlot(slot, isPoint ? 6 : 1, chooseTileSize(coverage));
+    }
+
+    for (uint32_t i = 0; i < pointLights.size(); i++) {
+        PointLight& light = pointLights[i];
+        LightSlot& slot = m_pointSlots[i];
+        light.shadowView = NO_SHADOW;
+        if (slot.views.empty() || !cameraFrustum.intersectsSphere(light.position, light.radius)) continue;
+
+        light.shadowView = static_cast<int32_t>(frame.views.size());
+        glm::mat4 faceProjection = glm::perspective(glm::radians(90.0f), 1.0f, SHADOW_NEAR_PLANE, light.radius);
+        for (uint32_t face = 0; face < 6; face++) {
+            glm::mat4 faceView = glm::lookAt(light.position, light.position + CUBE_FACE_DIRECTIONS[face],
+                                             CUBE_FACE_UPS[face]);
+            addView(slot.views[face], faceProjection * faceView, casters, frame);
+        }
+    }
+
+    for (uint32_t i = 0; i < spotlights.size(); i++) {
+        Spotlight& light = spotlights[i];
+        LightSlot& slot = m_spotSlots[i];
+        light.shadowView = NO_SHADOW;
+        if (slot.views.empty() || !cameraFrustum.intersectsSphere(light.position, light.range)) continue;
+
+        light.shadowView = static_cast<int32_t>(frame.views.size());
+        glm::vec3 direction = glm::normalize(light.direction);
+        float fieldOfView = 2.0f * std::acos(std::clamp(light.outerRadius, -1.0f, 1.0f));
+        glm::mat4 spotProjection = glm::perspective(fieldOfView, 1.0f, SHADOW_NEAR_PLANE, light.range);
+        glm::mat4 spotView = glm::lookAt(light.position, light.position + direction, getUpVector(direction));
+        addView(slot.views[0], spotProjection * spotView, casters, frame);
+    }
+}
+
+void ShadowPlanner::planCascades(const DirectionalLight& directional, const glm::mat4& view,
+                                 const glm::mat4& projection, std::span<const ShadowCaster> casters,
+                                 ShadowFrame& frame) {
+    if (!directional.castShadows || m_cascades.empty()) return;
+
+    // Camera planes from the OpenGL perspective matrix.
+    float cameraNear = projection[3][2] / (projection[2][2] - 1.0f);
+    float cameraFar = projection[3][2] / (projection[2][2] + 1.0f);
+    float shadowFar = std::min(cameraFar, m_settings.cascadeDistance);
+    float tanX = 1.0f / projection[0][0], tanY = 1.0f / projection[1][1];
+    glm::mat4 inverseView = glm::inverse(view);
+    glm::vec3 direction = glm::normalize(directional.direction);
+
+    const uint32_t count = static_cast<uint32_t>(m_cascades.size());
+    frame.uniforms.cascades = glm::ivec4(count, static_cast<int32_t>(frame.views.size()), 0, 0);
+
+    float begin = cameraNear;
+    for (uint32_t i = 0; i < count; i++) {
+        float t = static_cast<float>(i + 1) / count;
+        float uniformSplit = cameraNear + (shadowFar - cameraNear) * t;
+        float logSplit = cameraNear * std::pow(shadowFar / cameraNear, t);
+        float end = uniformSplit + (logSplit - uniformSplit) * CASCADE_SPLIT_LAMBDA;
+        frame.uniforms.cascadeSplits[i] = end;
+
+        // A sphere around the slice keeps the cascade size constant while
+        // the camera turns.
+        glm::vec3 corners[8];
+        glm::vec3 center(0.0f);
+        for (uint32_t c = 0; c < 8; c++) {
+            float depth = (c & 4) ? end : begin;
+            glm::vec3 corner((c & 1 ? 1.0f : -1.0f) * depth * tanX, (c & 2 ? 1.0f : -1.0f) * depth * tanY, -depth);
+            corners[c] = glm::vec3(inverseView * glm::vec4(corner, 1.0f));
+            center += corners[c] / 8.0f;
+        }
+        float radius = 0.0f;
+        for (const glm::vec3& corner : corners) radius = std::max(radius, glm::length(corner - center));
+        radius = std::ceil(radius * 16.0f) / 16.0f;
+
+        glm::mat4 lightView = glm::lookAt(center - direction * (radius + CASCADE_CASTER_MARGIN), center,
+                                          getUpVector(direction));
+        glm::mat4 lightProjection = glm::ortho(-radius, radius, -radius, radius, 0.0f,
+                                               2.0f * radius + CASCADE_CASTER_MARGIN);
+
+        // Snap to whole texels so the cascade does not shimmer, and stays
+        // cached, while the camera is still or only turning.
+        float halfSize = m_settings.cascadeSize * 0.5f;
+        glm::vec4 origin = lightProjection * lightView * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        glm::vec2 texel = glm::vec2(origin.x, origin.y) * halfSize;
+        glm::vec2 offset = (glm::vec2(std::round(texel.x), std::round(texel.y)) - texel) / halfSize;
+        lightProjection[3][0] += offset.x;
+        lightProjection[3][1] += offset.y;
+
+        addView(m_cascades[i], lightProjection * lightView, casters, frame);
+        begin = end;
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef SHADOW_PLANNER_H_
+#define SHADOW_PLANNER_H_
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <glm/glm.hpp>
+#include <light.hpp>
+#include <shadow_frame.hpp>
+#include <shadow_settings.hpp>
+#include <shadow_atlas_allocator.hpp>
+
+/**
+ * @class ShadowPlanner
+ * @brief Decides every frame which shadow views exist, where they live in the
+ * atlas and which of them must be rendered again.
+ *
+ * - Point lights get six cube face views and spot lights one, with a tile
+ *   size following the screen height covered by their range.
+ * - The directional light gets cascades of fixed size, snapped to their
+ *   texel grid so they do not change while the camera stands still.
+ * - A view is keyed by its matrix, its tile, and the casters inside it with
+ *   their transforms. Only views whose key changed are marked dirty; the
+ *   others keep what an earlier frame rendered into their tile. Views with
+ *   a skinned caster inside are dirty every frame.
+ *
+ * Lights are identified by their index in the spans passed to plan(), which
+ * must stay the same from one frame to the next for caching to work.
+ */
+class ShadowPlanner {
+public:
+    explicit ShadowPlanner(const ShadowSettings& settings);
+
+    /**
+     * @brief Fill `frame` and set the shadowView of every shadowed light.
+     */
+    void plan(std::span<PointLight> pointLights, std::span<Spotlight> spotlights,
+              const DirectionalLight& directional, std::span<const ShadowCaster> casters,
+              const glm::mat4& view, const glm::mat4& projection, ShadowFrame& frame);
+
+    /**
+     * @brief Tile size for a light covering `coverage` of the screen height.
+     */
+    uint32_t chooseTileSize(float coverage) const;
+
+    const ShadowSettings& getSettings() const { return m_settings; }
+    // Views planned and views marked dirty by the last plan().
+    uint32_t getViewCount() const { return m_viewCount; }
+    uint32_t getDirtyViewCount() const { return m_dirtyViewCount; }
+
+private:
+    struct CachedView {
+        ShadowTile tile;
+        // 0 until first rendered.
+        uint64_t key = 0;
+    };
+
+    // Views of one light, all of the same tile size.
+    struct LightSlot {
+        // Size chosen from coverage; tiles may be smaller if the atlas is full.
+        uint32_t requestedSize = 0;
+        uint32_t tileSize = 0;
+        std::vector<CachedView> views;
+    };
+
+    ShadowSettings m_settings;
+    ShadowAtlasAllocator m_allocator;
+    std::vector<LightSlot> m_pointSlots;
+    std::vector<LightSlot> m_spotSlots;
+    std::vector<CachedView> m_cascades;
+
+    // Scratch, kept to avoid allocating every frame.
+    std::vector<glm::vec4> m_casterSpheres;
+    std::vector<uint32_t> m_visibleCasters;
+    std::vector<std::pair<float, uint32_t>> m_order;
+    uint32_t m_viewCount{0};
+    uint32_t m_dirtyViewCount{0};
+
+    /**
+     * @brief Give `slot` `viewCount` tiles of `tileSize`, or of the largest
+     * smaller size that fits. Tiles are kept if the size did not change.
+     * @return false if the atlas is full, the slot is then empty.
+     */
+    bool resizeSlot(LightSlot& slot, uint32_t viewCount, uint32_t tileSize);
+    void releaseSlot(LightSlot& slot);
+
+    /**
+     * @brief Append the view to `frame`, with its casters if it is dirty.
+     */
+    void addView(CachedView& cached, const glm::mat4& viewProjection,
+                 std::span<const ShadowCaster> casters, ShadowFrame& frame);
+    void planCascades(const DirectionalLight& directional, const glm::mat4& view,
+                      const glm::mat4& projection, std::span<const ShadowCaster> casters, ShadowFrame& frame);
+};
+
+#endif
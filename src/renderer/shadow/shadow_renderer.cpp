@@ -0,0 +1,112 @@
+#include <shadow_renderer.hpp>
+#include <shader_permutations.hpp>
+#include <renderable.hpp>
+#include <stream_buffer.hpp>
+#include <gl_state.hpp>
+#include <memory_report.hpp>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+
+ShadowRenderer::ShadowRenderer(uint32_t atlasSize)
+    : m_atlasSize(atlasSize),
+      m_atlas(GL::createTexture2D(1, GL_DEPTH_COMPONENT32F, atlasSize, atlasSize)),
+      m_framebuffer(GL::createFramebuffer()),
+      m_permutations(std::make_unique<ShaderPermutations>("shaders/shadow_vertex.glsl", "shaders/depth_fragment.glsl",
+          SKINNING)) {
+    GLuint atlas = m_atlas.get();
+    // Linear filtering with comparison gives 2x2 PCF for free.
+    glTextureParameteri(atlas, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTextureParameteri(atlas, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(atlas, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(atlas, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(atlas, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTextureParameteri(atlas, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+
+    glNamedFramebufferTexture(m_framebuffer.get(), GL_DEPTH_ATTACHMENT, atlas, 0);
+    glNamedFramebufferDrawBuffer(m_framebuffer.get(), GL_NONE);
+    glNamedFramebufferReadBuffer(m_framebuffer.get(), GL_NONE);
+    if (glCheckNamedFramebufferStatus(m_framebuffer.get(), GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cerr << "ERROR::SHADOW_RENDERER::Framebuffer is incomplete." << std::endl;
+
+    // Never-rendered tiles read as unshadowed.
+    static constexpr GLfloat FAR_DEPTH = 1.0f;
+    glClearNamedFramebufferfv(m_framebuffer.get(), GL_DEPTH, 0, &FAR_DEPTH);
+
+    MemoryReport::getInstance().add(MemorySubsystem::RENDER_TARGETS_GPU, size_t(atlasSize) * atlasSize * 4);
+}
+
+ShadowRenderer::~ShadowRenderer() {
+    MemoryReport::getInstance().remove(MemorySubsystem::RENDER_TARGETS_GPU, size_t(m_atlasSize) * m_atlasSize * 4);
+}
+
+void ShadowRenderer::render(const ShadowFrame& frame, StreamBuffer& stream) {
+    bool anyDirty = std::any_of(frame.views.begin(), frame.views.end(),
+                                [](const ShadowView& view) { return view.dirty; });
+    if (anyDirty) {
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_framebuffer.get());
+        glEnable(GL_SCISSOR_TEST);
+        glEnable(GL_POLYGON_OFFSET_FILL);
+        glPolygonOffset(2.0f, 4.0f);
+        ShaderEngine* engines[2] = {m_permutations->get(0), m_permutations->get(SKINNING)};
+
+        for (const ShadowView& view : frame.views) {
+            if (!view.dirty) continue;
+
+            const ShadowTile& tile = view.tile;
+            glViewport(tile.x, tile.y, tile.size, tile.size);
+            // The scissor keeps the clear inside the tile.
+            glScissor(tile.x, tile.y, tile.size, tile.size);
+            glClear(GL_DEPTH_BUFFER_BIT);
+
+            ShaderEngine* current = nullptr;
+            for (uint32_t i = view.casterOffset; i < view.casterOffset + view.casterCount; i++) {
+                const ShadowCaster& caster = frame.casters[i];
+                bool skinned = caster.paletteOffset != NO_SKIN_PALETTE;
+                ShaderEngine* engine = engines[skinned];
+                if (!engine) continue;
+                if (engine != current) {
+                    engine->use();
+                    engine->setMat4("lightViewProjection", view.viewProjection);
+                    current = engine;
+                }
+                engine->setMat4("model", caster.model);
+                if (skinned) engine->setInt("paletteOffset", static_cast<int>(caster.paletteOffset));
+                caster.renderable->drawDepth(skinned);
+            }
+        }
+
+        glDisable(GL_POLYGON_OFFSET_FILL);
+        glDisable(GL_SCISSOR_TEST);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    }
+
+    // Clip space to the tile's texture coordinates, depth to [0, 1].
+    const float atlasSize = static_cast<float>(m_atlasSize);
+    m_gpuViews.clear();
+    for (const ShadowView& view : frame.views) {
+        const ShadowTile& tile = view.tile;
+        float scale = tile.size / atlasSize;
+        glm::mat4 toTile(1.0f);
+        toTile[0][0] = 0.5f * scale;
+        toTile[1][1] = 0.5f * scale;
+        toTile[2][2] = 0.5f;
+        toTile[3] = glm::vec4(tile.x / atlasSize + 0.5f * scale, tile.y / atlasSize + 0.5f * scale, 0.5f, 1.0f);
+
+        // Half a texel in, so filtering never reads a neighbouring tile.
+        float inset = 0.5f / atlasSize;
+        glm::vec4 rect(tile.x / atlasSize + inset, tile.y / atlasSize + inset,
+                       (tile.x + tile.size) / atlasSize - inset, (tile.y + tile.size) / atlasSize - inset);
+        m_gpuViews.push_back({toTile * view.viewProjection, rect});
+    }
+
+    stream.bindRange(GL_UNIFORM_BUFFER, SHADOW_UNIFORMS_BINDING, stream.push(frame.uniforms));
+    size_t bytes = m_gpuViews.size() * sizeof(GpuShadowView);
+    // Empty ranges cannot be bound.
+    StreamBuffer::Allocation views = stream.allocate(std::max<size_t>(bytes, 16));
+    if (bytes > 0) std::memcpy(views.data, m_gpuViews.data(), bytes);
+    stream.bindRange(GL_SHADER_STORAGE_BUFFER, SHADOW_VIEWS_BINDING, views);
+
+    GLState::getInstance().bindTextureUnit(SHADOW_ATLAS_UNIT, m_atlas.get());
+}
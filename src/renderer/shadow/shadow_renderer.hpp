@@ -0,0 +1,47 @@
+#ifndef SHADOW_RENDERER_H_
+#define SHADOW_RENDERER_H_
+
+#include <glad/glad.h>
+#include <memory>
+#include <vector>
+#include <gl_handle.hpp>
+#include <shadow_frame.hpp>
+
+class ShaderPermutations;
+class StreamBuffer;
+
+/**
+ * @class ShadowRenderer
+ * @brief Owns the shadow atlas, a single depth texture holding every shadow
+ * map, and renders the dirty views of a ShadowFrame into it. GL thread only.
+ *
+ * Casters are drawn from their position-only stream with a slope-scaled
+ * depth offset, skinned casters with the SKINNING variant. The atlas is
+ * sampled with hardware depth comparison.
+ */
+class ShadowRenderer {
+public:
+    explicit ShadowRenderer(uint32_t atlasSize);
+    ~ShadowRenderer();
+    ShadowRenderer(const ShadowRenderer&) = delete;
+    ShadowRenderer& operator=(const ShadowRenderer&) = delete;
+
+    /**
+     * @brief Render the dirty views, upload every view and the uniforms to
+     * `stream`, and bind the atlas for sampling. Leaves the default
+     * framebuffer bound and the viewport on the last tile rendered, the
+     * caller restores it.
+     */
+    void render(const ShadowFrame& frame, StreamBuffer& stream);
+
+    GLuint getAtlas() const { return m_atlas.get(); }
+
+private:
+    uint32_t m_atlasSize;
+    TextureHandle m_atlas;
+    FramebufferHandle m_framebuffer;
+    std::unique_ptr<ShaderPermutations> m_permutations;
+    std::vector<GpuShadowView> m_gpuViews;
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef SHADOW_SETTINGS_H_
+#define SHADOW_SETTINGS_H_
+
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+/**
+ * @brief Shadow atlas layout and quality, loaded from the "shadows" section
+ * of the configuration file. Sizes are in texels and powers of two.
+ */
+struct ShadowSettings {
+    uint32_t atlasSize = 4096;
+    // Bounds of the tiles of point and spot lights, picked from screen coverage.
+    uint32_t minTileSize = 128;
+    uint32_t maxTileSize = 1024;
+    // Directional light cascades, 0 to disable.
+    uint32_t cascadeCount = 3;
+    uint32_t cascadeSize = 1024;
+    // Distance from the camera covered by the cascades.
+    float cascadeDistance = 50.0f;
+
+    /**
+     * @brief Override the fields present in `config`, keep the others.
+     */
+    void apply(const nlohmann::json& config) {
+        atlasSize = config.value("atlas_size", atlasSize);
+        minTileSize = config.value("min_tile_size", minTileSize);
+        maxTileSize = config.value("max_tile_size", maxTileSize);
+        cascadeCount = config.value("cascade_count", cascadeCount);
+        cascadeSize = config.value("cascade_size", cascadeSize);
+        cascadeDistance = config.value("cascade_distance", cascadeDistance);
+    }
+};
+
+#endif
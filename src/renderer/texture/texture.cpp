@@ -1,6 +1,16 @@
 #include "texture.hpp"
+#include <stb_image.h>
+#include <asset_path.hpp>
+#include <config_manager.hpp>
+#include <cooked_image.hpp>
+#include <virtual_file_system.hpp>
+#include <algorithm>
+#include <iostream>
 #include <unordered_map>
 
+// Textures whose largest side would drop below this are released entirely.
+static constexpr int MIN_STREAMED_TEXTURE_SIZE = 32;
+
 
 std::string toString(TextureType type) {
     switch (type) {
@@ -23,3 +33,275 @@ TextureType fromString(const std::string& str) {
         throw std::invalid_argument("Invalid color string");
     }
 };
+
+static GLenum getPixelFormat(int components) {
+    switch (components) {
+        case 1: return GL_RED;
+        case 2: return GL_RG;
+        case 4: return GL_RGBA;
+        default: return GL_RGB;
+    }
+}
+
+static GLenum getInternalFormat(int components) {
+    switch (components) {
+        case 1: return GL_R8;
+        case 2: return GL_RG8;
+        case 4: return GL_RGBA8;
+        default: return GL_RGB8;
+    }
+}
+
+// Decoded pixels of the image file at `path`, null if it cannot be read.
+static unsigned char* loadImage(const std::string& path, int& width, int& height, int& components) {
+    FileData file;
+    try {
+        file = VirtualFileSystem::getInstance().open(path);
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+    return stbi_load_from_memory(file.data(), static_cast<int>(file.size()), &width, &height, &components, 0);
+}
+
+static void setSamplingParameters(GLuint texture) {
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+void TextureSource::PixelDeleter::operator()(unsigned char* pixels) const {
+    stbi_image_free(pixels);
+}
+
+std::shared_ptr<GpuTexture> GpuTexture::create(const unsigned char* data, int width, int height, int components,
+                                               const std::string& path) {
+    std::shared_ptr<GpuTexture> texture(new GpuTexture());
+    texture->m_path = path;
+    texture->m_width = width;
+    texture->m_height = height;
+    texture->m_components = components;
+    size_t bytes = texture->upload(data, width, height, components);
+
+    texture->m_gpuResource = GpuBudget::getInstance().add(texture.get(), MemorySubsystem::TEXTURE_GPU, bytes);
+    return texture;
+}
+
+// Cooked image at `path`, null with a message if it cannot be read.
+static std::shared_ptr<const IO::CookedImage> readCooked(const std::string& path) {
+    try {
+        return std::make_shared<const IO::CookedImage>(path);
+    } catch (const std::exception& e) {
+        std::cerr << "Texture failed to load at path: " << path << ": " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+TextureSource GpuTexture::decodeFile(const std::string& path) {
+    TextureSource source;
+    if (AssetPath::getExtension(path) == ".ltex") {
+        source.path = path;
+        source.cooked = readCooked(path);
+        return source;
+    }
+    std::string cooked = ConfigurationManager::getInstance()->getCookedPath(path);
+    if (!cooked.empty()) {
+        source.path = cooked;
+        source.cooked = readCooked(cooked);
+        if (source.cooked) return source;
+    }
+
+    source.path = path;
+    source.pixels.reset(loadImage(path, source.width, source.height, source.components));
+    if (!source.pixels) std::cerr << "Texture failed to load at path: " << path << std::endl;
+    return source;
+}
+
+std::shared_ptr<GpuTexture> GpuTexture::fromSource(const TextureSource& source) {
+    if (source.pixels)
+        return create(source.pixels.get(), source.width, source.height, source.components, source.path);
+    if (!source.cooked) return nullptr;
+
+    const IO::CookedImage& image = *source.cooked;
+    std::shared_ptr<GpuTexture> texture(new GpuTexture());
+    texture->m_path = source.path;
+    texture->m_width = image.getWidth();
+    texture->m_height = image.getHeight();
+    texture->m_components = image.getComponents();
+    size_t bytes = texture->upload(image);
+    texture->m_gpuResource = GpuBudget::getInstance().add(texture.get(), MemorySubsystem::TEXTURE_GPU, bytes);
+    return texture;
+}
+
+std::shared_ptr<GpuTexture> GpuTexture::fromFile(const std::string& path) {
+    return fromSource(decodeFile(path));
+}
+
+std::shared_ptr<GpuTexture> GpuTexture::fromMemory(std::span<const unsigned char> encoded, const std::string& name) {
+    int width, height, components;
+    std::unique_ptr<unsigned char, TextureSource::PixelDeleter> data(
+        stbi_load_from_memory(encoded.data(), static_cast<int>(encoded.size()), &width, &height, &components, 0));
+    if (!data) {
+        std::cerr << "Texture failed to decode: " << name << std::endl;
+        return nullptr;
+    }
+    std::shared_ptr<GpuTexture> texture = create(data.get(), width, height, components, name);
+    texture->m_encoded = std::make_shared<const std::vector<unsigned char>>(encoded.begin(), encoded.end());
+    return texture;
+}
+
+GpuTexture::~GpuTexture() {
+    GpuBudget::getInstance().remove(m_gpuResource);
+}
+
+size_t GpuTexture::getBytes(int width, int height) const {
+    // A full mip chain adds a third on top of the base level.
+    return static_cast<size_t>(width) * height * m_components * 4 / 3;
+}
+
+size_t GpuTexture::upload(const unsigned char* data, int width, int height, int components) {
+    m_handle = GL::createTexture2D(GL::getMipLevelCount(width, height),
+                                   getInternalFormat(components), width, height);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTextureSubImage2D(m_handle.get(), 0, 0, 0, width, height,
+                        getPixelFormat(components), GL_UNSIGNED_BYTE, data);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glGenerateTextureMipmap(m_handle.get());
+    setSamplingParameters(m_handle.get());
+    m_bytes = getBytes(width, height);
+    return m_bytes;
+}
+
+size_t GpuTexture::upload(const IO::CookedImage& image) {
+    // Every level is cooked, no mipmaps to generate.
+    m_handle = GL::createTexture2D(image.getLevelCount(), getInternalFormat(image.getComponents()),
+                                   image.getWidth(), image.getHeight());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (int level = 0; level < image.getLevelCount(); level++) {
+        glTextureSubImage2D(m_handle.get(), level, 0, 0, std::max(image.getWidth() >> level, 1),
+                            std::max(image.getHeight() >> level, 1), getPixelFormat(image.getComponents()),
+                            GL_UNSIGNED_BYTE, image.getLevel(level).data());
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    setSamplingParameters(m_handle.get());
+    m_bytes = getBytes(image.getWidth(), image.getHeight());
+    return m_bytes;
+}
+
+bool GpuTexture::canEvict() const {
+    return (std::max(m_width, m_height) >> m_droppedMips) >= MIN_STREAMED_TEXTURE_SIZE;
+}
+
+size_t GpuTexture::evict() {
+    m_droppedMips++;
+    int width = std::max(m_width >> m_droppedMips, 1);
+    int height = std::max(m_height >> m_droppedMips, 1);
+
+    if (!canEvict()) {
+        // Too small to be worth keeping: release to a single texel.
+        const unsigned char black[4] = {0, 0, 0, 255};
+        m_released = true;
+        return upload(black, 1, 1, m_components);
+    }
+
+    // Rebuild without the top level by copying the remaining levels on the GPU.
+    GLsizei levels = GL::getMipLevelCount(width, height);
+    TextureHandle smaller = GL::createTexture2D(levels, getInternalFormat(m_components), width, height);
+    for (GLsizei level = 0; level < levels; level++) {
+        glCopyImageSubData(m_handle.get(), GL_TEXTURE_2D, level + 1, 0, 0, 0,
+                           smaller.get(), GL_TEXTURE_2D, level, 0, 0, 0,
+                           std::max(width >> level, 1), std::max(height >> level, 1), 1);
+    }
+    setSamplingParameters(smaller.get());
+    m_handle = std::move(smaller);
+    m_bytes = getBytes(width, height);
+    return m_bytes;
+}
+
+// Decodes the image of an evicted texture on a worker, for GpuTexture::restore().
+// Takes the texture's source rather than the texture, which may die meanwhile.
+static Task<std::shared_ptr<TextureSource>> restoreSourceTask(AssetLoader& loader, std::string path,
+                                                              std::shared_ptr<const std::vector<unsigned char>> encoded) {
+    co_await loader.toWorker();
+    auto source = std::make_shared<TextureSource>();
+    if (!encoded) {
+        *source = GpuTexture::decodeFile(path);
+        co_return source;
+    }
+    source->path = path;
+    source->pixels.reset(stbi_load_from_memory(encoded->data(), static_cast<int>(encoded->size()), &source->width,
+                                               &source->height, &source->components, 0));
+    co_return source;
+}
+
+size_t GpuTexture::restoreLevel(const IO::CookedImage& image) {
+    int level = m_droppedMips - 1;
+    int width = std::max(m_width >> level, 1);
+    int height = std::max(m_height >> level, 1);
+    GLsizei levels = std::min(GL::getMipLevelCount(width, height), image.getLevelCount() - level);
+    GLenum format = getPixelFormat(m_components);
+
+    // The new top level comes from the image; the lower ones are the current
+    // levels, copied on the GPU, unless the texture was released.
+    TextureHandle larger = GL::createTexture2D(levels, getInternalFormat(m_components), width, height);
+    GLsizei uploaded = m_released ? levels : 1;
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (GLsizei i = 0; i < uploaded; i++) {
+        glTextureSubImage2D(larger.get(), i, 0, 0, std::max(width >> i, 1), std::max(height >> i, 1), format,
+                            GL_UNSIGNED_BYTE, image.getLevel(level + i).data());
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    for (GLsizei i = uploaded; i < levels; i++) {
+        glCopyImageSubData(m_handle.get(), GL_TEXTURE_2D, i - 1, 0, 0, 0,
+                           larger.get(), GL_TEXTURE_2D, i, 0, 0, 0,
+                           std::max(width >> i, 1), std::max(height >> i, 1), 1);
+    }
+    setSamplingParameters(larger.get());
+    m_handle = std::move(larger);
+    m_droppedMips = level;
+    m_released = false;
+    m_bytes = getBytes(width, height);
+    return m_bytes;
+}
+
+size_t GpuTexture::restore() {
+    AssetLoader& loader = AssetLoader::getInstance();
+    if (!m_restoreSource.isValid()) {
+        m_restoreSource = loader.load(restoreSourceTask(loader, m_path, m_encoded));
+        return m_bytes;
+    }
+    // Draws the lower levels until the image is decoded.
+    if (!m_restoreSource.isReady()) return m_bytes;
+
+    std::shared_ptr<TextureSource> source = m_restoreSource.get();
+    if (!source || !source->isValid()) {
+        std::cerr << "Texture failed to stream from path: " << m_path << std::endl;
+        m_restoreSource = {};
+        m_streamFailed = true;
+        return m_bytes;
+    }
+
+    const IO::CookedImage* image = source->cooked.get();
+    if (image && image->getWidth() == m_width && image->getHeight() == m_height &&
+        image->getComponents() == m_components) {
+        restoreLevel(*image);
+    } else if (image) {
+        // Cooked again at another size: nothing to grow from.
+        m_width = image->getWidth();
+        m_height = image->getHeight();
+        m_components = image->getComponents();
+        upload(*image);
+        m_droppedMips = 0;
+    } else {
+        m_width = source->width;
+        m_height = source->height;
+        m_components = source->components;
+        upload(source->pixels.get(), source->width, source->height, source->components);
+        m_droppedMips = 0;
+    }
+    if (m_droppedMips == 0) {
+        m_released = false;
+        m_restoreSource = {};
+    }
+    return m_bytes;
+}
@@ -2,8 +2,16 @@
 #define TEXTURE_HPP_
 
 #include <glad/glad.h>
+#include <memory>
+#include <span>
 #include <string>
+#include <vector>
 #include <stdexcept>
+#include <asset_loader.hpp>
+#include <gl_handle.hpp>
+#include <gpu_budget.hpp>
+
+namespace IO { class CookedImage; }
 
 enum TextureType {
     NOT_TEXTURE = -1,
@@ -14,8 +22,105 @@ enum TextureType {
 std::string toString(TextureType type);
 TextureType fromString(const std::string& str);
 
+/**
+ * @brief Pixels of an image file decoded off the GL thread, waiting to be
+ * uploaded by GpuTexture::fromSource(). Either a cooked image with its mip
+ * chain or the decoded base level.
+ */
+struct TextureSource {
+    struct PixelDeleter {
+        void operator()(unsigned char* pixels) const;
+    };
+
+    std::string path;
+    std::shared_ptr<const IO::CookedImage> cooked;
+    std::unique_ptr<unsigned char, PixelDeleter> pixels;
+    int width{0}, height{0}, components{0};
+
+    bool isValid() const { return cooked || pixels; }
+};
+
+/**
+ * @class GpuTexture
+ * @brief Immutable-storage 2D texture loaded from an image file and tracked by
+ * the GpuBudget.
+ *
+ * Meshes share a texture through std::shared_ptr<GpuTexture>. When evicted the
+ * texture is rebuilt one mip level smaller by copying its own lower levels on
+ * the GPU, so the GL name may change: always bind through getId().
+ *
+ * Restoring never decodes on the GL thread: the image is decoded again through
+ * the AssetLoader while the texture keeps drawing its lower levels. A cooked
+ * image then grows back one mip level per restore() step; a decoded base
+ * level is uploaded at once with its generated mipmaps.
+ */
+class GpuTexture : public GpuBudgetResource {
+public:
+    /**
+     * @brief Texture of the image at `path`, read from its cooked ".ltex"
+     * artifact when there is one.
+     * @return The texture, or nullptr if the image could not be read.
+     */
+    static std::shared_ptr<GpuTexture> fromFile(const std::string& path);
+    /**
+     * @brief Read and decode the image at `path` like fromFile(), without GL
+     * calls, so on any thread.
+     * @return The pixels, invalid if the image could not be read.
+     */
+    static TextureSource decodeFile(const std::string& path);
+    /**
+     * @brief Upload pixels read by decodeFile(). GL thread only.
+     * @return The texture, or nullptr if `source` is invalid.
+     */
+    static std::shared_ptr<GpuTexture> fromSource(const TextureSource& source);
+    /**
+     * @brief Texture decoded from an encoded image in memory, e.g. embedded in
+     * a GLB. The encoded bytes are kept to restore the texture after eviction.
+     * @param name Identifies the image in messages and getPath().
+     * @return The texture, or nullptr if the image could not be decoded.
+     */
+    static std::shared_ptr<GpuTexture> fromMemory(std::span<const unsigned char> encoded, const std::string& name);
+
+    ~GpuTexture() override;
+    GpuTexture(const GpuTexture&) = delete;
+    GpuTexture& operator=(const GpuTexture&) = delete;
+
+    GLuint getId() const { return m_handle.get(); }
+    GpuResourceId getGpuResource() const { return m_gpuResource; }
+    const std::string& getPath() const { return m_path; }
+
+    bool canEvict() const override;
+    size_t evict() override;
+    size_t restore() override;
+    bool isDegraded() const override { return m_droppedMips > 0 && !m_streamFailed; }
+
+private:
+    TextureHandle m_handle;
+    std::string m_path;
+    // Source of embedded images, which have no file to reload.
+    std::shared_ptr<const std::vector<unsigned char>> m_encoded;
+    int m_width{0}, m_height{0}, m_components{0};
+    int m_droppedMips{0};
+    // Released to a single texel: no lower levels are left to copy.
+    bool m_released{false};
+    // The source could not be read again, so the texture stays degraded.
+    bool m_streamFailed{false};
+    // Pixels being decoded, then kept while restoring one level at a time.
+    AssetHandle<TextureSource> m_restoreSource;
+    size_t m_bytes{0};
+    GpuResourceId m_gpuResource{INVALID_GPU_RESOURCE};
+
+    GpuTexture() = default;
+    static std::shared_ptr<GpuTexture> create(const unsigned char* data, int width, int height, int components,
+                                              const std::string& path);
+    size_t upload(const unsigned char* data, int width, int height, int components);
+    size_t upload(const IO::CookedImage& image);
+    size_t restoreLevel(const IO::CookedImage& image);
+    size_t getBytes(int width, int height) const;
+};
+
 struct Texture {
-    GLuint id;
+    std::shared_ptr<GpuTexture> texture;
     TextureType type;
     std::string path;
 };
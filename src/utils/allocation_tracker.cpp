@@ -0,0 +1,105 @@
+#include <allocation_tracker.hpp>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static constexpr size_t TAG_COUNT = static_cast<size_t>(AllocationTag::COUNT);
+
+// Plain atomics rather than a singleton: operator new may run before any
+// static constructor.
+static std::array<std::atomic<uint64_t>, TAG_COUNT> s_counts{};
+static std::array<std::atomic<uint64_t>, TAG_COUNT> s_bytes{};
+static std::array<AllocationCounters, TAG_COUNT> s_frameStart{};
+static std::array<AllocationCounters, TAG_COUNT> s_lastFrame{};
+static thread_local AllocationTag t_currentTag = AllocationTag::GENERAL;
+
+const char* toString(AllocationTag tag) {
+    switch (tag) {
+        case AllocationTag::GENERAL: return "General";
+        case AllocationTag::INPUT: return "Input";
+        case AllocationTag::UI: return "UI";
+        case AllocationTag::RENDERER: return "Renderer";
+        case AllocationTag::ASSETS: return "Assets";
+        default: return "Unknown";
+    }
+}
+
+void AllocationTracker::record(size_t bytes) {
+    size_t tag = static_cast<size_t>(t_currentTag);
+    s_counts[tag].fetch_add(1, std::memory_order_relaxed);
+    s_bytes[tag].fetch_add(bytes, std::memory_order_relaxed);
+}
+
+AllocationTag AllocationTracker::getCurrentTag() {
+    return t_currentTag;
+}
+
+void AllocationTracker::setCurrentTag(AllocationTag tag) {
+    t_currentTag = tag;
+}
+
+void AllocationTracker::newFrame() {
+    for (size_t i = 0; i < TAG_COUNT; i++) {
+        AllocationCounters total = getTotal(static_cast<AllocationTag>(i));
+        s_lastFrame[i] = {total.count - s_frameStart[i].count, total.bytes - s_frameStart[i].bytes};
+        s_frameStart[i] = total;
+    }
+}
+
+AllocationCounters AllocationTracker::getLastFrame() {
+    AllocationCounters sum;
+    for (const AllocationCounters& counters : s_lastFrame) {
+        sum.count += counters.count;
+        sum.bytes += counters.bytes;
+    }
+    return sum;
+}
+
+AllocationCounters AllocationTracker::getLastFrame(AllocationTag tag) {
+    return s_lastFrame[static_cast<size_t>(tag)];
+}
+
+AllocationCounters AllocationTracker::getCurrentFrame() {
+    AllocationCounters sum;
+    for (size_t i = 0; i < TAG_COUNT; i++) {
+        AllocationCounters total = getTotal(static_cast<AllocationTag>(i));
+        sum.count += total.count - s_frameStart[i].count;
+        sum.bytes += total.bytes - s_frameStart[i].bytes;
+    }
+    return sum;
+}
+
+AllocationCounters AllocationTracker::getTotal(AllocationTag tag) {
+    size_t i = static_cast<size_t>(tag);
+    return {s_counts[i].load(std::memory_order_relaxed), s_bytes[i].load(std::memory_order_relaxed)};
+}
+
+void* operator new(size_t size) {
+    AllocationTracker::record(size);
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    AllocationTracker::record(size);
+    if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    AllocationTracker::record(size);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    AllocationTracker::record(size);
+    return std::malloc(size ? size : 1);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
@@ -0,0 +1,69 @@
+#ifndef ALLOCATION_TRACKER_H_
+#define ALLOCATION_TRACKER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+enum class AllocationTag : uint8_t {
+    GENERAL,
+    INPUT,
+    UI,
+    RENDERER,
+    ASSETS,
+    COUNT
+};
+
+const char* toString(AllocationTag tag);
+
+struct AllocationCounters {
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+};
+
+/**
+ * @class AllocationTracker
+ * @brief Counts every heap allocation made through the global operator new,
+ * per frame and per tagged subsystem.
+ *
+ * The tag applies to the calling thread, see ScopedAllocationTag. Over-aligned
+ * allocations are not tracked.
+ */
+class AllocationTracker {
+public:
+    static void record(size_t bytes);
+
+    static AllocationTag getCurrentTag();
+    static void setCurrentTag(AllocationTag tag);
+
+    /**
+     * @brief Close the current frame and start a new one.
+     */
+    static void newFrame();
+
+    // Allocations of the last completed frame.
+    static AllocationCounters getLastFrame();
+    static AllocationCounters getLastFrame(AllocationTag tag);
+    // Allocations since the current frame started.
+    static AllocationCounters getCurrentFrame();
+
+    static AllocationCounters getTotal(AllocationTag tag);
+};
+
+/**
+ * @brief Attribute allocations of the current thread to `tag` for the
+ * lifetime of this object.
+ */
+class ScopedAllocationTag {
+public:
+    explicit ScopedAllocationTag(AllocationTag tag) : m_previous(AllocationTracker::getCurrentTag()) {
+        AllocationTracker::setCurrentTag(tag);
+    }
+    ~ScopedAllocationTag() { AllocationTracker::setCurrentTag(m_previous); }
+
+    ScopedAllocationTag(const ScopedAllocationTag&) = delete;
+    ScopedAllocationTag& operator=(const ScopedAllocationTag&) = delete;
+private:
+    AllocationTag m_previous;
+};
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef ASSET_PATH_H_
+#define ASSET_PATH_H_
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <string_view>
+
+/**
+ * Asset paths are written either way in the configuration and the code
+ * (".\\res\\teapot.fbx", "res/teapot.fbx"). These helpers give them one form
+ * so they can be compared and used as keys.
+ */
+namespace AssetPath {
+
+    /**
+     * @brief `path` with '/' separators, without "." segments, repeated
+     * separators or a trailing separator. ".." segments are resolved against
+     * the previous segment when there is one.
+     */
+    inline std::string normalize(std::string_view path) {
+        std::string result;
+        result.reserve(path.size());
+        bool absolute = !path.empty() && (path[0] == '/' || path[0] == '\\');
+        size_t begin = 0;
+        while (begin <= path.size()) {
+            size_t end = path.find_first_of("/\\", begin);
+            if (end == std::string_view::npos) end = path.size();
+            std::string_view segment = path.substr(begin, end - begin);
+            begin = end + 1;
+
+            if (segment.empty() || segment == ".") continue;
+            if (segment == "..") {
+                size_t last = result.find_last_of('/');
+                std::string_view previous = last == std::string::npos ? std::string_view(result)
+                                                                      : std::string_view(result).substr(last + 1);
+                if (!previous.empty() && previous != "..") {
+                    result.resize(last == std::string::npos ? 0 : last);
+                    continue;
+                }
+            }
+            if (!result.empty()) result += '/';
+            result += segment;
+        }
+        return absolute ? '/' + result : result;
+    }
+
+    /**
+     * @brief Lowercase extension of `path` with its dot, empty if none.
+     */
+    inline std::string getExtension(std::string_view path) {
+        size_t dot = path.find_last_of('.');
+        size_t separator = path.find_last_of("/\\");
+        if (dot == std::string_view::npos || (separator != std::string_view::npos && dot < separator)) return "";
+        std::string extension(path.substr(dot));
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return extension;
+    }
+
+    /**
+     * @brief Directory part of `path`, "." if it has none.
+     */
+    inline std::string getDirectory(std::string_view path) {
+        size_t separator = path.find_last_of("/\\");
+        return separator == std::string_view::npos ? "." : std::string(path.substr(0, separator));
+    }
+
+}
+
+#endif
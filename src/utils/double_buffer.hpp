@@ -0,0 +1,83 @@
+#ifndef DOUBLE_BUFFER_H_
+#define DOUBLE_BUFFER_H_
+
+#include <array>
+#include <condition_variable>
+#include <mutex>
+
+/**
+ * @class DoubleBuffer
+ * @brief Hands values from one producer thread to one consumer thread, the
+ * producer filling the next value while the consumer reads the previous one.
+ *
+ * The producer runs at most one value ahead: publish() blocks until the
+ * consumer has released the value it was reading, since that buffer is the
+ * one the producer writes next.
+ */
+template <typename T>
+class DoubleBuffer {
+public:
+    DoubleBuffer() = default;
+    DoubleBuffer(const DoubleBuffer&) = delete;
+    DoubleBuffer& operator=(const DoubleBuffer&) = delete;
+
+    /**
+     * @brief Buffer the producer may fill. Never read by the consumer until
+     * published.
+     */
+    T& getWriteBuffer() { return m_buffers[m_write]; }
+
+    /**
+     * @brief Hand the write buffer over to the consumer. Does nothing once
+     * stopped.
+     */
+    void publish() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this] { return m_stopped || (!m_pending && !m_reading); });
+        if (m_stopped) return;
+        m_read = m_write;
+        m_write ^= 1;
+        m_pending = true;
+        m_condition.notify_all();
+    }
+
+    /**
+     * @brief Wait for a published buffer, which stays valid until release().
+     * @return nullptr once stopped and the last published buffer consumed.
+     */
+    T* acquire() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this] { return m_stopped || m_pending; });
+        if (!m_pending) return nullptr;
+        m_pending = false;
+        m_reading = true;
+        return &m_buffers[m_read];
+    }
+
+    void release() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_reading = false;
+        m_condition.notify_all();
+    }
+
+    /**
+     * @brief Wake both sides up for good.
+     */
+    void stop() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopped = true;
+        m_condition.notify_all();
+    }
+
+private:
+    std::array<T, 2> m_buffers;
+    size_t m_write{0};
+    size_t m_read{1};
+    bool m_pending{false};
+    bool m_reading{false};
+    bool m_stopped{false};
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+};
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef FRAME_ARENA_H_
+#define FRAME_ARENA_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+/**
+ * @class FrameArena
+ * @brief Linear allocator for data that only lives for one frame.
+ *
+ * Allocation is a pointer bump and nothing is freed individually: reset()
+ * releases everything at once. Requests that do not fit go to overflow blocks,
+ * and the next reset() grows the arena to the peak usage, so a steady-state
+ * frame never touches the heap.
+ */
+class FrameArena {
+public:
+    explicit FrameArena(size_t capacity) { grow(capacity); }
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        uintptr_t base = reinterpret_cast<uintptr_t>(m_buffer.get());
+        size_t offset = ((base + m_offset + alignment - 1) & ~(alignment - 1)) - base;
+        if (offset + bytes <= m_capacity) {
+            m_offset = offset + bytes;
+            m_used += bytes;
+            return m_buffer.get() + offset;
+        }
+
+        m_used += bytes + alignment;
+        m_overflow.emplace_back(new std::byte[bytes + alignment]);
+        uintptr_t overflow = reinterpret_cast<uintptr_t>(m_overflow.back().get());
+        return reinterpret_cast<void*>((overflow + alignment - 1) & ~(alignment - 1));
+    }
+
+    template <typename T>
+    T* allocate(size_t count) {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    /**
+     * @brief Release every allocation of the frame.
+     */
+    void reset() {
+        if (!m_overflow.empty()) {
+            m_overflow.clear();
+            grow(m_used + m_used / 2);
+        }
+        m_peak = std::max(m_peak, m_used);
+        m_offset = 0;
+        m_used = 0;
+    }
+
+    size_t getCapacity() const { return m_capacity; }
+    size_t getUsed() const { return m_used; }
+    size_t getPeak() const { return std::max(m_peak, m_used); }
+
+private:
+    std::unique_ptr<std::byte[]> m_buffer;
+    std::vector<std::unique_ptr<std::byte[]>> m_overflow;
+    size_t m_capacity{0};
+    size_t m_offset{0};
+    size_t m_used{0};
+    size_t m_peak{0};
+
+    void grow(size_t capacity) {
+        m_buffer.reset(new std::byte[capacity]);
+        m_capacity = capacity;
+    }
+};
+
+/**
+ * @brief Standard allocator backed by a FrameArena; deallocate() is a no-op.
+ */
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(FrameArena& arena) : m_arena(&arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.getArena()) {}
+
+    T* allocate(size_t count) { return m_arena->allocate<T>(count); }
+    void deallocate(T*, size_t) {}
+
+    FrameArena* getArena() const { return m_arena; }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return m_arena == other.getArena(); }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return m_arena != other.getArena(); }
+
+private:
+    FrameArena* m_arena;
+};
+
+template <typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef HASH_H_
+#define HASH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * 64-bit FNV-1a. Not cryptographic: used for cache keys and lookup tables,
+ * where speed and a stable result across runs matter more than collisions
+ * being hard to find.
+ */
+namespace Hash {
+
+    constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+    constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+    /**
+     * @brief Hash of `size` bytes, continuing from `hash` to chain values.
+     */
+    inline uint64_t fnv1a(const void* data, size_t size, uint64_t hash = FNV_OFFSET) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    constexpr uint64_t fnv1a(std::string_view str, uint64_t hash = FNV_OFFSET) {
+        for (char c : str) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    /**
+     * @brief Hash of the bytes of `value`, which must have no padding.
+     */
+    template <typename T>
+    uint64_t fnv1a(const T& value, uint64_t hash = FNV_OFFSET) {
+        static_assert(std::is_trivially_copyable_v<T>, "Only plain values can be hashed bytewise.");
+        return fnv1a(&value, sizeof(T), hash);
+    }
+
+}
+
+#endif
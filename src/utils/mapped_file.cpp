@@ -0,0 +1,97 @@
+#include <mapped_file.hpp>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+MappedFile::MappedFile(const std::string& path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("Cannot open file: " + path);
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw std::runtime_error("Cannot read the size of file: " + path);
+    }
+    m_size = static_cast<size_t>(size.QuadPart);
+    // Empty files cannot be mapped.
+    if (m_size > 0) {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        // The view keeps the mapping and the file alive.
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        if (!view) throw std::runtime_error("Cannot map file: " + path);
+        m_data = static_cast<const unsigned char*>(view);
+    } else {
+        CloseHandle(file);
+    }
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0)
+        throw std::runtime_error("Cannot open file: " + path);
+
+    struct stat status;
+    if (fstat(file, &status) != 0) {
+        ::close(file);
+        throw std::runtime_error("Cannot read the size of file: " + path);
+    }
+    m_size = static_cast<size_t>(status.st_size);
+    // Empty files cannot be mapped.
+    if (m_size > 0) {
+        void* view = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+        // The mapping keeps the file alive.
+        ::close(file);
+        if (view == MAP_FAILED) throw std::runtime_error("Cannot map file: " + path);
+        madvise(view, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const unsigned char*>(view);
+    } else {
+        ::close(file);
+    }
+#endif
+    m_open = true;
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)),
+      m_open(std::exchange(other.m_open, false)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_open = std::exchange(other.m_open, false);
+    }
+    return *this;
+}
+
+void MappedFile::close() {
+    if (m_data) {
+#ifdef _WIN32
+        UnmapViewOfFile(m_data);
+#else
+        munmap(const_cast<unsigned char*>(m_data), m_size);
+#endif
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_open = false;
+}
@@ -0,0 +1,43 @@
+#ifndef MAPPED_FILE_H_
+#define MAPPED_FILE_H_
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+/**
+ * @class MappedFile
+ * @brief Read-only memory mapping of a whole file.
+ *
+ * Pages are only read from disk when first touched, and parsers can work on
+ * views into the mapping instead of copying the file into a buffer. The
+ * mapping lives as long as the object, so views must not outlive it.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    /**
+     * @throws std::runtime_error if the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const unsigned char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    std::span<const unsigned char> getBytes() const { return {m_data, m_size}; }
+    // Whether a file is mapped, even an empty one.
+    bool isOpen() const { return m_open; }
+
+private:
+    const unsigned char* m_data{nullptr};
+    size_t m_size{0};
+    bool m_open{false};
+
+    void close();
+};
+
+#endif
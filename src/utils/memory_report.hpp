@@ -0,0 +1,76 @@
+#ifndef MEMORY_REPORT_H_
+#define MEMORY_REPORT_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+enum class MemorySubsystem {
+    GEOMETRY_CPU,
+    COLLISION_CPU,
+    GEOMETRY_GPU,
+    TEXTURE_GPU,
+    RENDER_TARGETS_GPU,
+    MATERIALS_GPU,
+    COUNT
+};
+
+inline const char* toString(MemorySubsystem subsystem) {
+    switch (subsystem) {
+        case MemorySubsystem::GEOMETRY_CPU: return "Geometry (CPU)";
+        case MemorySubsystem::COLLISION_CPU: return "Collision (CPU)";
+        case MemorySubsystem::GEOMETRY_GPU: return "Geometry (GPU)";
+        case MemorySubsystem::TEXTURE_GPU: return "Textures (GPU)";
+        case MemorySubsystem::RENDER_TARGETS_GPU: return "Render targets (GPU)";
+        case MemorySubsystem::MATERIALS_GPU: return "Materials (GPU)";
+        default: return "Unknown";
+    }
+}
+
+/**
+ * @class MemoryReport
+ * @brief Bytes currently held by each engine subsystem. This class is a Singleton.
+ */
+class MemoryReport {
+public:
+    static MemoryReport& getInstance() {
+        static MemoryReport instance;
+        return instance;
+    }
+
+    MemoryReport(const MemoryReport&) = delete;
+    MemoryReport& operator=(const MemoryReport&) = delete;
+
+    void add(MemorySubsystem subsystem, int64_t bytes) {
+        m_bytes[static_cast<size_t>(subsystem)].fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void remove(MemorySubsystem subsystem, int64_t bytes) {
+        m_bytes[static_cast<size_t>(subsystem)].fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    int64_t getBytes(MemorySubsystem subsystem) const {
+        return m_bytes[static_cast<size_t>(subsystem)].load(std::memory_order_relaxed);
+    }
+
+    void print(std::ostream& os) const {
+        os << "Memory report:\n";
+        int64_t total = 0;
+        for (size_t i = 0; i < m_bytes.size(); i++) {
+            int64_t bytes = m_bytes[i].load(std::memory_order_relaxed);
+            total += bytes;
+            os << "  " << toString(static_cast<MemorySubsystem>(i)) << ": "
+               << bytes / 1024 << " KB\n";
+        }
+        os << "  Total: " << total / 1024 << " KB\n";
+    }
+
+private:
+    std::array<std::atomic<int64_t>, static_cast<size_t>(MemorySubsystem::COUNT)> m_bytes{};
+
+    MemoryReport() {}
+    ~MemoryReport() {}
+};
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef SIMD_H_
+#define SIMD_H_
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LAMB_SIMD_SSE
+#include <emmintrin.h>
+#endif
+
+namespace Simd {
+
+    /**
+     * @brief Column-major 4x4 product `out = lhs * rhs`.
+     *
+     * `out` may alias `rhs` but not `lhs`.
+     */
+    inline void mat4Mul(const glm::mat4& lhs, const glm::mat4& rhs, glm::mat4& out) {
+#ifdef LAMB_SIMD_SSE
+        const float* a = &lhs[0][0];
+        const float* b = &rhs[0][0];
+        float* r = &out[0][0];
+
+        __m128 c0 = _mm_loadu_ps(a);
+        __m128 c1 = _mm_loadu_ps(a + 4);
+        __m128 c2 = _mm_loadu_ps(a + 8);
+        __m128 c3 = _mm_loadu_ps(a + 12);
+
+        for (int j = 0; j < 4; j++) {
+            const float* column = b + 4 * j;
+            __m128 result = _mm_mul_ps(c0, _mm_set1_ps(column[0]));
+            result = _mm_add_ps(result, _mm_mul_ps(c1, _mm_set1_ps(column[1])));
+            result = _mm_add_ps(result, _mm_mul_ps(c2, _mm_set1_ps(column[2])));
+            result = _mm_add_ps(result, _mm_mul_ps(c3, _mm_set1_ps(column[3])));
+            _mm_storeu_ps(r + 4 * j, result);
+        }
+#else
+        out = lhs * rhs;
+#endif
+    }
+
+#ifdef LAMB_SIMD_SSE
+    /**
+     * @brief Dot product of `a` and `b` broadcast to every lane.
+     */
+    inline __m128 dot4(__m128 a, __m128 b) {
+        __m128 products = _mm_mul_ps(a, b);
+        __m128 sums = _mm_add_ps(products, _mm_shuffle_ps(products, products, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_add_ps(sums, _mm_shuffle_ps(sums, sums, _MM_SHUFFLE(1, 0, 3, 2)));
+    }
+#endif
+
+    /**
+     * @brief Normalized lerp from `a` to `b` along the shorter arc. Close to
+     * slerp for the small angles between neighbouring keys, and far cheaper.
+     *
+     * Relies on glm storing quaternions as x, y, z, w.
+     */
+    inline glm::quat quatNlerp(const glm::quat& a, const glm::quat& b, float t) {
+#ifdef LAMB_SIMD_SSE
+        __m128 qa = _mm_loadu_ps(&a[0]);
+        __m128 qb = _mm_loadu_ps(&b[0]);
+        // q and -q are the same rotation: flip b onto the hemisphere of a.
+        __m128 sign = _mm_and_ps(dot4(qa, qb), _mm_set1_ps(-0.0f));
+        qb = _mm_xor_ps(qb, sign);
+        __m128 result = _mm_add_ps(qa, _mm_mul_ps(_mm_sub_ps(qb, qa), _mm_set1_ps(t)));
+        result = _mm_div_ps(result, _mm_sqrt_ps(dot4(result, result)));
+
+        glm::quat out;
+        _mm_storeu_ps(&out[0], result);
+        return out;
+#else
+        glm::quat target = glm::dot(a, b) < 0.0f ? -b : b;
+        return glm::normalize(a * (1.0f - t) + target * t);
+#endif
+    }
+
+}
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef TASK_H_
+#define TASK_H_
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+template <typename T>
+class Task;
+
+namespace TaskDetail {
+
+    struct PromiseBase {
+        std::coroutine_handle<> continuation;
+        std::exception_ptr exception;
+
+        // Lazy: the body runs when the task is awaited.
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        struct FinalAwaiter {
+            bool await_ready() noexcept { return false; }
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+                // Resume the awaiting coroutine directly, without growing the stack.
+                std::coroutine_handle<> continuation = handle.promise().continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+            void await_resume() noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+
+        void unhandled_exception() { exception = std::current_exception(); }
+    };
+
+    template <typename T>
+    struct Promise : PromiseBase {
+        std::optional<T> value;
+
+        Task<T> get_return_object();
+        void return_value(T result) { value.emplace(std::move(result)); }
+        T getResult() {
+            if (this->exception) std::rethrow_exception(this->exception);
+            return std::move(*value);
+        }
+    };
+
+    template <>
+    struct Promise<void> : PromiseBase {
+        Task<void> get_return_object();
+        void return_void() {}
+        void getResult() {
+            if (exception) std::rethrow_exception(exception);
+        }
+    };
+
+}
+
+/**
+ * @class Task
+ * @brief Coroutine producing a `T`, started when awaited with `co_await`.
+ *
+ * The awaiting coroutine resumes on the thread the task finished on, and
+ * receives the task's result or exception. Tasks themselves do not choose a
+ * thread: they move between worker threads and the GL thread by awaiting
+ * AssetLoader::toWorker() and AssetLoader::toGlThread().
+ *
+ * A task is awaited at most once. Move-only.
+ */
+template <typename T = void>
+class Task {
+public:
+    using promise_type = TaskDetail::Promise<T>;
+
+    Task() = default;
+    explicit Task(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+    Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (m_handle) m_handle.destroy();
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() {
+        if (m_handle) m_handle.destroy();
+    }
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        m_handle.promise().continuation = awaiting;
+        return m_handle;
+    }
+    T await_resume() { return m_handle.promise().getResult(); }
+
+private:
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+namespace TaskDetail {
+
+    template <typename T>
+    Task<T> Promise<T>::get_return_object() {
+        return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+    }
+
+    inline Task<void> Promise<void>::get_return_object() {
+        return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+    }
+
+}
+
+#endif
@@ -0,0 +1,92 @@
+#include <thread_pool.hpp>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+
+ThreadPool::ThreadPool(size_t workerCount) {
+    m_workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; i++)
+        m_workers.emplace_back(&ThreadPool::run, this);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+    for (std::thread& worker : m_workers)
+        worker.join();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_condition.notify_one();
+}
+
+void ThreadPool::run() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+            if (m_stopping && m_tasks.empty()) return;
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain, const RangeFunction& function) {
+    if (count == 0) return;
+    grain = std::max<size_t>(grain, 1);
+    const size_t chunkCount = (count + grain - 1) / grain;
+    if (chunkCount == 1 || m_workers.empty()) {
+        function(0, count, 0);
+        return;
+    }
+
+    // Shared with the helper tasks, which may only start once the loop is over.
+    struct Loop {
+        const RangeFunction* function;
+        size_t count, grain, chunkCount;
+        std::atomic<size_t> nextChunk{0};
+        std::atomic<size_t> nextSlot{1};
+        size_t pendingChunks;
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+    auto loop = std::make_shared<Loop>();
+    loop->function = &function;
+    loop->count = count;
+    loop->grain = grain;
+    loop->chunkCount = chunkCount;
+    loop->pendingChunks = chunkCount;
+
+    auto work = [](Loop& loop, size_t slot) {
+        size_t finished = 0;
+        for (size_t chunk = loop.nextChunk++; chunk < loop.chunkCount; chunk = loop.nextChunk++) {
+            size_t begin = chunk * loop.grain;
+            (*loop.function)(begin, std::min(begin + loop.grain, loop.count), slot);
+            finished++;
+        }
+        if (finished == 0) return;
+
+        std::lock_guard<std::mutex> lock(loop.mutex);
+        loop.pendingChunks -= finished;
+        if (loop.pendingChunks == 0) loop.done.notify_all();
+    };
+
+    size_t helpers = std::min(m_workers.size(), chunkCount - 1);
+    for (size_t i = 0; i < helpers; i++)
+        submit([loop, work] { work(*loop, loop->nextSlot++); });
+
+    work(*loop, 0);
+    std::unique_lock<std::mutex> lock(loop->mutex);
+    loop->done.wait(lock, [&loop] { return loop->pendingChunks == 0; });
+}
@@ -0,0 +1,64 @@
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Fixed set of worker threads for CPU work that does not touch GL.
+ * This class is a Singleton.
+ *
+ * Tasks are either fire-and-forget (submit) or data-parallel loops
+ * (parallelFor) that the calling thread takes part in, so a loop always
+ * completes even if every worker is busy.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Called with [begin, end) and the slot of the thread running it.
+     * Slots are unique among the threads of one parallelFor call and smaller
+     * than getThreadCount(); the calling thread always has slot 0.
+     */
+    using RangeFunction = std::function<void(size_t begin, size_t end, size_t slot)>;
+
+    static ThreadPool& getInstance() {
+        static ThreadPool instance(std::thread::hardware_concurrency() > 1
+            ? std::thread::hardware_concurrency() - 1 : 1);
+        return instance;
+    }
+
+    explicit ThreadPool(size_t workerCount);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Workers plus the calling thread.
+     */
+    size_t getThreadCount() const { return m_workers.size() + 1; }
+
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief Run `function` over [0, count) in chunks of `grain` items and
+     * wait for all of them.
+     */
+    void parallelFor(size_t count, size_t grain, const RangeFunction& function);
+
+private:
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping{false};
+
+    void run();
+};
+
+#endif
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include <animation_clip.hpp>
+#include <skeleton.hpp>
+
+static float angleBetween(const glm::quat& a, const glm::quat& b) {
+    float dot = std::abs(a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z);
+    return 2.0f * std::acos(std::min(dot, 1.0f));
+}
+
+static glm::quat axisAngle(float angle, const glm::vec3& axis) {
+    glm::vec3 n = glm::normalize(axis) * std::sin(angle * 0.5f);
+    return glm::quat(std::cos(angle * 0.5f), n.x, n.y, n.z);
+}
+
+TEST(AnimationClipTest, RotationCompressionKeepsTheRotation) {
+    const glm::vec3 axes[] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}, {1, 2, 3}, {-3, 1, -0.5f}};
+    for (const glm::vec3& axis : axes) {
+        for (float angle = -3.0f; angle <= 3.0f; angle += 0.25f) {
+            glm::quat rotation = axisAngle(angle, axis);
+            glm::quat decompressed = decompressRotation(compressRotation(rotation));
+            EXPECT_LT(angleBetween(rotation, decompressed), 0.001f) << "angle " << angle;
+        }
+    }
+}
+
+TEST(AnimationClipTest, QuantizationStaysWithinOneStep) {
+    const float min = -2.0f, extent = 5.0f;
+    for (float value = min; value <= min + extent; value += 0.37f)
+        EXPECT_NEAR(dequantize(quantize(value, min, extent), min, extent), value, extent / 65535.0f);
+    // Constant channels have no extent.
+    EXPECT_EQ(dequantize(quantize(4.0f, 4.0f, 0.0f), 4.0f, 0.0f), 4.0f);
+}
+
+TEST(AnimationClipTest, CompressedKeysAreSmallerThanPoses) {
+    EXPECT_EQ(sizeof(CompressedJointKey), 18u);
+    EXPECT_LT(sizeof(CompressedJointKey) * 2, sizeof(JointPose));
+}
+
+TEST(AnimationClipTest, SamplesKeysAndInterpolatesBetweenThem) {
+    // One animated joint out of two, moving along x over three frames.
+    std::vector<JointPose> frames(3);
+    for (int i = 0; i < 3; i++) {
+        frames[i].translation = glm::vec3(static_cast<float>(i), 1.0f, 0.0f);
+        frames[i].rotation = axisAngle(0.5f * i, glm::vec3(0, 1, 0));
+    }
+    AnimationClip clip("walk", 10.0f, 3, {1}, frames);
+    EXPECT_FLOAT_EQ(clip.getDuration(), 0.2f);
+    EXPECT_LT(clip.getBytes(), clip.getUncompressedBytes());
+
+    std::vector<JointPose> pose(2);
+    pose[0].translation = glm::vec3(7.0f);
+    clip.sample(0.1f, pose);
+    EXPECT_NEAR(pose[1].translation.x, 1.0f, 1e-3f);
+    EXPECT_NEAR(pose[1].translation.y, 1.0f, 1e-3f);
+    EXPECT_LT(angleBetween(pose[1].rotation, frames[1].rotation), 0.002f);
+    // Joints without a track keep what the pose held.
+    EXPECT_EQ(pose[0].translation, glm::vec3(7.0f));
+
+    clip.sample(0.05f, pose);
+    EXPECT_NEAR(pose[1].translation.x, 0.5f, 1e-3f);
+    EXPECT_LT(angleBetween(pose[1].rotation, axisAngle(0.25f, glm::vec3(0, 1, 0))), 0.002f);
+}
+
+TEST(AnimationClipTest, SamplingLoops) {
+    std::vector<JointPose> frames(3);
+    for (int i = 0; i < 3; i++) frames[i].translation = glm::vec3(static_cast<float>(i), 0.0f, 0.0f);
+    AnimationClip clip("loop", 10.0f, 3, {0}, frames);
+
+    std::vector<JointPose> pose(1);
+    clip.sample(0.25f, pose);
+    EXPECT_NEAR(pose[0].translation.x, 0.5f, 1e-3f);
+    clip.sample(-0.15f, pose);
+    EXPECT_NEAR(pose[0].translation.x, 0.5f, 1e-3f);
+}
+
+TEST(AnimationClipTest, PaletteFollowsTheHierarchy) {
+    // Root at the origin, child one unit up; the bone sits on the child.
+    Skeleton skeleton;
+    skeleton.jointNames = {"root", "arm"};
+    skeleton.jointParents = {-1, 0};
+    skeleton.bindPose.resize(2);
+    skeleton.bindPose[1].translation = glm::vec3(0.0f, 1.0f, 0.0f);
+    skeleton.boneJoints = {1};
+    JointPose inverseBind;
+    inverseBind.translation = glm::vec3(0.0f, -1.0f, 0.0f);
+    skeleton.inverseBindMatrices = {toMatrix(inverseBind)};
+    EXPECT_EQ(skeleton.findJoint("arm"), 1);
+    EXPECT_EQ(skeleton.findJoint("leg"), -1);
+
+    std::vector<glm::mat4> globals(2), palette(1);
+    skeleton.computePalette(skeleton.bindPose, globals, palette);
+    glm::vec4 vertex(0.0f, 1.5f, 0.0f, 1.0f);
+    glm::vec4 bound = palette[0] * vertex;
+    EXPECT_NEAR(glm::length(glm::vec3(bound - vertex)), 0.0f, 1e-5f);
+
+    // Turning the root a quarter around z swings the arm to -x.
+    std::vector<JointPose> pose = skeleton.bindPose;
+    pose[0].rotation = axisAngle(1.5707963f, glm::vec3(0, 0, 1));
+    skeleton.computePalette(pose, globals, palette);
+    glm::vec4 moved = palette[0] * vertex;
+    EXPECT_NEAR(moved.x, -1.5f, 1e-5f);
+    EXPECT_NEAR(moved.y, 0.0f, 1e-5f);
+}
+
+TEST(AnimationClipTest, BlendMovesTowardTheSecondPose) {
+    std::vector<JointPose> a(1), b(1), out(1);
+    b[0].translation = glm::vec3(2.0f, 0.0f, 0.0f);
+    b[0].rotation = axisAngle(1.0f, glm::vec3(1, 0, 0));
+    b[0].scale = glm::vec3(3.0f);
+
+    blendPoses(a, b, 0.5f, out);
+    EXPECT_NEAR(out[0].translation.x, 1.0f, 1e-6f);
+    EXPECT_NEAR(out[0].scale.x, 2.0f, 1e-6f);
+    // Normalized lerp stays close to the true halfway rotation for small angles.
+    EXPECT_LT(angleBetween(out[0].rotation, axisAngle(0.5f, glm::vec3(1, 0, 0))), 0.01f);
+
+    blendPoses(a, b, 1.0f, out);
+    EXPECT_LT(angleBetween(out[0].rotation, b[0].rotation), 1e-4f);
+}
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <asset_cook.hpp>
+#include <asset_path.hpp>
+#include <cooked_image.hpp>
+#include <shader_preprocessor.hpp>
+#include <thread_pool.hpp>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+void writeText(const fs::path& path, const std::string& text) {
+    fs::create_directories(path.parent_path());
+    std::ofstream(path, std::ios::binary) << text;
+}
+
+std::string readText(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+/**
+ * @brief Temporary source and output trees, removed with the fixture.
+ */
+class AssetCookTest : public testing::Test {
+protected:
+    fs::path m_root = fs::temp_directory_path() / "lamb_asset_cook_test";
+    fs::path m_source = m_root / "source";
+    fs::path m_output = m_root / "cooked";
+    std::atomic<int> m_cookCount{0};
+    uint64_t m_settings = 1;
+
+    void SetUp() override { fs::remove_all(m_root); }
+    void TearDown() override { fs::remove_all(m_root); }
+
+    // Shaders cooked for real, and a ".mtl" rule whose settings the test controls.
+    std::vector<Cook::CookRule> createRules() {
+        std::vector<Cook::CookRule> rules;
+        rules.push_back({{".glsl"}, 1, nullptr, [this](const Cook::CookJob& job) {
+            m_cookCount++;
+            std::vector<std::string> includes;
+            writeText(job.artifactPath, ShaderPreprocessor::expandIncludes(job.sourcePath, &includes));
+            std::vector<std::string> dependencies;
+            for (const std::string& include : includes)
+                dependencies.push_back(fs::relative(include, m_source).generic_string());
+            return dependencies;
+        }});
+        rules.push_back({{".mtl"}, 1, [this](const std::string&) { return m_settings; },
+                         [this](const Cook::CookJob& job) {
+            m_cookCount++;
+            writeText(job.artifactPath, readText(job.sourcePath));
+            return std::vector<std::string>();
+        }});
+        return rules;
+    }
+};
+
+}
+
+TEST(AssetPathTest, NormalizesSeparatorsAndDots) {
+    EXPECT_EQ(AssetPath::normalize(".\\res\\teapot.fbx"), "res/teapot.fbx");
+    EXPECT_EQ(AssetPath::normalize("res//shaders/./a/../b.glsl"), "res/shaders/b.glsl");
+    EXPECT_EQ(AssetPath::normalize("../res/"), "../res");
+    EXPECT_EQ(AssetPath::normalize("/root/a"), "/root/a");
+    EXPECT_EQ(AssetPath::getExtension("res/Box.BMP"), ".bmp");
+    EXPECT_EQ(AssetPath::getExtension("res.d/box"), "");
+    EXPECT_EQ(Cook::getArtifactPath(".\\res\\teapot.fbx"), "res/teapot.lmodel");
+    EXPECT_EQ(Cook::getArtifactPath("res/box.PNG"), "res/box.ltex");
+    EXPECT_EQ(Cook::getArtifactPath("res/scene.gltf"), "");
+}
+
+TEST_F(AssetCookTest, CooksOnlyWhatChanged) {
+    writeText(m_source / "shaders/common.glsl", "float one() { return 1.0; }\n");
+    writeText(m_source / "shaders/a.glsl", "#version 460 core\n#include \"common.glsl\"\nvoid main() {}\n");
+    writeText(m_source / "shaders/b.glsl", "#version 460 core\nvoid main() {}\n");
+    writeText(m_source / "res/materials.mtl", "newmtl Gold\n");
+    writeText(m_source / "res/notes.txt", "not an asset\n");
+
+    ThreadPool pool(2);
+    Cook::AssetCooker cooker(m_source.string(), m_output.string(), createRules());
+    std::vector<std::string> sources = cooker.findSources({"res", "shaders"});
+    ASSERT_EQ(sources, (std::vector<std::string>{"res/materials.mtl", "shaders/a.glsl", "shaders/b.glsl",
+                                                 "shaders/common.glsl"}));
+
+    Cook::CookReport report = cooker.cook(sources, false, &pool);
+    EXPECT_TRUE(report.errors.empty());
+    EXPECT_EQ(report.cooked, 4u);
+    EXPECT_EQ(readText(m_output / "shaders/a.glsl"),
+              "#version 460 core\nfloat one() { return 1.0; }\nvoid main() {}\n");
+
+    // Nothing changed.
+    m_cookCount = 0;
+    report = cooker.cook(sources, false, &pool);
+    EXPECT_EQ(report.upToDate, 4u);
+    EXPECT_EQ(m_cookCount, 0);
+
+    // An include changed: it and the shader including it.
+    writeText(m_source / "shaders/common.glsl", "float one() { return 1.0f; }\n");
+    report = cooker.cook(sources, false, &pool);
+    EXPECT_EQ(report.cooked, 2u);
+    EXPECT_EQ(report.upToDate, 2u);
+
+    // Settings changed, or the artifact was deleted.
+    m_settings = 2;
+    fs::remove(m_output / "shaders/b.glsl");
+    m_cookCount = 0;
+    report = cooker.cook(sources, false, &pool);
+    EXPECT_EQ(report.cooked, 2u);
+    EXPECT_TRUE(fs::exists(m_output / "shaders/b.glsl"));
+
+    // Sources that are gone lose their artifact.
+    fs::remove(m_source / "shaders/b.glsl");
+    report = cooker.cook(cooker.findSources({"res", "shaders"}), false, &pool);
+    EXPECT_EQ(report.removed, 1u);
+    EXPECT_FALSE(fs::exists(m_output / "shaders/b.glsl"));
+
+    // Failures are reported and retried.
+    writeText(m_source / "shaders/broken.glsl", "#include \"missing.glsl\"\n");
+    sources = cooker.findSources({"res", "shaders"});
+    report = cooker.cook(sources, false, &pool);
+    EXPECT_EQ(report.errors.size(), 1u);
+    report = cooker.cook(sources, false, &pool);
+    EXPECT_EQ(report.errors.size(), 1u);
+    EXPECT_EQ(report.upToDate, 3u);
+}
+
+TEST(ShaderPreprocessorTest, ExpandsIncludesAndStripsComments) {
+    fs::path root = fs::temp_directory_path() / "lamb_shader_preprocessor_test";
+    writeText(root / "lib/math.glsl", "// Math\nconst float PI = 3.14159;\n");
+    writeText(root / "main.glsl", "#version 460 core\n  #  include \"lib/math.glsl\"\nvoid main() {} /* end\n */\n");
+    writeText(root / "loop.glsl", "#include \"loop.glsl\"\n");
+
+    std::vector<std::string> includes;
+    std::string source = ShaderPreprocessor::expandIncludes((root / "main.glsl").string(), &includes);
+    EXPECT_EQ(source, "#version 460 core\n// Math\nconst float PI = 3.14159;\nvoid main() {} /* end\n */\n");
+    ASSERT_EQ(includes.size(), 1u);
+    EXPECT_EQ(AssetPath::normalize(includes[0]), AssetPath::normalize((root / "lib/math.glsl").string()));
+    EXPECT_EQ(ShaderPreprocessor::stripComments(source),
+              "#version 460 core\n\nconst float PI = 3.14159;\nvoid main() {}  \n\n");
+    EXPECT_THROW(ShaderPreprocessor::expandIncludes((root / "loop.glsl").string()), std::runtime_error);
+    fs::remove_all(root);
+}
+
+TEST(CookedImageTest, StoresFullMipChain) {
+    // 5x3 RGB gradient.
+    std::vector<unsigned char> pixels;
+    for (int y = 0; y < 3; y++) {
+        for (int x = 0; x < 5; x++) pixels.insert(pixels.end(), {static_cast<unsigned char>(x * 50), 100, 200});
+    }
+    fs::path path = fs::temp_directory_path() / "lamb_cooked_image_test.ltex";
+    IO::writeCookedImage(path.string(), pixels.data(), 5, 3, 3);
+
+    {
+        IO::CookedImage image(path.string());
+        EXPECT_EQ(image.getWidth(), 5);
+        EXPECT_EQ(image.getHeight(), 3);
+        ASSERT_EQ(image.getLevelCount(), 3);
+        EXPECT_TRUE(std::equal(pixels.begin(), pixels.end(), image.getLevel(0).begin()));
+        ASSERT_EQ(image.getLevel(1).size(), 2u * 1u * 3u);
+        ASSERT_EQ(image.getLevel(2).size(), 3u);
+        // Average of columns 0 and 1, then of the two level 1 texels.
+        EXPECT_EQ(image.getLevel(1)[0], 25);
+        EXPECT_EQ(image.getLevel(1)[3], 125);
+        EXPECT_EQ(image.getLevel(2)[0], 75);
+        EXPECT_EQ(image.getLevel(2)[2], 200);
+    }
+
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << "LTEX";
+    EXPECT_THROW(IO::CookedImage(path.string()), std::runtime_error);
+    fs::remove(path);
+}
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <asset_loader.hpp>
+#include <task.hpp>
+#include <thread_pool.hpp>
+
+namespace {
+
+Task<int> square(int value) {
+    if (value < 0) throw std::invalid_argument("Negative value");
+    co_return value * value;
+}
+
+/**
+ * @brief Load whose CPU step records how many loads overlap, and whose last
+ * step records the thread it ran on.
+ */
+Task<std::shared_ptr<int>> slowLoad(AssetLoader& loader, int value, std::atomic<int>& running,
+                                    std::atomic<int>& maxRunning, std::thread::id& uploadThread) {
+    co_await loader.toWorker();
+    int now = ++running;
+    for (int seen = maxRunning; now > seen && !maxRunning.compare_exchange_weak(seen, now);) {}
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    running--;
+    int result = co_await square(value);
+
+    co_await loader.toGlThread();
+    uploadThread = std::this_thread::get_id();
+    co_return std::make_shared<int>(result);
+}
+
+}
+
+TEST(AssetLoaderTest, RunsLoadsConcurrentlyAndFinishesOnGlThread) {
+    ThreadPool pool(4);
+    AssetLoader loader(pool);
+    std::atomic<int> running{0}, maxRunning{0};
+    std::vector<std::thread::id> uploadThreads(16);
+    std::vector<AssetHandle<int>> handles;
+    for (int i = 0; i < 16; i++)
+        handles.push_back(loader.load(slowLoad(loader, i, running, maxRunning, uploadThreads[i])));
+
+    EXPECT_EQ(loader.getPendingCount(), 16u);
+    EXPECT_FALSE(handles[0].isReady());
+    loader.waitAll();
+    EXPECT_EQ(loader.getPendingCount(), 0u);
+    EXPECT_GT(maxRunning, 1);
+    for (int i = 0; i < 16; i++) {
+        ASSERT_TRUE(handles[i].isReady());
+        EXPECT_EQ(*handles[i].get(), i * i);
+        EXPECT_EQ(uploadThreads[i], std::this_thread::get_id());
+    }
+}
+
+TEST(AssetLoaderTest, LoadsAwaitOtherLoadsAndReportErrors) {
+    ThreadPool pool(2);
+    AssetLoader loader(pool);
+    auto load = [&loader](int value) -> Task<std::shared_ptr<int>> {
+        co_await loader.toWorker();
+        co_return std::make_shared<int>(co_await square(value));
+    };
+    AssetHandle<int> good = loader.load(load(3));
+    AssetHandle<int> bad = loader.load(load(-1));
+
+    // Dependent loads wait on handles without blocking a thread.
+    std::shared_ptr<int> fromGood, fromBad;
+    auto dependent = [&]() -> Task<void> {
+        fromGood = co_await good;
+        fromBad = co_await bad;
+    };
+    loader.spawn(dependent());
+    loader.waitAll();
+
+    EXPECT_EQ(*good.get(), 9);
+    EXPECT_EQ(bad.get(), nullptr);
+    EXPECT_EQ(bad.getError(), "Negative value");
+    EXPECT_EQ(*fromGood, 9);
+    EXPECT_EQ(fromBad, nullptr);
+}
+
+TEST(AssetLoaderTest, GlStepsQueuedDuringAPumpWaitForTheNext) {
+    ThreadPool pool(1);
+    AssetLoader loader(pool);
+    int steps = 0;
+    auto polling = [&]() -> Task<std::shared_ptr<int>> {
+        for (int i = 0; i < 3; i++) {
+            co_await loader.toGlThread();
+            steps++;
+        }
+        co_return std::make_shared<int>(steps);
+    };
+    AssetHandle<int> handle = loader.load(polling());
+    EXPECT_EQ(loader.runGlTasks(), 1u);
+    EXPECT_EQ(steps, 1);
+    EXPECT_EQ(loader.runGlTasks(), 1u);
+    EXPECT_EQ(loader.runGlTasks(), 1u);
+    EXPECT_EQ(loader.runGlTasks(), 0u);
+    ASSERT_TRUE(handle.isReady());
+    EXPECT_EQ(*handle.get(), 3);
+    EXPECT_EQ(loader.getPendingCount(), 0u);
+}
+
+TEST(AssetLoaderTest, DelayedGlStepsDoNotSpin) {
+    ThreadPool pool(1);
+    AssetLoader loader(pool);
+    // Polls like a shader compile, done after 20 ms.
+    int polls = 0;
+    auto polling = [&]() -> Task<std::shared_ptr<int>> {
+        auto done = std::chrono::steady_clock::now() + std::chrono::milliseconds(20);
+        do {
+            co_await loader.toGlThread(std::chrono::milliseconds(2));
+            polls++;
+        } while (std::chrono::steady_clock::now() < done);
+        co_return std::make_shared<int>(polls);
+    };
+    AssetHandle<int> handle = loader.load(polling());
+    EXPECT_EQ(loader.runGlTasks(), 0u);
+
+    loader.waitAll();
+    ASSERT_TRUE(handle.isReady());
+    EXPECT_GE(polls, 1);
+    EXPECT_LE(polls, 11);
+}
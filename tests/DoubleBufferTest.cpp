@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include <double_buffer.hpp>
+
+TEST(DoubleBufferTest, ConsumerSeesEveryPublishedValueInOrder) {
+    DoubleBuffer<int> buffer;
+    std::vector<int> received;
+
+    std::thread consumer([&] {
+        while (int* value = buffer.acquire()) {
+            received.push_back(*value);
+            buffer.release();
+        }
+    });
+
+    for (int i = 0; i < 100; i++) {
+        buffer.getWriteBuffer() = i;
+        buffer.publish();
+    }
+    // Values published before stopping are still delivered.
+    buffer.stop();
+    consumer.join();
+
+    ASSERT_EQ(received.size(), 100);
+    for (int i = 0; i < 100; i++)
+        EXPECT_EQ(received[i], i);
+}
+
+TEST(DoubleBufferTest, WriteBufferIsNeverTheOneBeingRead) {
+    DoubleBuffer<int> buffer;
+    buffer.getWriteBuffer() = 1;
+    buffer.publish();
+
+    int* reading = buffer.acquire();
+    ASSERT_NE(reading, nullptr);
+    EXPECT_NE(&buffer.getWriteBuffer(), reading);
+    EXPECT_EQ(*reading, 1);
+    buffer.release();
+}
+
+TEST(DoubleBufferTest, StopWakesTheConsumer) {
+    DoubleBuffer<int> buffer;
+    std::thread consumer([&] { EXPECT_EQ(buffer.acquire(), nullptr); });
+    buffer.stop();
+    consumer.join();
+}
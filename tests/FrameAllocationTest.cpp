@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include <SDL2/SDL.h>
+#include <glm/glm.hpp>
+#include <allocation_tracker.hpp>
+#include <frame_arena.hpp>
+#include <input.hpp>
+
+TEST(FrameAllocationTest, TaggedAllocationsAreCounted) {
+    AllocationCounters before = AllocationTracker::getTotal(AllocationTag::ASSETS);
+    {
+        ScopedAllocationTag tag(AllocationTag::ASSETS);
+        std::vector<int> values(1000);
+        ASSERT_EQ(values.size(), 1000);
+    }
+    AllocationCounters after = AllocationTracker::getTotal(AllocationTag::ASSETS);
+
+    EXPECT_EQ(after.count - before.count, 1);
+    EXPECT_GE(after.bytes - before.bytes, 1000 * sizeof(int));
+    EXPECT_EQ(AllocationTracker::getCurrentTag(), AllocationTag::GENERAL);
+}
+
+TEST(FrameAllocationTest, ArenaOverflowGrowsOnReset) {
+    FrameArena arena(64);
+    arena.allocate<float>(100);
+    EXPECT_GT(arena.getUsed(), arena.getCapacity());
+
+    arena.reset();
+    EXPECT_GE(arena.getCapacity(), 100 * sizeof(float));
+    EXPECT_EQ(arena.getUsed(), 0);
+}
+
+TEST(FrameAllocationTest, SteadyStateFrameDoesNotAllocate) {
+    Uint8 keystate[SDL_NUM_SCANCODES] = {0};
+    keystate[SDL_SCANCODE_W] = 1;
+
+    FrameArena arena(256);
+
+    auto frame = [&] {
+        arena.reset();
+        ActionList actions = getActions(keystate);
+
+        FrameVector<glm::mat4> matrices{ArenaAllocator<glm::mat4>(arena)};
+        matrices.reserve(64);
+        for (size_t i = 0; i < 64; i++)
+            matrices.push_back(glm::mat4(static_cast<float>(actions.size())));
+    };
+
+    // The first frames warm up the arena.
+    for (int i = 0; i < 3; i++) frame();
+
+    AllocationTracker::newFrame();
+    for (int i = 0; i < 100; i++) frame();
+    AllocationCounters steadyState = AllocationTracker::getCurrentFrame();
+
+    EXPECT_EQ(steadyState.count, 0);
+    EXPECT_EQ(steadyState.bytes, 0);
+}
@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <gltf_document.hpp>
+
+namespace {
+
+void appendUint32(std::vector<unsigned char>& bytes, uint32_t value) {
+    unsigned char raw[4];
+    std::memcpy(raw, &value, sizeof(value));
+    bytes.insert(bytes.end(), raw, raw + 4);
+}
+
+template <typename T>
+void appendValues(std::vector<unsigned char>& bytes, std::initializer_list<T> values) {
+    for (T value : values) {
+        unsigned char raw[sizeof(T)];
+        std::memcpy(raw, &value, sizeof(T));
+        bytes.insert(bytes.end(), raw, raw + sizeof(T));
+    }
+}
+
+/**
+ * @brief GLB file made of `json` and `binary`, both padded to 4 bytes.
+ */
+std::vector<unsigned char> makeGlb(std::string json, std::vector<unsigned char> binary) {
+    while (json.size() % 4 != 0) json.push_back(' ');
+    while (binary.size() % 4 != 0) binary.push_back(0);
+
+    std::vector<unsigned char> glb;
+    appendUint32(glb, 0x46546C67);
+    appendUint32(glb, 2);
+    appendUint32(glb, static_cast<uint32_t>(12 + 8 + json.size() + 8 + binary.size()));
+    appendUint32(glb, static_cast<uint32_t>(json.size()));
+    appendUint32(glb, 0x4E4F534A);
+    glb.insert(glb.end(), json.begin(), json.end());
+    appendUint32(glb, static_cast<uint32_t>(binary.size()));
+    appendUint32(glb, 0x004E4942);
+    glb.insert(glb.end(), binary.begin(), binary.end());
+    return glb;
+}
+
+// Triangle: 3 float positions, then interleaved normalized byte UVs padded to
+// 4 bytes, then 16-bit indices.
+std::vector<unsigned char> makeTriangleGlb() {
+    std::vector<unsigned char> binary;
+    appendValues<float>(binary, {0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f});
+    appendValues<uint8_t>(binary, {0, 0, 0, 0, 255, 0, 0, 0, 0, 255, 0, 0});
+    appendValues<uint16_t>(binary, {0, 1, 2});
+
+    std::string json = R"({
+        "asset": {"version": "2.0"},
+        "buffers": [{"byteLength": 54}],
+        "bufferViews": [
+            {"buffer": 0, "byteOffset": 0, "byteLength": 36},
+            {"buffer": 0, "byteOffset": 36, "byteLength": 12, "byteStride": 4},
+            {"buffer": 0, "byteOffset": 48, "byteLength": 6}
+        ],
+        "accessors": [
+            {"bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3"},
+            {"bufferView": 1, "componentType": 5121, "count": 3, "type": "VEC2", "normalized": true},
+            {"bufferView": 2, "componentType": 5123, "count": 3, "type": "SCALAR"},
+            {"bufferView": 0, "byteOffset": 12, "componentType": 5126, "count": 3, "type": "VEC3"},
+            {"componentType": 5126, "count": 2, "type": "VEC2"}
+        ],
+        "meshes": [{"primitives": [{"attributes": {"POSITION": 0, "TEXCOORD_0": 1}, "indices": 2}]}]
+    })";
+    return makeGlb(json, binary);
+}
+
+}
+
+TEST(GltfDocumentTest, ReadsAccessorsFromBinaryChunk) {
+    std::vector<unsigned char> glb = makeTriangleGlb();
+    IO::GltfDocument document = IO::GltfDocument::fromBytes(glb);
+    EXPECT_EQ(document.getJson()["meshes"].size(), 1u);
+
+    IO::GltfAccessor positions = document.getAccessor(0);
+    EXPECT_EQ(positions.count, 3u);
+    EXPECT_EQ(positions.components, 3);
+    EXPECT_EQ(positions.stride, 12u);
+    // Views point into the file bytes, nothing is copied.
+    EXPECT_GE(positions.data, glb.data());
+    EXPECT_LT(positions.data, glb.data() + glb.size());
+
+    // Interleaved output, as into an array of vertices.
+    std::vector<float> out(3 * 5, -1.0f);
+    IO::readFloats(positions, 3, out.data(), 5);
+    EXPECT_FLOAT_EQ(out[5], 1.0f);
+    EXPECT_FLOAT_EQ(out[11], 1.0f);
+    EXPECT_FLOAT_EQ(out[3], -1.0f);
+
+    IO::GltfAccessor uvs = document.getAccessor(1);
+    EXPECT_EQ(uvs.stride, 4u);
+    IO::readFloats(uvs, 2, out.data() + 3, 5);
+    EXPECT_FLOAT_EQ(out[3], 0.0f);
+    EXPECT_FLOAT_EQ(out[8], 1.0f);
+    EXPECT_FLOAT_EQ(out[9], 0.0f);
+    EXPECT_FLOAT_EQ(out[14], 1.0f);
+
+    unsigned int indices[3];
+    IO::readIndices(document.getAccessor(2), indices);
+    EXPECT_EQ(indices[0], 0u);
+    EXPECT_EQ(indices[2], 2u);
+}
+
+TEST(GltfDocumentTest, ConvertsNormalizedAndMissingData) {
+    std::vector<unsigned char> binary;
+    appendValues<int16_t>(binary, {-32768, 32767, 0, -16384});
+    std::string json = R"({
+        "asset": {"version": "2.0"},
+        "buffers": [{"byteLength": 8}],
+        "bufferViews": [{"buffer": 0, "byteLength": 8}],
+        "accessors": [
+            {"bufferView": 0, "componentType": 5122, "count": 1, "type": "VEC4", "normalized": true},
+            {"componentType": 5126, "count": 2, "type": "VEC2"},
+            {"bufferView": 0, "componentType": 5122, "count": 1, "type": "VEC4"}
+        ]
+    })";
+    std::vector<unsigned char> glb = makeGlb(json, binary);
+    IO::GltfDocument document = IO::GltfDocument::fromBytes(glb);
+
+    float values[4];
+    IO::readFloats(document.getAccessor(0), 4, values, 4);
+    // The most negative value clamps to -1.
+    EXPECT_FLOAT_EQ(values[0], -1.0f);
+    EXPECT_FLOAT_EQ(values[1], 1.0f);
+    EXPECT_FLOAT_EQ(values[2], 0.0f);
+    EXPECT_NEAR(values[3], -0.5f, 1e-4f);
+
+    // Not normalized, e.g. quantized positions: converted as is.
+    IO::readFloats(document.getAccessor(2), 4, values, 4);
+    EXPECT_FLOAT_EQ(values[0], -32768.0f);
+    EXPECT_FLOAT_EQ(values[3], -16384.0f);
+
+    // Accessors without a buffer view read as zeros.
+    IO::GltfAccessor empty = document.getAccessor(1);
+    EXPECT_EQ(empty.data, nullptr);
+    float zeros[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    IO::readFloats(empty, 2, zeros, 2);
+    EXPECT_EQ(zeros[0], 0.0f);
+    EXPECT_EQ(zeros[3], 0.0f);
+}
+
+TEST(GltfDocumentTest, ReadsDataUris) {
+    // Two 16-bit indices, 1 and 2, in base64.
+    std::string json = R"({
+        "asset": {"version": "2.0"},
+        "buffers": [{"byteLength": 4, "uri": "data:application/octet-stream;base64,AQACAA=="}],
+        "bufferViews": [{"buffer": 0, "byteLength": 4}],
+        "accessors": [{"bufferView": 0, "componentType": 5123, "count": 2, "type": "SCALAR"}],
+        "images": [{"uri": "data:image/png;base64,iVBORw=="}, {"uri": "texture.png"}]
+    })";
+    std::vector<unsigned char> bytes(json.begin(), json.end());
+    IO::GltfDocument document = IO::GltfDocument::fromBytes(bytes);
+
+    unsigned int indices[2];
+    IO::readIndices(document.getAccessor(0), indices);
+    EXPECT_EQ(indices[0], 1u);
+    EXPECT_EQ(indices[1], 2u);
+
+    ASSERT_EQ(document.getImage(0).size(), 4u);
+    EXPECT_EQ(document.getImage(0)[1], 'P');
+    // External images are left to the caller.
+    EXPECT_TRUE(document.getImage(1).empty());
+}
+
+TEST(GltfDocumentTest, RejectsMalformedFiles) {
+    std::vector<unsigned char> glb = makeTriangleGlb();
+    std::vector<unsigned char> truncated(glb.begin(), glb.end() - 8);
+    EXPECT_THROW(IO::GltfDocument::fromBytes(truncated), std::runtime_error);
+
+    std::string text = R"({"asset": {"version": "1.0"}})";
+    std::vector<unsigned char> version(text.begin(), text.end());
+    EXPECT_THROW(IO::GltfDocument::fromBytes(version), std::runtime_error);
+
+    std::string outside = R"({
+        "asset": {"version": "2.0"},
+        "buffers": [{"byteLength": 4, "uri": "data:application/octet-stream;base64,AQACAA=="}],
+        "bufferViews": [{"buffer": 0, "byteLength": 4}],
+        "accessors": [{"bufferView": 0, "componentType": 5126, "count": 2, "type": "VEC3"}]
+    })";
+    std::vector<unsigned char> bytes(outside.begin(), outside.end());
+    IO::GltfDocument document = IO::GltfDocument::fromBytes(bytes);
+    EXPECT_THROW(document.getAccessor(0), std::runtime_error);
+    EXPECT_THROW(document.getAccessor(1), std::runtime_error);
+}
+
+TEST(GltfDocumentTest, LoadsMappedFile) {
+    std::vector<unsigned char> glb = makeTriangleGlb();
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "lamb_gltf_document_test.glb";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(glb.data()), static_cast<std::streamsize>(glb.size()));
+    }
+
+    IO::GltfDocument document = IO::GltfDocument::load(path.string());
+    unsigned int indices[3];
+    IO::readIndices(document.getAccessor(2), indices);
+    EXPECT_EQ(indices[1], 1u);
+    std::filesystem::remove(path);
+
+    EXPECT_THROW(IO::GltfDocument::load(path.string()), std::runtime_error);
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include <glm/glm.hpp>
+#include <light_clusters.hpp>
+
+// OpenGL perspective with a 90 degree field of view and a square aspect.
+static glm::mat4 makeProjection(float near, float far) {
+    glm::mat4 projection(0.0f);
+    projection[0][0] = 1.0f;
+    projection[1][1] = 1.0f;
+    projection[2][2] = -(far + near) / (far - near);
+    projection[2][3] = -1.0f;
+    projection[3][2] = -2.0f * far * near / (far - near);
+    return projection;
+}
+
+static PointLight makeLight(glm::vec3 position, float radius) {
+    PointLight light;
+    light.position = position;
+    light.radius = radius;
+    return light;
+}
+
+TEST(LightClustersTest, LightIsListedInTheClusterContainingIt) {
+    LightClusters clusters;
+    std::vector<PointLight> lights = {makeLight(glm::vec3(0.0f, 0.0f, -10.0f), 1.0f)};
+    clusters.build(lights, glm::mat4(1.0f), makeProjection(0.1f, 100.0f));
+
+    const glm::vec4& depth = clusters.getUniforms().depthParams;
+    uint32_t slice = static_cast<uint32_t>(std::log(10.0f) * depth.z + depth.w);
+    const LightClusterRange& range = clusters.getClusters()[LightClusters::getClusterIndex(
+        LightClusters::GRID_X / 2, LightClusters::GRID_Y / 2, slice)];
+
+    ASSERT_EQ(range.count, 1);
+    EXPECT_EQ(clusters.getLightIndices()[range.offset], 0);
+}
+
+TEST(LightClustersTest, LightsOutsideTheFrustumAreCulled) {
+    LightClusters clusters;
+    std::vector<PointLight> lights = {
+        makeLight(glm::vec3(0.0f, 0.0f, 10.0f), 1.0f),     // behind the camera
+        makeLight(glm::vec3(0.0f, 0.0f, -500.0f), 1.0f),   // past the far plane
+        makeLight(glm::vec3(50.0f, 0.0f, -10.0f), 1.0f),   // off to the side
+        makeLight(glm::vec3(0.0f, 0.0f, -5.0f), 0.5f),
+    };
+    clusters.build(lights, glm::mat4(1.0f), makeProjection(0.1f, 100.0f));
+
+    EXPECT_EQ(clusters.getVisibleLightCount(), 1);
+    for (uint32_t index : clusters.getLightIndices())
+        EXPECT_EQ(index, 3);
+}
+
+TEST(LightClustersTest, RangesCoverTheIndexList) {
+    LightClusters clusters;
+    std::vector<PointLight> lights;
+    for (int i = 0; i < 200; i++)
+        lights.push_back(makeLight(glm::vec3((i % 20) - 10.0f, (i / 20) - 5.0f, -2.0f - i * 0.3f), 2.0f));
+    clusters.build(lights, glm::mat4(1.0f), makeProjection(0.1f, 100.0f));
+
+    uint32_t expectedOffset = 0;
+    for (const LightClusterRange& range : clusters.getClusters()) {
+        EXPECT_EQ(range.offset, expectedOffset);
+        expectedOffset += range.count;
+    }
+    EXPECT_EQ(expectedOffset, clusters.getLightIndices().size());
+}
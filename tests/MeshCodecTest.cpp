@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <cooked_model.hpp>
+#include <mesh_codec.hpp>
+#include <thread_pool.hpp>
+
+namespace {
+
+/**
+ * @brief Grid of `size` x `size` quads on a wavy surface, with normals,
+ * tangents and texture coordinates.
+ */
+void makeGrid(int size, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    vertices.clear();
+    indices.clear();
+    for (int y = 0; y <= size; y++) {
+        for (int x = 0; x <= size; x++) {
+            Vertex vertex{};
+            float height = std::sin(x * 0.3f) * std::cos(y * 0.2f);
+            vertex.position = glm::vec3(x * 0.1f, height, y * 0.1f);
+            vertex.normal = glm::normalize(glm::vec3(-0.3f * std::cos(x * 0.3f), 1.0f, 0.2f * std::sin(y * 0.2f)));
+            vertex.tangent = glm::vec3(1.0f, 0.0f, 0.0f);
+            vertex.biTangent = glm::vec3(0.0f, 0.0f, 1.0f);
+            vertex.textureCoordinates = glm::vec2(x / static_cast<float>(size), y / static_cast<float>(size));
+            vertices.push_back(vertex);
+        }
+    }
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            unsigned int corner = y * (size + 1) + x;
+            indices.insert(indices.end(), {corner, corner + size + 1, corner + 1});
+            indices.insert(indices.end(), {corner + 1, corner + size + 1, corner + size + 2});
+        }
+    }
+}
+
+/**
+ * @brief Triangle starting from its smallest index, keeping the winding.
+ */
+std::array<unsigned int, 3> canonical(const unsigned int* triangle) {
+    int first = static_cast<int>(std::min_element(triangle, triangle + 3) - triangle);
+    return {triangle[first], triangle[(first + 1) % 3], triangle[(first + 2) % 3]};
+}
+
+}
+
+TEST(MeshCodecTest, VerticesRoundTripWithinQuantization) {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    makeGrid(120, vertices, indices);
+    vertices[7].m_BoneIDs[0] = 3;
+    vertices[7].m_Weights[0] = 0.75f;
+    vertices[7].m_Weights[1] = 0.25f;
+
+    ThreadPool pool(3);
+    std::vector<unsigned char> encoded = MeshCodec::encodeVertices(vertices);
+    ASSERT_EQ(MeshCodec::getVertexCount(encoded), vertices.size());
+    std::vector<Vertex> decoded(vertices.size());
+    MeshCodec::decodeVertices(encoded, decoded, &pool);
+
+    const float positionError = 12.0f / 65535.0f;
+    for (size_t i = 0; i < vertices.size(); i++) {
+        for (int c = 0; c < 3; c++) {
+            EXPECT_NEAR(decoded[i].position[c], vertices[i].position[c], positionError);
+            EXPECT_NEAR(decoded[i].normal[c], vertices[i].normal[c], 1e-3f);
+        }
+        EXPECT_NEAR(decoded[i].textureCoordinates.x, vertices[i].textureCoordinates.x, 1e-4f);
+        EXPECT_NEAR(decoded[i].tangent.x, 1.0f, 1e-4f);
+        EXPECT_NEAR(decoded[i].biTangent.z, 1.0f, 1e-4f);
+    }
+    EXPECT_EQ(decoded[7].m_BoneIDs[0], 3);
+    EXPECT_NEAR(decoded[7].m_Weights[0], 0.75f, 1e-4f);
+    EXPECT_EQ(decoded[8].m_Weights[0], 0.0f);
+}
+
+TEST(MeshCodecTest, MissingStreamsDecodeAsZero) {
+    std::vector<Vertex> vertices(40, Vertex{});
+    for (size_t i = 0; i < vertices.size(); i++) vertices[i].position = glm::vec3(static_cast<float>(i), -1.0f, 2.0f);
+
+    std::vector<unsigned char> encoded = MeshCodec::encodeVertices(vertices);
+    std::vector<Vertex> decoded(vertices.size());
+    MeshCodec::decodeVertices(encoded, decoded);
+    EXPECT_EQ(decoded[39].position, glm::vec3(39.0f, -1.0f, 2.0f));
+    EXPECT_EQ(decoded[5].normal, glm::vec3(0.0f));
+    EXPECT_EQ(decoded[5].tangent, glm::vec3(0.0f));
+    EXPECT_EQ(decoded[5].m_Weights[3], 0.0f);
+
+    std::vector<Vertex> empty;
+    EXPECT_EQ(MeshCodec::getVertexCount(MeshCodec::encodeVertices(empty)), 0u);
+}
+
+TEST(MeshCodecTest, IndicesRoundTripAcrossBlocks) {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    makeGrid(100, vertices, indices);
+    MeshCodec::optimizeVertexOrder(vertices, indices);
+    // A few triangles sharing no edge and far-away vertices.
+    indices.insert(indices.end(), {5000, 3, 9000, 17, 10200, 1});
+
+    ThreadPool pool(3);
+    std::vector<unsigned char> encoded = MeshCodec::encodeIndices(indices);
+    ASSERT_EQ(MeshCodec::getIndexCount(encoded), indices.size());
+    std::vector<unsigned int> decoded(indices.size());
+    MeshCodec::decodeIndices(encoded, decoded, &pool);
+
+    for (size_t i = 0; i < indices.size(); i += 3)
+        ASSERT_EQ(canonical(&decoded[i]), canonical(&indices[i])) << "triangle " << i / 3;
+    // Mostly one byte per triangle.
+    EXPECT_LT(encoded.size(), indices.size() / 3 * 2);
+
+    std::vector<unsigned int> strip = {0, 1};
+    EXPECT_THROW(MeshCodec::encodeIndices(strip), std::invalid_argument);
+}
+
+TEST(MeshCodecTest, RejectsMalformedBuffers) {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    makeGrid(20, vertices, indices);
+    std::vector<unsigned char> encodedVertices = MeshCodec::encodeVertices(vertices);
+    std::vector<unsigned char> encodedIndices = MeshCodec::encodeIndices(indices);
+
+    std::vector<unsigned char> truncated(encodedVertices.begin(), encodedVertices.end() - 10);
+    std::vector<Vertex> decodedVertices(vertices.size());
+    EXPECT_THROW(MeshCodec::decodeVertices(truncated, decodedVertices), std::runtime_error);
+    EXPECT_THROW(MeshCodec::getVertexCount(encodedIndices), std::runtime_error);
+
+    truncated.assign(encodedIndices.begin(), encodedIndices.end() - 10);
+    std::vector<unsigned int> decodedIndices(indices.size());
+    EXPECT_THROW(MeshCodec::decodeIndices(truncated, decodedIndices), std::runtime_error);
+}
+
+TEST(MeshCodecTest, CookedModelRoundTrip) {
+    IO::CookedModel model;
+    model.materialLibraries = {"scene.mtl"};
+    for (int i = 0; i < 3; i++) {
+        IO::CookedMesh mesh;
+        makeGrid(10 + i, mesh.vertices, mesh.indices);
+        mesh.material = "Material" + std::to_string(i);
+        mesh.textures.push_back({TextureType::DIFFUSE, "textures/albedo.png"});
+        mesh.skinned = i == 2;
+        model.meshes.push_back(std::move(mesh));
+    }
+    model.nodes.push_back({"root", -1, glm::mat4(1.0f)});
+    model.nodes.push_back({"child", 0, glm::mat4(2.0f)});
+    model.instances = {{0, 0}, {1, 1}, {2, 1}};
+
+    ThreadPool pool(2);
+    std::vector<unsigned char> bytes = IO::serializeCookedModel(model);
+    IO::CookedModel loaded = IO::parseCookedModel(bytes, &pool);
+
+    EXPECT_EQ(loaded.materialLibraries, model.materialLibraries);
+    ASSERT_EQ(loaded.meshes.size(), 3u);
+    for (size_t i = 0; i < 3; i++) {
+        EXPECT_EQ(loaded.meshes[i].vertices.size(), model.meshes[i].vertices.size());
+        EXPECT_EQ(loaded.meshes[i].indices.size(), model.meshes[i].indices.size());
+        EXPECT_EQ(loaded.meshes[i].material, model.meshes[i].material);
+        EXPECT_EQ(loaded.meshes[i].skinned, model.meshes[i].skinned);
+        ASSERT_EQ(loaded.meshes[i].textures.size(), 1u);
+        EXPECT_EQ(loaded.meshes[i].textures[0].path, "textures/albedo.png");
+    }
+    ASSERT_EQ(loaded.nodes.size(), 2u);
+    EXPECT_EQ(loaded.nodes[1].name, "child");
+    EXPECT_EQ(loaded.nodes[1].parent, 0);
+    EXPECT_EQ(loaded.nodes[1].localTransform, glm::mat4(2.0f));
+    ASSERT_EQ(loaded.instances.size(), 3u);
+    EXPECT_EQ(loaded.instances[2].node, 1u);
+
+    bytes.resize(bytes.size() / 2);
+    EXPECT_THROW(IO::parseCookedModel(bytes, &pool), std::runtime_error);
+}
+
+TEST(MeshCodecTest, CompressesLargeMeshes) {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    makeGrid(700, vertices, indices);
+    MeshCodec::optimizeVertexOrder(vertices, indices);
+
+    std::vector<unsigned char> encodedVertices = MeshCodec::encodeVertices(vertices);
+    std::vector<unsigned char> encodedIndices = MeshCodec::encodeIndices(indices);
+    EXPECT_LT(encodedVertices.size(), vertices.size() * sizeof(Vertex) / 4);
+    EXPECT_LT(encodedIndices.size(), indices.size() * sizeof(unsigned int) / 4);
+
+    std::vector<Vertex> decodedVertices(vertices.size());
+    std::vector<unsigned int> decodedIndices(indices.size());
+    MeshCodec::decodeVertices(encodedVertices, decodedVertices);
+    MeshCodec::decodeIndices(encodedIndices, decodedIndices);
+    EXPECT_EQ(decodedIndices, indices);
+    EXPECT_NEAR(decodedVertices.back().position.x, vertices.back().position.x, 1e-2f);
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <mtl_parser.hpp>
+#include <material_registry.hpp>
+
+TEST(MtlParserTest, ReadsColorsAndScalars) {
+    std::vector<Material> materials = IO::parseMTLSource(
+        "# Library\n"
+        "newmtl Gold Leaf\n"
+        "Ka 0.25 0.2 0.075     # ambient\r\n"
+        "Kd 0.5\n"
+        "Ks +0.6 0.55 0.35\n"
+        "Ke 0 0 1e-1\n"
+        "Ns 51.2\n"
+        "Ni 1.45\n"
+        "illum 7\n"
+        "sharpness 120\n"
+        "d -halo 0.5\n"
+        "\n"
+        "newmtl Glass\n"
+        "Tr 0.75\n"
+        "Tf xyz 0.9505 1.0 1.089\n");
+
+    ASSERT_EQ(materials.size(), 2u);
+    const Material& gold = materials[0];
+    EXPECT_EQ(gold.name, "Gold Leaf");
+    EXPECT_EQ(gold.ambient, glm::vec3(0.25f, 0.2f, 0.075f));
+    // A single value sets every component.
+    EXPECT_EQ(gold.diffuse, glm::vec3(0.5f));
+    EXPECT_EQ(gold.specular, glm::vec3(0.6f, 0.55f, 0.35f));
+    EXPECT_FLOAT_EQ(gold.emissive.z, 0.1f);
+    EXPECT_FLOAT_EQ(gold.shininess, 51.2f);
+    EXPECT_FLOAT_EQ(gold.opticalDensity, 1.45f);
+    EXPECT_EQ(gold.illumination, 7);
+    EXPECT_FLOAT_EQ(gold.sharpness, 120.0f);
+    EXPECT_TRUE(gold.dissolveHalo);
+    EXPECT_FLOAT_EQ(gold.dissolve, 0.5f);
+
+    const Material& glass = materials[1];
+    EXPECT_FLOAT_EQ(glass.dissolve, 0.25f);
+    // D65 white point converts to white.
+    EXPECT_NEAR(glass.transmissionFilter.x, 1.0f, 1e-3f);
+    EXPECT_NEAR(glass.transmissionFilter.y, 1.0f, 1e-3f);
+    EXPECT_NEAR(glass.transmissionFilter.z, 1.0f, 1e-3f);
+}
+
+TEST(MtlParserTest, ReadsMapsWithOptions) {
+    std::vector<Material> materials = IO::parseMTLSource(
+        "newmtl Brick\n"
+        "map_Kd -o 0.5 0.25 -s 2 -clamp on -blendu off textures/brick wall.png\n"
+        "bump -bm 0.3 -imfchan l brick_bump.png\n"
+        "refl -type sphere -mm 0.1 0.8 sky.png\n"
+        "map_aat on\n");
+
+    ASSERT_EQ(materials.size(), 1u);
+    const MaterialMap& diffuse = materials[0].getMap(MaterialMapType::DIFFUSE);
+    EXPECT_EQ(diffuse.path, "textures/brick wall.png");
+    EXPECT_EQ(diffuse.offset, glm::vec3(0.5f, 0.25f, 0.0f));
+    EXPECT_EQ(diffuse.scale, glm::vec3(2.0f, 1.0f, 1.0f));
+    EXPECT_TRUE(diffuse.clamp);
+    EXPECT_FALSE(diffuse.blendU);
+    EXPECT_TRUE(diffuse.blendV);
+
+    const MaterialMap& bump = materials[0].getMap(MaterialMapType::BUMP);
+    EXPECT_EQ(bump.path, "brick_bump.png");
+    EXPECT_FLOAT_EQ(bump.bumpMultiplier, 0.3f);
+    EXPECT_EQ(bump.channel, 'l');
+
+    const MaterialMap& reflection = materials[0].getMap(MaterialMapType::REFLECTION);
+    EXPECT_EQ(reflection.type, "sphere");
+    EXPECT_FLOAT_EQ(reflection.rangeBase, 0.1f);
+    EXPECT_FLOAT_EQ(reflection.rangeGain, 0.8f);
+    EXPECT_TRUE(materials[0].textureAntiAliasing);
+    EXPECT_TRUE(materials[0].getMap(MaterialMapType::SPECULAR).path.empty());
+}
+
+TEST(MtlParserTest, SkipsMalformedStatements) {
+    std::vector<Material> materials = IO::parseMTLSource(
+        "Kd 1 1 1\n"
+        "newmtl Rough\n"
+        "Ns abc\n"
+        "Kd spectral curve.rfl\n"
+        "Pr 0.5\n"
+        "Ks 0.2\n");
+
+    ASSERT_EQ(materials.size(), 1u);
+    EXPECT_FLOAT_EQ(materials[0].shininess, 0.0f);
+    EXPECT_EQ(materials[0].diffuse, glm::vec3(0.0f));
+    EXPECT_EQ(materials[0].specular, glm::vec3(0.2f));
+}
+
+TEST(MtlParserTest, RegistryKeepsIdsStable) {
+    MaterialRegistry registry;
+    EXPECT_EQ(registry.size(), 1u);
+    EXPECT_EQ(registry.find("default"), DEFAULT_MATERIAL);
+    EXPECT_EQ(registry.find("Gold"), INVALID_MATERIAL);
+
+    std::vector<MaterialId> ids;
+    for (int i = 0; i < 1000; i++) {
+        Material material;
+        material.name = "material_" + std::to_string(i);
+        material.shininess = static_cast<float>(i);
+        ids.push_back(registry.add(std::move(material)));
+    }
+    Material first = registry.get(ids[0]);
+    EXPECT_EQ(registry.find("material_500"), ids[500]);
+    EXPECT_FLOAT_EQ(registry.get(ids[500]).shininess, 500.0f);
+
+    // Registering a name again replaces the material under the same id.
+    Material replacement;
+    replacement.name = "material_0";
+    replacement.shininess = 64.0f;
+    EXPECT_EQ(registry.add(replacement), ids[0]);
+    EXPECT_EQ(registry.size(), 1001u);
+    EXPECT_FLOAT_EQ(registry.get(ids[0]).shininess, 64.0f);
+    // get() returned a copy, which the replacement leaves untouched.
+    EXPECT_FLOAT_EQ(first.shininess, 0.0f);
+}
+
+TEST(MtlParserTest, RegistryCollectsChangedRange) {
+    MaterialRegistry registry;
+    std::vector<GpuMaterial> changes;
+    EXPECT_EQ(registry.collectChanges(changes), DEFAULT_MATERIAL);
+    EXPECT_EQ(changes.size(), 1u);
+    EXPECT_FLOAT_EQ(changes[0].diffuse.w, 32.0f);
+
+    registry.collectChanges(changes);
+    EXPECT_TRUE(changes.empty());
+
+    Material a, b;
+    a.name = "a";
+    b.name = "b";
+    b.dissolve = 0.5f;
+    registry.add(a);
+    MaterialId id = registry.add(b);
+    EXPECT_EQ(registry.collectChanges(changes), 1u);
+    ASSERT_EQ(changes.size(), 2u);
+    EXPECT_FLOAT_EQ(changes[id - 1].ambient.w, 0.5f);
+
+    EXPECT_EQ(registry.collectChanges(changes, true), 0u);
+    EXPECT_EQ(changes.size(), 3u);
+}
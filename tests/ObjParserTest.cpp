@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <obj_parser.hpp>
+#include <thread_pool.hpp>
+
+TEST(ObjParserTest, ReadsQuadAsTriangles) {
+    IO::ObjGeometry geometry = IO::parseOBJSource(
+        "# Quad\n"
+        "mtllib quad.mtl\n"
+        "v 0 0 0\n"
+        "v 1 0 0   # corner\r\n"
+        "v 1 1 +0\n"
+        "v 0 1 0\n"
+        "vt 0 0\n"
+        "vt 1 0\n"
+        "vt 1 1\n"
+        "vt 0 1 0\n"
+        "vn 0 0 1\n"
+        "usemtl Brick\n"
+        "f 1/1/1 2/2/1 3/3/1 4/4/1\n");
+
+    ASSERT_EQ(geometry.vertices.size(), 4u);
+    ASSERT_EQ(geometry.indices.size(), 6u);
+    EXPECT_EQ(geometry.indices, (std::vector<unsigned int>{0, 1, 2, 0, 2, 3}));
+    EXPECT_EQ(geometry.vertices[2].position, glm::vec3(1.0f, 1.0f, 0.0f));
+    EXPECT_EQ(geometry.vertices[3].textureCoordinates, glm::vec2(0.0f, 1.0f));
+    EXPECT_EQ(geometry.vertices[1].normal, glm::vec3(0.0f, 0.0f, 1.0f));
+    ASSERT_EQ(geometry.materialLibraries.size(), 1u);
+    EXPECT_EQ(geometry.materialLibraries[0], "quad.mtl");
+    ASSERT_EQ(geometry.groups.size(), 1u);
+    EXPECT_EQ(geometry.groups[0].material, "Brick");
+    EXPECT_EQ(geometry.groups[0].indexCount, 6u);
+}
+
+TEST(ObjParserTest, SharesCornersAndResolvesRelativeIndices) {
+    IO::ObjGeometry geometry = IO::parseOBJSource(
+        "v 0 0 0\n"
+        "v 1 0 0\n"
+        "v 1 1 0\n"
+        "f 1 2 3\n"
+        "v 0 1 0\n"
+        "f -4 -2 -1\n"
+        "vn 0 0 1\n"
+        "f 1//1 3//1 4//1\n");
+
+    // The second face reuses two corners of the first, the third has normals.
+    ASSERT_EQ(geometry.indices.size(), 9u);
+    EXPECT_EQ(geometry.vertices.size(), 7u);
+    EXPECT_EQ(geometry.indices[3], 0u);
+    EXPECT_EQ(geometry.indices[4], 2u);
+    EXPECT_EQ(geometry.indices[5], 3u);
+    EXPECT_EQ(geometry.vertices[3].position, glm::vec3(0.0f, 1.0f, 0.0f));
+    EXPECT_EQ(geometry.vertices[geometry.indices[6]].normal, glm::vec3(0.0f, 0.0f, 1.0f));
+}
+
+TEST(ObjParserTest, SkipsInvalidStatements) {
+    IO::ObjGeometry geometry = IO::parseOBJSource(
+        "v 0 0 0\n"
+        "v 1 0 0\n"
+        "v 1 1 0\n"
+        "v 1 abc 0\n"
+        "f 1 2\n"
+        "f 1 2 9\n"
+        "f 0 1 2\n"
+        "curv 0 1 1 2\n"
+        "f 1 2 3\n");
+
+    // The malformed vertex keeps its place so later indices stay right.
+    EXPECT_EQ(geometry.indices.size(), 3u);
+    EXPECT_EQ(geometry.vertices.size(), 3u);
+    ASSERT_EQ(geometry.groups.size(), 1u);
+    EXPECT_TRUE(geometry.groups[0].material.empty());
+}
+
+TEST(ObjParserTest, ChunksDoNotChangeResult) {
+    std::string source = "mtllib a.mtl\n";
+    const int size = 40;
+    for (int y = 0; y <= size; y++) {
+        for (int x = 0; x <= size; x++)
+            source += "v " + std::to_string(x) + " " + std::to_string(y) + " 0\n";
+    }
+    source += "vn 0 0 1\n";
+    for (int y = 0; y < size; y++) {
+        source += y % 2 == 0 ? "usemtl Even\n" : "usemtl Odd\n";
+        for (int x = 0; x < size; x++) {
+            int corner = y * (size + 1) + x + 1;
+            // Quads with normals, then triangles with relative indices, then plain triangles.
+            int relative = corner - (size + 1) * (size + 1) - 1;
+            if (y % 3 == 0) {
+                source += "f " + std::to_string(corner) + "//1 " + std::to_string(corner + 1) + "//1 " +
+                          std::to_string(corner + size + 2) + "//1 " + std::to_string(corner + size + 1) + "//1\n";
+            } else if (y % 3 == 1) {
+                source += "f " + std::to_string(relative) + " " + std::to_string(relative + 1) + " " +
+                          std::to_string(relative + size + 2) + "\n";
+            } else {
+                source += "f " + std::to_string(corner) + " " + std::to_string(corner + 1) + " " +
+                          std::to_string(corner + size + 2) + "\n";
+            }
+        }
+    }
+
+    ThreadPool pool(3);
+    IO::ObjGeometry whole = IO::parseOBJSource(source, "grid", source.size() + 1, &pool);
+    IO::ObjGeometry chunked = IO::parseOBJSource(source, "grid", 97, &pool);
+
+    EXPECT_EQ(whole.indices, chunked.indices);
+    ASSERT_EQ(whole.vertices.size(), chunked.vertices.size());
+    for (size_t i = 0; i < whole.vertices.size(); i++) {
+        EXPECT_EQ(whole.vertices[i].position, chunked.vertices[i].position);
+        EXPECT_EQ(whole.vertices[i].normal, chunked.vertices[i].normal);
+    }
+    ASSERT_EQ(whole.groups.size(), static_cast<size_t>(size));
+    ASSERT_EQ(chunked.groups.size(), whole.groups.size());
+    for (size_t i = 0; i < whole.groups.size(); i++) {
+        EXPECT_EQ(whole.groups[i].material, chunked.groups[i].material);
+        EXPECT_EQ(whole.groups[i].firstIndex, chunked.groups[i].firstIndex);
+        EXPECT_EQ(whole.groups[i].indexCount, chunked.groups[i].indexCount);
+    }
+    EXPECT_EQ(chunked.materialLibraries.size(), 1u);
+}
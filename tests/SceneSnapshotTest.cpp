@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <entity_manager.hpp>
+#include <material_registry.hpp>
+#include <scene_snapshot.hpp>
+#include <transform_hierarchy.hpp>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+MaterialId addMaterial(MaterialRegistry& registry, const std::string& name) {
+    Material material;
+    material.name = name;
+    return registry.add(std::move(material));
+}
+
+}
+
+TEST(SceneSnapshotTest, EntitiesRoundTrip) {
+    MaterialRegistry materials;
+    MaterialId gold = addMaterial(materials, "Gold");
+    MaterialId stone = addMaterial(materials, "Stone");
+
+    TransformHierarchy transforms;
+    EntityManager saved;
+    Entity& root = saved.createEntity();
+    Transform rootLocal;
+    rootLocal.position = glm::vec3(1.0f, 2.0f, 3.0f);
+    root.transform = transforms.create(INVALID_TRANSFORM, rootLocal);
+    root.material = stone;
+    root.model = saved.addAsset(".\\res\\teapot.fbx");
+    Entity& child = saved.createEntity();
+    Transform childLocal;
+    childLocal.rotation = glm::vec3(0.0f, 90.0f, 0.0f);
+    childLocal.scale = glm::vec3(0.5f);
+    child.transform = transforms.create(root.transform, childLocal);
+    child.material = gold;
+    child.model = saved.addAsset("res/teapot.fbx");
+    Entity& bare = saved.createEntity();
+    // Under a node that is not an entity's, so saved as a root.
+    Entity& orphan = saved.createEntity();
+    orphan.transform = transforms.create(transforms.create());
+    // Saved before its parent.
+    Entity& leaf = saved.createEntity();
+    Entity& late = saved.createEntity();
+    late.transform = transforms.create();
+    leaf.transform = transforms.create(late.transform);
+
+    fs::path path = fs::temp_directory_path() / "lamb_scene_snapshot_test.lscene";
+    saved.save(path.string(), materials, transforms);
+
+    // Loaded against a registry with other ids, and next to other entities.
+    MaterialRegistry otherMaterials;
+    addMaterial(otherMaterials, "Unused");
+    MaterialId otherGold = addMaterial(otherMaterials, "Gold");
+    TransformHierarchy otherTransforms;
+    otherTransforms.create();
+    EntityManager loaded;
+    loaded.createEntity();
+    std::span<Entity> entities = loaded.load(path.string(), otherMaterials, otherTransforms);
+    ASSERT_EQ(entities.size(), 6u);
+    EXPECT_EQ(loaded.getEntities().size(), 7u);
+    EXPECT_EQ(otherTransforms.size(), 7u);
+
+    EXPECT_EQ(otherTransforms.getParent(entities[0].transform), INVALID_TRANSFORM);
+    EXPECT_EQ(otherTransforms.getLocal(entities[0].transform).position, rootLocal.position);
+    EXPECT_EQ(entities[0].material, INVALID_MATERIAL);
+    EXPECT_EQ(loaded.getAssetPath(entities[0].model), "res/teapot.fbx");
+
+    EXPECT_EQ(otherTransforms.getParent(entities[1].transform), entities[0].transform);
+    EXPECT_EQ(otherTransforms.getLocal(entities[1].transform).rotation, childLocal.rotation);
+    EXPECT_EQ(otherTransforms.getLocal(entities[1].transform).scale, childLocal.scale);
+    EXPECT_EQ(entities[1].material, otherGold);
+    EXPECT_EQ(entities[1].model, entities[0].model);
+
+    EXPECT_EQ(otherTransforms.getParent(entities[2].transform), INVALID_TRANSFORM);
+    EXPECT_EQ(entities[2].material, bare.material);
+    EXPECT_EQ(entities[2].model, INVALID_ASSET);
+    EXPECT_EQ(otherTransforms.getParent(entities[3].transform), INVALID_TRANSFORM);
+    EXPECT_EQ(otherTransforms.getParent(entities[4].transform), entities[5].transform);
+
+    // The restored hierarchy drives the world matrices.
+    otherTransforms.update();
+    transforms.update();
+    EXPECT_EQ(otherTransforms.getWorldMatrix(entities[1].transform), transforms.getWorldMatrix(child.transform));
+    fs::remove(path);
+}
+
+TEST(SceneSnapshotTest, RejectsCorruptSnapshots) {
+    IO::SceneData scene;
+    scene.parents = {-1, 0};
+    scene.transforms.resize(2);
+    scene.materials = {IO::NO_SCENE_REFERENCE, 0};
+    scene.models = {IO::NO_SCENE_REFERENCE, IO::NO_SCENE_REFERENCE};
+    scene.materialNames = {"Gold"};
+    std::vector<unsigned char> bytes = IO::serializeScene(scene);
+
+    auto open = [](std::vector<unsigned char> file) {
+        auto owner = std::make_shared<std::vector<unsigned char>>(std::move(file));
+        return IO::SceneSnapshot(FileData(owner, *owner));
+    };
+    EXPECT_EQ(open(bytes).getMaterialName(0), "Gold");
+    EXPECT_THROW(open(std::vector<unsigned char>(bytes.begin(), bytes.end() - 1)), std::runtime_error);
+    EXPECT_THROW(open(std::vector<unsigned char>(bytes.begin(), bytes.begin() + 8)), std::runtime_error);
+
+    scene.parents[0] = 1;
+    scene.parents[1] = 1;
+    EXPECT_THROW(open(IO::serializeScene(scene)), std::runtime_error);
+    // 0 and 1 parent each other.
+    scene.parents[1] = 0;
+    EXPECT_THROW(open(IO::serializeScene(scene)), std::runtime_error);
+    scene.parents[0] = -1;
+    EXPECT_NO_THROW(open(IO::serializeScene(scene)));
+    scene.materials[1] = 1;
+    EXPECT_THROW(open(IO::serializeScene(scene)), std::runtime_error);
+    scene.models.pop_back();
+    EXPECT_THROW(IO::serializeScene(scene), std::invalid_argument);
+}
+
+TEST(SceneSnapshotTest, LoadsLargeScenes) {
+    constexpr int32_t COUNT = 100000;
+    IO::SceneData scene;
+    scene.materialNames = {"Gold", "Stone"};
+    scene.assets = {"res/teapot.fbx", "res/box.lmodel", "res/crate.lmodel"};
+    for (int32_t i = 0; i < COUNT; i++) {
+        scene.parents.push_back(i < 100 ? -1 : i % 100);
+        scene.transforms.push_back({glm::vec3(static_cast<float>(i)), glm::vec3(0.0f), glm::vec3(1.0f)});
+        scene.materials.push_back(i % 2);
+        scene.models.push_back(i % 3);
+    }
+    fs::path path = fs::temp_directory_path() / "lamb_scene_snapshot_large.lscene";
+    IO::writeScene(path.string(), scene);
+
+    MaterialRegistry materials;
+    addMaterial(materials, "Gold");
+    TransformHierarchy transforms;
+    EntityManager entities;
+    std::span<Entity> loaded = entities.load(path.string(), materials, transforms);
+    ASSERT_EQ(loaded.size(), static_cast<size_t>(COUNT));
+    EXPECT_EQ(transforms.getLocal(loaded[COUNT - 1].transform).position, glm::vec3(static_cast<float>(COUNT - 1)));
+    EXPECT_EQ(transforms.getParent(loaded[COUNT - 1].transform), loaded[(COUNT - 1) % 100].transform);
+    EXPECT_EQ(entities.getAssetPath(loaded[4].model), "res/box.lmodel");
+    EXPECT_EQ(loaded[1].material, INVALID_MATERIAL);
+    fs::remove(path);
+}
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <shader_features.hpp>
+
+TEST(ShaderFeaturesTest, DefinesFollowTheVersionLine) {
+    std::string source = "#version 460 core\nout vec4 color;\nvoid main() {}\n";
+    std::vector<ShaderConstant> constants = {{"MAX_BONES", "128"}};
+
+    std::string result = injectDefines(source, DIFFUSE_MAP | SHADOWS, constants);
+
+    EXPECT_EQ(result,
+        "#version 460 core\n"
+        "#define DIFFUSE_MAP\n"
+        "#define SHADOWS\n"
+        "#define MAX_BONES 128\n"
+        "#line 2\n"
+        "out vec4 color;\nvoid main() {}\n");
+}
+
+TEST(ShaderFeaturesTest, LineNumbersSkipLeadingComments) {
+    std::string source = "// Header\n\n#version 460 core\nvoid main() {}";
+
+    std::string result = injectDefines(source, SPOTLIGHT);
+
+    EXPECT_EQ(result, "// Header\n\n#version 460 core\n#define SPOTLIGHT\n#line 4\nvoid main() {}");
+}
+
+TEST(ShaderFeaturesTest, SourceWithoutVersionGetsDefinesFirst) {
+    EXPECT_EQ(injectDefines("void main() {}", POINT_LIGHTS), "#define POINT_LIGHTS\n#line 1\nvoid main() {}");
+    EXPECT_EQ(injectDefines("#version 460 core", 0), "#version 460 core\n#line 2\n");
+}
+
+TEST(ShaderFeaturesTest, EveryFeatureHasAName) {
+    for (uint32_t bit = 0; bit < SHADER_FEATURE_COUNT; bit++)
+        EXPECT_NE(getShaderFeatureName(1u << bit), nullptr);
+    EXPECT_EQ(getShaderFeatureName(1u << SHADER_FEATURE_COUNT), nullptr);
+    EXPECT_EQ(getShaderFeatureName(DIFFUSE_MAP | SHADOWS), nullptr);
+}
+
+TEST(ShaderFeaturesTest, FallbackNeverAddsFeatures) {
+    std::vector<ShaderFeatures> available = {0, DIFFUSE_MAP | SPECULAR_MAP, SHADOWS};
+
+    EXPECT_EQ(findFallbackVariant(available, DIFFUSE_MAP), 0u);
+    EXPECT_EQ(findFallbackVariant(available, DIFFUSE_MAP | SPECULAR_MAP | SHADOWS), DIFFUSE_MAP | SPECULAR_MAP);
+    EXPECT_EQ(findFallbackVariant(available, SHADOWS | POINT_LIGHTS), SHADOWS);
+    EXPECT_FALSE(findFallbackVariant(std::vector<ShaderFeatures>{SHADOWS}, DIFFUSE_MAP).has_value());
+}
+
+TEST(ShaderFeaturesTest, FallbackTiesPickTheSmallerMask) {
+    std::vector<ShaderFeatures> available = {SPOTLIGHT, DIFFUSE_MAP, SHADOWS};
+
+    EXPECT_EQ(findFallbackVariant(available, DIFFUSE_MAP | SHADOWS | SPOTLIGHT), DIFFUSE_MAP);
+}
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <shadow_atlas_allocator.hpp>
+
+static bool overlaps(const ShadowTile& a, const ShadowTile& b) {
+    return a.x < b.x + b.size && b.x < a.x + a.size && a.y < b.y + b.size && b.y < a.y + a.size;
+}
+
+TEST(ShadowAtlasAllocatorTest, TilesFillTheAtlasWithoutOverlapping) {
+    ShadowAtlasAllocator allocator(1024, 128);
+    std::vector<ShadowTile> tiles;
+    for (int i = 0; i < 64; i++) {
+        std::optional<ShadowTile> tile = allocator.allocate(128);
+        ASSERT_TRUE(tile.has_value());
+        tiles.push_back(*tile);
+    }
+
+    EXPECT_FALSE(allocator.allocate(128).has_value());
+    EXPECT_EQ(allocator.getFreeTexels(), 0);
+    for (size_t i = 0; i < tiles.size(); i++) {
+        EXPECT_LE(tiles[i].x + tiles[i].size, 1024);
+        EXPECT_LE(tiles[i].y + tiles[i].size, 1024);
+        for (size_t j = i + 1; j < tiles.size(); j++)
+            EXPECT_FALSE(overlaps(tiles[i], tiles[j]));
+    }
+}
+
+TEST(ShadowAtlasAllocatorTest, SizesAreRoundedUpToPowersOfTwo) {
+    ShadowAtlasAllocator allocator(2048, 128);
+
+    EXPECT_EQ(allocator.allocate(100)->size, 128);
+    EXPECT_EQ(allocator.allocate(300)->size, 512);
+    EXPECT_FALSE(allocator.allocate(4096).has_value());
+}
+
+TEST(ShadowAtlasAllocatorTest, FreedTilesMergeBack) {
+    ShadowAtlasAllocator allocator(1024, 128);
+    std::vector<ShadowTile> tiles;
+    for (int i = 0; i < 16; i++) tiles.push_back(*allocator.allocate(256));
+    EXPECT_FALSE(allocator.allocate(512).has_value());
+
+    for (const ShadowTile& tile : tiles) allocator.free(tile);
+
+    EXPECT_EQ(allocator.getFreeTexels(), 1024u * 1024u);
+    std::optional<ShadowTile> whole = allocator.allocate(1024);
+    ASSERT_TRUE(whole.has_value());
+    EXPECT_EQ(*whole, (ShadowTile{0, 0, 1024}));
+}
+
+TEST(ShadowAtlasAllocatorTest, HeldTilesKeepTheirPlace) {
+    ShadowAtlasAllocator allocator(1024, 128);
+    ShadowTile held = *allocator.allocate(256);
+    std::vector<ShadowTile> others;
+    for (int i = 0; i < 7; i++) others.push_back(*allocator.allocate(256));
+    for (const ShadowTile& tile : others) allocator.free(tile);
+
+    // Three quarters are whole again, the held tile's quarter is not.
+    for (int i = 0; i < 3; i++) {
+        std::optional<ShadowTile> quarter = allocator.allocate(512);
+        ASSERT_TRUE(quarter.has_value());
+        EXPECT_FALSE(overlaps(*quarter, held));
+    }
+    EXPECT_FALSE(allocator.allocate(512).has_value());
+}
@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <vector>
+#include <thread_pool.hpp>
+
+TEST(ThreadPoolTest, ParallelForVisitsEveryIndexOnce) {
+    ThreadPool pool(3);
+    std::vector<std::atomic<int>> visits(1000);
+
+    pool.parallelFor(visits.size(), 7, [&](size_t begin, size_t end, size_t slot) {
+        EXPECT_LT(slot, pool.getThreadCount());
+        for (size_t i = begin; i < end; i++) visits[i]++;
+    });
+
+    for (const std::atomic<int>& count : visits)
+        EXPECT_EQ(count.load(), 1);
+}
+
+TEST(ThreadPoolTest, SlotsAreNotShared) {
+    ThreadPool pool(3);
+    std::vector<std::atomic<int>> busy(pool.getThreadCount());
+
+    pool.parallelFor(64, 1, [&](size_t, size_t, size_t slot) {
+        EXPECT_EQ(busy[slot]++, 0);
+        std::this_thread::yield();
+        busy[slot]--;
+    });
+}
+
+TEST(ThreadPoolTest, SubmittedTasksRunBeforeShutdown) {
+    std::atomic<int> ran{0};
+    {
+        ThreadPool pool(2);
+        for (int i = 0; i < 10; i++)
+            pool.submit([&ran] { ran++; });
+    }
+    EXPECT_EQ(ran.load(), 10);
+}
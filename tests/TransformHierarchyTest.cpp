@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <transform_hierarchy.hpp>
+
+static Transform translation(float x, float y, float z) {
+    Transform transform;
+    transform.position = glm::vec3(x, y, z);
+    return transform;
+}
+
+TEST(TransformHierarchyTest, ChildInheritsParentTransform) {
+    TransformHierarchy hierarchy;
+    TransformHandle root = hierarchy.create(INVALID_TRANSFORM, translation(1.0f, 0.0f, 0.0f));
+    TransformHandle child = hierarchy.create(root, translation(0.0f, 2.0f, 0.0f));
+    hierarchy.update();
+
+    glm::vec4 origin = hierarchy.getWorldMatrix(child) * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    EXPECT_FLOAT_EQ(origin.x, 1.0f);
+    EXPECT_FLOAT_EQ(origin.y, 2.0f);
+    EXPECT_FLOAT_EQ(origin.z, 0.0f);
+}
+
+TEST(TransformHierarchyTest, OnlyDirtySubtreeIsRecomputed) {
+    TransformHierarchy hierarchy;
+    TransformHandle a = hierarchy.create();
+    TransformHandle b = hierarchy.create();
+    hierarchy.create(a);
+    hierarchy.create(a);
+    hierarchy.create(b);
+    hierarchy.update();
+    EXPECT_EQ(hierarchy.getLastUpdateCount(), 5);
+
+    hierarchy.update();
+    EXPECT_EQ(hierarchy.getLastUpdateCount(), 0);
+
+    hierarchy.setLocal(a, translation(0.0f, 0.0f, 5.0f));
+    hierarchy.update();
+    EXPECT_EQ(hierarchy.getLastUpdateCount(), 3);
+}
+
+TEST(TransformHierarchyTest, ReparentingKeepsHandlesValid) {
+    TransformHierarchy hierarchy;
+    TransformHandle child = hierarchy.create(INVALID_TRANSFORM, translation(0.0f, 1.0f, 0.0f));
+    TransformHandle parent = hierarchy.create(INVALID_TRANSFORM, translation(3.0f, 0.0f, 0.0f));
+    hierarchy.setParent(child, parent);
+    hierarchy.update();
+
+    EXPECT_EQ(hierarchy.getParent(child), parent);
+    glm::vec4 origin = hierarchy.getWorldMatrix(child) * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    EXPECT_FLOAT_EQ(origin.x, 3.0f);
+    EXPECT_FLOAT_EQ(origin.y, 1.0f);
+
+    EXPECT_THROW(hierarchy.setParent(parent, child), std::invalid_argument);
+}
+
+TEST(TransformHierarchyTest, DestroyRemovesSubtree) {
+    TransformHierarchy hierarchy;
+    TransformHandle root = hierarchy.create();
+    TransformHandle child = hierarchy.create(root);
+    TransformHandle grandChild = hierarchy.create(child);
+    TransformHandle other = hierarchy.create();
+
+    hierarchy.destroy(child);
+    hierarchy.update();
+
+    EXPECT_EQ(hierarchy.size(), 2);
+    EXPECT_TRUE(hierarchy.isValid(root));
+    EXPECT_TRUE(hierarchy.isValid(other));
+    EXPECT_FALSE(hierarchy.isValid(child));
+    EXPECT_FALSE(hierarchy.isValid(grandChild));
+}
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <pak_archive.hpp>
+#include <virtual_file_system.hpp>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+void writeText(const fs::path& path, const std::string& text) {
+    fs::create_directories(path.parent_path());
+    std::ofstream(path, std::ios::binary) << text;
+}
+
+/**
+ * @brief A loose directory and a pak archive of other files, removed with the
+ * fixture.
+ */
+class VirtualFileSystemTest : public testing::Test {
+protected:
+    fs::path m_root = fs::temp_directory_path() / "lamb_vfs_test";
+    fs::path m_loose = m_root / "loose";
+    fs::path m_packed = m_root / "packed";
+    std::string m_pak = (m_root / "assets.pak").string();
+
+    void SetUp() override {
+        fs::remove_all(m_root);
+        writeText(m_loose / "shaders/a.glsl", "loose a");
+        writeText(m_loose / "shaders/b.glsl", "loose b");
+        writeText(m_packed / "shaders/a.glsl", "packed a");
+        writeText(m_packed / "res/empty.txt", "");
+        writeText(m_packed / "res/box.ltex", std::string(100, 'x'));
+        PakArchive::writeDirectory(m_pak, m_packed.string());
+    }
+    void TearDown() override { fs::remove_all(m_root); }
+};
+
+}
+
+TEST_F(VirtualFileSystemTest, PakArchiveRoundTrip) {
+    PakArchive archive(m_pak);
+    EXPECT_EQ(archive.getPaths(), (std::vector<std::string>{"res/box.ltex", "res/empty.txt", "shaders/a.glsl"}));
+    EXPECT_TRUE(archive.exists("shaders/a.glsl"));
+    EXPECT_FALSE(archive.exists("shaders/b.glsl"));
+    EXPECT_FALSE(archive.exists("shaders"));
+    EXPECT_EQ(archive.getNativePath("shaders/a.glsl"), "");
+
+    std::optional<FileData> file = archive.open("res/box.ltex");
+    ASSERT_TRUE(file);
+    EXPECT_EQ(file->getText(), std::string(100, 'x'));
+    // Contents are aligned relative to the page aligned mapping.
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(file->data()) % PakArchive::ALIGNMENT, 0u);
+    EXPECT_EQ(archive.open("res/empty.txt")->size(), 0u);
+    EXPECT_FALSE(archive.open("res/missing.txt"));
+
+    EXPECT_THROW(PakArchive::write(m_pak, {{"a.txt", (m_packed / "res/empty.txt").string()},
+                                           {"./a.txt", (m_packed / "res/empty.txt").string()}}),
+                 std::runtime_error);
+}
+
+TEST_F(VirtualFileSystemTest, MountsOverrideInOrder) {
+    VirtualFileSystem files;
+    files.mountDirectory("", m_loose.string());
+    files.mountArchive("", m_pak);
+    files.mountDirectory("extra", m_packed.string());
+
+    // The archive hides the loose file, the others fall through.
+    EXPECT_EQ(files.readText(".\\shaders\\a.glsl"), "packed a");
+    EXPECT_EQ(files.readText("shaders/./x/../b.glsl"), "loose b");
+    EXPECT_EQ(files.getNativePath("shaders/a.glsl"), "");
+    EXPECT_EQ(fs::path(files.getNativePath("shaders/b.glsl")), m_loose / "shaders/b.glsl");
+
+    // Mount points match whole path segments.
+    EXPECT_EQ(files.readText("extra/shaders/a.glsl"), "packed a");
+    EXPECT_FALSE(files.exists("extras/shaders/a.glsl"));
+    EXPECT_FALSE(files.exists("extra"));
+    EXPECT_THROW(files.open("shaders/c.glsl"), std::runtime_error);
+
+    // Absolute paths bypass the mounts.
+    std::string absolute = fs::absolute(m_loose / "shaders/a.glsl").string();
+    EXPECT_EQ(files.readText(absolute), "loose a");
+
+    // Data outlives its mount.
+    FileData data = files.open("res/box.ltex");
+    files.unmountAll();
+    EXPECT_FALSE(files.exists("res/box.ltex"));
+    EXPECT_EQ(data.getText(), std::string(100, 'x'));
+}
+
+TEST_F(VirtualFileSystemTest, RejectsCorruptArchives) {
+    std::string bytes;
+    {
+        std::ifstream file(m_pak, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    auto rewrite = [&](const std::string& contents) {
+        std::ofstream(m_pak, std::ios::binary | std::ios::trunc) << contents;
+    };
+
+    rewrite(bytes.substr(0, bytes.size() - 1));
+    EXPECT_THROW(PakArchive{m_pak}, std::runtime_error);
+    rewrite("LPAK");
+    EXPECT_THROW(PakArchive{m_pak}, std::runtime_error);
+    std::string badMagic = bytes;
+    badMagic[0] = 'X';
+    rewrite(badMagic);
+    EXPECT_THROW(PakArchive{m_pak}, std::runtime_error);
+    EXPECT_THROW(PakArchive{(m_root / "missing.pak").string()}, std::runtime_error);
+}
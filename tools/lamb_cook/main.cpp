@@ -0,0 +1,83 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include <asset_cook.hpp>
+#include <config_manager.hpp>
+#include <cook_rules.hpp>
+#include <pak_archive.hpp>
+#include <thread_pool.hpp>
+
+// Source directories scanned for assets, relative to the source root.
+static const std::vector<std::string> SOURCE_DIRECTORIES = {"res", "shaders"};
+
+static std::vector<Cook::CookRule> createRules() {
+    std::vector<Cook::CookRule> rules;
+    rules.push_back({{".fbx"}, 1, Cook::getModelSettingsHash, Cook::cookModel});
+    rules.push_back({{".png", ".bmp"}, 1, nullptr, Cook::cookTexture});
+    rules.push_back({{".mtl"}, 1, nullptr, Cook::cookMaterialLibrary});
+    rules.push_back({{".glsl"}, 1, nullptr, Cook::cookShader});
+    return rules;
+}
+
+static void printUsage() {
+    std::cout << "Usage: lamb_cook [--source DIR] [--output DIR] [--force] [--pak FILE] [--keep-going]\n"
+              << "Cooks res/ and shaders/ of the source directory (default \".\") into the output\n"
+              << "directory (default \"cooked\"), skipping assets that did not change.\n"
+              << "--pak packs the output directory into one archive, to mount at \"cooked\".\n"
+              << "--keep-going reports assets that failed to cook but still exits with 0." << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::string sourceRoot = ".";
+    std::string outputRoot = "cooked";
+    std::string pakPath;
+    bool force = false;
+    bool keepGoing = false;
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "--source" && i + 1 < argc) sourceRoot = argv[++i];
+        else if (argument == "--output" && i + 1 < argc) outputRoot = argv[++i];
+        else if (argument == "--force") force = true;
+        else if (argument == "--pak" && i + 1 < argc) pakPath = argv[++i];
+        else if (argument == "--keep-going") keepGoing = true;
+        else {
+            printUsage();
+            return argument == "--help" ? 0 : 2;
+        }
+    }
+
+    // Import profiles come from the configuration: read it before the workers need it.
+    ConfigurationManager::getInstance();
+
+    auto start = std::chrono::steady_clock::now();
+    Cook::AssetCooker cooker(sourceRoot, outputRoot, createRules());
+    std::vector<std::string> sources = cooker.findSources(SOURCE_DIRECTORIES);
+    Cook::CookReport report;
+    try {
+        report = cooker.cook(sources, force);
+    } catch (const std::exception& e) {
+        std::cerr << "ERROR::COOK::" << e.what() << std::endl;
+        return 1;
+    }
+    if (!pakPath.empty() && report.errors.empty()) {
+        try {
+            PakArchive::writeDirectory(pakPath, outputRoot);
+        } catch (const std::exception& e) {
+            report.errors.push_back(std::string("Pak archive: ") + e.what());
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (const std::string& skipped : report.skipped) std::cout << "COOK::SKIPPED::" << skipped << std::endl;
+    for (const std::string& error : report.errors) std::cerr << "ERROR::COOK::" << error << std::endl;
+    std::cout << "COOK::" << sources.size() << " assets, cooked: " << report.cooked
+              << ", up to date: " << report.upToDate << ", skipped: " << report.skipped.size()
+              << ", removed: " << report.removed << ", failed: " << report.errors.size()
+              << " (" << ThreadPool::getInstance().getThreadCount() << " threads, " << seconds << " s)" << std::endl;
+    return report.errors.empty() || keepGoing ? 0 : 1;
+}
@@ -0,0 +1,65 @@
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include <entity_manager.hpp>
+#include <material_registry.hpp>
+#include <scene_snapshot.hpp>
+#include <transform_hierarchy.hpp>
+
+namespace fs = std::filesystem;
+
+static void printUsage() {
+    std::cout << "Usage: lamb_scene_bench [--entities N] [--runs N]\n"
+              << "Writes a scene of N entities (default 100000) to a temporary \".lscene\"\n"
+              << "snapshot and reports how long loading it takes, over --runs loads (default 5)." << std::endl;
+}
+
+int main(int argc, char** argv) {
+    int32_t count = 100000;
+    int runs = 5;
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument == "--entities" && i + 1 < argc) count = std::stoi(argv[++i]);
+        else if (argument == "--runs" && i + 1 < argc) runs = std::stoi(argv[++i]);
+        else {
+            printUsage();
+            return argument == "--help" ? 0 : 2;
+        }
+    }
+
+    // A hundred roots with the rest of the scene spread under them.
+    IO::SceneData scene;
+    scene.materialNames = {"Gold", "Stone"};
+    scene.assets = {"res/teapot.fbx", "res/box.lmodel", "res/crate.lmodel"};
+    for (int32_t i = 0; i < count; i++) {
+        scene.parents.push_back(i < 100 ? -1 : i % 100);
+        scene.transforms.push_back({glm::vec3(static_cast<float>(i)), glm::vec3(0.0f), glm::vec3(1.0f)});
+        scene.materials.push_back(i % 2);
+        scene.models.push_back(i % 3);
+    }
+    fs::path path = fs::temp_directory_path() / "lamb_scene_bench.lscene";
+    IO::writeScene(path.string(), scene);
+
+    MaterialRegistry materials;
+    Material gold;
+    gold.name = "Gold";
+    materials.add(std::move(gold));
+
+    double best = 0.0;
+    double total = 0.0;
+    for (int run = 0; run < runs; run++) {
+        TransformHierarchy transforms;
+        EntityManager entities;
+        auto start = std::chrono::steady_clock::now();
+        entities.load(path.string(), materials, transforms);
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        best = run == 0 ? milliseconds : std::min(best, milliseconds);
+        total += milliseconds;
+    }
+    std::cout << count << " entities, " << fs::file_size(path) / 1024 << " KB: best " << best << " ms, mean "
+              << total / runs << " ms over " << runs << " loads" << std::endl;
+    fs::remove(path);
+    return 0;
+}